@@ -0,0 +1,525 @@
+/**
+ * \file spherical_bench.c
+ * \brief Medição de desempenho dos kernels da \c spherical_core.
+ *
+ * Cada caso é medido em tamanhos que cabem na L1, na L2, na L3 e em DRAM.
+ * Para cada caso/tamanho, o kernel é repetido até somar pelo menos
+ * \c --min-time segundos; são feitas \c --reps rodadas e a melhor é a
+ * reportada, em nanossegundos por elemento e em GB/s (bytes das entradas e
+ * saídas de cada elemento, sem contar a reutilização na cache).
+ *
+ * Uso:
+ * \code
+ * spherical_bench [--filter texto] [--min-time s] [--reps n] [--max-size n]
+ *                 [--threads n] [--csv]
+ * \endcode
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "spherical.h"
+#include "spherical_attitude.h"
+#include "spherical_coverage.h"
+#include "spherical_frames.h"
+#include "spherical_geodesy.h"
+#include "spherical_jmatrix.h"
+#include "spherical_lut.h"
+#include "spherical_parallel.h"
+#include "spherical_simd.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct BenchData {
+    size_t n;
+    float *azT, *elT, *azR, *elR;   // entradas (rad)
+    float *ax, *ay, *az;            // vetores A (SoA)
+    float *bx, *by, *bz;            // vetores B (SoA)
+    float *x, *y, *z, *out;         // saídas
+    SphVec3 *va, *vb, *vo;          // AoS para os casos escalares
+    SphSlerpBatch basis;            // bases de slerp dos pares (A, B)
+    unsigned char *inside;
+    uint16_t *azQ;                  // entradas quantizadas (encoder de 16 bits)
+    int16_t *elQ;
+    SphPool *pool;
+} BenchData;
+
+typedef void (*BenchFn)(BenchData *d);
+
+typedef struct BenchCase {
+    const char *name;
+    BenchFn fn;
+    size_t bytesPerElem;  ///< Entradas + saídas de um elemento.
+} BenchCase;
+
+// Resultados lidos depois de cada rodada, para o compilador não descartar o trabalho
+static volatile float gSink;
+
+static double NowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* --- AzElToVec --- */
+
+static void AzElScalar(BenchData *d) {
+    for (size_t i = 0; i < d->n; ++i) d->vo[i] = SphAzElToVec(d->azT[i], d->elT[i]);
+    gSink = d->vo[d->n - 1].x;
+}
+
+static void AzElBatch(BenchData *d) {
+    SphBatchAzElToVec(d->azT, d->elT, d->n, d->x, d->y, d->z);
+    gSink = d->x[d->n - 1];
+}
+
+static void AzElSimd(BenchData *d) {
+    SphAzElToVecSimd(d->azT, d->elT, d->n, d->x, d->y, d->z, SPH_ACCURACY_PRECISE);
+    gSink = d->x[d->n - 1];
+}
+
+static void AzElSimdFast(BenchData *d) {
+    SphAzElToVecSimd(d->azT, d->elT, d->n, d->x, d->y, d->z, SPH_ACCURACY_FAST);
+    gSink = d->x[d->n - 1];
+}
+
+// As entradas em rad servem como graus: só o tempo importa aqui
+static void AzElDegConvertSimd(BenchData *d) {
+    for (size_t i = 0; i < d->n; ++i) {
+        d->ax[i] = SPH_TO_RAD(d->azT[i], DEG);
+        d->ay[i] = SPH_TO_RAD(d->elT[i], DEG);
+    }
+    SphAzElToVecSimd(d->ax, d->ay, d->n, d->x, d->y, d->z, SPH_ACCURACY_PRECISE);
+    gSink = d->x[d->n - 1];
+}
+
+static void AzElNedDeg(BenchData *d) {
+    SphBatchAzElToVecNedDeg(d->azT, d->elT, d->n, d->x, d->y, d->z, SPH_ACCURACY_PRECISE);
+    gSink = d->x[d->n - 1];
+}
+
+static void AzElEnuRad(BenchData *d) {
+    SphBatchAzElToVecEnuRad(d->azT, d->elT, d->n, d->x, d->y, d->z, SPH_ACCURACY_PRECISE);
+    gSink = d->x[d->n - 1];
+}
+
+static void AzElQ16(BenchData *d) {
+    SphBatchAzElQ16ToVec(d->azQ, d->elQ, d->n, d->x, d->y, d->z, SPH_ACCURACY_PRECISE);
+    gSink = d->x[d->n - 1];
+}
+
+static void AzElQ16Fast(BenchData *d) {
+    SphBatchAzElQ16ToVec(d->azQ, d->elQ, d->n, d->x, d->y, d->z, SPH_ACCURACY_FAST);
+    gSink = d->x[d->n - 1];
+}
+
+static void AzElSimdRange(size_t begin, size_t end, void *user) {
+    BenchData *d = user;
+    SphAzElToVecSimd(d->azT + begin, d->elT + begin, end - begin,
+                     d->x + begin, d->y + begin, d->z + begin, SPH_ACCURACY_PRECISE);
+}
+
+static void AzElSimdMt(BenchData *d) {
+    SphPoolParallelFor(d->pool, d->n, SPH_PARALLEL_TILE, AzElSimdRange, d);
+    gSink = d->x[d->n - 1];
+}
+
+/* --- AngleBetweenUnit --- */
+
+static void AngleScalar(BenchData *d) {
+    for (size_t i = 0; i < d->n; ++i) d->out[i] = SphAngleBetweenUnit(d->va[i], d->vb[i]);
+    gSink = d->out[d->n - 1];
+}
+
+static void AngleBatch(BenchData *d) {
+    SphBatchAngleBetweenUnit(d->ax, d->ay, d->az, d->bx, d->by, d->bz, d->n, d->out);
+    gSink = d->out[d->n - 1];
+}
+
+static void AngleRange(size_t begin, size_t end, void *user) {
+    BenchData *d = user;
+    SphBatchAngleBetweenUnit(d->ax + begin, d->ay + begin, d->az + begin,
+                             d->bx + begin, d->by + begin, d->bz + begin,
+                             end - begin, d->out + begin);
+}
+
+static void AngleMt(BenchData *d) {
+    SphPoolParallelFor(d->pool, d->n, SPH_PARALLEL_TILE, AngleRange, d);
+    gSink = d->out[d->n - 1];
+}
+
+/* --- SlerpUnit --- */
+
+static void SlerpScalar(BenchData *d) {
+    for (size_t i = 0; i < d->n; ++i) d->vo[i] = SphSlerpUnit(d->va[i], d->vb[i], 0.375f);
+    gSink = d->vo[d->n - 1].x;
+}
+
+// Um arco, muitos pontos: θ e 1/sin θ uma vez só
+static void SlerpArcPlan(BenchData *d) {
+    SphArcPlan p = SphArcPrepare(d->va[0], d->vb[0]);
+    const float dt = 1.0f / (float)d->n;
+    for (size_t i = 0; i < d->n; ++i) d->vo[i] = SphArcPoint(&p, (float)i * dt);
+    gSink = d->vo[d->n - 1].x;
+}
+
+// Um arco, muitos pontos, pela recorrência de rotação (nenhum seno por ponto)
+static void SlerpBasisUniform(BenchData *d) {
+    SphSlerpBasis p = SphSlerpPrepare(d->va[0], d->vb[0]);
+    SphSlerpBasisUniform(&p, 0.0f, 1.0f / (float)d->n, d->n, d->vo);
+    gSink = d->vo[d->n - 1].x;
+}
+
+static void SlerpPrepareBatch(BenchData *d) {
+    SphBatchSlerpPrepare(d->ax, d->ay, d->az, d->bx, d->by, d->bz, d->n, &d->basis);
+    gSink = d->basis.theta[d->n - 1];
+}
+
+static void SlerpBasisBatch(BenchData *d) {
+    SphBatchSlerpEval(&d->basis, d->n, 0.375f, d->x, d->y, d->z);
+    gSink = d->x[d->n - 1];
+}
+
+static void SlerpBasisSimd(BenchData *d) {
+    SphSlerpEvalSimd(&d->basis, d->n, 0.375f, d->x, d->y, d->z, SPH_ACCURACY_PRECISE);
+    gSink = d->x[d->n - 1];
+}
+
+/* --- Atitude (corpo -> local) --- */
+
+static const float kYaw = 0.7f, kPitch = 0.1f, kRoll = -0.25f;
+
+// Referência ingênua: a matriz de atitude remontada a cada alvo
+static void BodyAzElPerTarget(BenchData *d) {
+    for (size_t i = 0; i < d->n; ++i) {
+        SphMat3 m = SphAttitudeMat3(kYaw, kPitch, kRoll);
+        d->vo[i] = SphMat3Apply(&m, SphAzElToVec(d->azT[i], d->elT[i]));
+    }
+    gSink = d->vo[d->n - 1].x;
+}
+
+static void BodyAzElBatch(BenchData *d) {
+    SphMat3 m = SphAttitudeMat3(kYaw, kPitch, kRoll);
+    SphBatchBodyAzElToVec(&m, d->azT, d->elT, d->n, d->x, d->y, d->z, SPH_ACCURACY_PRECISE);
+    gSink = d->x[d->n - 1];
+}
+
+static void AngleJBodyBatch(BenchData *d) {
+    SphMat3 m = SphAttitudeMat3(kYaw, kPitch, kRoll);
+    SphBatchAngleJBody(&m, d->azT, d->elT, d->n, d->azR[0], d->elR[0], d->out, SPH_ACCURACY_PRECISE);
+    gSink = d->out[d->n - 1];
+}
+
+/* --- Mapa de cobertura --- */
+
+// Um bloco de 16 linhas com n células contra 8 eixos (tempo por célula, J e contagem)
+static void CoverageTile8(BenchData *d) {
+    uint16_t *count = (uint16_t *)d->x; // n floats bastam para n contagens
+    const size_t cols = d->n / SPH_COVERAGE_TILE_ROWS;
+    SphCoverageGrid g = { -3.0f, 0.8f, 6.0f / (float)cols, -0.05f, cols, SPH_COVERAGE_TILE_ROWS };
+    SphCoverageCompute(NULL, &g, d->azR, d->elR, 8, 0.26f, d->out, count);
+    gSink = d->out[d->n - 1];
+}
+
+/* --- Geodésia (azT/elT e azR/elR como longitude/latitude) --- */
+
+static void HaversineScalar(BenchData *d) {
+    for (size_t i = 0; i < d->n; ++i) d->out[i] = SphHaversine(d->elT[i], d->azT[i], d->elR[i], d->azR[i]);
+    gSink = d->out[d->n - 1];
+}
+
+static void HaversineBatch(BenchData *d) {
+    SphBatchHaversine(d->elT, d->azT, d->elR, d->azR, d->n, d->out, SPH_ACCURACY_PRECISE);
+    gSink = d->out[d->n - 1];
+}
+
+static void BearingScalar(BenchData *d) {
+    for (size_t i = 0; i < d->n; ++i) d->out[i] = SphInitialBearing(d->elT[i], d->azT[i], d->elR[i], d->azR[i]);
+    gSink = d->out[d->n - 1];
+}
+
+static void BearingBatch(BenchData *d) {
+    SphBatchInitialBearing(d->elT, d->azT, d->elR, d->azR, d->n, d->out, SPH_ACCURACY_PRECISE);
+    gSink = d->out[d->n - 1];
+}
+
+// Rota de T[i] até R[i]; o ponto é T[i + 1] (o último usa T[0])
+static void CrossTrackScalar(BenchData *d) {
+    for (size_t i = 0; i < d->n; ++i) {
+        size_t k = i + 1 < d->n ? i + 1 : 0;
+        d->out[i] = SphCrossTrack(d->elT[i], d->azT[i], d->elR[i], d->azR[i], d->elT[k], d->azT[k]);
+    }
+    gSink = d->out[d->n - 1];
+}
+
+static void CrossTrackBatch(BenchData *d) {
+    SphBatchCrossTrack(d->elT, d->azT, d->elR, d->azR, d->elT + 1, d->azT + 1, d->n - 1, d->out, SPH_ACCURACY_PRECISE);
+    gSink = d->out[d->n - 2];
+}
+
+// Todos os pares de 64 posições A contra n/64 posições B (n pares no total)
+static void AllPairs64(BenchData *d) {
+    SphAllPairsDistance(NULL, d->ax, d->ay, d->az, 64, d->bx, d->by, d->bz, d->n / 64, d->out);
+    gSink = d->out[d->n - 1];
+}
+
+static void AllPairs64Mt(BenchData *d) {
+    SphAllPairsDistance(d->pool, d->ax, d->ay, d->az, 64, d->bx, d->by, d->bz, d->n / 64, d->out);
+    gSink = d->out[d->n - 1];
+}
+
+// Janela de ~0.5° (55 km na Terra): só a contagem, sem a matriz
+static void AllPairs64Gate(BenchData *d) {
+    gSink = (float)SphAllPairsGate(d->ax, d->ay, d->az, 64, d->bx, d->by, d->bz, d->n / 64, 0.0087f, NULL, 0);
+}
+
+/* --- Matriz J: 16 eixos (A) × n/16 alvos (B), n pares --- */
+
+static void JMatrixNested(BenchData *d) {
+    const size_t m = d->n / 16;
+    for (size_t i = 0; i < 16; ++i)
+        for (size_t j = 0; j < m; ++j) d->out[i*m + j] = SphAngleBetweenUnit(d->va[i], d->vb[j]);
+    gSink = d->out[d->n / 16 * 16 - 1];
+}
+
+static void JMatrix16(BenchData *d) {
+    SphJMatrix(NULL, d->ax, d->ay, d->az, 16, d->bx, d->by, d->bz, d->n / 16, SPH_ACCURACY_PRECISE, d->out);
+    gSink = d->out[d->n / 16 * 16 - 1];
+}
+
+static void JMatrix16Fast(BenchData *d) {
+    SphJMatrix(NULL, d->ax, d->ay, d->az, 16, d->bx, d->by, d->bz, d->n / 16, SPH_ACCURACY_FAST, d->out);
+    gSink = d->out[d->n / 16 * 16 - 1];
+}
+
+static void JMatrix16Mt(BenchData *d) {
+    SphJMatrix(d->pool, d->ax, d->ay, d->az, 16, d->bx, d->by, d->bz, d->n / 16, SPH_ACCURACY_PRECISE, d->out);
+    gSink = d->out[d->n / 16 * 16 - 1];
+}
+
+static void JMatrix16Cos(BenchData *d) {
+    SphJMatrixCos(NULL, d->ax, d->ay, d->az, 16, d->bx, d->by, d->bz, d->n / 16, d->out);
+    gSink = d->out[d->n / 16 * 16 - 1];
+}
+
+// Cone de ~15°: máscara de bytes e contagem, sem acos
+static void JMatrix16Gate(BenchData *d) {
+    size_t count;
+    SphJMatrixGate(NULL, d->ax, d->ay, d->az, 16, d->bx, d->by, d->bz, d->n / 16,
+                   SphCosThreshold(0.26f), d->inside, &count);
+    gSink = (float)count;
+}
+
+/* --- cos J analítico / J --- */
+
+static void CosJScalar(BenchData *d) {
+    for (size_t i = 0; i < d->n; ++i) d->out[i] = SphCosJ(d->azT[i], d->elT[i], d->azR[0], d->elR[0]);
+    gSink = d->out[d->n - 1];
+}
+
+static void CosJBatch(BenchData *d) {
+    SphBatchCosJ(d->azT, d->elT, d->n, d->azR[0], d->elR[0], d->out);
+    gSink = d->out[d->n - 1];
+}
+
+static void GateJBatch(BenchData *d) {
+    gSink = (float)SphBatchGateJ(d->azT, d->elT, d->n, d->azR[0], d->elR[0],
+                                 SphCosThreshold(0.26f), d->inside);
+}
+
+static void AngleJBatch(BenchData *d) {
+    SphBatchAngleJ(d->azT, d->elT, d->n, d->azR[0], d->elR[0], d->out);
+    gSink = d->out[d->n - 1];
+}
+
+static void AngleJPairedBatch(BenchData *d) {
+    SphBatchAngleJPaired(d->azT, d->elT, d->azR, d->elR, d->n, d->out);
+    gSink = d->out[d->n - 1];
+}
+
+static void AngleJPairedMt(BenchData *d) {
+    SphParallelAngleJPaired(d->pool, d->azT, d->elT, d->azR, d->elR, d->n, d->out);
+    gSink = d->out[d->n - 1];
+}
+
+static const BenchCase kCases[] = {
+    { "AzElToVec/scalar",        AzElScalar,        20 },
+    { "AzElToVec/batch",         AzElBatch,         20 },
+    { "AzElToVec/simd",          AzElSimd,          20 },
+    { "AzElToVec/simd_fast",     AzElSimdFast,      20 },
+    { "AzElToVec/simd_mt",       AzElSimdMt,        20 },
+    { "AzElToVec/deg_convert",   AzElDegConvertSimd, 20 },
+    { "AzElToVec/ned_deg",       AzElNedDeg,        20 },
+    { "AzElToVec/enu_rad",       AzElEnuRad,        20 },
+    { "AzElToVec/q16",           AzElQ16,           16 },
+    { "AzElToVec/q16_fast",      AzElQ16Fast,       16 },
+    { "AngleBetweenUnit/scalar", AngleScalar,       28 },
+    { "AngleBetweenUnit/batch",  AngleBatch,        28 },
+    { "AngleBetweenUnit/mt",     AngleMt,           28 },
+    { "SlerpUnit/scalar",        SlerpScalar,       36 },
+    { "SlerpUnit/arc_plan",      SlerpArcPlan,      12 },
+    { "SlerpUnit/basis_uniform", SlerpBasisUniform, 12 },
+    { "SlerpPrepare/batch",      SlerpPrepareBatch, 52 },
+    { "SlerpUnit/basis_batch",   SlerpBasisBatch,   40 },
+    { "SlerpUnit/basis_simd",    SlerpBasisSimd,    40 },
+    { "BodyAzElToVec/per_target", BodyAzElPerTarget, 20 },
+    { "BodyAzElToVec/batch",     BodyAzElBatch,     20 },
+    { "AngleJBody/batch",        AngleJBodyBatch,   12 },
+    { "Coverage/tile_8axes",     CoverageTile8,      6 },
+    { "Haversine/scalar",        HaversineScalar,   20 },
+    { "Haversine/batch",         HaversineBatch,    20 },
+    { "Bearing/scalar",          BearingScalar,     20 },
+    { "Bearing/batch",           BearingBatch,      20 },
+    { "CrossTrack/scalar",       CrossTrackScalar,  28 },
+    { "CrossTrack/batch",        CrossTrackBatch,   28 },
+    { "AllPairs/64xN",           AllPairs64,         4 },
+    { "AllPairs/64xN_mt",        AllPairs64Mt,       4 },
+    { "AllPairs/64xN_gate",      AllPairs64Gate,     0 },
+    { "JMatrix/16xN_nested",     JMatrixNested,      4 },
+    { "JMatrix/16xN",            JMatrix16,          4 },
+    { "JMatrix/16xN_fast",       JMatrix16Fast,      4 },
+    { "JMatrix/16xN_mt",         JMatrix16Mt,        4 },
+    { "JMatrix/16xN_cos",        JMatrix16Cos,       4 },
+    { "JMatrix/16xN_gate",       JMatrix16Gate,      1 },
+    { "CosJ/scalar",             CosJScalar,        12 },
+    { "CosJ/batch",              CosJBatch,         12 },
+    { "CosJ/gate",               GateJBatch,         9 },
+    { "AngleJ/batch",            AngleJBatch,       12 },
+    { "AngleJPaired/batch",      AngleJPairedBatch, 20 },
+    { "AngleJPaired/mt",         AngleJPairedMt,    20 },
+};
+
+/** Aloca e preenche os arranjos para \c n elementos. \return 0, ou -1 sem memória. */
+static int BenchDataInit(BenchData *d, size_t n) {
+    memset(d, 0, sizeof *d);
+    d->n = n;
+    float **soa[] = { &d->azT, &d->elT, &d->azR, &d->elR, &d->ax, &d->ay, &d->az,
+                      &d->bx, &d->by, &d->bz, &d->x, &d->y, &d->z, &d->out,
+                      &d->basis.ux, &d->basis.uy, &d->basis.uz,
+                      &d->basis.wx, &d->basis.wy, &d->basis.wz, &d->basis.theta };
+    for (size_t k = 0; k < sizeof soa / sizeof soa[0]; ++k) {
+        if (!(*soa[k] = malloc(n * sizeof(float)))) return -1;
+    }
+    d->va = malloc(n * sizeof *d->va);
+    d->vb = malloc(n * sizeof *d->vb);
+    d->vo = malloc(n * sizeof *d->vo);
+    d->inside = malloc(n);
+    d->azQ = malloc(n * sizeof *d->azQ);
+    d->elQ = malloc(n * sizeof *d->elQ);
+    if (!d->va || !d->vb || !d->vo || !d->inside || !d->azQ || !d->elQ) return -1;
+
+    unsigned s = 12345u;
+    for (size_t i = 0; i < n; ++i) {
+        s = s * 1664525u + 1013904223u;
+        d->azT[i] = (float)(s >> 8) / 16777216.0f * 6.2831853f;
+        s = s * 1664525u + 1013904223u;
+        d->elT[i] = ((float)(s >> 8) / 16777216.0f - 0.5f) * 3.0f;
+        d->azR[i] = d->azT[i] * 0.5f + 0.3f;
+        d->elR[i] = d->elT[i] * 0.5f + 0.1f;
+        d->azQ[i] = (uint16_t)(d->azT[i] / SPH_Q16_TO_RAD);
+        d->elQ[i] = (int16_t)(d->elT[i] / SPH_Q16_TO_RAD);
+        d->va[i] = SphAzElToVec(d->azT[i], d->elT[i]);
+        d->vb[i] = SphAzElToVec(d->azR[i], d->elR[i]);
+        d->ax[i] = d->va[i].x; d->ay[i] = d->va[i].y; d->az[i] = d->va[i].z;
+        d->bx[i] = d->vb[i].x; d->by[i] = d->vb[i].y; d->bz[i] = d->vb[i].z;
+    }
+    SphBatchSlerpPrepare(d->ax, d->ay, d->az, d->bx, d->by, d->bz, n, &d->basis);
+    return 0;
+}
+
+static void BenchDataFree(BenchData *d) {
+    float *soa[] = { d->azT, d->elT, d->azR, d->elR, d->ax, d->ay, d->az,
+                     d->bx, d->by, d->bz, d->x, d->y, d->z, d->out,
+                     d->basis.ux, d->basis.uy, d->basis.uz,
+                     d->basis.wx, d->basis.wy, d->basis.wz, d->basis.theta };
+    for (size_t k = 0; k < sizeof soa / sizeof soa[0]; ++k) free(soa[k]);
+    free(d->va);
+    free(d->vb);
+    free(d->vo);
+    free(d->inside);
+    free(d->azQ);
+    free(d->elQ);
+}
+
+/** Melhor tempo por elemento (ns) em \c reps rodadas de pelo menos \c minTime s. */
+static double RunCase(const BenchCase *c, BenchData *d, double minTime, int reps, long *itersOut) {
+    c->fn(d); // aquecimento (páginas, caches, frequência)
+    double best = 0.0;
+    long iters = 0;
+    for (int r = 0; r < reps; ++r) {
+        long it = 0;
+        double t0 = NowSeconds(), el;
+        do {
+            c->fn(d);
+            ++it;
+            el = NowSeconds() - t0;
+        } while (el < minTime);
+        double ns = el * 1e9 / ((double)it * (double)d->n);
+        if (r == 0 || ns < best) { best = ns; iters = it; }
+    }
+    *itersOut = iters;
+    return best;
+}
+
+static void Usage(void) {
+    fprintf(stderr,
+            "uso: spherical_bench [--filter texto] [--min-time s] [--reps n]\n"
+            "                     [--max-size n] [--threads n] [--csv]\n");
+}
+
+int main(int argc, char **argv) {
+    const char *filter = NULL;
+    double minTime = 0.1;
+    int reps = 3, threads = 0, csv = 0;
+    size_t maxSize = (size_t)1 << 22;
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(a, "--csv") == 0) { csv = 1; continue; }
+        if (!v) { Usage(); return 2; }
+        if (strcmp(a, "--filter") == 0) filter = v;
+        else if (strcmp(a, "--min-time") == 0) minTime = atof(v);
+        else if (strcmp(a, "--reps") == 0) reps = atoi(v);
+        else if (strcmp(a, "--max-size") == 0) maxSize = (size_t)strtoull(v, NULL, 10);
+        else if (strcmp(a, "--threads") == 0) threads = atoi(v);
+        else { Usage(); return 2; }
+        ++i;
+    }
+    if (reps < 1) reps = 1;
+
+    // L1 (~20 KiB), L2 (~320 KiB), L3 (~5 MiB), DRAM (~80 MiB) com 20 B/elemento
+    const size_t sizes[] = { (size_t)1 << 10, (size_t)1 << 14, (size_t)1 << 18, (size_t)1 << 22 };
+    SphPool *pool = SphPoolCreate(threads);
+
+    if (csv) printf("name,size,ns_per_elem,gb_per_s,iterations\n");
+    else {
+        printf("ISA: %s | threads: %d\n", SphIsaName(SphIsaActive()), SphPoolThreads(pool));
+        printf("%-26s %10s %12s %10s %10s\n", "Benchmark", "Size", "ns/elem", "GB/s", "Iters");
+        printf("--------------------------------------------------------------------------\n");
+    }
+    for (size_t s = 0; s < sizeof sizes / sizeof sizes[0]; ++s) {
+        size_t n = sizes[s];
+        if (n > maxSize) break;
+        BenchData d;
+        if (BenchDataInit(&d, n) != 0) {
+            fprintf(stderr, "spherical_bench: sem memória para %zu elementos\n", n);
+            BenchDataFree(&d);
+            break;
+        }
+        d.pool = pool;
+        for (size_t k = 0; k < sizeof kCases / sizeof kCases[0]; ++k) {
+            const BenchCase *c = &kCases[k];
+            if (filter && !strstr(c->name, filter)) continue;
+            long iters;
+            double ns = RunCase(c, &d, minTime, reps, &iters);
+            double gbs = (double)c->bytesPerElem / ns; // bytes/ns == GB/s
+            if (csv) printf("%s,%zu,%.4f,%.3f,%ld\n", c->name, n, ns, gbs, iters);
+            else printf("%-26s %10zu %12.3f %10.2f %10ld\n", c->name, n, ns, gbs, iters);
+        }
+        BenchDataFree(&d);
+    }
+    SphPoolDestroy(pool);
+    return 0;
+}
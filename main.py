@@ -9,27 +9,28 @@
 # * Elevation measured from horizon (xy-plane) toward +Z (local vertical)
 # * You can change the angles below to test other situations
 
+import os
+import sys
+
 import numpy as np
 import matplotlib.pyplot as plt
 
+# The math comes from the same C library as the viewer (libspherical, see python/spherical_core.py)
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "python"))
+import spherical_core as sph
+
 # ---------- helpers ----------
 def azel_to_vec(az, el):
     """
     Convert azimuth (rad) and elevation (rad) to a 3D unit vector.
     Azimuth from +X toward +Y; Elevation from XY-plane toward +Z.
+    Arrays give a (3, ...) result with rows x, y, z.
     """
-    ce = np.cos(el)
-    x = ce * np.cos(az)
-    y = ce * np.sin(az)
-    z = np.sin(el)
-    v = np.array([x, y, z], dtype=float)
-    return v / np.linalg.norm(v)
+    return sph.azel_to_vec(az, el)
 
 def angle_between(v1, v2):
     """Great-circle / central angle between two unit vectors (rad)."""
-    # numerical safety
-    c = np.clip(np.dot(v1, v2), -1.0, 1.0)
-    return np.arccos(c)
+    return sph.angle_between(v1, v2)
 
 # ---------- example angles (feel free to edit) ----------
 AZ_T_deg, EL_T_deg = 40.0, 25.0     # target azimuth/elevation (degrees)
@@ -43,7 +44,7 @@ vT = azel_to_vec(AZ_T, EL_T)
 vR = azel_to_vec(AZ_R, EL_R)
 
 # angle J using dot product (equivalent to spherical law of cosines)
-J = angle_between(vT, vR)
+J = float(angle_between(vT, vR))
 J_deg = np.degrees(J)
 
 # Also show the analytic spherical-trig form for verification:
@@ -53,6 +54,7 @@ J_trig = np.degrees(np.arccos(np.clip(cosJ_trig, -1.0, 1.0)))
 
 print(f"AZ_T={AZ_T_deg:.1f}°, EL_T={EL_T_deg:.1f}°   |   AZ_R={AZ_R_deg:.1f}°, EL_R={EL_R_deg:.1f}°")
 print(f"Ângulo J (alvo a partir do eixo de rolagem) ≈ {J_deg:.3f}°  (verificação: {J_trig:.3f}°)")
+print(f"libspherical ABI {sph.abi_version()}, kernels {sph.isa_name()}")
 
 # ---------- plot ----------
 fig = plt.figure(figsize=(7, 6))
@@ -0,0 +1,222 @@
+"""
+Binding Python (ctypes + NumPy) da libspherical, a ABI C estável de src/spherical_capi.h.
+
+As mesmas funções do visualizador, com os mesmos números, para uso em notebooks:
+
+    import numpy as np
+    import spherical_core as sph
+
+    az = np.radians(np.random.uniform(0, 360, 1_000_000)).astype(np.float32)
+    el = np.radians(np.random.uniform(-10, 60, 1_000_000)).astype(np.float32)
+    v = sph.azel_to_vec(az, el)                    # (3, N): linhas x, y, z (SoA)
+    J = sph.angle_j(az, el, np.radians(10), np.radians(5))
+
+Regras dos arranjos:
+* Entradas chegam pelo protocolo de buffer (np.asarray). Arranjos float32
+  C-contíguos vão direto para o C, sem cópia; outros tipos (por exemplo
+  float64) são convertidos uma vez para float32.
+* Saídas são alocadas aqui, ou passadas em ``out=`` (float32, C-contíguas,
+  graváveis, já no formato certo) para reaproveitar memória.
+* ctypes.CDLL solta o GIL durante cada chamada: várias threads Python podem
+  processar fatias do mesmo arranjo em paralelo.
+
+A biblioteca é procurada em $SPHERICAL_LIB, ao lado deste arquivo e em
+build/ na raiz do repositório (cmake --build build --target spherical_shared).
+"""
+
+import ctypes
+import os
+import sys
+from ctypes import POINTER, c_char_p, c_float, c_int, c_longlong, c_size_t, c_ubyte
+
+import numpy as np
+
+ABI_VERSION = 1
+
+PRECISE = 0      # polinômios de seno/cosseno, erro ~1e-7
+FAST = 1         # erro ~5e-4
+
+ANGLE_ACOSF = 0  # acos do produto escalar em float (o padrão da spherical_core)
+ANGLE_ACOSD = 1  # contas em double
+ANGLE_ATAN2 = 2  # atan2(|a x b|, a . b): preciso perto de 0 e de pi
+
+_FLOAT_P = POINTER(c_float)
+
+
+def _library_names():
+    if sys.platform == "win32":
+        return ["spherical.dll"]
+    if sys.platform == "darwin":
+        return ["libspherical.dylib", "libspherical.1.dylib"]
+    return ["libspherical.so", "libspherical.so.1"]
+
+
+def _find_library():
+    env = os.environ.get("SPHERICAL_LIB")
+    if env:
+        return env
+    here = os.path.dirname(os.path.abspath(__file__))
+    root = os.path.dirname(here)
+    dirs = [here, os.path.join(root, "build"), os.path.join(root, "build", "Release"),
+            os.path.join(root, "build", "Debug")]
+    for d in dirs:
+        for name in _library_names():
+            path = os.path.join(d, name)
+            if os.path.exists(path):
+                return path
+    raise ImportError("libspherical não encontrada: compile com "
+                      "'cmake --build build --target spherical_shared' ou defina SPHERICAL_LIB")
+
+
+def _load():
+    lib = ctypes.CDLL(_find_library())
+    sig = {
+        "SphLibAbiVersion": (c_int, []),
+        "SphLibIsaName": (c_char_p, []),
+        "SphLibAzElToVec": (c_int, [_FLOAT_P, _FLOAT_P, c_size_t, _FLOAT_P, _FLOAT_P, _FLOAT_P, c_int]),
+        "SphLibAngleBetween": (c_int, [_FLOAT_P] * 6 + [c_size_t, _FLOAT_P, c_int]),
+        "SphLibAngleJ": (c_int, [_FLOAT_P, _FLOAT_P, c_size_t, c_float, c_float, _FLOAT_P]),
+        "SphLibAngleJPaired": (c_int, [_FLOAT_P] * 4 + [c_size_t, _FLOAT_P, c_int]),
+        "SphLibGateJ": (c_longlong, [_FLOAT_P, _FLOAT_P, c_size_t, c_float, c_float, c_float,
+                                     POINTER(c_ubyte)]),
+        "SphLibHaversine": (c_int, [_FLOAT_P] * 4 + [c_size_t, _FLOAT_P, c_int]),
+    }
+    for name, (res, args) in sig.items():
+        fn = getattr(lib, name)
+        fn.restype = res
+        fn.argtypes = args
+    version = lib.SphLibAbiVersion()
+    if version != ABI_VERSION:
+        raise ImportError(f"libspherical com ABI {version}; este binding espera {ABI_VERSION}")
+    return lib
+
+
+_lib = _load()
+
+
+def _in(a):
+    """float32 C-contíguo (sem cópia quando já é). Escalares continuam 0-d."""
+    return np.asarray(a, dtype=np.float32, order="C")
+
+
+def _inputs(*arrays):
+    """
+    Converte as entradas com _in e as estende ao formato comum (regras de
+    broadcast do NumPy). Só as que precisam ser estendidas são copiadas.
+    """
+    arrays = [_in(a) for a in arrays]
+    shape = np.broadcast_shapes(*(a.shape for a in arrays))
+    return [a if a.shape == shape else _in(np.broadcast_to(a, shape)) for a in arrays], shape
+
+
+def _ret(res, out):
+    """Saídas 0-d (entradas escalares) voltam como escalares NumPy, salvo com out=."""
+    return res[()] if out is None and res.ndim == 0 else res
+
+
+def _out(out, shape):
+    if out is None:
+        return np.empty(shape, dtype=np.float32)
+    if (out.dtype != np.float32 or out.shape != tuple(shape) or not out.flags.c_contiguous
+            or not out.flags.writeable):
+        raise ValueError(f"out deve ser float32 C-contíguo e gravável, com formato {tuple(shape)}")
+    return out
+
+
+def _ptr(a):
+    return a.ctypes.data_as(_FLOAT_P)
+
+
+def _check(rc, name):
+    if rc != 0:
+        raise ValueError(f"{name}: parâmetros inválidos")
+
+
+def abi_version():
+    """Versão da ABI da biblioteca carregada."""
+    return _lib.SphLibAbiVersion()
+
+
+def isa_name():
+    """ISA escolhida pelos kernels SIMD nesta CPU ("avx2", "neon", ...)."""
+    return _lib.SphLibIsaName().decode()
+
+
+def azel_to_vec(az, el, accuracy=PRECISE, out=None):
+    """
+    Az/El (rad) -> vetores unitários. Convenção X = Norte, Y = Leste, Z = Cima.
+
+    Retorna um arranjo (3,) + formato (o de az e el após o broadcast; (3,)
+    para escalares): out[0], out[1] e out[2] são x, y e z (cada linha
+    contígua, como os kernels SoA).
+    """
+    (az, el), shape = _inputs(az, el)
+    n = az.size
+    res = _out(out, (3,) + shape)
+    flat = res.reshape(3, n)
+    _check(_lib.SphLibAzElToVec(_ptr(az), _ptr(el), n, _ptr(flat[0]), _ptr(flat[1]), _ptr(flat[2]),
+                                accuracy), "azel_to_vec")
+    return res
+
+
+def angle_between(a, b, mode=ANGLE_ACOSF, out=None):
+    """
+    Ângulo (rad) entre vetores unitários no formato de azel_to_vec: (3,) + formato.
+
+    Retorna um arranjo no formato (um escalar para dois vetores (3,)).
+    """
+    (a, b), shape = _inputs(a, b)
+    if shape[:1] != (3,):
+        raise ValueError("os vetores devem ter formato (3, ...)")
+    n = a[0].size
+    fa, fb = a.reshape(3, n), b.reshape(3, n)
+    res = _out(out, shape[1:])
+    _check(_lib.SphLibAngleBetween(_ptr(fa[0]), _ptr(fa[1]), _ptr(fa[2]),
+                                   _ptr(fb[0]), _ptr(fb[1]), _ptr(fb[2]), n, _ptr(res), mode),
+           "angle_between")
+    return _ret(res, out)
+
+
+def angle_j(az_t, el_t, az_r, el_r, mode=ANGLE_ACOSF, out=None):
+    """
+    Ângulo J (rad) entre os alvos (az_t, el_t) e o eixo de rolagem (az_r, el_r).
+
+    Com az_r e el_r escalares (um eixo para todos), usa o kernel de eixo único
+    (modo ACOSF); senão, cada alvo é comparado com o seu eixo. O resultado tem
+    o formato das quatro entradas após o broadcast (escalar se todas forem).
+    """
+    if np.ndim(az_r) == 0 and np.ndim(el_r) == 0 and mode == ANGLE_ACOSF:
+        (az_t, el_t), shape = _inputs(az_t, el_t)
+        res = _out(out, shape)
+        _check(_lib.SphLibAngleJ(_ptr(az_t), _ptr(el_t), az_t.size, float(az_r), float(el_r), _ptr(res)),
+               "angle_j")
+    else:
+        (az_t, el_t, az_r, el_r), shape = _inputs(az_t, el_t, az_r, el_r)
+        res = _out(out, shape)
+        _check(_lib.SphLibAngleJPaired(_ptr(az_t), _ptr(el_t), _ptr(az_r), _ptr(el_r), az_t.size,
+                                       _ptr(res), mode), "angle_j")
+    return _ret(res, out)
+
+
+def gate_j(az_t, el_t, az_r, el_r, half_angle):
+    """
+    Alvos dentro do cone J <= half_angle (rad) em torno do eixo (az_r, el_r).
+
+    Retorna (quantidade, máscara booleana no formato de az_t e el_t após o broadcast).
+    """
+    (az_t, el_t), shape = _inputs(az_t, el_t)
+    mask = np.empty(shape, dtype=np.uint8)
+    count = _lib.SphLibGateJ(_ptr(az_t), _ptr(el_t), az_t.size, float(az_r), float(el_r),
+                             float(half_angle), mask.ctypes.data_as(POINTER(c_ubyte)))
+    if count < 0:
+        raise ValueError("gate_j: parâmetros inválidos")
+    return int(count), mask.view(np.bool_)
+
+
+def haversine(lat1, lon1, lat2, lon2, accuracy=PRECISE, out=None):
+    """Ângulo central (rad) entre posições lat/lon (rad); multiplique pelo raio da Terra."""
+    (lat1, lon1, lat2, lon2), shape = _inputs(lat1, lon1, lat2, lon2)
+    res = _out(out, shape)
+    _check(_lib.SphLibHaversine(_ptr(lat1), _ptr(lon1), _ptr(lat2), _ptr(lon2), lat1.size, _ptr(res),
+                                accuracy), "haversine")
+    return _ret(res, out)
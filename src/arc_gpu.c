@@ -0,0 +1,196 @@
+/**
+ * \file arc_gpu.c
+ * \brief Implementação da tesselação de arcos no vertex shader (com caminho de CPU).
+ */
+#include "arc_gpu.h"
+
+#include "line_mesh.h"
+#include "spherical.h"
+
+#include "raymath.h"
+#include "rlgl.h"
+
+#include <stdlib.h>
+
+// Meia largura da fita (em unidades do mundo, esfera de raio 1)
+#define ARC_RIBBON_HALF_WIDTH 0.0025f
+
+// Extremidades por instância; (t, lado) por vértice. θ e 1/sin θ são
+// calculados uma vez por vértice na GPU, sem custo para a CPU.
+static const char *kArcVs =
+    "#version 330\n"
+    "in vec2 arcParam;\n"
+    "in vec3 arcStart;\n"
+    "in vec3 arcEnd;\n"
+    "uniform mat4 mvp;\n"
+    "uniform float radius;\n"
+    "uniform float halfWidth;\n"
+    "void main() {\n"
+    "    float theta = acos(clamp(dot(arcStart, arcEnd), -1.0, 1.0));\n"
+    "    vec3 p = arcStart;\n"
+    "    if (theta > 1e-5) {\n"
+    "        float inv = 1.0/sin(theta);\n"
+    "        p = (sin((1.0 - arcParam.x)*theta)*arcStart + sin(arcParam.x*theta)*arcEnd)*inv;\n"
+    "    }\n"
+    "    vec3 n = cross(arcStart, arcEnd);\n"
+    "    float len = length(n);\n"
+    "    n = len > 1e-6 ? n/len : vec3(0.0);\n"
+    "    gl_Position = mvp*vec4(p*radius + n*(arcParam.y*halfWidth), 1.0);\n"
+    "}\n";
+
+static const char *kArcFs =
+    "#version 330\n"
+    "uniform vec4 colDiffuse;\n"
+    "out vec4 finalColor;\n"
+    "void main() { finalColor = colDiffuse; }\n";
+
+struct ArcBatch {
+    int maxArcs, steps, count;
+    Vector3 *starts, *ends;
+
+    // GPU (gpu == 0: caminho de CPU)
+    int gpu;
+    Shader shader;
+    int locMvp, locRadius, locHalfWidth, locColor;
+    unsigned int vao, paramVbo, startVbo, endVbo;
+
+    // CPU
+    SphVec3 *points;
+    LineMesh lines;
+};
+
+/** Gabarito de vértices: 2 triângulos por segmento, (t, lado) por vértice. */
+static float *BuildParams(int steps) {
+    float *p = malloc((size_t)steps * 12 * sizeof *p);
+    if (!p) return NULL;
+    for (int i = 0; i < steps; ++i) {
+        float t0 = (float)i / steps, t1 = (float)(i + 1) / steps;
+        const float quad[12] = { t0, -1, t1, -1, t1, 1,   t0, -1, t1, 1, t0, 1 };
+        for (int k = 0; k < 12; ++k) p[i*12 + k] = quad[k];
+    }
+    return p;
+}
+
+static int LoadGpu(ArcBatch *b) {
+    b->shader = LoadShaderFromMemory(kArcVs, kArcFs);
+    if (b->shader.id == 0 || b->shader.id == rlGetShaderIdDefault()) return 0;
+    int locParam = GetShaderLocationAttrib(b->shader, "arcParam");
+    int locStart = GetShaderLocationAttrib(b->shader, "arcStart");
+    int locEnd = GetShaderLocationAttrib(b->shader, "arcEnd");
+    b->locMvp = GetShaderLocation(b->shader, "mvp");
+    b->locRadius = GetShaderLocation(b->shader, "radius");
+    b->locHalfWidth = GetShaderLocation(b->shader, "halfWidth");
+    b->locColor = GetShaderLocation(b->shader, "colDiffuse");
+    float *params = BuildParams(b->steps);
+    if (!params || locParam < 0 || locStart < 0 || locEnd < 0) {
+        free(params);
+        UnloadShader(b->shader);
+        return 0;
+    }
+
+    b->vao = rlLoadVertexArray();
+    rlEnableVertexArray(b->vao);
+    b->paramVbo = rlLoadVertexBuffer(params, b->steps * 12 * (int)sizeof(float), false);
+    rlSetVertexAttribute((unsigned)locParam, 2, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute((unsigned)locParam);
+    b->startVbo = rlLoadVertexBuffer(NULL, b->maxArcs * (int)sizeof(Vector3), true);
+    rlSetVertexAttribute((unsigned)locStart, 3, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute((unsigned)locStart);
+    rlSetVertexAttributeDivisor((unsigned)locStart, 1);
+    b->endVbo = rlLoadVertexBuffer(NULL, b->maxArcs * (int)sizeof(Vector3), true);
+    rlSetVertexAttribute((unsigned)locEnd, 3, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute((unsigned)locEnd);
+    rlSetVertexAttributeDivisor((unsigned)locEnd, 1);
+    rlDisableVertexArray();
+    free(params);
+    return 1;
+}
+
+ArcBatch *ArcBatchCreate(int maxArcs, int steps) {
+    ArcBatch *b = calloc(1, sizeof *b);
+    if (!b) return NULL;
+    b->maxArcs = maxArcs;
+    b->steps = steps < 1 ? 1 : steps;
+    b->starts = malloc((size_t)maxArcs * sizeof *b->starts);
+    b->ends = malloc((size_t)maxArcs * sizeof *b->ends);
+    b->points = malloc((size_t)(b->steps + 1) * sizeof *b->points);
+    if (!b->starts || !b->ends || !b->points) {
+        ArcBatchDestroy(b);
+        return NULL;
+    }
+    b->gpu = LoadGpu(b);
+    return b;
+}
+
+void ArcBatchClear(ArcBatch *b) {
+    b->count = 0;
+}
+
+int ArcBatchAdd(ArcBatch *b, Vector3 a, Vector3 e) {
+    if (b->count >= b->maxArcs) return -1;
+    b->starts[b->count] = a;
+    b->ends[b->count] = e;
+    b->count++;
+    return 0;
+}
+
+static void DrawCpu(ArcBatch *b, float radius, Color color) {
+    LineMeshClear(&b->lines);
+    for (int i = 0; i < b->count; ++i) {
+        SphVec3 a = { b->starts[i].x, b->starts[i].y, b->starts[i].z };
+        SphVec3 e = { b->ends[i].x, b->ends[i].y, b->ends[i].z };
+        SphGreatCircleArcPoints(a, e, b->steps, radius, b->points);
+        for (int k = 0; k < b->steps; ++k) {
+            SphVec3 p = b->points[k], q = b->points[k + 1];
+            LineMeshAdd(&b->lines, (Vector3){ p.x, p.y, p.z }, (Vector3){ q.x, q.y, q.z }, color);
+        }
+    }
+    LineMeshDraw(&b->lines);
+}
+
+void ArcBatchDraw(ArcBatch *b, float radius, Color color) {
+    if (b->count == 0) return;
+    if (!b->gpu) {
+        DrawCpu(b, radius, color);
+        return;
+    }
+    // O lote pendente da rlgl precisa sair antes do desenho direto
+    rlDrawRenderBatchActive();
+    rlUpdateVertexBuffer(b->startVbo, b->starts, b->count * (int)sizeof(Vector3), 0);
+    rlUpdateVertexBuffer(b->endVbo, b->ends, b->count * (int)sizeof(Vector3), 0);
+
+    Matrix mvp = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    Vector4 c = ColorNormalize(color);
+    float hw = ARC_RIBBON_HALF_WIDTH;
+    rlEnableShader(b->shader.id);
+    SetShaderValueMatrix(b->shader, b->locMvp, mvp);
+    SetShaderValue(b->shader, b->locRadius, &radius, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(b->shader, b->locHalfWidth, &hw, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(b->shader, b->locColor, &c, SHADER_UNIFORM_VEC4);
+    rlDisableBackfaceCulling();
+    rlEnableVertexArray(b->vao);
+    rlDrawVertexArrayInstanced(0, b->steps * 6, b->count);
+    rlDisableVertexArray();
+    rlEnableBackfaceCulling();
+    rlDisableShader();
+}
+
+int ArcBatchOnGpu(const ArcBatch *b) {
+    return b->gpu;
+}
+
+void ArcBatchDestroy(ArcBatch *b) {
+    if (!b) return;
+    if (b->gpu) {
+        rlUnloadVertexArray(b->vao);
+        rlUnloadVertexBuffer(b->paramVbo);
+        rlUnloadVertexBuffer(b->startVbo);
+        rlUnloadVertexBuffer(b->endVbo);
+        UnloadShader(b->shader);
+    }
+    LineMeshFree(&b->lines);
+    free(b->starts);
+    free(b->ends);
+    free(b->points);
+    free(b);
+}
@@ -0,0 +1,55 @@
+/**
+ * \file arc_gpu.h
+ * \brief Tesselação de arcos de grande círculo no vertex shader.
+ *
+ * Cada arco é uma instância: a GPU recebe apenas as duas extremidades
+ * (\c a, \c b) e um gabarito fixo de parâmetros (t, lado), e o vertex shader
+ * calcula o slerp de cada vértice. O arco vira uma fita fina no plano
+ * tangente à esfera (perpendicular ao plano do grande círculo), pois o
+ * desenho instanciado da rlgl só aceita triângulos.
+ *
+ * Sem shader (por exemplo, contexto sem OpenGL 3.3), os arcos são tesselados
+ * na CPU com \ref SphGreatCircleArcPoints (por arco, um \c atan2 em
+ * \ref SphSlerpPrepare e um seno/cosseno do passo; os pontos saem da
+ * recorrência de \ref SphSlerpBasisUniform, sem trigonometria por ponto) e
+ * desenhados como linhas em uma única \ref LineMesh.
+ */
+#ifndef ARC_GPU_H
+#define ARC_GPU_H
+
+#include "raylib.h"
+
+typedef struct ArcBatch ArcBatch;
+
+/**
+ * \brief Cria um lote para até \c maxArcs arcos de \c steps segmentos.
+ *
+ * Precisa ser chamada depois de \c InitWindow (carrega shader e buffers).
+ */
+ArcBatch *ArcBatchCreate(int maxArcs, int steps);
+
+/** \brief Esvazia o lote (início de quadro). */
+void ArcBatchClear(ArcBatch *batch);
+
+/**
+ * \brief Acrescenta o arco de \c a até \c b (vetores unitários).
+ * \return 0, ou -1 se o lote está cheio.
+ */
+int ArcBatchAdd(ArcBatch *batch, Vector3 a, Vector3 b);
+
+/**
+ * \brief Desenha todos os arcos do lote (dentro de \c BeginMode3D).
+ *
+ * \param batch Lote.
+ * \param radius Raio em que os arcos são desenhados (ligeiramente acima da esfera).
+ * \param color Cor dos arcos.
+ */
+void ArcBatchDraw(ArcBatch *batch, float radius, Color color);
+
+/** \brief 1 se os arcos são tesselados na GPU; 0 no caminho de CPU. */
+int ArcBatchOnGpu(const ArcBatch *batch);
+
+/** \brief Libera shader, buffers e o lote. */
+void ArcBatchDestroy(ArcBatch *batch);
+
+#endif /* ARC_GPU_H */
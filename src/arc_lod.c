@@ -0,0 +1,38 @@
+/**
+ * \file arc_lod.c
+ * \brief Implementação do nível de detalhe dos arcos.
+ */
+#include "arc_lod.h"
+
+#include <math.h>
+
+#define ARC_LOD_TOLERANCE_PX 0.5f
+#define ARC_LOD_NEAR 0.05f
+
+ArcLod ArcLodFromCamera(Camera3D camera, int screenHeight) {
+    ArcLod lod = { camera, screenHeight, ARC_LOD_TOLERANCE_PX };
+    return lod;
+}
+
+/** Pixels por unidade do mundo a uma distância \c dist da câmera. */
+static float PixelsPerUnit(const ArcLod *lod, float dist) {
+    if (lod->camera.projection == CAMERA_ORTHOGRAPHIC) return (float)lod->screenHeight / lod->camera.fovy;
+    float halfFov = lod->camera.fovy * 0.5f * (3.14159265f / 180.0f);
+    return (float)lod->screenHeight / (2.0f * tanf(halfFov) * dist);
+}
+
+int ArcLodSteps(const ArcLod *lod, float angle, float radius, Vector3 mid) {
+    angle = fabsf(angle);
+    if (angle <= 0.0f) return 1;
+    // Distância mínima possível até o arco: nenhum ponto fica mais longe do
+    // ponto médio do que meio comprimento de arco
+    Vector3 c = lod->camera.position;
+    float dx = mid.x - c.x, dy = mid.y - c.y, dz = mid.z - c.z;
+    float dist = sqrtf(dx*dx + dy*dy + dz*dz) - 0.5f*angle*radius;
+    if (dist < ARC_LOD_NEAR) dist = ARC_LOD_NEAR;
+
+    float k = PixelsPerUnit(lod, dist);
+    float n = ceilf(angle * sqrtf(radius * k / (8.0f * lod->tolerancePx)));
+    if (!(n >= 1.0f)) return 1;
+    return n > (float)ARC_LOD_MAX_STEPS ? ARC_LOD_MAX_STEPS : (int)n;
+}
@@ -0,0 +1,48 @@
+/**
+ * \file arc_lod.h
+ * \brief Nível de detalhe dos arcos: segmentos a partir do ângulo e do tamanho na tela.
+ *
+ * Um arco de ângulo \f$\alpha\f$ e raio \f$r\f$ dividido em \f$n\f$ cordas
+ * afasta-se da curva, no meio de cada corda, por
+ * \f$s = r\,(1 - \cos(\alpha / 2n)) \approx r\,\alpha^2 / (8 n^2)\f$.
+ * Com \f$k\f$ pixels por unidade do mundo na distância do arco, basta que
+ * \f$s\,k\f$ fique abaixo de uma tolerância em pixels:
+ * \f$n = \lceil \alpha \sqrt{r k / (8\,\mathrm{tol})} \rceil\f$.
+ *
+ * Assim um arco de 0,5° recebe um ou dois segmentos, e arcos longe da câmera
+ * recebem menos segmentos que os próximos.
+ */
+#ifndef ARC_LOD_H
+#define ARC_LOD_H
+
+#include "raylib.h"
+
+/** Limite superior de segmentos por arco (os valores fixos antigos). */
+#define ARC_LOD_MAX_STEPS 64
+
+/** Estado da câmera usado pela política de nível de detalhe. */
+typedef struct ArcLod {
+    Camera3D camera;
+    int screenHeight;     ///< Altura da área de desenho (pixels).
+    float tolerancePx;    ///< Erro máximo da corda (pixels).
+} ArcLod;
+
+/**
+ * \brief Prepara a política para o quadro atual.
+ * \param camera Câmera do quadro.
+ * \param screenHeight Altura da tela (pixels).
+ */
+ArcLod ArcLodFromCamera(Camera3D camera, int screenHeight);
+
+/**
+ * \brief Quantidade de segmentos para um arco.
+ *
+ * \param lod Política do quadro.
+ * \param angle Ângulo do arco (rad, em módulo).
+ * \param radius Raio do arco.
+ * \param mid Ponto médio do arco (coordenadas do mundo).
+ * \return Segmentos, entre 1 e \ref ARC_LOD_MAX_STEPS.
+ */
+int ArcLodSteps(const ArcLod *lod, float angle, float radius, Vector3 mid);
+
+#endif /* ARC_LOD_H */
@@ -0,0 +1,230 @@
+/**
+ * \file coverage_map.c
+ * \brief Leitura dos eixos, cores e gravação dos mapas de cobertura.
+ */
+#include "coverage_map.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COVERAGE_MAGIC "SPHCOV01"
+#define COVERAGE_VERSION 1u
+
+static const float kDeg2Rad = 3.14159265358979323846f / 180.0f;
+static const float kPi = 3.14159265358979323846f;
+
+static void StoreLe32(unsigned char *p, uint32_t u) {
+    p[0] = (unsigned char)u; p[1] = (unsigned char)(u >> 8);
+    p[2] = (unsigned char)(u >> 16); p[3] = (unsigned char)(u >> 24);
+}
+
+static void StoreLeFloat(unsigned char *p, float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof u);
+    StoreLe32(p, u);
+}
+
+void CoverageColorize(const SphCoverageGrid *g, const float *J, const uint16_t *count,
+                      size_t nAxes, float halfAngle, unsigned char *rgba) {
+    const size_t cells = g->rows * g->cols;
+    const float farSpan = kPi - halfAngle > 1e-6f ? kPi - halfAngle : 1e-6f;
+    for (size_t i = 0; i < cells; ++i) {
+        unsigned char *p = rgba + 4*i;
+        if (count[i]) {
+            float f = (float)count[i] / (float)nAxes;
+            p[0] = 40;
+            p[1] = (unsigned char)(120.0f + 135.0f*f);
+            p[2] = 60;
+            p[3] = 190;
+        } else {
+            // Fora do FOV: quanto mais perto da borda, mais claro
+            float f = 1.0f - (J[i] - halfAngle) / farSpan;
+            f = f < 0.0f ? 0.0f : f;
+            p[0] = (unsigned char)(20.0f + 40.0f*f);
+            p[1] = (unsigned char)(24.0f + 50.0f*f);
+            p[2] = (unsigned char)(50.0f + 90.0f*f);
+            p[3] = 110;
+        }
+    }
+}
+
+int CoverageRasterWrite(const char *path, const SphCoverageGrid *g, size_t nAxes, float halfAngle,
+                        const float *J, const uint16_t *count) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    unsigned char h[64];
+    memset(h, 0, sizeof h);
+    memcpy(h, COVERAGE_MAGIC, 8);
+    StoreLe32(h + 8, COVERAGE_VERSION);
+    StoreLe32(h + 12, (uint32_t)g->cols);
+    StoreLe32(h + 16, (uint32_t)g->rows);
+    StoreLe32(h + 20, (uint32_t)nAxes);
+    StoreLeFloat(h + 24, g->az0);
+    StoreLeFloat(h + 28, g->el0);
+    StoreLeFloat(h + 32, g->dAz);
+    StoreLeFloat(h + 36, g->dEl);
+    StoreLeFloat(h + 40, halfAngle);
+    // Como no tracklog, as matrizes vão na ordem de bytes da máquina (little-endian nas plataformas-alvo)
+    const size_t cells = g->rows * g->cols;
+    int ok = fwrite(h, 1, sizeof h, f) == sizeof h &&
+             fwrite(J, sizeof *J, cells, f) == cells &&
+             fwrite(count, sizeof *count, cells, f) == cells;
+    if (fclose(f) != 0) ok = 0;
+    if (!ok) fprintf(stderr, "%s: erro de escrita\n", path);
+    return ok ? 0 : -1;
+}
+
+int CoverageImageWrite(const char *path, const SphCoverageGrid *g, const unsigned char *rgba) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "P6\n%zu %zu\n255\n", g->cols, g->rows);
+    unsigned char *row = malloc(3 * g->cols);
+    int ok = row != NULL;
+    for (size_t i = 0; ok && i < g->rows; ++i) {
+        const unsigned char *src = rgba + 4 * i * g->cols;
+        for (size_t j = 0; j < g->cols; ++j) memcpy(row + 3*j, src + 4*j, 3);
+        ok = fwrite(row, 3, g->cols, f) == g->cols;
+    }
+    free(row);
+    if (fclose(f) != 0) ok = 0;
+    if (!ok) fprintf(stderr, "%s: erro de escrita\n", path);
+    return ok ? 0 : -1;
+}
+
+/** Lê os eixos (graus) e os devolve em radianos. \return Quantidade de eixos, ou 0 em caso de erro. */
+static size_t ReadAxes(const char *path, float **azOut, float **elOut) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return 0;
+    }
+    size_t n = 0, cap = 16;
+    float *az = malloc(cap * sizeof *az), *el = malloc(cap * sizeof *el);
+    char line[256];
+    while (az && el && fgets(line, sizeof line, f)) {
+        float a, e;
+        if (line[0] == '#' || sscanf(line, "%f,%f", &a, &e) != 2) continue;
+        if (n == cap) {
+            cap *= 2;
+            float *na = realloc(az, cap * sizeof *az), *ne = na ? realloc(el, cap * sizeof *el) : NULL;
+            if (na) az = na;
+            if (!na || !ne) {
+                n = 0;
+                break;
+            }
+            el = ne;
+        }
+        az[n] = a * kDeg2Rad;
+        el[n] = e * kDeg2Rad;
+        ++n;
+    }
+    fclose(f);
+    if (n == 0 || n > UINT16_MAX) {
+        fprintf(stderr, "%s: esperados de 1 a %u eixos \"az,el\" (graus)\n", path, (unsigned)UINT16_MAX);
+        free(az);
+        free(el);
+        return 0;
+    }
+    *azOut = az;
+    *elOut = el;
+    return n;
+}
+
+/**
+ * Quantidade de células de passo \c step em \c span, limitada ao u32 do
+ * cabeçalho do raster. \return 0 se não couber.
+ */
+static size_t GridSide(float span, float step) {
+    const double n = ceil((double)span / (double)step);
+    return n >= 1.0 && n <= (double)UINT32_MAX ? (size_t)n : 0;
+}
+
+/**
+ * Grade pedida: esfera inteira ou região [az0, az1] × [el0, el1], com a maior
+ * elevação na primeira linha. \return 0, ou -1 (mensagem em stderr) se o
+ * passo ou a região forem inválidos ou a grade não couber no raster.
+ */
+static int MakeGrid(const CoverageOptions *opt, SphCoverageGrid *g) {
+    const float step = opt->stepDeg * kDeg2Rad;
+    if (!isfinite(step) || !(step > 0.0f)) {
+        fprintf(stderr, "cobertura: --grid deve ser finito e > 0\n");
+        return -1;
+    }
+    if (!opt->haveRegion) {
+        *g = SphCoverageGridFull(step);
+        if (g->rows == 0 || g->cols == 0) {
+            fprintf(stderr, "cobertura: passo %g° pequeno demais\n", (double)opt->stepDeg);
+            return -1;
+        }
+        return 0;
+    }
+    const float az0 = opt->region[0] * kDeg2Rad, az1 = opt->region[1] * kDeg2Rad;
+    const float el0 = opt->region[2] * kDeg2Rad, el1 = opt->region[3] * kDeg2Rad;
+    if (!isfinite(az0) || !isfinite(az1) || !isfinite(el0) || !isfinite(el1) || !(az1 > az0) || !(el1 > el0)) {
+        fprintf(stderr, "cobertura: --region exige az0 < az1 e el0 < el1, finitos\n");
+        return -1;
+    }
+    g->cols = GridSide(az1 - az0, step);
+    g->rows = GridSide(el1 - el0, step);
+    if (g->cols == 0 || g->rows == 0) {
+        fprintf(stderr, "cobertura: região grande demais para o passo %g°\n", (double)opt->stepDeg);
+        return -1;
+    }
+    g->dAz = (az1 - az0) / (float)g->cols;
+    g->dEl = -(el1 - el0) / (float)g->rows;
+    g->az0 = az0 + 0.5f*g->dAz;
+    g->el0 = el1 + 0.5f*g->dEl;
+    return 0;
+}
+
+int CoverageRun(const CoverageOptions *opt, SphPool *pool) {
+    if (!opt->rasterPath && !opt->imagePath) {
+        fprintf(stderr, "cobertura: use ao menos um de --raster e --image\n");
+        return 2;
+    }
+    SphCoverageGrid g;
+    if (MakeGrid(opt, &g) != 0) return 2;
+    // 4 bytes por célula na maior saída (J e RGBA)
+    if (g.rows > SIZE_MAX / g.cols || g.rows * g.cols > SIZE_MAX / 4) {
+        fprintf(stderr, "cobertura: grade %zu x %zu grande demais\n", g.cols, g.rows);
+        return 2;
+    }
+    float *azR = NULL, *elR = NULL;
+    size_t nAxes = ReadAxes(opt->axesPath, &azR, &elR);
+    if (nAxes == 0) return 1;
+
+    const size_t cells = g.rows * g.cols;
+    const float half = opt->fovHalfDeg * kDeg2Rad;
+    float *J = malloc(cells * sizeof *J);
+    uint16_t *count = malloc(cells * sizeof *count);
+    unsigned char *rgba = opt->imagePath ? malloc(4 * cells) : NULL;
+    int rc = 1;
+    if (!J || !count || (opt->imagePath && !rgba)) {
+        fprintf(stderr, "cobertura: sem memória para %zu x %zu células\n", g.cols, g.rows);
+    } else if (SphCoverageCompute(pool, &g, azR, elR, nAxes, half, J, count) == 0) {
+        size_t covered = 0;
+        for (size_t i = 0; i < cells; ++i) covered += count[i] != 0;
+        printf("grade %zu x %zu, %zu eixos, FOV %.2f°: %.2f%% das células cobertas\n",
+               g.cols, g.rows, nAxes, opt->fovHalfDeg, 100.0 * (double)covered / (double)cells);
+        rc = 0;
+        if (opt->rasterPath && CoverageRasterWrite(opt->rasterPath, &g, nAxes, half, J, count) != 0) rc = 1;
+        if (opt->imagePath) {
+            CoverageColorize(&g, J, count, nAxes, half, rgba);
+            if (CoverageImageWrite(opt->imagePath, &g, rgba) != 0) rc = 1;
+        }
+    }
+    free(rgba);
+    free(count);
+    free(J);
+    free(azR);
+    free(elR);
+    return rc;
+}
@@ -0,0 +1,62 @@
+/**
+ * \file coverage_map.h
+ * \brief Mapas de cobertura em arquivo: raster binário, imagem PPM e o modo headless \c --coverage.
+ *
+ * O cálculo está em \ref SphCoverageCompute (biblioteca \c spherical_core);
+ * aqui ficam a leitura dos eixos candidatos, a gravação do resultado e as
+ * cores usadas tanto na imagem quanto na textura do visualizador.
+ *
+ * Raster \c .sphcov (little-endian):
+ * - Cabeçalho de 64 bytes: \c "SPHCOV01", versão (u32), colunas (u32),
+ *   linhas (u32), eixos (u32), depois \c az0, \c el0, \c dAz, \c dEl e o
+ *   semiângulo do FOV (f32, radianos); restante reservado (zeros).
+ * - Menor J por célula (f32, radianos), linhas × colunas, por linhas.
+ * - Eixos que cobrem cada célula (u16), linhas × colunas, por linhas.
+ */
+#ifndef COVERAGE_MAP_H
+#define COVERAGE_MAP_H
+
+#include "spherical_coverage.h"
+#include "spherical_parallel.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Parâmetros do modo headless \c --coverage (ângulos em graus). */
+typedef struct CoverageOptions {
+    const char *axesPath;    ///< CSV com um eixo \c "az,el" por linha (\c '#' inicia comentário).
+    float stepDeg;           ///< Passo da grade.
+    float fovHalfDeg;        ///< Semiângulo do FOV.
+    int haveRegion;          ///< Se 0, a esfera inteira.
+    float region[4];         ///< az0, az1, el0, el1 (com \c haveRegion).
+    const char *rasterPath;  ///< Raster \c .sphcov (ou NULL).
+    const char *imagePath;   ///< Imagem PPM (ou NULL).
+} CoverageOptions;
+
+/**
+ * \brief Cores de um mapa (RGBA, 4 bytes por célula, na ordem da grade).
+ *
+ * Células cobertas em verde, mais claro quanto mais eixos as cobrem; as
+ * descobertas em azul-escuro, mais claro quanto mais perto do FOV do eixo
+ * mais próximo. Com alfa parcial, para a textura sobre a esfera.
+ *
+ * \param J,count Saídas de \ref SphCoverageCompute (ambas obrigatórias).
+ */
+void CoverageColorize(const SphCoverageGrid *grid, const float *J, const uint16_t *count,
+                      size_t nAxes, float halfAngle, unsigned char *rgba);
+
+/** \brief Grava o raster \c .sphcov. \return 0, ou -1 em caso de erro (mensagem em stderr). */
+int CoverageRasterWrite(const char *path, const SphCoverageGrid *grid, size_t nAxes, float halfAngle,
+                        const float *J, const uint16_t *count);
+
+/** \brief Grava as cores de \ref CoverageColorize como PPM binário (P6). \return 0 ou -1. */
+int CoverageImageWrite(const char *path, const SphCoverageGrid *grid, const unsigned char *rgba);
+
+/**
+ * \brief Modo headless \c --coverage: lê os eixos, calcula o mapa e grava os arquivos pedidos.
+ * \param pool Pool de threads (NULL: thread atual).
+ * \return Código de saída do processo.
+ */
+int CoverageRun(const CoverageOptions *opt, SphPool *pool);
+
+#endif /* COVERAGE_MAP_H */
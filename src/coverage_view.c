@@ -0,0 +1,110 @@
+/**
+ * \file coverage_view.c
+ * \brief Textura equirretangular do mapa de cobertura e a malha de esfera correspondente.
+ */
+#include "coverage_view.h"
+
+#include "coverage_map.h"
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "spherical_coverage.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#define COVERAGE_SEG_AZ 96
+#define COVERAGE_SEG_EL 48
+#define COVERAGE_RADIUS 0.995f  // logo abaixo da esfera aramada
+
+struct CoverageView {
+    SphCoverageGrid grid;
+    float *J;
+    uint16_t *count;
+    unsigned char *rgba;
+    Texture2D tex;
+    Mesh mesh;
+    Material material;
+};
+
+/** Esfera em Norte-Leste-Cima com u = Az (de -π a π) e v = El (de π/2 a -π/2), como a grade. */
+static Mesh GenCoverageSphere(void) {
+    const float pi = 3.14159265358979323846f;
+    Mesh m = { 0 };
+    m.vertexCount = (COVERAGE_SEG_AZ + 1) * (COVERAGE_SEG_EL + 1);
+    m.triangleCount = 2 * COVERAGE_SEG_AZ * COVERAGE_SEG_EL;
+    m.vertices = MemAlloc((unsigned)m.vertexCount * 3 * sizeof(float));
+    m.texcoords = MemAlloc((unsigned)m.vertexCount * 2 * sizeof(float));
+    m.normals = MemAlloc((unsigned)m.vertexCount * 3 * sizeof(float));
+    m.indices = MemAlloc((unsigned)m.triangleCount * 3 * sizeof(unsigned short));
+    for (int i = 0; i <= COVERAGE_SEG_EL; ++i) {
+        float v = (float)i / COVERAGE_SEG_EL;
+        float el = 0.5f*pi - v*pi;
+        for (int j = 0; j <= COVERAGE_SEG_AZ; ++j) {
+            float u = (float)j / COVERAGE_SEG_AZ;
+            SphVec3 d = SphAzElToVec(-pi + u*2.0f*pi, el);
+            int k = i*(COVERAGE_SEG_AZ + 1) + j;
+            m.vertices[3*k] = COVERAGE_RADIUS*d.x;
+            m.vertices[3*k + 1] = COVERAGE_RADIUS*d.y;
+            m.vertices[3*k + 2] = COVERAGE_RADIUS*d.z;
+            m.normals[3*k] = d.x; m.normals[3*k + 1] = d.y; m.normals[3*k + 2] = d.z;
+            m.texcoords[2*k] = u;
+            m.texcoords[2*k + 1] = v;
+        }
+    }
+    // Triângulos no sentido anti-horário vistos de fora (a face de trás é descartada)
+    int t = 0;
+    for (int i = 0; i < COVERAGE_SEG_EL; ++i) {
+        for (int j = 0; j < COVERAGE_SEG_AZ; ++j) {
+            unsigned short a = (unsigned short)(i*(COVERAGE_SEG_AZ + 1) + j), b = (unsigned short)(a + 1);
+            unsigned short d = (unsigned short)(a + COVERAGE_SEG_AZ + 1), c = (unsigned short)(d + 1);
+            m.indices[t++] = d; m.indices[t++] = c; m.indices[t++] = b;
+            m.indices[t++] = d; m.indices[t++] = b; m.indices[t++] = a;
+        }
+    }
+    UploadMesh(&m, false);
+    return m;
+}
+
+CoverageView *CoverageViewCreate(float stepDeg) {
+    CoverageView *v = calloc(1, sizeof *v);
+    if (!v) return NULL;
+    v->grid = SphCoverageGridFull(stepDeg * 3.14159265358979323846f / 180.0f);
+    const size_t cells = v->grid.rows * v->grid.cols;
+    v->J = malloc(cells * sizeof *v->J);
+    v->count = malloc(cells * sizeof *v->count);
+    v->rgba = calloc(cells, 4);
+    if (!v->J || !v->count || !v->rgba) {
+        CoverageViewDestroy(v);
+        return NULL;
+    }
+    Image img = { v->rgba, (int)v->grid.cols, (int)v->grid.rows, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    v->tex = LoadTextureFromImage(img);
+    SetTextureFilter(v->tex, TEXTURE_FILTER_BILINEAR);
+    v->mesh = GenCoverageSphere();
+    v->material = LoadMaterialDefault();
+    v->material.maps[MATERIAL_MAP_DIFFUSE].texture = v->tex;
+    return v;
+}
+
+void CoverageViewUpdate(CoverageView *v, const float *azR, const float *elR, size_t nAxes, float halfAngle) {
+    if (SphCoverageCompute(NULL, &v->grid, azR, elR, nAxes, halfAngle, v->J, v->count) != 0) return;
+    CoverageColorize(&v->grid, v->J, v->count, nAxes, halfAngle, v->rgba);
+    UpdateTexture(v->tex, v->rgba);
+}
+
+void CoverageViewDraw(const CoverageView *v) {
+    rlDisableDepthMask();
+    DrawMesh(v->mesh, v->material, MatrixIdentity());
+    rlEnableDepthMask();
+}
+
+void CoverageViewDestroy(CoverageView *v) {
+    if (!v) return;
+    if (v->material.maps) UnloadMaterial(v->material); // também libera a textura
+    if (v->mesh.vertexCount) UnloadMesh(v->mesh);
+    free(v->J);
+    free(v->count);
+    free(v->rgba);
+    free(v);
+}
@@ -0,0 +1,41 @@
+/**
+ * \file coverage_view.h
+ * \brief Mapa de cobertura desenhado como textura sobre a esfera unitária.
+ *
+ * A grade é a da esfera inteira (\ref SphCoverageGridFull), em ordem de
+ * imagem: a textura é equirretangular e a malha da esfera, gerada aqui em
+ * Norte-Leste-Cima, tem as coordenadas de textura \f$u\f$ = Az e
+ * \f$v\f$ = El da mesma grade. O mapa só é recalculado (em
+ * \ref SphCoverageCompute) e reenviado à GPU quando os eixos mudam.
+ */
+#ifndef COVERAGE_VIEW_H
+#define COVERAGE_VIEW_H
+
+#include <stddef.h>
+
+typedef struct CoverageView CoverageView;
+
+/**
+ * \brief Cria a textura e a malha (depois de \c InitWindow).
+ * \param stepDeg Passo da grade em graus (por exemplo 0.5: 720 × 360 células).
+ */
+CoverageView *CoverageViewCreate(float stepDeg);
+
+/**
+ * \brief Recalcula o mapa para \c nAxes eixos (rad) e atualiza a textura.
+ * \param halfAngle Semiângulo do FOV (rad).
+ */
+void CoverageViewUpdate(CoverageView *view, const float *azR, const float *elR, size_t nAxes, float halfAngle);
+
+/**
+ * \brief Desenha a esfera texturizada (dentro de \c BeginMode3D).
+ *
+ * Semitransparente e sem escrever no buffer de profundidade: desenhada
+ * depois das setas e dos arcos, não os esconde.
+ */
+void CoverageViewDraw(const CoverageView *view);
+
+/** \brief Libera textura, malha e buffers. */
+void CoverageViewDestroy(CoverageView *view);
+
+#endif /* COVERAGE_VIEW_H */
@@ -0,0 +1,224 @@
+/**
+ * \file frame_export.c
+ * \brief Desenho fora da tela, leitura dos pixels e codificação PNG em um pool de threads.
+ *
+ * Só a thread principal toca no OpenGL: ela desenha a cena na
+ * \c RenderTexture2D, lê os pixels (\c LoadImageFromTexture) e empilha a
+ * imagem em uma fila limitada. As threads codificadoras desempilham, viram a
+ * imagem na vertical (a origem do OpenGL é embaixo), descartam o alfa e
+ * gravam o PNG. A rlgl da Raylib não expõe pixel buffer objects, então a
+ * leitura em si é síncrona; o que sai do caminho da GPU é a codificação.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "frame_export.h"
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define EXPORT_MAX_WORKERS 64
+#define EXPORT_PATH_MAX 512
+
+typedef struct EncodeJob {
+    Image image;
+    char path[EXPORT_PATH_MAX];
+} EncodeJob;
+
+/** Fila limitada (produtor: thread da GPU; consumidores: codificadores). */
+typedef struct EncodeQueue {
+    pthread_mutex_t mu;
+    pthread_cond_t notEmpty, notFull;
+    EncodeJob *jobs;
+    size_t cap, head, count;
+    int closing;
+    size_t failed;
+} EncodeQueue;
+
+static const float kDeg2Rad = 3.14159265358979323846f / 180.0f;
+
+static void *EncodeWorker(void *arg) {
+    EncodeQueue *q = arg;
+    for (;;) {
+        pthread_mutex_lock(&q->mu);
+        while (q->count == 0 && !q->closing) pthread_cond_wait(&q->notEmpty, &q->mu);
+        if (q->count == 0) {
+            pthread_mutex_unlock(&q->mu);
+            return NULL;
+        }
+        EncodeJob job = q->jobs[q->head];
+        q->head = (q->head + 1) % q->cap;
+        --q->count;
+        pthread_cond_signal(&q->notFull);
+        pthread_mutex_unlock(&q->mu);
+
+        ImageFlipVertical(&job.image);
+        ImageFormat(&job.image, PIXELFORMAT_UNCOMPRESSED_R8G8B8);
+        int ok = ExportImage(job.image, job.path);
+        UnloadImage(job.image);
+        if (!ok) {
+            pthread_mutex_lock(&q->mu);
+            ++q->failed;
+            pthread_mutex_unlock(&q->mu);
+        }
+    }
+}
+
+/** Empilha um quadro; espera se a fila estiver cheia. */
+static void EncodePush(EncodeQueue *q, const EncodeJob *job) {
+    pthread_mutex_lock(&q->mu);
+    while (q->count == q->cap) pthread_cond_wait(&q->notFull, &q->mu);
+    q->jobs[(q->head + q->count) % q->cap] = *job;
+    ++q->count;
+    pthread_cond_signal(&q->notEmpty);
+    pthread_mutex_unlock(&q->mu);
+}
+
+/** Lê a lista de cenas. \return Quantidade de cenas (0 em caso de erro, com mensagem). */
+static size_t ReadShots(const char *path, ExportShot **out) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return 0;
+    }
+    size_t n = 0, cap = 256;
+    ExportShot *shots = malloc(cap * sizeof *shots);
+    char line[512];
+    while (shots && fgets(line, sizeof line, f)) {
+        // Câmera padrão: a posição inicial do visualizador (2.5, 2.0, 2.5)
+        float v[8] = { 0, 0, 0, 0, 38.66f, 37.98f, 4.062f, 60.0f };
+        if (line[0] == '#') continue;
+        int k = sscanf(line, "%f,%f,%f,%f,%f,%f,%f,%f", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7]);
+        if (k < 4) continue;
+        if (n == cap) {
+            ExportShot *grown = realloc(shots, 2 * cap * sizeof *shots);
+            if (!grown) break;
+            shots = grown;
+            cap *= 2;
+        }
+        ExportShot *s = &shots[n++];
+        s->azT = v[0]; s->elT = v[1]; s->azR = v[2]; s->elR = v[3];
+        float ca = v[4] * kDeg2Rad, ce = v[5] * kDeg2Rad;
+        memset(&s->cam, 0, sizeof s->cam);
+        s->cam.position = (Vector3){ v[6]*cosf(ce)*cosf(ca), v[6]*cosf(ce)*sinf(ca), v[6]*sinf(ce) };
+        s->cam.target = (Vector3){ 0.0f, 0.0f, 0.0f };
+        s->cam.up = (Vector3){ 0.0f, 0.0f, 1.0f };
+        s->cam.fovy = v[7];
+        s->cam.projection = CAMERA_PERSPECTIVE;
+    }
+    fclose(f);
+    if (n == 0) {
+        fprintf(stderr, "%s: nenhuma cena \"azT,elT,azR,elR[,camAz,camEl[,camDist[,fovy]]]\"\n", path);
+        free(shots);
+        return 0;
+    }
+    *out = shots;
+    return n;
+}
+
+static void PrintUsage(void) {
+    fprintf(stderr,
+        "uso: spherical_trig --export lista.csv [--out dir] [--size LxA] [--workers n]\n"
+        "lista: azT,elT,azR,elR[,camAz,camEl[,camDist[,fovy]]] (graus)\n");
+}
+
+int RunFrameExport(int argc, char **argv, ExportDrawFn draw, void *user) {
+    if (argc < 1) {
+        PrintUsage();
+        return 2;
+    }
+    const char *listPath = argv[0], *outDir = ".";
+    int width = 1280, height = 720;
+    long workers = sysconf(_SC_NPROCESSORS_ONLN);
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(a, "--out") == 0 && v) { outDir = v; ++i; }
+        else if (strcmp(a, "--size") == 0 && v) {
+            if (sscanf(v, "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) { PrintUsage(); return 2; }
+            ++i;
+        }
+        else if (strcmp(a, "--workers") == 0 && v) { workers = atol(v); ++i; }
+        else { PrintUsage(); return 2; }
+    }
+    if (workers < 1) workers = 1;
+    if (workers > EXPORT_MAX_WORKERS) workers = EXPORT_MAX_WORKERS;
+    if (mkdir(outDir, 0755) != 0 && errno != EEXIST) {
+        perror(outDir);
+        return 1;
+    }
+
+    ExportShot *shots = NULL;
+    size_t n = ReadShots(listPath, &shots);
+    if (n == 0) return 1;
+
+    // Dois quadros por codificador na fila: o suficiente para ninguém esperar
+    EncodeQueue q;
+    memset(&q, 0, sizeof q);
+    q.cap = 2 * (size_t)workers;
+    q.jobs = malloc(q.cap * sizeof *q.jobs);
+    if (!q.jobs) {
+        free(shots);
+        return 1;
+    }
+    pthread_mutex_init(&q.mu, NULL);
+    pthread_cond_init(&q.notEmpty, NULL);
+    pthread_cond_init(&q.notFull, NULL);
+
+    // Um contexto OpenGL precisa de uma janela, mesmo que oculta
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN | FLAG_MSAA_4X_HINT);
+    InitWindow(width, height, "spherical_trig --export");
+    RenderTexture2D target = LoadRenderTexture(width, height);
+
+    pthread_t threads[EXPORT_MAX_WORKERS];
+    int started = 0;
+    while (started < workers && pthread_create(&threads[started], NULL, EncodeWorker, &q) == 0) ++started;
+
+    int rc = 0;
+    if (started == 0 || target.id == 0) {
+        fprintf(stderr, "export: não foi possível iniciar os codificadores ou o alvo de desenho\n");
+        rc = 1;
+    } else {
+        double t0 = GetTime();
+        for (size_t i = 0; i < n; ++i) {
+            BeginTextureMode(target);
+            draw(&shots[i], width, height, user);
+            EndTextureMode();
+            EncodeJob job;
+            job.image = LoadImageFromTexture(target.texture);
+            snprintf(job.path, sizeof job.path, "%s/shot_%06zu.png", outDir, i);
+            EncodePush(&q, &job);
+        }
+        pthread_mutex_lock(&q.mu);
+        q.closing = 1;
+        pthread_cond_broadcast(&q.notEmpty);
+        pthread_mutex_unlock(&q.mu);
+        for (int k = 0; k < started; ++k) pthread_join(threads[k], NULL);
+        started = 0;
+        double el = GetTime() - t0;
+        printf("export: %zu quadros %dx%d em %.2f s (%.1f quadros/s, %ld codificadores), %zu falhas\n",
+               n, width, height, el, el > 0.0 ? (double)n / el : 0.0, workers, q.failed);
+        rc = q.failed ? 1 : 0;
+    }
+    // Caminho de erro: encerra os codificadores que chegaram a iniciar
+    pthread_mutex_lock(&q.mu);
+    q.closing = 1;
+    pthread_cond_broadcast(&q.notEmpty);
+    pthread_mutex_unlock(&q.mu);
+    for (int k = 0; k < started; ++k) pthread_join(threads[k], NULL);
+
+    UnloadRenderTexture(target);
+    CloseWindow();
+    pthread_cond_destroy(&q.notFull);
+    pthread_cond_destroy(&q.notEmpty);
+    pthread_mutex_destroy(&q.mu);
+    free(q.jobs);
+    free(shots);
+    return rc;
+}
@@ -0,0 +1,52 @@
+/**
+ * \file frame_export.h
+ * \brief Exportação em lote de quadros fora da tela (relatórios de incidentes).
+ *
+ * Cada linha de uma lista de cenas vira um PNG, sem interação e sem janela
+ * visível: a cena é desenhada em uma \c RenderTexture2D, os pixels são lidos
+ * de volta e a codificação PNG (a etapa cara, ~dezenas de ms por quadro)
+ * vai para um pool de threads codificadoras, enquanto a thread da GPU já
+ * desenha a cena seguinte. Uma fila limitada entre as duas etapas segura a
+ * memória quando os codificadores ficam para trás.
+ *
+ * Formato da lista (CSV, graus, \c '#' inicia comentário):
+ * \code
+ * azT,elT,azR,elR[,camAz,camEl[,camDist[,fovy]]]
+ * \endcode
+ * A câmera orbita a origem (padrão: a do visualizador interativo).
+ */
+#ifndef FRAME_EXPORT_H
+#define FRAME_EXPORT_H
+
+#include "raylib.h"
+
+/** Uma cena da lista: ângulos em graus e câmera já posicionada. */
+typedef struct ExportShot {
+    float azT, elT, azR, elR;
+    Camera3D cam;
+} ExportShot;
+
+/**
+ * \brief Desenha uma cena no alvo atual (já dentro de \c BeginTextureMode).
+ * \param width,height Tamanho do alvo, para projetar os rótulos.
+ */
+typedef void (*ExportDrawFn)(const ExportShot *shot, int width, int height, void *user);
+
+/**
+ * \brief Modo \c --export: lê a lista, desenha cada cena fora da tela e grava os PNGs.
+ *
+ * Opções reconhecidas (após \c --export \<lista.csv\>):
+ * - \c --out \<dir\>        diretório de saída (padrão: \c "."), arquivos \c shot_000000.png, ...
+ * - \c --size \<L\>x\<A\>     tamanho dos quadros (padrão: 1280x720)
+ * - \c --workers \<n\>      threads codificadoras (padrão: núcleos online)
+ *
+ * Abre uma janela oculta só para ter o contexto OpenGL.
+ *
+ * \param argc,argv Argumentos após \c --export.
+ * \param draw Função que desenha uma cena.
+ * \param user Repassado a \c draw.
+ * \return Código de saída do processo.
+ */
+int RunFrameExport(int argc, char **argv, ExportDrawFn draw, void *user);
+
+#endif /* FRAME_EXPORT_H */
@@ -0,0 +1,179 @@
+/**
+ * \file frame_profiler.c
+ * \brief Implementação do perfilador de quadros.
+ */
+#include "frame_profiler.h"
+
+#include "raylib.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *kPhaseNames[PROF_PHASE_COUNT] = {
+    "input", "compute", "draw3d", "labels", "hud", "end_drawing"
+};
+
+/** Um evento completo do trace (tempos em segundos desde a criação). */
+typedef struct TraceEvent {
+    double start, dur;
+    int phase;  ///< ProfPhase, ou PROF_PHASE_COUNT para o quadro.
+} TraceEvent;
+
+struct FrameProfiler {
+    double origin;
+    double frameStart;
+    double phaseStart[PROF_PHASE_COUNT];
+    float current[PROF_PHASE_COUNT + 1];  // ms no quadro atual (+ quadro inteiro)
+
+    // Anéis das últimas FRAME_PROFILER_HISTORY durações (ms), por fase
+    float history[PROF_PHASE_COUNT + 1][FRAME_PROFILER_HISTORY];
+    int head, filled;
+    float p50[PROF_PHASE_COUNT + 1], p99[PROF_PHASE_COUNT + 1];
+
+    // Captura de trace
+    char *tracePath;
+    TraceEvent *events;
+    int eventCount, eventCap, framesLeft;
+    int frameEvents;  // eventCount no início do quadro atual
+};
+
+static double Now(const FrameProfiler *p) {
+    return GetTime() - p->origin;
+}
+
+FrameProfiler *FrameProfilerCreate(void) {
+    FrameProfiler *p = calloc(1, sizeof *p);
+    if (!p) return NULL;
+    p->origin = GetTime();
+    return p;
+}
+
+void FrameProfilerBeginFrame(FrameProfiler *p) {
+    p->frameStart = Now(p);
+    p->frameEvents = p->eventCount;
+    memset(p->current, 0, sizeof p->current);
+}
+
+static void Record(FrameProfiler *p, int phase, double start, double end) {
+    p->current[phase] += (float)((end - start) * 1000.0);
+    if (!p->tracePath || p->eventCount >= p->eventCap) return;
+    p->events[p->eventCount++] = (TraceEvent){ start, end - start, phase };
+}
+
+void FrameProfilerBegin(FrameProfiler *p, ProfPhase phase) {
+    p->phaseStart[phase] = Now(p);
+}
+
+void FrameProfilerEnd(FrameProfiler *p, ProfPhase phase) {
+    Record(p, phase, p->phaseStart[phase], Now(p));
+}
+
+static int CompareFloat(const void *a, const void *b) {
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+static void UpdatePercentiles(FrameProfiler *p) {
+    float sorted[FRAME_PROFILER_HISTORY];
+    const int n = p->filled;
+    for (int k = 0; k <= PROF_PHASE_COUNT; ++k) {
+        memcpy(sorted, p->history[k], (size_t)n * sizeof *sorted);
+        qsort(sorted, (size_t)n, sizeof *sorted, CompareFloat);
+        p->p50[k] = sorted[(n - 1) / 2];
+        p->p99[k] = sorted[(n - 1) * 99 / 100];
+    }
+}
+
+/** Grava os eventos capturados e encerra a captura. */
+static void WriteTrace(FrameProfiler *p) {
+    FILE *f = fopen(p->tracePath, "w");
+    if (f) {
+        fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+        fputs("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"render\"}}", f);
+        for (int i = 0; i < p->eventCount; ++i) {
+            const TraceEvent *e = &p->events[i];
+            const char *name = e->phase == PROF_PHASE_COUNT ? "frame" : kPhaseNames[e->phase];
+            fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+                    name, e->start * 1e6, e->dur * 1e6);
+        }
+        fputs("\n]}\n", f);
+        fclose(f);
+        TraceLog(LOG_INFO, "PROFILER: trace com %d eventos gravado em %s", p->eventCount, p->tracePath);
+    } else {
+        TraceLog(LOG_WARNING, "PROFILER: não foi possível gravar %s", p->tracePath);
+    }
+    free(p->tracePath);
+    free(p->events);
+    p->tracePath = NULL;
+    p->events = NULL;
+    p->eventCount = p->eventCap = p->framesLeft = 0;
+}
+
+void FrameProfilerEndFrame(FrameProfiler *p) {
+    Record(p, PROF_PHASE_COUNT, p->frameStart, Now(p));
+    for (int k = 0; k <= PROF_PHASE_COUNT; ++k) p->history[k][p->head] = p->current[k];
+    p->head = (p->head + 1) % FRAME_PROFILER_HISTORY;
+    if (p->filled < FRAME_PROFILER_HISTORY) p->filled++;
+    UpdatePercentiles(p);
+
+    if (p->tracePath && --p->framesLeft <= 0) WriteTrace(p);
+}
+
+void FrameProfilerDiscardFrame(FrameProfiler *p) {
+    memset(p->current, 0, sizeof p->current);
+    p->eventCount = p->frameEvents;
+}
+
+void FrameProfilerStats(const FrameProfiler *p, ProfPhase phase, float *p50, float *p99) {
+    *p50 = p->p50[phase];
+    *p99 = p->p99[phase];
+}
+
+int FrameProfilerStartTrace(FrameProfiler *p, const char *path, int frames) {
+    if (p->tracePath || frames <= 0) return -1;
+    size_t len = strlen(path) + 1;
+    p->tracePath = malloc(len);
+    p->eventCap = frames * (PROF_PHASE_COUNT + 1);
+    p->events = malloc((size_t)p->eventCap * sizeof *p->events);
+    if (!p->tracePath || !p->events) {
+        free(p->tracePath);
+        free(p->events);
+        p->tracePath = NULL;
+        p->events = NULL;
+        return -1;
+    }
+    memcpy(p->tracePath, path, len);
+    p->eventCount = p->frameEvents = 0;
+    p->framesLeft = frames;
+    return 0;
+}
+
+int FrameProfilerTracing(const FrameProfiler *p) {
+    return p->tracePath != NULL;
+}
+
+void FrameProfilerDrawOverlay(const FrameProfiler *p, int x, int y) {
+    // A fonte padrão não é monoespaçada: cada coluna tem o seu x
+    const int line = 18, fs = 16, c50 = x + 120, c99 = x + 200;
+    DrawRectangle(x - 6, y - 6, 290, line * (PROF_PHASE_COUNT + 3) + 8, Fade(BLACK, 0.55f));
+    DrawText("fase", x, y, fs, LIGHTGRAY);
+    DrawText("p50 ms", c50, y, fs, LIGHTGRAY);
+    DrawText("p99 ms", c99, y, fs, LIGHTGRAY);
+    y += line;
+    for (int k = 0; k <= PROF_PHASE_COUNT; ++k) {
+        const char *name = k == PROF_PHASE_COUNT ? "quadro" : kPhaseNames[k];
+        Color c = k == PROF_PHASE_COUNT ? YELLOW : RAYWHITE;
+        DrawText(name, x, y, fs, c);
+        DrawText(TextFormat("%.3f", p->p50[k]), c50, y, fs, c);
+        DrawText(TextFormat("%.3f", p->p99[k]), c99, y, fs, c);
+        y += line;
+    }
+    if (p->tracePath) DrawText(TextFormat("gravando trace... (%d quadros)", p->framesLeft), x, y, fs, RED);
+}
+
+void FrameProfilerDestroy(FrameProfiler *p) {
+    if (!p) return;
+    if (p->tracePath) WriteTrace(p);
+    free(p);
+}
@@ -0,0 +1,84 @@
+/**
+ * \file frame_profiler.h
+ * \brief Perfilador de quadros: tempo por fase do laço, p50/p99 na tela e trace JSON.
+ *
+ * Cada fase do laço (entrada, cálculo, desenho 3D, rótulos, HUD, \c EndDrawing)
+ * é delimitada por \ref FrameProfilerBegin / \ref FrameProfilerEnd. As durações
+ * dos últimos \ref FRAME_PROFILER_HISTORY quadros ficam em um anel por fase,
+ * do qual saem a mediana (p50) e o percentil 99 (p99) mostrados no overlay.
+ *
+ * Sob demanda, os próximos N quadros são gravados como eventos completos
+ * (\c "ph":"X") no formato Chrome Trace Event, que abre em \c chrome://tracing
+ * e no Perfetto (https://ui.perfetto.dev).
+ *
+ * Observação: \c EndDrawing inclui a troca de buffers e a espera do limitador
+ * de quadros (\c SetTargetFPS), então essa fase costuma dominar o quadro.
+ */
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+/** Quantidade de quadros usada nas estatísticas móveis. */
+#define FRAME_PROFILER_HISTORY 240
+
+/** Fases medidas em cada quadro. */
+typedef enum ProfPhase {
+    PROF_INPUT = 0,    ///< Teclado, mouse e câmera.
+    PROF_COMPUTE,      ///< AzElToVec, J e atualização da visão com muitos alvos.
+    PROF_DRAW3D,       ///< Esfera, arcos e setas (dentro de \c BeginMode3D).
+    PROF_LABELS,       ///< Rótulos 2D via \c GetWorldToScreen.
+    PROF_HUD,          ///< Textos do HUD.
+    PROF_END_DRAWING,  ///< \c EndDrawing (envio à GPU, troca de buffers, espera).
+    PROF_PHASE_COUNT
+} ProfPhase;
+
+typedef struct FrameProfiler FrameProfiler;
+
+/** \brief Cria o perfilador. \return NULL se faltar memória. */
+FrameProfiler *FrameProfilerCreate(void);
+
+/** \brief Marca o início de um quadro. */
+void FrameProfilerBeginFrame(FrameProfiler *prof);
+
+/** \brief Marca o início da fase \c phase no quadro atual. */
+void FrameProfilerBegin(FrameProfiler *prof, ProfPhase phase);
+
+/** \brief Marca o fim da fase \c phase no quadro atual. */
+void FrameProfilerEnd(FrameProfiler *prof, ProfPhase phase);
+
+/**
+ * \brief Fecha o quadro: atualiza os anéis e, se houver captura em curso,
+ *        grava o arquivo de trace ao completar os quadros pedidos.
+ */
+void FrameProfilerEndFrame(FrameProfiler *prof);
+
+/**
+ * \brief Abandona o quadro atual sem registrá-lo (nem nos anéis, nem no trace).
+ *
+ * Para quadros que não chegam a desenhar, como os ociosos do modo por
+ * eventos: fecha o par com \ref FrameProfilerBeginFrame sem puxar os
+ * percentis para baixo.
+ */
+void FrameProfilerDiscardFrame(FrameProfiler *prof);
+
+/**
+ * \brief Percentis móveis de uma fase (ms).
+ * \param phase Fase, ou \ref PROF_PHASE_COUNT para o quadro inteiro.
+ */
+void FrameProfilerStats(const FrameProfiler *prof, ProfPhase phase, float *p50, float *p99);
+
+/**
+ * \brief Começa a gravar os próximos \c frames quadros em \c path (JSON).
+ * \return 0, ou -1 se já há uma captura em curso ou faltou memória.
+ */
+int FrameProfilerStartTrace(FrameProfiler *prof, const char *path, int frames);
+
+/** \brief 1 enquanto há uma captura em curso. */
+int FrameProfilerTracing(const FrameProfiler *prof);
+
+/** \brief Desenha a tabela p50/p99 por fase com canto superior esquerdo em (x, y). */
+void FrameProfilerDrawOverlay(const FrameProfiler *prof, int x, int y);
+
+/** \brief Libera o perfilador (uma captura incompleta é gravada como está). */
+void FrameProfilerDestroy(FrameProfiler *prof);
+
+#endif /* FRAME_PROFILER_H */
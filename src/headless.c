@@ -0,0 +1,386 @@
+/**
+ * \file headless.c
+ * \brief Laço do modo headless: lê lotes de telemetria, calcula J em lote e escreve o resultado.
+ *
+ * Enquanto a thread de leitura (\ref TelemetryOpen) preenche o próximo lote,
+ * este laço converte o lote atual para radianos, calcula J com
+ * \ref SphParallelAngleJPaired (em paralelo com \c --threads) e formata a saída em um buffer grande, escrito
+ * com poucas chamadas a \c fwrite.
+ *
+ * Nenhuma alocação acontece por lote: os buffers de vida longa (lotes de
+ * telemetria e saída) vêm de um \ref SphBufferPool, e os temporários de cada
+ * lote (ângulos em radianos, J, vetores) de uma \ref SphArena zerada ao fim
+ * do lote.
+ */
+#include "headless.h"
+
+#include "coverage_map.h"
+#include "spherical.h"
+#include "spherical_arena.h"
+#include "spherical_parallel.h"
+#include "state_server.h"
+#include "telemetry.h"
+#include "tracklog.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HEADLESS_OUT_BYTES (1u << 20)
+
+static const float kDeg2Rad = 3.14159265358979323846f / 180.0f;
+static const float kRad2Deg = 180.0f / 3.14159265358979323846f;
+
+typedef struct OutBuffer {
+    char *data;
+    size_t len;
+    FILE *f;
+} OutBuffer;
+
+static void OutFlush(OutBuffer *o) {
+    if (o->len) fwrite(o->data, 1, o->len, o->f);
+    o->len = 0;
+}
+
+static void OutReserve(OutBuffer *o, size_t n) {
+    if (o->len + n > HEADLESS_OUT_BYTES) OutFlush(o);
+}
+
+static void StoreLe32(unsigned char *p, uint32_t u) {
+    p[0] = (unsigned char)u; p[1] = (unsigned char)(u >> 8);
+    p[2] = (unsigned char)(u >> 16); p[3] = (unsigned char)(u >> 24);
+}
+
+static void WriteBinary(OutBuffer *o, double t, float j) {
+    uint64_t ut; uint32_t uj;
+    memcpy(&ut, &t, sizeof ut);
+    memcpy(&uj, &j, sizeof uj);
+    OutReserve(o, 12);
+    unsigned char *p = (unsigned char *)o->data + o->len;
+    StoreLe32(p, (uint32_t)ut);
+    StoreLe32(p + 4, (uint32_t)(ut >> 32));
+    StoreLe32(p + 8, uj);
+    o->len += 12;
+}
+
+static void WriteCsv(OutBuffer *o, double t, float j) {
+    // Quase sempre cabe em 64 bytes, mas um t enorme em %.6f passa de 300:
+    // o tamanho real vem do snprintf, e a linha é refeita depois de esvaziar o buffer
+    OutReserve(o, 64);
+    size_t room = HEADLESS_OUT_BYTES - o->len;
+    int n = snprintf(o->data + o->len, room, "%.6f,%.4f\n", t, j);
+    if (n < 0) return;
+    if ((size_t)n >= room) {
+        OutFlush(o);
+        n = snprintf(o->data, HEADLESS_OUT_BYTES, "%.6f,%.4f\n", t, j);
+        if (n < 0 || (size_t)n >= HEADLESS_OUT_BYTES) return;
+    }
+    o->len += (size_t)n;
+}
+
+static int ParseFormat(const char *s, TelemetryFormat *out) {
+    if (strcmp(s, "csv") == 0) { *out = TELEMETRY_CSV; return 1; }
+    if (strcmp(s, "bin") == 0) { *out = TELEMETRY_BINARY; return 1; }
+    fprintf(stderr, "formato desconhecido: '%s' (use csv ou bin)\n", s);
+    return 0;
+}
+
+/** Inteiro decimal em [lo, hi], sem sobras; mensagem em stderr se inválido. */
+static int ParseLong(const char *opt, const char *s, long lo, long hi, long *out) {
+    char *end;
+    errno = 0;
+    long v = strtol(s, &end, 10);
+    if (errno != 0 || end == s || *end != '\0' || v < lo || v > hi) {
+        fprintf(stderr, "%s: valor inválido '%s' (use um inteiro de %ld a %ld)\n", opt, s, lo, hi);
+        return 0;
+    }
+    *out = v;
+    return 1;
+}
+
+/** Real finito em [lo, hi], sem sobras; mensagem em stderr se inválido. */
+static int ParseFloat(const char *opt, const char *s, float lo, float hi, float *out) {
+    char *end;
+    errno = 0;
+    float v = strtof(s, &end);
+    if (errno != 0 || end == s || *end != '\0' || !isfinite(v) || v < lo || v > hi) {
+        fprintf(stderr, "%s: valor inválido '%s' (use um número de %g a %g)\n", opt, s, (double)lo, (double)hi);
+        return 0;
+    }
+    *out = v;
+    return 1;
+}
+
+static void PrintUsage(void) {
+    fprintf(stderr,
+        "uso: spherical_trig --headless [--in -|arquivo|udp://[end]:porta]\n"
+        "                               [--format csv|bin] [--out-format csv|bin] [--batch n]\n"
+        "                               [--convert log.sphtrk | --replay log.sphtrk] [--threads n]\n"
+        "                               [--publish [end:]porta [--publish-hz n]]\n"
+        "       spherical_trig --headless --coverage eixos.csv [--grid graus] [--fov graus]\n"
+        "                               [--region az0,az1,el0,el1] [--raster mapa.sphcov] [--image mapa.ppm]\n"
+        "entrada: t,azT,elT,azR,elR (graus) | saída: t,J (graus)\n");
+}
+
+/** Estado do replay: saída, memória temporária de um bloco e estatísticas de trilha. */
+typedef struct ReplayState {
+    SphPool *pool;
+    SphArena *arena;
+    OutBuffer *out;
+    TelemetryFormat outFmt;
+    int havePrev;
+    SphVec3 prev;    ///< Último vetor T do bloco anterior
+    double pathRad;  ///< Comprimento do caminho de T sobre a esfera (soma dos arcos)
+    float minJ, maxJ;
+} ReplayState;
+
+/**
+ * \brief Arco entre dois vetores unitários pela corda: \f$2\arcsin(|a - b|/2)\f$.
+ *
+ * Entre amostras consecutivas o arco é minúsculo, e \c acosf do produto
+ * escalar (próximo de 1) acumularia ruído de arredondamento na soma.
+ */
+static double ChordArc(SphVec3 a, SphVec3 b) {
+    double dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+    double h = 0.5 * sqrt(dx*dx + dy*dy + dz*dz);
+    return 2.0 * asin(h < 1.0 ? h : 1.0);
+}
+
+static int ReplayChunk(const TrackLogChunk *c, void *user) {
+    ReplayState *st = user;
+    size_t n = c->count;
+    float *J = SPH_ARENA_NEW(st->arena, float, n);
+    float *x = SPH_ARENA_NEW(st->arena, float, n);
+    float *y = SPH_ARENA_NEW(st->arena, float, n);
+    float *z = SPH_ARENA_NEW(st->arena, float, n);
+    if (!J || !x || !y || !z) {
+        fprintf(stderr, "replay: sem memória para um bloco de %zu registros\n", n);
+        return -1;
+    }
+    // As colunas do arquivo mapeado vão direto para os kernels (sem cópia)
+    SphParallelAngleJPaired(st->pool, c->azT, c->elT, c->azR, c->elR, n, J);
+    SphBatchAzElToVec(c->azT, c->elT, n, x, y, z);
+
+    // Arcos de grande círculo entre amostras consecutivas de T
+    if (n > 0) {
+        if (st->havePrev) {
+            SphVec3 cur = { x[0], y[0], z[0] };
+            st->pathRad += ChordArc(st->prev, cur);
+        }
+        double path = 0.0;
+        for (size_t i = 1; i < n; ++i) {
+            SphVec3 a = { x[i - 1], y[i - 1], z[i - 1] };
+            SphVec3 b = { x[i], y[i], z[i] };
+            path += ChordArc(a, b);
+        }
+        st->pathRad += path;
+        st->prev = (SphVec3){ x[n - 1], y[n - 1], z[n - 1] };
+        st->havePrev = 1;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        float j = J[i] * kRad2Deg;
+        st->minJ = fminf(st->minJ, j);
+        st->maxJ = fmaxf(st->maxJ, j);
+        if (st->outFmt == TELEMETRY_BINARY) WriteBinary(st->out, c->t[i], j);
+        else WriteCsv(st->out, c->t[i], j);
+    }
+    SphArenaReset(st->arena);
+    return 0;
+}
+
+static int RunReplay(const char *path, TelemetryFormat outFmt, OutBuffer *out, SphPool *pool,
+                     SphArena *arena) {
+    TrackLog *log = TrackLogOpen(path);
+    if (!log) return 1;
+    ReplayState st;
+    memset(&st, 0, sizeof st);
+    st.pool = pool;
+    st.arena = arena;
+    st.out = out;
+    st.outFmt = outFmt;
+    st.minJ = INFINITY;
+    st.maxJ = -INFINITY;
+    int rc = TrackLogReplay(log, ReplayChunk, &st);
+    OutFlush(out);
+    fprintf(stderr, "replay: %zu registros, J em [%.3f°, %.3f°], caminho de T = %.3f°\n",
+            TrackLogCount(log), st.minJ, st.maxJ, st.pathRad * kRad2Deg);
+    TrackLogClose(log);
+    return rc ? 1 : 0;
+}
+
+static int RunConvert(TelemetryReader *reader, const char *path) {
+    TrackLogWriter *w = TrackLogCreate(path, 0);
+    if (!w) return 1;
+    size_t total = 0;
+    int rc = 0;
+    const TelemetryBatch *b;
+    while (rc == 0 && (b = TelemetryNext(reader)) != NULL) {
+        for (size_t i = 0; i < b->count && rc == 0; ++i) {
+            rc = TrackLogAppend(w, b->t[i], b->azT[i] * kDeg2Rad, b->elT[i] * kDeg2Rad,
+                                b->azR[i] * kDeg2Rad, b->elR[i] * kDeg2Rad);
+        }
+        total += b->count;
+    }
+    if (TrackLogFinish(w) != 0) rc = -1;
+    fprintf(stderr, "convert: %zu registros gravados em %s%s\n", total, path, rc ? " (erro de escrita)" : "");
+    return rc ? 1 : 0;
+}
+
+/** Laço ao vivo: um lote por vez, com os temporários na arena. */
+static int RunLive(TelemetryReader *reader, TelemetryFormat outFmt, OutBuffer *out, SphPool *pool,
+                   SphArena *arena) {
+    size_t total = 0;
+    int rc = 0;
+    const TelemetryBatch *b;
+    while ((b = TelemetryNext(reader)) != NULL) {
+        size_t n = b->count;
+        float *azT = SPH_ARENA_NEW(arena, float, n), *elT = SPH_ARENA_NEW(arena, float, n);
+        float *azR = SPH_ARENA_NEW(arena, float, n), *elR = SPH_ARENA_NEW(arena, float, n);
+        float *J = SPH_ARENA_NEW(arena, float, n);
+        if (!azT || !elT || !azR || !elR || !J) {
+            fprintf(stderr, "headless: sem memória para um lote de %zu registros\n", n);
+            rc = 1;
+            break;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            azT[i] = b->azT[i] * kDeg2Rad; elT[i] = b->elT[i] * kDeg2Rad;
+            azR[i] = b->azR[i] * kDeg2Rad; elR[i] = b->elR[i] * kDeg2Rad;
+        }
+        SphParallelAngleJPaired(pool, azT, elT, azR, elR, n, J);
+        if (outFmt == TELEMETRY_BINARY) {
+            for (size_t i = 0; i < n; ++i) WriteBinary(out, b->t[i], J[i] * kRad2Deg);
+        } else {
+            for (size_t i = 0; i < n; ++i) WriteCsv(out, b->t[i], J[i] * kRad2Deg);
+        }
+        // Com entrada ao vivo, cada lote sai imediatamente (latência de um lote)
+        OutFlush(out);
+        fflush(out->f);
+        total += n;
+        SphArenaReset(arena);
+    }
+    OutFlush(out);
+    fprintf(stderr, "headless: %zu registros processados, %zu descartados\n", total, TelemetryErrors(reader));
+    return rc;
+}
+
+/** Publicador: J calculado uma vez por lote e enviado a todos os assinantes (veja state_server.h). */
+static int RunPublish(TelemetryReader *reader, StateServer *server, SphPool *pool, SphArena *arena) {
+    size_t total = 0;
+    int rc = 0;
+    const TelemetryBatch *b;
+    while ((b = TelemetryNext(reader)) != NULL) {
+        size_t n = b->count;
+        float *azT = SPH_ARENA_NEW(arena, float, n), *elT = SPH_ARENA_NEW(arena, float, n);
+        float *azR = SPH_ARENA_NEW(arena, float, n), *elR = SPH_ARENA_NEW(arena, float, n);
+        float *J = SPH_ARENA_NEW(arena, float, n);
+        if (!azT || !elT || !azR || !elR || !J) {
+            fprintf(stderr, "publish: sem memória para um lote de %zu registros\n", n);
+            rc = 1;
+            break;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            azT[i] = b->azT[i] * kDeg2Rad; elT[i] = b->elT[i] * kDeg2Rad;
+            azR[i] = b->azR[i] * kDeg2Rad; elR[i] = b->elR[i] * kDeg2Rad;
+        }
+        SphParallelAngleJPaired(pool, azT, elT, azR, elR, n, J);
+        for (size_t i = 0; i < n; ++i) {
+            StateSample s = { b->t[i], b->azT[i], b->elT[i], b->azR[i], b->elR[i], J[i] * kRad2Deg };
+            StateServerPublish(server, &s); // fila cheia: descartado e contado
+        }
+        total += n;
+        SphArenaReset(arena);
+    }
+    fprintf(stderr, "publish: %zu registros, %zu descartados na entrada, %llu na fila, "
+                    "%d clientes, %llu ressincronizações\n",
+            total, TelemetryErrors(reader), (unsigned long long)StateServerOverruns(server),
+            StateServerClients(server), (unsigned long long)StateServerResyncs(server));
+    return rc;
+}
+
+int RunHeadless(int argc, char **argv) {
+    const char *uri = "-";
+    TelemetryFormat inFmt = TELEMETRY_CSV, outFmt = TELEMETRY_CSV;
+    size_t batch = 0;
+    const char *convertPath = NULL, *replayPath = NULL, *publishBind = NULL;
+    int threads = 1, publishHz = 0;
+    CoverageOptions cov = { NULL, 0.1f, 15.0f, 0, { 0 }, NULL, NULL };
+    for (int i = 0; i < argc; ++i) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(a, "--in") == 0 && v) { uri = v; ++i; }
+        else if (strcmp(a, "--format") == 0 && v) { if (!ParseFormat(v, &inFmt)) return 2; ++i; }
+        else if (strcmp(a, "--out-format") == 0 && v) { if (!ParseFormat(v, &outFmt)) return 2; ++i; }
+        else if (strcmp(a, "--batch") == 0 && v) {
+            long n;
+            if (!ParseLong(a, v, 1, (long)TELEMETRY_MAX_BATCH, &n)) return 2;
+            batch = (size_t)n;
+            ++i;
+        }
+        else if (strcmp(a, "--convert") == 0 && v) { convertPath = v; ++i; }
+        else if (strcmp(a, "--replay") == 0 && v) { replayPath = v; ++i; }
+        else if (strcmp(a, "--threads") == 0 && v) {
+            long n;
+            if (!ParseLong(a, v, 0, 1024, &n)) return 2;
+            threads = (int)n;
+            ++i;
+        }
+        else if (strcmp(a, "--publish") == 0 && v) { publishBind = v; ++i; }
+        else if (strcmp(a, "--publish-hz") == 0 && v) {
+            long n;
+            if (!ParseLong(a, v, 1, 10000, &n)) return 2;
+            publishHz = (int)n;
+            ++i;
+        }
+        else if (strcmp(a, "--coverage") == 0 && v) { cov.axesPath = v; ++i; }
+        else if (strcmp(a, "--grid") == 0 && v) {
+            // 1e-4° já dá 3.6 milhões de colunas na esfera inteira
+            if (!ParseFloat(a, v, 1e-4f, 180.0f, &cov.stepDeg)) { PrintUsage(); return 2; }
+            ++i;
+        }
+        else if (strcmp(a, "--fov") == 0 && v) {
+            if (!ParseFloat(a, v, 0.0f, 180.0f, &cov.fovHalfDeg)) { PrintUsage(); return 2; }
+            ++i;
+        }
+        else if (strcmp(a, "--region") == 0 && v) {
+            cov.haveRegion = sscanf(v, "%f,%f,%f,%f", &cov.region[0], &cov.region[1], &cov.region[2], &cov.region[3]) == 4;
+            if (!cov.haveRegion) { PrintUsage(); return 2; }
+            ++i;
+        }
+        else if (strcmp(a, "--raster") == 0 && v) { cov.rasterPath = v; ++i; }
+        else if (strcmp(a, "--image") == 0 && v) { cov.imagePath = v; ++i; }
+        else { PrintUsage(); return 2; }
+    }
+
+    SphBufferPool *buffers = SphBufferPoolCreate();
+    SphArena *arena = SphArenaCreate(0);
+    OutBuffer out = { SphBufferPoolAcquire(buffers, HEADLESS_OUT_BYTES), 0, stdout };
+    // Com --threads 1 (padrão) o pool é NULL e tudo roda na thread atual
+    SphPool *pool = threads != 1 ? SphPoolCreate(threads) : NULL;
+    int rc = 1;
+    if (buffers && arena && out.data) {
+        if (cov.axesPath) {
+            rc = CoverageRun(&cov, pool);
+        } else if (replayPath) {
+            rc = RunReplay(replayPath, outFmt, &out, pool, arena);
+        } else {
+            TelemetryReader *reader = TelemetryOpen(uri, inFmt, batch, buffers);
+            StateServer *server = reader && publishBind ? StateServerStart(publishBind, publishHz) : NULL;
+            if (reader && (server || !publishBind)) {
+                rc = convertPath ? RunConvert(reader, convertPath)
+                     : server    ? RunPublish(reader, server, pool, arena)
+                                 : RunLive(reader, outFmt, &out, pool, arena);
+            }
+            StateServerStop(server);
+            if (reader) TelemetryClose(reader);
+        }
+    }
+    SphPoolDestroy(pool);
+    SphBufferPoolRelease(buffers, out.data);
+    SphBufferPoolDestroy(buffers);
+    SphArenaDestroy(arena);
+    return rc;
+}
@@ -0,0 +1,34 @@
+/**
+ * \file headless.h
+ * \brief Modo sem janela (headless) do \c spherical_trig: telemetria Az/El -> J.
+ */
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+/**
+ * \brief Executa o modo headless (nenhuma chamada à Raylib, sem \c InitWindow).
+ *
+ * Opções reconhecidas:
+ * - \c --in \<uri\>        fonte: \c "-" (stdin, padrão), arquivo ou \c udp://[end]:porta
+ * - \c --format csv|bin   formato de entrada (padrão: csv)
+ * - \c --out-format csv|bin formato de saída (padrão: csv)
+ * - \c --batch \<n\>       registros por lote (padrão: 65536)
+ * - \c --convert \<log\>    grava a entrada em um log colunar (\ref tracklog.h) em vez de calcular J
+ * - \c --replay \<log\>     processa um log colunar via \c mmap (ignora \c --in)
+ * - \c --threads \<n\>      threads para o cálculo de J (padrão: 1; 0 = todos os núcleos)
+ * - \c --publish [end:]porta em vez de escrever em stdout, publica (t, ângulos, J) por TCP
+ *   para os visualizadores \c --subscribe (veja \ref state_server.h), em \c --publish-hz
+ *   \<n\> lotes de deltas por segundo (padrão: 50)
+ * - \c --coverage \<csv\>    mapa de cobertura dos eixos do arquivo (veja \ref CoverageRun), com
+ *   \c --grid \<graus\> (padrão: 0.1), \c --fov \<graus\> (semiângulo, padrão: 15),
+ *   \c --region az0,az1,el0,el1, \c --raster \<arquivo.sphcov\> e \c --image \<arquivo.ppm\>
+ *
+ * A saída vai para stdout: em CSV, uma linha \c "t,J" por registro (J em
+ * graus); em binário, registros de 12 bytes (\c double t, \c float J).
+ *
+ * \param argc,argv Argumentos após \c --headless.
+ * \return Código de saída do processo.
+ */
+int RunHeadless(int argc, char **argv);
+
+#endif /* HEADLESS_H */
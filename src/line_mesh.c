@@ -0,0 +1,117 @@
+/**
+ * \file line_mesh.c
+ * \brief Implementação da malha de linhas em lote.
+ */
+#include "line_mesh.h"
+
+#include "raymath.h"
+#include "rlgl.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+void LineMeshClear(LineMesh *mesh) {
+    mesh->count = 0;
+}
+
+void LineMeshAdd(LineMesh *mesh, Vector3 a, Vector3 b, Color color) {
+    if (mesh->count + 2 > mesh->capacity) {
+        int cap = mesh->capacity ? mesh->capacity * 2 : 256;
+        Vector3 *v = realloc(mesh->vertices, (size_t)cap * sizeof *v);
+        Color *c = realloc(mesh->colors, (size_t)cap * sizeof *c);
+        if (v) mesh->vertices = v;
+        if (c) mesh->colors = c;
+        if (!v || !c) return;
+        mesh->capacity = cap;
+    }
+    mesh->vertices[mesh->count] = a;
+    mesh->colors[mesh->count++] = color;
+    mesh->vertices[mesh->count] = b;
+    mesh->colors[mesh->count++] = color;
+}
+
+void LineMeshDraw(const LineMesh *mesh) {
+    if (mesh->count == 0) return;
+    // Garante espaço no lote atual (descarrega antes, se necessário)
+    rlCheckRenderBatchLimit(mesh->count);
+    rlBegin(RL_LINES);
+    for (int i = 0; i < mesh->count; ++i) {
+        Color c = mesh->colors[i];
+        rlColor4ub(c.r, c.g, c.b, c.a);
+        rlVertex3f(mesh->vertices[i].x, mesh->vertices[i].y, mesh->vertices[i].z);
+    }
+    rlEnd();
+}
+
+void LineMeshFree(LineMesh *mesh) {
+    free(mesh->vertices);
+    free(mesh->colors);
+    mesh->vertices = NULL;
+    mesh->colors = NULL;
+    mesh->count = mesh->capacity = 0;
+}
+
+/** Direção da largura da fita: a × b, ou qualquer perpendicular se o segmento passa pela origem. */
+static Vector3 RibbonSide(Vector3 a, Vector3 b) {
+    Vector3 n = Vector3CrossProduct(a, b);
+    if (Vector3Length(n) < 1e-6f) {
+        Vector3 d = Vector3Subtract(b, a);
+        n = Vector3CrossProduct(d, fabsf(d.z) < 0.9f ? (Vector3){ 0, 0, 1 } : (Vector3){ 1, 0, 0 });
+    }
+    return Vector3Normalize(n);
+}
+
+int LineMeshUpload(LineMeshGpu *gpu, const LineMesh *lines, float halfWidth) {
+    memset(gpu, 0, sizeof *gpu);
+    const int segs = lines->count / 2;
+    if (segs == 0) return -1;
+    Mesh m = { 0 };
+    m.vertexCount = segs * 6;
+    m.triangleCount = segs * 2;
+    m.vertices = MemAlloc((unsigned)m.vertexCount * 3 * sizeof *m.vertices);
+    m.colors = MemAlloc((unsigned)m.vertexCount * 4 * sizeof *m.colors);
+    if (!m.vertices || !m.colors) {
+        MemFree(m.vertices);
+        MemFree(m.colors);
+        return -1;
+    }
+    for (int s = 0; s < segs; ++s) {
+        const Vector3 a = lines->vertices[2*s], b = lines->vertices[2*s + 1];
+        const Color ca = lines->colors[2*s], cb = lines->colors[2*s + 1];
+        const Vector3 w = Vector3Scale(RibbonSide(a, b), halfWidth);
+        // Dois triângulos: (a-, b-, b+) e (a-, b+, a+), na ordem do gabarito de ArcBatch
+        const Vector3 v[6] = { Vector3Subtract(a, w), Vector3Subtract(b, w), Vector3Add(b, w),
+                               Vector3Subtract(a, w), Vector3Add(b, w), Vector3Add(a, w) };
+        const Color c[6] = { ca, cb, cb, ca, cb, ca };
+        for (int k = 0; k < 6; ++k) {
+            float *p = m.vertices + (size_t)(6*s + k) * 3;
+            unsigned char *q = m.colors + (size_t)(6*s + k) * 4;
+            p[0] = v[k].x; p[1] = v[k].y; p[2] = v[k].z;
+            q[0] = c[k].r; q[1] = c[k].g; q[2] = c[k].b; q[3] = c[k].a;
+        }
+    }
+    UploadMesh(&m, false);
+    gpu->mesh = m;
+    gpu->material = LoadMaterialDefault();
+    gpu->ready = 1;
+    return 0;
+}
+
+void LineMeshGpuDraw(const LineMeshGpu *gpu) {
+    if (!gpu->ready) return;
+    // O lote pendente da rlgl sai antes, para manter a ordem de desenho
+    rlDrawRenderBatchActive();
+    rlDisableBackfaceCulling();
+    DrawMesh(gpu->mesh, gpu->material, MatrixIdentity());
+    rlEnableBackfaceCulling();
+}
+
+void LineMeshGpuUnload(LineMeshGpu *gpu) {
+    if (gpu->ready) {
+        // Libera também as cópias de CPU (vertices/colors)
+        UnloadMesh(gpu->mesh);
+        UnloadMaterial(gpu->material);
+    }
+    memset(gpu, 0, sizeof *gpu);
+}
@@ -0,0 +1,73 @@
+/**
+ * \file line_mesh.h
+ * \brief Malha de linhas pré-calculada, desenhada em um único lote da Raylib.
+ *
+ * Em vez de recalcular senos/cossenos e chamar \c DrawLine3D por segmento,
+ * guardamos os vértices e cores uma vez e os enviamos todos juntos entre um
+ * único \c rlBegin(RL_LINES) / \c rlEnd(): a Raylib os agrupa em uma só
+ * chamada de desenho. É o caminho das linhas que mudam (arcos da cena).
+ *
+ * A geometria estática (esfera aramada, equador) não muda de um quadro para
+ * o outro: \ref LineMeshUpload a converte em fitas finas e a deixa na GPU
+ * (um VAO com posições e cores), e \ref LineMeshGpuDraw a desenha com uma
+ * chamada, sem reenviar nenhum vértice.
+ */
+#ifndef LINE_MESH_H
+#define LINE_MESH_H
+
+#include "raylib.h"
+
+/**
+ * \brief Lista de segmentos (dois vértices por segmento) com cor por vértice.
+ */
+typedef struct LineMesh {
+    Vector3 *vertices;
+    Color *colors;
+    int count;     ///< Quantidade de vértices (2 por segmento).
+    int capacity;
+} LineMesh;
+
+/** \brief Esvazia a malha mantendo a memória alocada. */
+void LineMeshClear(LineMesh *mesh);
+
+/** \brief Acrescenta um segmento de \c a até \c b. */
+void LineMeshAdd(LineMesh *mesh, Vector3 a, Vector3 b, Color color);
+
+/** \brief Envia todos os segmentos em um único lote \c RL_LINES. */
+void LineMeshDraw(const LineMesh *mesh);
+
+/** \brief Libera a memória da malha. */
+void LineMeshFree(LineMesh *mesh);
+
+/**
+ * \brief Malha de linhas residente na GPU (geometria estática).
+ *
+ * Como em \ref ArcBatch, o desenho instanciado e as malhas da rlgl só aceitam
+ * triângulos: cada segmento vira uma fita de dois triângulos, com a largura
+ * ao longo de \f$a \times b\f$ (perpendicular ao segmento e tangente à
+ * esfera centrada na origem).
+ */
+typedef struct LineMeshGpu {
+    Mesh mesh;          ///< 6 vértices por segmento, com cor por vértice.
+    Material material;  ///< Material padrão (o shader usa a cor dos vértices).
+    int ready;          ///< 1 depois de um \ref LineMeshUpload bem-sucedido.
+} LineMeshGpu;
+
+/**
+ * \brief Converte os segmentos de \c lines em fitas e os envia à GPU, uma vez.
+ *
+ * Precisa ser chamada depois de \c InitWindow. \c lines pode ser liberada
+ * depois: a malha da GPU guarda a sua própria cópia.
+ *
+ * \param halfWidth Meia largura das fitas (unidades do mundo).
+ * \return 0, ou -1 se faltou memória ou a malha está vazia.
+ */
+int LineMeshUpload(LineMeshGpu *gpu, const LineMesh *lines, float halfWidth);
+
+/** \brief Desenha a malha da GPU com uma chamada (dentro de \c BeginMode3D). */
+void LineMeshGpuDraw(const LineMeshGpu *gpu);
+
+/** \brief Libera os buffers da GPU (seguro em uma malha não enviada). */
+void LineMeshGpuUnload(LineMeshGpu *gpu);
+
+#endif /* LINE_MESH_H */
@@ -0,0 +1,91 @@
+/**
+ * \file live_feed.c
+ * \brief Implementação da thread de ingestão que alimenta a fila SPSC.
+ *
+ * A thread de ingestão é a única produtora da fila e só ela chama
+ * \ref TelemetryNext. Lotes pequenos (\ref LIVE_FEED_BATCH) mantêm a latência
+ * de um registro até o laço baixa: o leitor publica um lote assim que não há
+ * mais dados imediatos na fonte.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "live_feed.h"
+
+#include "spsc_ring.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LIVE_FEED_BATCH 256
+
+struct LiveFeed {
+    TelemetryReader *reader;
+    SpscRing *ring;
+    pthread_t thread;
+    _Atomic uint64_t received;
+    _Atomic int ended;
+};
+
+static void *IngestThread(void *arg) {
+    LiveFeed *f = arg;
+    const TelemetryBatch *b;
+    while ((b = TelemetryNext(f->reader)) != NULL) {
+        for (size_t i = 0; i < b->count; ++i) {
+            LiveSample s = { b->t[i], b->azT[i], b->elT[i], b->azR[i], b->elR[i] };
+            SpscRingPush(f->ring, &s); // fila cheia: descartado e contado como overrun
+        }
+        atomic_fetch_add_explicit(&f->received, b->count, memory_order_relaxed);
+    }
+    atomic_store(&f->ended, 1);
+    return NULL;
+}
+
+LiveFeed *LiveFeedStart(const char *uri, TelemetryFormat format) {
+    LiveFeed *f = calloc(1, sizeof *f);
+    if (!f) return NULL;
+    atomic_init(&f->received, 0);
+    atomic_init(&f->ended, 0);
+    f->ring = SpscRingCreate(sizeof(LiveSample), LIVE_FEED_RING);
+    f->reader = f->ring ? TelemetryOpen(uri, format, LIVE_FEED_BATCH, NULL) : NULL;
+    if (!f->reader) {
+        SpscRingDestroy(f->ring);
+        free(f);
+        return NULL;
+    }
+    if (pthread_create(&f->thread, NULL, IngestThread, f) != 0) {
+        fprintf(stderr, "ao vivo: não foi possível criar a thread de ingestão\n");
+        TelemetryClose(f->reader);
+        SpscRingDestroy(f->ring);
+        free(f);
+        return NULL;
+    }
+    return f;
+}
+
+size_t LiveFeedDrain(LiveFeed *f, LiveSample *out, size_t max) {
+    return SpscRingPop(f->ring, out, max);
+}
+
+uint64_t LiveFeedReceived(const LiveFeed *f) {
+    return atomic_load_explicit(&((LiveFeed *)f)->received, memory_order_relaxed);
+}
+
+uint64_t LiveFeedOverruns(const LiveFeed *f) {
+    return SpscRingOverruns(f->ring);
+}
+
+int LiveFeedEnded(const LiveFeed *f) {
+    return atomic_load(&((LiveFeed *)f)->ended);
+}
+
+void LiveFeedStop(LiveFeed *f) {
+    if (!f) return;
+    // Acorda a ingestão se ela estiver esperando dados em TelemetryNext
+    TelemetryInterrupt(f->reader);
+    pthread_join(f->thread, NULL);
+    TelemetryClose(f->reader);
+    SpscRingDestroy(f->ring);
+    free(f);
+}
@@ -0,0 +1,58 @@
+/**
+ * \file live_feed.h
+ * \brief Telemetria ao vivo para o laço de renderização: thread de ingestão e fila SPSC.
+ *
+ * O laço de renderização fica parado em \c EndDrawing esperando o vsync; se
+ * ele mesmo lesse a rede, cada rajada de pacotes esperaria até 16 ms. Aqui
+ * uma thread de ingestão lê a fonte (\ref TelemetryOpen) e empilha cada
+ * registro em uma \ref SpscRing; o laço desempilha tudo o que chegou uma vez
+ * por quadro, sem locks (\ref LiveFeedDrain). Se a fila encher, os registros
+ * novos são descartados e contados (\ref LiveFeedOverruns).
+ */
+#ifndef LIVE_FEED_H
+#define LIVE_FEED_H
+
+#include "telemetry.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Capacidade da fila entre a ingestão e o laço (registros). */
+#define LIVE_FEED_RING 65536
+
+/** Um registro de telemetria (ângulos em graus, como em \ref TelemetryBatch). */
+typedef struct LiveSample {
+    double t;
+    float azT, elT;
+    float azR, elR;
+} LiveSample;
+
+/** Fonte ao vivo opaca. */
+typedef struct LiveFeed LiveFeed;
+
+/**
+ * \brief Abre a fonte e inicia a thread de ingestão.
+ * \param uri,format Como em \ref TelemetryOpen.
+ * \return Fonte, ou NULL em caso de erro (mensagem em stderr).
+ */
+LiveFeed *LiveFeedStart(const char *uri, TelemetryFormat format);
+
+/**
+ * \brief Desempilha até \c max registros, em ordem de chegada (só a thread de renderização).
+ * \return Quantidade de registros copiados para \c out.
+ */
+size_t LiveFeedDrain(LiveFeed *feed, LiveSample *out, size_t max);
+
+/** \brief Registros recebidos da fonte (incluindo os descartados). */
+uint64_t LiveFeedReceived(const LiveFeed *feed);
+
+/** \brief Registros descartados porque a fila estava cheia. */
+uint64_t LiveFeedOverruns(const LiveFeed *feed);
+
+/** \brief 1 se a fonte terminou (fim do arquivo ou erro). */
+int LiveFeedEnded(const LiveFeed *feed);
+
+/** \brief Encerra a thread de ingestão e libera a fonte. */
+void LiveFeedStop(LiveFeed *feed);
+
+#endif /* LIVE_FEED_H */
@@ -29,12 +29,47 @@
  * - Alvo (T): A/D = Az −/+  |  W/S = El +/−
  * - Eixo (R): J/L = Az −/+  |  I/K = El +/−
  * - Reset: R
+ * - Visão com muitos alvos (instanciada): M
+ * - Mapa de cobertura do FOV de R sobre a esfera: C
  * - Mouse (botão direito): orbitar câmera  |  Scroll: FOV
+ *
+ * Com \c --headless, o programa não abre janela: lê registros de telemetria
+ * (stdin, arquivo ou UDP) e escreve J para cada um (veja \ref RunHeadless).
+ *
+ * Com \c --export \<lista.csv\>, cada cena da lista é desenhada fora da tela
+ * e gravada em PNG (veja \ref frame_export.h).
+ *
+ * Com \c --live \<uri\> [\c --live-format csv|bin], T e R seguem uma fonte
+ * de telemetria ao vivo, lida por uma thread de ingestão (veja \ref live_feed.h).
+ *
+ * Com \c --subscribe \<end:porta\>, T, R e J vêm de um publicador
+ * (\c --headless \c --publish, veja \ref state_server.h): vários consoles
+ * mostram o mesmo estado, calculado uma vez no nó de ingestão.
+ *
+ * Com \c --sim-log \<arquivo.csv\>, J de cada passo de 1 kHz da simulação
+ * (e não só o do último passo de cada quadro) é gravado em \c t,J (veja
+ * \ref SimLoopSetSink).
  */
 #include "raylib.h"
 #include "raymath.h"
+#include "arc_lod.h"
+#include "coverage_view.h"
+#include "frame_export.h"
+#include "frame_profiler.h"
+#include "headless.h"
+#include "line_mesh.h"
+#include "live_feed.h"
+#include "multi_target.h"
+#include "sim_loop.h"
+#include "spherical.h"
+#include "spherical_arena.h"
+#include "state_client.h"
+#include "text_cache.h"
 #include <math.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -42,14 +77,23 @@
 
 static float deg2rad(float d) { return d * (float)M_PI / 180.0f; }
 
+// Conversões entre o Vector3 da Raylib e o SphVec3 da biblioteca (mesmo layout)
+static inline SphVec3 ToSphVec3(Vector3 v) { return (SphVec3){ v.x, v.y, v.z }; }
+static inline Vector3 ToVector3(SphVec3 v) { return (Vector3){ v.x, v.y, v.z }; }
+
+// Modo de precisão do ângulo J no HUD (ACOSF, ACOSD ou ATAN2; veja SPH_ANGLE_FN)
+#ifndef APP_ANGLE_MODE
+#define APP_ANGLE_MODE ATAN2
+#endif
+
 // Forward declaration (usada antes da definição)
 static Vector3 AzElToVec(float az, float el);
 
 /**
- * \brief Desenha um arco de azimute no plano do horizonte (El=0) de az0 até az1.
+ * \brief Gera um arco de azimute no plano do horizonte (El=0) de az0 até az1,
+ *        com \c steps segmentos.
  */
-static void DrawAzimuthArc(float az0, float az1, Color color) {
-    int steps = 64;
+static void BuildAzimuthArc(LineMesh *mesh, float az0, float az1, int steps, Color color) {
     float r = 1.001f; // levemente acima da esfera para evitar z-fighting
     float a0 = az0, a1 = az1;
     // manter direção (se az1 < az0, desenha no sentido negativo)
@@ -60,58 +104,56 @@ static void DrawAzimuthArc(float az0, float az1, Color color) {
         float aB = a0 + (a1 - a0)*t1;
         Vector3 pA = (Vector3){ r*cosf(aA), r*sinf(aA), 0.0f };
         Vector3 pB = (Vector3){ r*cosf(aB), r*sinf(aB), 0.0f };
-        DrawLine3D(pA, pB, color);
+        LineMeshAdd(mesh, pA, pB, color);
     }
 }
 
 /**
- * \brief Desenha um arco de elevação, para az fixo, de 0 até el.
+ * \brief Gera um arco de elevação, para az fixo, de 0 até el.
+ *
+ * A quantidade de segmentos vem de \ref ArcLodSteps (ângulo e tamanho na tela);
+ * os pontos são calculados em lote, com os arranjos temporários na arena do quadro.
  */
-static void DrawElevationArc(float az, float el, Color color) {
-    int steps = 32;
+static void BuildElevationArc(LineMesh *mesh, SphArena *frame, const ArcLod *lod, float az, float el, Color color) {
     float r = 1.001f;
-    for (int i = 0; i < steps; ++i) {
-        float t0 = (float)i/steps;
-        float t1 = (float)(i+1)/steps;
-        float eA = 0.0f + (el - 0.0f)*t0;
-        float eB = 0.0f + (el - 0.0f)*t1;
-        Vector3 pA = AzElToVec(az, eA);
-        Vector3 pB = AzElToVec(az, eB);
-        pA = Vector3Scale(pA, r);
-        pB = Vector3Scale(pB, r);
-        DrawLine3D(pA, pB, color);
+    int steps = ArcLodSteps(lod, el, r, Vector3Scale(AzElToVec(az, 0.5f*el), r));
+    float *azs = SPH_ARENA_NEW(frame, float, steps + 1), *els = SPH_ARENA_NEW(frame, float, steps + 1);
+    float *x = SPH_ARENA_NEW(frame, float, steps + 1), *y = SPH_ARENA_NEW(frame, float, steps + 1);
+    float *z = SPH_ARENA_NEW(frame, float, steps + 1);
+    if (!azs || !els || !x || !y || !z) return;
+    for (int i = 0; i <= steps; ++i) {
+        azs[i] = az;
+        els[i] = el*(float)i/steps;
+    }
+    SphBatchAzElToVec(azs, els, (size_t)steps + 1, x, y, z);
+    for (int i = 1; i <= steps; ++i) {
+        LineMeshAdd(mesh, (Vector3){ r*x[i - 1], r*y[i - 1], r*z[i - 1] }, (Vector3){ r*x[i], r*y[i], r*z[i] }, color);
     }
 }
 
 /**
  * \brief Slerp (interpolação esférica) entre dois vetores unitários.
+ *
+ * Ponte para \ref SphSlerpUnit da biblioteca \c spherical_core.
  */
 static Vector3 SlerpUnit(Vector3 a, Vector3 b, float t) {
-    float dot = a.x*b.x + a.y*b.y + a.z*b.z;
-    if (dot > 1.0f) dot = 1.0f; else if (dot < -1.0f) dot = -1.0f;
-    float theta = acosf(dot);
-    if (theta < 1e-5f) return a; // quase iguais
-    float s = sinf(theta);
-    float w0 = sinf((1.0f - t)*theta)/s;
-    float w1 = sinf(t*theta)/s;
-    Vector3 r0 = Vector3Scale(a, w0);
-    Vector3 r1 = Vector3Scale(b, w1);
-    return Vector3Add(r0, r1);
+    return ToVector3(SphSlerpUnit(ToSphVec3(a), ToSphVec3(b), t));
 }
 
 /**
- * \brief Desenha o arco de grande círculo entre dois vetores unitários (ângulo j).
+ * \brief Gera o arco de grande círculo entre dois vetores unitários (ângulo j).
  */
-static void DrawGreatCircleArc(Vector3 a, Vector3 b, Color color) {
-    int steps = 64;
-    float r = 1.002f;
-    Vector3 prev = Vector3Scale(a, r);
+static void BuildGreatCircleArc(LineMesh *mesh, SphArena *frame, const ArcLod *lod, Vector3 a, Vector3 b, Color color) {
+    const float r = 1.002f;
+    SphArcPlan plan = SphArcPrepare(ToSphVec3(a), ToSphVec3(b));
+    SphVec3 mid = SphArcPoint(&plan, 0.5f);
+    int steps = ArcLodSteps(lod, plan.theta, r, Vector3Scale(ToVector3(mid), r));
+    SphVec3 *pts = SPH_ARENA_NEW(frame, SphVec3, steps + 1);
+    if (!pts) return;
+    // θ e 1/sin θ uma vez por arco (antes: um acos e um sin por ponto)
+    SphGreatCircleArcPoints(ToSphVec3(a), ToSphVec3(b), steps, r, pts);
     for (int i = 1; i <= steps; ++i) {
-        float t = (float)i/steps;
-        Vector3 cur = SlerpUnit(a, b, t);
-        cur = Vector3Scale(cur, r);
-        DrawLine3D(prev, cur, color);
-        prev = cur;
+        LineMeshAdd(mesh, ToVector3(pts[i - 1]), ToVector3(pts[i]), color);
     }
 }
 static float rad2deg(float r) { return r * 180.0f / (float)M_PI; }
@@ -130,19 +172,14 @@ static float rad2deg(float r) { return r * 180.0f / (float)M_PI; }
  * - \f$z = \sin(El)\f$
  *
  * O vetor é normalizado por segurança numérica (deve ter norma 1).
+ * A implementação está em \ref SphAzElToVec (biblioteca \c spherical_core).
  *
  * \param az Azimute em radianos.
  * \param el Elevação em radianos.
  * \return Vetor 3D unitário correspondente à direção (az, el).
  */
 static Vector3 AzElToVec(float az, float el) {
-    float ce = cosf(el);
-    Vector3 v = { ce * cosf(az), ce * sinf(az), sinf(el) };
-    float n = sqrtf(v.x*v.x + v.y*v.y + v.z*v.z);
-    if (n > 0.0f) {
-        v.x /= n; v.y /= n; v.z /= n;
-    }
-    return v;
+    return ToVector3(SphAzElToVec(az, el));
 }
 
 /**
@@ -153,14 +190,17 @@ static Vector3 AzElToVec(float az, float el) {
  * um \c clamp do valor para o intervalo [-1, 1] para evitar erros numéricos
  * (por exemplo, arredondamentos que produziriam \c acos fora do domínio).
  *
+ * Perto de 0° e de 180°, porém, \c acos em float perde quase toda a precisão.
+ * Por isso o modo é escolhido na compilação por \c APP_ANGLE_MODE (veja
+ * \ref SPH_ANGLE_FN): \c ATAN2 (padrão, preciso em qualquer J), \c ACOSD
+ * (double) ou \c ACOSF (o acos em float, mais rápido).
+ *
  * \param a Vetor unitário A.
  * \param b Vetor unitário B.
  * \return Ângulo entre A e B, em radianos (intervalo [0, \f$\pi\f$]).
  */
 static float AngleBetweenUnit(Vector3 a, Vector3 b) {
-    float c = a.x*b.x + a.y*b.y + a.z*b.z;
-    if (c > 1.0f) c = 1.0f; else if (c < -1.0f) c = -1.0f;
-    return acosf(c);
+    return SPH_ANGLE_FN(SphAngleBetweenUnit, APP_ANGLE_MODE)(ToSphVec3(a), ToSphVec3(b));
 }
 
 /**
@@ -187,18 +227,20 @@ static void DrawArrow3D(Vector3 start, Vector3 end, float thickness, Color color
 }
 
 /**
- * \brief Desenha uma esfera aramada (wireframe) para referência visual.
+ * \brief Gera os segmentos de uma esfera aramada (wireframe) em uma \ref LineMesh.
  *
  * A esfera unitária é muito útil para enxergarmos cada direção (vetor unitário)
- * como um ponto na sua superfície. Aqui desenhamos "paralelos" (linhas de
+ * como um ponto na sua superfície. Aqui geramos "paralelos" (linhas de
  * elevação) e "meridianos" (linhas de azimute).
  *
+ * \param mesh Malha de destino (os segmentos são acrescentados).
  * \param radius Raio da esfera (tipicamente 1.0).
  * \param segAzi Quantidade de segmentos em azimute (meridianos).
  * \param segEle Quantidade de segmentos em elevação (paralelos).
  * \param color Cor das linhas.
  */
-static void DrawSphereWire(float radius, int segAzi, int segEle, Color color) {
+static void BuildSphereWire(LineMesh *mesh, float radius, int segAzi, int segEle, Color color) {
+    Color c = Fade(color, 0.4f);
     // Linhas de latitude (elevação)
     for (int i = 1; i < segEle; ++i) {
         float t = (float)i/segEle * (float)M_PI; // 0..pi
@@ -208,40 +250,347 @@ static void DrawSphereWire(float radius, int segAzi, int segEle, Color color) {
         for (int k = 1; k <= segAzi; ++k) {
             float a = (float)k/segAzi * 2.0f*(float)M_PI;
             Vector3 cur = (Vector3){ radius*r*cosf(a), radius*r*sinf(a), radius*z };
-            DrawLine3D(prev, cur, Fade(color, 0.4f));
+            LineMeshAdd(mesh, prev, cur, c);
             prev = cur;
         }
     }
-    // Linhas de longitude (azimute)
+    // Linhas de longitude (azimute), do polo norte (t=0) ao polo sul (t=pi)
     for (int k = 0; k < segAzi; ++k) {
         float a = (float)k/segAzi * 2.0f*(float)M_PI;
-        Vector3 prev = { radius*cosf(a), 0, 0 };
+        Vector3 prev = { 0, 0, radius };
         for (int i = 1; i <= segEle; ++i) {
             float t = (float)i/segEle * (float)M_PI;
             Vector3 cur = (Vector3){ radius*sinf(t)*cosf(a), radius*sinf(t)*sinf(a), radius*cosf(t) };
-            DrawLine3D(prev, cur, Fade(color, 0.4f));
+            LineMeshAdd(mesh, prev, cur, c);
             prev = cur;
         }
     }
 }
 
+/**
+ * \brief Parâmetros que definem a geometria estática em cache.
+ *
+ * Se algum deles mudar (por exemplo, a resolução da esfera), a malha é
+ * reconstruída; caso contrário, é apenas redesenhada.
+ */
+typedef struct StaticGeometryKey {
+    float radius;
+    int segAzi, segEle;
+    Color sphereColor, equatorColor;
+} StaticGeometryKey;
+
+/** Esfera aramada e equador: a chave com que foram gerados e a malha na GPU. */
+static struct {
+    StaticGeometryKey key;
+    LineMeshGpu gpu;
+    LineMesh cpu; ///< Caminho de reserva, se o envio à GPU falhar.
+} gStatic;
+
+/**
+ * \brief Desenha a esfera aramada e o equador a partir de uma malha em cache.
+ *
+ * Os ~1.300 segmentos são gerados e enviados à GPU uma vez (e de novo só se
+ * os parâmetros mudarem); nos outros quadros, o desenho é uma única chamada,
+ * sem senos/cossenos e sem reenviar vértices.
+ */
+static void DrawStaticGeometry(float radius, int segAzi, int segEle, Color sphereColor, Color equatorColor) {
+    StaticGeometryKey key;
+    memset(&key, 0, sizeof key);
+    key.radius = radius; key.segAzi = segAzi; key.segEle = segEle;
+    key.sphereColor = sphereColor; key.equatorColor = equatorColor;
+    if ((!gStatic.gpu.ready && gStatic.cpu.count == 0) || memcmp(&key, &gStatic.key, sizeof key) != 0) {
+        LineMeshGpuUnload(&gStatic.gpu);
+        LineMeshClear(&gStatic.cpu);
+        BuildSphereWire(&gStatic.cpu, radius, segAzi, segEle, sphereColor);
+        BuildAzimuthArc(&gStatic.cpu, 0.0f, 2.0f*(float)M_PI, 64, equatorColor);
+        // Na GPU, a cópia de CPU não é mais necessária
+        if (LineMeshUpload(&gStatic.gpu, &gStatic.cpu, 0.0015f*radius) == 0) LineMeshFree(&gStatic.cpu);
+        gStatic.key = key;
+    }
+    if (gStatic.gpu.ready) LineMeshGpuDraw(&gStatic.gpu);
+    else LineMeshDraw(&gStatic.cpu);
+}
+
+/** \brief Libera a geometria estática (antes de \c CloseWindow). */
+static void UnloadStaticGeometry(void) {
+    LineMeshGpuUnload(&gStatic.gpu);
+    LineMeshFree(&gStatic.cpu);
+}
+
+/**
+ * \brief Entradas da cena. Tudo o que é derivado delas fica em \ref SceneCache
+ *        e só é recalculado quando alguma entrada muda.
+ */
+typedef struct SceneInputs {
+    float azT_deg, elT_deg, azR_deg, elR_deg;
+    Camera3D cam;
+    int screenW, screenH;
+} SceneInputs;
+
+/** \brief Valores derivados das entradas: vetores, J, arcos e posições dos rótulos. */
+typedef struct SceneCache {
+    SceneInputs in;
+    bool valid;
+    Vector3 vT, vR;
+    float Jdeg, Jdeg_trig;
+    LineMesh arcs;                     ///< Arcos de azimute, de elevação e o arco J.
+    Vector2 sT, sR, sN, sE, sUp, sj;   ///< Rótulos projetados na tela.
+} SceneCache;
+
+/**
+ * \brief Atualiza o cache a partir das entradas do quadro.
+ *
+ * - Ângulos diferentes: refaz vetores, J, arcos e rótulos.
+ * - Só a câmera (ou o tamanho da tela) diferente: refaz arcos (nível de
+ *   detalhe) e rótulos.
+ * - Nada diferente: nenhum seno, cosseno ou acos é calculado.
+ *
+ * Os temporários da tesselação vêm de \c frame (zerada a cada quadro).
+ *
+ * \return true se algo mudou (o quadro precisa ser redesenhado).
+ */
+static bool UpdateScene(SceneCache *sc, const SceneInputs *in, SphArena *frame) {
+    const size_t anglesSize = offsetof(SceneInputs, cam);
+    bool anglesChanged = !sc->valid || memcmp(in, &sc->in, anglesSize) != 0;
+    bool viewChanged = !sc->valid || memcmp((const char *)in + anglesSize, (const char *)&sc->in + anglesSize,
+                                            sizeof *in - anglesSize) != 0;
+    if (!anglesChanged && !viewChanged) return false;
+
+    float AZ_T = deg2rad(in->azT_deg), EL_T = deg2rad(in->elT_deg);
+    float AZ_R = deg2rad(in->azR_deg), EL_R = deg2rad(in->elR_deg);
+    if (anglesChanged) {
+        sc->vT = AzElToVec(AZ_T, EL_T);
+        sc->vR = AzElToVec(AZ_R, EL_R);
+        sc->Jdeg = rad2deg(AngleBetweenUnit(sc->vT, sc->vR));
+        // Verificação forma analítica: cosJ = sin(EL_T)sin(EL_R)+cos(EL_T)cos(EL_R)cos(ΔAZ)
+        sc->Jdeg_trig = rad2deg(acosf(SphCosJ(AZ_T, EL_T, AZ_R, EL_R)));
+    }
+
+    // Arcos (o nível de detalhe depende da câmera)
+    ArcLod lod = ArcLodFromCamera(in->cam, in->screenH);
+    LineMeshClear(&sc->arcs);
+    // Arcos de azimute desde N (az=0) até AZ_T e AZ_R (no horizonte)
+    float amT = 0.5f*AZ_T, amR = 0.5f*AZ_R;
+    BuildAzimuthArc(&sc->arcs, 0.0f, AZ_T, ArcLodSteps(&lod, AZ_T, 1.001f, (Vector3){ cosf(amT), sinf(amT), 0.0f }),
+                    Fade(SKYBLUE, 0.8f));
+    BuildAzimuthArc(&sc->arcs, 0.0f, AZ_R, ArcLodSteps(&lod, AZ_R, 1.001f, (Vector3){ cosf(amR), sinf(amR), 0.0f }),
+                    Fade(ORANGE, 0.8f));
+    // Arcos de elevação ao longo dos meridianos de T e R (de 0 até EL)
+    BuildElevationArc(&sc->arcs, frame, &lod, AZ_T, EL_T, Fade(SKYBLUE, 0.8f));
+    BuildElevationArc(&sc->arcs, frame, &lod, AZ_R, EL_R, Fade(ORANGE, 0.8f));
+    // Arco do ângulo J entre T e R (grande círculo)
+    BuildGreatCircleArc(&sc->arcs, frame, &lod, sc->vT, sc->vR, YELLOW);
+
+    // Rótulos: T, R, N (AZ=0°), E (AZ=90°), Up e 'j' no ponto médio do arco
+    sc->sT = GetWorldToScreenEx(Vector3Scale(sc->vT, 1.05f), in->cam, in->screenW, in->screenH);
+    sc->sR = GetWorldToScreenEx(Vector3Scale(sc->vR, 1.05f), in->cam, in->screenW, in->screenH);
+    sc->sN = GetWorldToScreenEx((Vector3){1.05f, 0.0f, 0.0f}, in->cam, in->screenW, in->screenH);
+    sc->sE = GetWorldToScreenEx((Vector3){0.0f, 1.05f, 0.0f}, in->cam, in->screenW, in->screenH);
+    sc->sUp = GetWorldToScreenEx((Vector3){0.0f, 0.0f, 1.15f}, in->cam, in->screenW, in->screenH);
+    sc->sj = GetWorldToScreenEx(Vector3Scale(SlerpUnit(sc->vT, sc->vR, 0.5f), 1.03f), in->cam, in->screenW, in->screenH);
+
+    sc->in = *in;
+    sc->valid = true;
+    return true;
+}
+
+/**
+ * \brief Desenha a cena 3D a partir do cache (dentro de \c BeginMode3D).
+ *
+ * Eixos, esfera e equador, setas de T, R e Up e os arcos. Compartilhada pelo
+ * laço interativo e pela exportação fora da tela (\ref ExportDraw).
+ */
+static void DrawScene3D(const SceneCache *sc) {
+    // Eixos N-E-Up (X=North, Y=East, Z=Up)
+    float L = 1.2f;
+    DrawLine3D((Vector3){0,0,0}, (Vector3){L,0,0}, WHITE);
+    DrawLine3D((Vector3){0,0,0}, (Vector3){0,L,0}, WHITE);
+    DrawLine3D((Vector3){0,0,0}, (Vector3){0,0,L}, WHITE);
+
+    // Esfera unitária (grade em tom alaranjado) e equador completo (destaque),
+    // ambos estáticos e desenhados a partir de uma malha em cache
+    DrawStaticGeometry(1.0f, 32, 20, Fade(ORANGE, 0.35f), Fade(ORANGE, 0.55f));
+
+    // Vetores T e R
+    DrawArrow3D((Vector3){0,0,0}, sc->vT, 0.05f, SKYBLUE);
+    DrawArrow3D((Vector3){0,0,0}, sc->vR, 0.05f, ORANGE);
+
+    // Vetor Up (referência +Z)
+    DrawArrow3D((Vector3){0,0,0}, (Vector3){0,0,1.2f}, 0.05f, GREEN);
+
+    // Arcos de azimute, de elevação e do ângulo J (malha em cache, refeita
+    // só quando os ângulos ou a câmera mudam)
+    LineMeshDraw(&sc->arcs);
+}
+
+/**
+ * \brief Textos da cena e do HUD com o layout em cache (veja \ref text_cache.h).
+ *
+ * Os rótulos fixos são preparados uma vez; as linhas numéricas do HUD só são
+ * refeitas quando o valor mostrado muda.
+ */
+typedef struct SceneText {
+    bool ready;
+    TextLabel T, R, N, E, Up, j, title, eventMode, controls;
+    TextField azElT, azElR, J, sim, multi, live, sub;
+} SceneText;
+
+/** \brief Prepara os rótulos fixos (depois de \c InitWindow: usa a fonte padrão). */
+static void SceneTextInit(SceneText *tx) {
+    if (tx->ready) return;
+    TextLabelSet(&tx->T, "T", 18, RAYWHITE);
+    TextLabelSet(&tx->R, "R", 18, RAYWHITE);
+    TextLabelSet(&tx->N, "N (AZ=0°)", 16, RAYWHITE);
+    TextLabelSet(&tx->E, "E (AZ=90°)", 16, RAYWHITE);
+    TextLabelSet(&tx->Up, "Up", 16, GREEN);
+    TextLabelSet(&tx->j, "j", 20, YELLOW);
+    TextLabelSet(&tx->title, "Trigonometria Esférica — Ângulo J", 22, RAYWHITE);
+    TextLabelSet(&tx->eventMode, "modo por eventos (E)", 18, GREEN);
+    TextLabelSet(&tx->controls, "Controles: T(A/D,W/S), R(J/L,I/K), Reset(R), Multi(M), Cobertura(C), Perfil(P), Trace(O), Eventos(E), Mouse Orbita",
+                 18, LIGHTGRAY);
+    tx->ready = true;
+}
+
+/** \brief Marcadores de T e R na esfera (dentro de \c BeginMode3D). */
+static void DrawSceneMarkers(const SceneCache *sc) {
+    DrawSphere(Vector3Scale(sc->vT, 1.05f), 0.02f, SKYBLUE);
+    DrawSphere(Vector3Scale(sc->vR, 1.05f), 0.02f, ORANGE);
+}
+
+/** \brief Rótulos já projetados em 2D (posições do cache), depois de \c EndMode3D. */
+static void DrawSceneLabels(const SceneCache *sc, const SceneText *tx) {
+    TextLabelDraw(&tx->T, (float)((int)sc->sT.x + 6), (float)((int)sc->sT.y - 10));
+    TextLabelDraw(&tx->R, (float)((int)sc->sR.x + 6), (float)((int)sc->sR.y - 10));
+
+    // Rótulos N (AZ=0°) e E (AZ=90°) no equador
+    TextLabelDraw(&tx->N, (float)((int)sc->sN.x + 6), (float)((int)sc->sN.y - 10));
+    TextLabelDraw(&tx->E, (float)((int)sc->sE.x + 6), (float)((int)sc->sE.y - 10));
+
+    // Rótulo Up próximo ao topo
+    TextLabelDraw(&tx->Up, (float)((int)sc->sUp.x + 6), (float)((int)sc->sUp.y - 10));
+
+    // Rótulo 'j' do ângulo entre T e R (no ponto médio do arco)
+    TextLabelDraw(&tx->j, (float)((int)sc->sj.x + 4), (float)((int)sc->sj.y - 10));
+}
+
+/**
+ * \brief Fundo, título e as linhas de T, R e J do HUD.
+ * \return Posição vertical da próxima linha.
+ */
+static int DrawSceneHud(const SceneCache *sc, SceneText *tx, int pad, int line) {
+    int y = pad;
+    DrawRectangle(pad-6, pad-6, 520, 180, Fade(BLACK, 0.45f));
+    TextLabelDraw(&tx->title, (float)pad, (float)y); y += line + 4;
+    const double t[2] = { sc->in.azT_deg, sc->in.elT_deg };
+    const double r[2] = { sc->in.azR_deg, sc->in.elR_deg };
+    const double j[2] = { sc->Jdeg, sc->Jdeg_trig };
+    TextFieldUpdate(&tx->azElT, 18, RAYWHITE, 0.1, "Alvo  T: Az=%.1f°, El=%.1f°", 2, t);
+    TextFieldUpdate(&tx->azElR, 18, RAYWHITE, 0.1, "Eixo  R: Az=%.1f°, El=%.1f°", 2, r);
+    TextFieldUpdate(&tx->J, 18, YELLOW, 0.001, "J(T,R) ≈ %.3f°  (verificação: %.3f°)", 2, j);
+    TextLabelDraw(&tx->azElT.label, (float)pad, (float)y); y += line;
+    TextLabelDraw(&tx->azElR.label, (float)pad, (float)y); y += line;
+    TextLabelDraw(&tx->J.label, (float)pad, (float)y); y += line;
+    return y;
+}
+
+/**
+ * \brief Desenha uma cena de \c --export (veja \ref RunFrameExport).
+ *
+ * O mesmo caminho do laço interativo: as entradas passam por
+ * \ref UpdateScene (com o tamanho do alvo fora da tela, para o nível de
+ * detalhe e os rótulos) e a cena sai de \ref DrawScene3D,
+ * \ref DrawSceneMarkers, \ref DrawSceneLabels e \ref DrawSceneHud.
+ */
+static void ExportDraw(const ExportShot *shot, int width, int height, void *user) {
+    static SceneCache scene;
+    static SceneText text;
+    SceneTextInit(&text);
+    SphArena *frame = user;
+    SphArenaReset(frame);
+    SceneInputs in;
+    memset(&in, 0, sizeof in);
+    in.azT_deg = shot->azT; in.elT_deg = shot->elT;
+    in.azR_deg = shot->azR; in.elR_deg = shot->elR;
+    in.cam = shot->cam;
+    in.screenW = width; in.screenH = height;
+    UpdateScene(&scene, &in, frame);
+
+    ClearBackground((Color){20,24,28,255});
+    BeginMode3D(shot->cam);
+    DrawScene3D(&scene);
+    DrawSceneMarkers(&scene);
+    EndMode3D();
+    DrawSceneLabels(&scene, &text);
+    DrawSceneHud(&scene, &text, 12, 22);
+}
+
+/**
+ * \brief Consumidor dos passos da simulação para \c --sim-log.
+ *
+ * Uma linha \c t,J (s, graus) por passo de 1 kHz, no formato da saída do
+ * modo headless; o \c FILE tem buffer grande, e o quadro só copia bytes.
+ */
+static void SimLogStep(double t, const SimState *s, void *user) {
+    fprintf((FILE *)user, "%.6f,%.4f\n", t, rad2deg(s->J));
+}
+
 /**
  * \brief Função principal. Configura a janela/câmera e executa o laço de renderização.
  *
  * Passos do laço (cada quadro):
- * 1. Lê o teclado e atualiza os ângulos do alvo (T) e do eixo (R).
- * 2. Converte (Az, El) em vetores unitários \c vT e \c vR com \ref AzElToVec.
- * 3. Calcula o ângulo esférico \c J pelo produto escalar (\ref AngleBetweenUnit).
- * 4. Calcula \c J também pela fórmula analítica (verificação de consistência).
- * 5. Desenha eixos, esfera, setas dos vetores e um HUD com os valores.
+ * 1. Lê o teclado e executa os passos fixos (1 kHz) da simulação dos ângulos
+ *    do alvo (T) e do eixo (R) que cabem no tempo do quadro (\ref SimLoopAdvance);
+ *    o desenho usa o estado interpolado entre os dois últimos passos.
+ * 2. Se os ângulos ou a câmera mudaram (\ref UpdateScene): converte (Az, El)
+ *    em vetores unitários \c vT e \c vR com \ref AzElToVec, calcula o ângulo
+ *    esférico \c J pelo produto escalar (\ref AngleBetweenUnit) e pela
+ *    fórmula analítica (verificação de consistência) e refaz arcos e rótulos.
+ * 3. Desenha eixos, esfera, setas dos vetores e um HUD com os valores. No
+ *    modo por eventos (tecla E), quadros sem nenhuma mudança não são
+ *    desenhados: o laço dorme até a próxima entrada.
  *
  * Observações:
  * - A escolha de eixos (X=Norte, Y=Leste, Z=Cima) é uma convenção. Você pode
  *   adaptá-la ao seu sistema, desde que ajuste as fórmulas de conversão.
  * - As duas formas de calcular \c J devem coincidir. Pequenas diferenças
  *   ocorrem por arredondamentos de ponto flutuante (isso é esperado).
+ * - Se o primeiro argumento for \c --headless, nada disso acontece: o controle
+ *   passa para \ref RunHeadless com os argumentos restantes. Com \c --export,
+ *   para \ref RunFrameExport (cenas desenhadas fora da tela, em PNG).
  */
-int main(void) {
+int main(int argc, char **argv) {
+    // Modo sem janela: telemetria Az/El -> J (veja headless.h)
+    if (argc > 1 && strcmp(argv[1], "--headless") == 0) return RunHeadless(argc - 2, argv + 2);
+    // Exportação em lote: uma lista de cenas -> PNGs (veja frame_export.h)
+    if (argc > 1 && strcmp(argv[1], "--export") == 0) {
+        SphArena *frame = SphArenaCreate(64 * 1024);
+        if (!frame) return 1;
+        int rc = RunFrameExport(argc - 2, argv + 2, ExportDraw, frame);
+        SphArenaDestroy(frame);
+        return rc;
+    }
+
+    // Telemetria ao vivo (opcional): --live <uri> [--live-format csv|bin] ou --subscribe <end:porta>;
+    // --sim-log <arquivo.csv> grava J de cada passo da simulação
+    const char *liveUri = NULL, *subAddr = NULL, *simLogPath = NULL;
+    TelemetryFormat liveFmt = TELEMETRY_CSV;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--live") == 0) liveUri = argv[++i];
+        else if (strcmp(argv[i], "--subscribe") == 0) subAddr = argv[++i];
+        else if (strcmp(argv[i], "--sim-log") == 0) simLogPath = argv[++i];
+        else if (strcmp(argv[i], "--live-format") == 0) liveFmt = strcmp(argv[++i], "bin") == 0 ? TELEMETRY_BINARY : TELEMETRY_CSV;
+    }
+
+    FILE *simLog = NULL;
+    if (simLogPath) {
+        simLog = fopen(simLogPath, "w");
+        if (!simLog) {
+            perror(simLogPath);
+            return 1;
+        }
+        setvbuf(simLog, NULL, _IOFBF, 1 << 20);
+    }
+
     const int screenWidth = 1280;
     const int screenHeight = 720;
     SetConfigFlags(FLAG_MSAA_4X_HINT | FLAG_WINDOW_RESIZABLE);
@@ -254,28 +603,127 @@ int main(void) {
     cam.fovy     = 60.0f;
     cam.projection = CAMERA_PERSPECTIVE;
 
-    // Parâmetros iniciais (em graus)
-    float azT_deg = 40.0f, elT_deg = 25.0f; // alvo
-    float azR_deg = 10.0f, elR_deg =  5.0f; // eixo de rolagem
+    // Ângulos de T (alvo) e R (eixo de rolagem) em uma simulação de 1 kHz,
+    // independente da taxa de quadros; o desenho interpola entre dois passos
+    SimLoop sim;
+    SimLoopInit(&sim, SIM_LOOP_HZ, 40.0f, 25.0f, 10.0f, 5.0f);
+    if (simLog) SimLoopSetSink(&sim, SimLogStep, simLog);
+    int simLastFrame = 0; // passos executados no último quadro
+    double lastTime = GetTime();
+
+    // Visão com muitos alvos (criada na primeira vez que for ligada)
+    const int multiCount = 10000;
+    const float fovHalf = deg2rad(15.0f);
+    MultiTargetView *multi = NULL;
+    bool multiOn = false;
+
+    // Mapa de cobertura do FOV de R (textura na esfera), refeito só quando R muda
+    CoverageView *coverage = NULL;
+    bool coverageOn = false;
+    float coverageAz = NAN, coverageEl = NAN;
+
+    // Cache da cena (vetores, J, arcos e rótulos) e modo por eventos (E)
+    SceneCache scene = {0};
+    static SceneText text; // ~100 KB de quads: fora da pilha
+    SceneTextInit(&text);
+    bool eventMode = false;
+
+    // Perfilador de quadros (P: overlay, O: grava os próximos 300 quadros em JSON)
+    FrameProfiler *prof = FrameProfilerCreate();
+    bool profOn = false;
+    // Memória temporária de um quadro (tesselação), devolvida de uma vez a cada quadro
+    SphArena *frame = SphArenaCreate(64 * 1024);
+    if (!prof || !frame) {
+        FrameProfilerDestroy(prof);
+        SphArenaDestroy(frame);
+        if (simLog) fclose(simLog);
+        CloseWindow();
+        return 1;
+    }
+
+    // Ingestão em outra thread: o vsync não atrasa a leitura e a rede não atrasa o quadro
+    LiveFeed *live = liveUri ? LiveFeedStart(liveUri, liveFmt) : NULL;
+    size_t liveLastFrame = 0; // registros desempilhados no último quadro
+    // Assinante: a thread de rede decodifica os deltas; J chega pronto do publicador
+    StateClient *sub = subAddr ? StateClientStart(subAddr) : NULL;
+    size_t subLastFrame = 0;
+    float subJ = 0.0f; // J do último estado recebido (graus)
 
     SetTargetFPS(60);
 
     while (!WindowShouldClose()) {
-        // Controles
-        float dt = GetFrameTime();
-        float sp = 60.0f * dt; // deg/s
+        SphArenaReset(frame); // O(1): tudo o que o quadro anterior alocou
+        FrameProfilerBeginFrame(prof);
+        FrameProfilerBegin(prof, PROF_INPUT);
+        // Tempo real do quadro, em double (o acumulador da simulação soma milhares deles)
+        double now = GetTime();
+        double frameTime = now - lastTime;
+        lastTime = now;
+        if (frameTime > 0.1) frameTime = 0.1; // após uma espera longa no modo por eventos
+        float dt = (float)frameTime;
+        // Controles: taxas (60°/s) para todos os passos de simulação deste quadro
+        const float sp = 60.0f;
+        SimRates rates = { 0.0f, 0.0f, 0.0f, 0.0f };
         // Alvo T
-        if (IsKeyDown(KEY_A)) azT_deg -= sp; if (IsKeyDown(KEY_D)) azT_deg += sp;
-        if (IsKeyDown(KEY_W)) elT_deg += sp; if (IsKeyDown(KEY_S)) elT_deg -= sp;
+        if (IsKeyDown(KEY_A)) rates.azT -= sp; if (IsKeyDown(KEY_D)) rates.azT += sp;
+        if (IsKeyDown(KEY_W)) rates.elT += sp; if (IsKeyDown(KEY_S)) rates.elT -= sp;
         // Eixo R
-        if (IsKeyDown(KEY_J)) azR_deg -= sp; if (IsKeyDown(KEY_L)) azR_deg += sp;
-        if (IsKeyDown(KEY_I)) elR_deg += sp; if (IsKeyDown(KEY_K)) elR_deg -= sp;
+        if (IsKeyDown(KEY_J)) rates.azR -= sp; if (IsKeyDown(KEY_L)) rates.azR += sp;
+        if (IsKeyDown(KEY_I)) rates.elR += sp; if (IsKeyDown(KEY_K)) rates.elR -= sp;
+        bool moving = IsKeyDown(KEY_A) || IsKeyDown(KEY_D) || IsKeyDown(KEY_W) || IsKeyDown(KEY_S) ||
+                      IsKeyDown(KEY_J) || IsKeyDown(KEY_L) || IsKeyDown(KEY_I) || IsKeyDown(KEY_K) ||
+                      IsMouseButtonDown(MOUSE_BUTTON_LEFT);
+        bool uiChanged = IsKeyPressed(KEY_R) || IsKeyPressed(KEY_M) || IsKeyPressed(KEY_P) ||
+                         IsKeyPressed(KEY_O) || IsKeyPressed(KEY_E) || IsKeyPressed(KEY_C);
         // Reset
-        if (IsKeyPressed(KEY_R)) { azT_deg=40; elT_deg=25; azR_deg=10; elR_deg=5; }
+        if (IsKeyPressed(KEY_R)) SimLoopSet(&sim, 40.0f, 25.0f, 10.0f, 5.0f);
+        // Muitos alvos
+        if (IsKeyPressed(KEY_M)) {
+            multiOn = !multiOn;
+            if (multiOn && !multi) multi = MultiTargetCreate(multiCount, 12345u);
+            if (!multi) multiOn = false;
+        }
+        // Mapa de cobertura
+        if (IsKeyPressed(KEY_C)) {
+            coverageOn = !coverageOn;
+            if (coverageOn && !coverage) coverage = CoverageViewCreate(0.5f);
+        }
+        // Perfilador
+        if (IsKeyPressed(KEY_P)) profOn = !profOn;
+        if (IsKeyPressed(KEY_O)) FrameProfilerStartTrace(prof, "frame_trace.json", 300);
+        // Modo por eventos: parado, o laço dorme até a próxima entrada
+        if (IsKeyPressed(KEY_E)) {
+            eventMode = !eventMode;
+            if (!eventMode) DisableEventWaiting();
+        }
+
+        // Telemetria ao vivo: desempilha tudo o que chegou desde o último quadro
+        // (sem locks) e mostra o registro mais recente
+        if (live) {
+            LiveSample chunk[256];
+            size_t n, drained = 0;
+            while ((n = LiveFeedDrain(live, chunk, 256)) > 0) {
+                const LiveSample *last = &chunk[n - 1];
+                SimLoopSet(&sim, last->azT, last->elT, last->azR, last->elR);
+                drained += n;
+            }
+            liveLastFrame = drained;
+        }
+        if (sub) {
+            StateSample chunk[256];
+            size_t n, drained = 0;
+            while ((n = StateClientDrain(sub, chunk, 256)) > 0) {
+                const StateSample *last = &chunk[n - 1];
+                SimLoopSet(&sim, last->azT, last->elT, last->azR, last->elR);
+                subJ = last->J;
+                drained += n;
+            }
+            subLastFrame = drained;
+        }
 
-        // Limites razoáveis para elevação (-89..+89)
-        if (elT_deg > 89) elT_deg = 89; if (elT_deg < -89) elT_deg = -89;
-        if (elR_deg > 89) elR_deg = 89; if (elR_deg < -89) elR_deg = -89;
+        // Passos fixos que cabem no tempo do quadro (elevações limitadas a ±89°)
+        simLastFrame = SimLoopAdvance(&sim, frameTime, rates);
+        SimState shown = SimLoopDisplay(&sim);
 
         // Câmera orbital simples
         if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
@@ -293,92 +741,118 @@ int main(void) {
         float mw = GetMouseWheelMove();
         if (fabsf(mw) > 0.01f) cam.fovy = Clamp(cam.fovy - mw*2.0f, 20.0f, 90.0f);
 
-        // Cálculos
-        float AZ_T = deg2rad(azT_deg), EL_T = deg2rad(elT_deg);
-        float AZ_R = deg2rad(azR_deg), EL_R = deg2rad(elR_deg);
-        Vector3 vT = AzElToVec(AZ_T, EL_T);
-        Vector3 vR = AzElToVec(AZ_R, EL_R);
-        float J = AngleBetweenUnit(vT, vR);
-        float Jdeg = rad2deg(J);
-
-        // Verificação forma analítica: cosJ = sin(EL_T)sin(EL_R)+cos(EL_T)cos(EL_R)cos(ΔAZ)
-        float cosJ = sinf(EL_T)*sinf(EL_R) + cosf(EL_T)*cosf(EL_R)*cosf(AZ_T - AZ_R);
-        if (cosJ > 1.0f) cosJ = 1.0f; else if (cosJ < -1.0f) cosJ = -1.0f;
-        float Jdeg_trig = rad2deg(acosf(cosJ));
+        // Entradas da cena (zeradas antes: o cache as compara byte a byte)
+        SceneInputs in;
+        memset(&in, 0, sizeof in);
+        in.azT_deg = shown.azT; in.elT_deg = shown.elT;
+        in.azR_deg = shown.azR; in.elR_deg = shown.elR;
+        in.cam = cam;
+        in.screenW = GetScreenWidth(); in.screenH = GetScreenHeight();
+        FrameProfilerEnd(prof, PROF_INPUT);
+
+        // Cálculos: só quando alguma entrada mudou (veja UpdateScene)
+        FrameProfilerBegin(prof, PROF_COMPUTE);
+        bool changed = UpdateScene(&scene, &in, frame);
+        Vector3 vR = scene.vR;
+        if (multiOn && multi) MultiTargetUpdate(multi, dt, vR, fovHalf);
+        if (coverageOn && coverage && (shown.azR != coverageAz || shown.elR != coverageEl)) {
+            float az = deg2rad(shown.azR), el = deg2rad(shown.elR);
+            CoverageViewUpdate(coverage, &az, &el, 1, fovHalf);
+            coverageAz = shown.azR;
+            coverageEl = shown.elR;
+        }
+        FrameProfilerEnd(prof, PROF_COMPUTE);
+
+        // Nada mudou e nada está animando: no modo por eventos, o quadro não é
+        // redesenhado e PollInputEvents bloqueia até a próxima entrada
+        bool animating = moving || (multiOn && multi) || FrameProfilerTracing(prof) ||
+                         (live && !LiveFeedEnded(live)) || (sub && !StateClientEnded(sub));
+        if (eventMode) {
+            if (animating) DisableEventWaiting(); else EnableEventWaiting();
+            if (!changed && !animating && !uiChanged) {
+                FrameProfilerDiscardFrame(prof);
+                PollInputEvents();
+                continue;
+            }
+        }
 
         BeginDrawing();
+        FrameProfilerBegin(prof, PROF_DRAW3D);
         ClearBackground((Color){20,24,28,255});
 
         BeginMode3D(cam);
-        // Eixos N-E-Up (X=North, Y=East, Z=Up)
-        float L = 1.2f;
-        DrawLine3D((Vector3){0,0,0}, (Vector3){L,0,0}, WHITE);
-        DrawLine3D((Vector3){0,0,0}, (Vector3){0,L,0}, WHITE);
-        DrawLine3D((Vector3){0,0,0}, (Vector3){0,0,L}, WHITE);
-
-        // Esfera unitária (grade em tom alaranjado)
-        DrawSphereWire(1.0f, 32, 20, Fade(ORANGE, 0.35f));
-        // Equador completo (destaque)
-        DrawAzimuthArc(0.0f, 2.0f*(float)M_PI, Fade(ORANGE, 0.55f));
-
-        // Vetores T e R
-        DrawArrow3D((Vector3){0,0,0}, (Vector3){vT.x, vT.y, vT.z}, 0.05f, SKYBLUE);
-        DrawArrow3D((Vector3){0,0,0}, (Vector3){vR.x, vR.y, vR.z}, 0.05f, ORANGE);
-
-        // Vetor Up (referência +Z)
-        DrawArrow3D((Vector3){0,0,0}, (Vector3){0,0,1.2f}, 0.05f, GREEN);
-
-        // Arcos de azimute desde N (az=0) até AZ_T e AZ_R (no horizonte)
-        DrawAzimuthArc(0.0f, AZ_T, Fade(SKYBLUE, 0.8f));
-        DrawAzimuthArc(0.0f, AZ_R, Fade(ORANGE, 0.8f));
-
-        // Arcos de elevação ao longo dos meridianos de T e R (de 0 até EL)
-        DrawElevationArc(AZ_T, EL_T, Fade(SKYBLUE, 0.8f));
-        DrawElevationArc(AZ_R, EL_R, Fade(ORANGE, 0.8f));
-
-        // Arco do ângulo J entre T e R (grande círculo)
-        DrawGreatCircleArc(vT, vR, YELLOW);
-
-        // Rótulos projetados em 2D com marcadores esféricos
-        Vector3 pT = Vector3Scale(vT, 1.05f);
-        Vector3 pR = Vector3Scale(vR, 1.05f);
-        DrawSphere(pT, 0.02f, SKYBLUE);
-        DrawSphere(pR, 0.02f, ORANGE);
-        Vector2 sT = GetWorldToScreen(pT, cam);
-        Vector2 sR = GetWorldToScreen(pR, cam);
-        DrawText("T", (int)sT.x + 6, (int)sT.y - 10, 18, RAYWHITE);
-        DrawText("R", (int)sR.x + 6, (int)sR.y - 10, 18, RAYWHITE);
-
-        // Rótulos N (AZ=0°) e E (AZ=90°) no equador
-        Vector2 sN = GetWorldToScreen((Vector3){1.05f, 0.0f, 0.0f}, cam);
-        Vector2 sE = GetWorldToScreen((Vector3){0.0f, 1.05f, 0.0f}, cam);
-        DrawText("N (AZ=0°)", (int)sN.x + 6, (int)sN.y - 10, 16, RAYWHITE);
-        DrawText("E (AZ=90°)", (int)sE.x + 6, (int)sE.y - 10, 16, RAYWHITE);
-
-        // Rótulo Up próximo ao topo
-        Vector2 sUp = GetWorldToScreen((Vector3){0.0f, 0.0f, 1.15f}, cam);
-        DrawText("Up", (int)sUp.x + 6, (int)sUp.y - 10, 16, GREEN);
-
-        // Rótulo 'j' do ângulo entre T e R (no ponto médio do arco)
-        Vector3 mid = SlerpUnit(vT, vR, 0.5f);
-        Vector2 sj = GetWorldToScreen(Vector3Scale(mid, 1.03f), cam);
-        DrawText("j", (int)sj.x + 4, (int)sj.y - 10, 20, YELLOW);
+        DrawScene3D(&scene);
 
+        // Muitos alvos: marcadores/setas instanciados e arcos J em lote
+        if (multiOn && multi) MultiTargetDraw3D(multi, vR);
+
+        // Cobertura: por último, semitransparente e sem escrever profundidade
+        if (coverageOn && coverage) CoverageViewDraw(coverage);
+        FrameProfilerEnd(prof, PROF_DRAW3D);
+
+        FrameProfilerBegin(prof, PROF_LABELS);
+        DrawSceneMarkers(&scene);
         EndMode3D();
+        DrawSceneLabels(&scene, &text);
+        FrameProfilerEnd(prof, PROF_LABELS);
 
         // HUD
-        const int pad = 12; int y = pad; const int line = 22;
-        DrawRectangle(pad-6, pad-6, 520, 180, Fade(BLACK, 0.45f));
-        DrawText("Trigonometria Esférica — Ângulo J", pad, y, 22, RAYWHITE); y += line + 4;
-        DrawText(TextFormat("Alvo  T: Az=%.1f°, El=%.1f°", azT_deg, elT_deg), pad, y, 18, RAYWHITE); y += line;
-        DrawText(TextFormat("Eixo  R: Az=%.1f°, El=%.1f°", azR_deg, elR_deg), pad, y, 18, RAYWHITE); y += line;
-        DrawText(TextFormat("J(T,R) ≈ %.3f°  (verificação: %.3f°)", Jdeg, Jdeg_trig), pad, y, 18, YELLOW);
+        FrameProfilerBegin(prof, PROF_HUD);
+        const int pad = 12, line = 22;
+        int y = DrawSceneHud(&scene, &text, pad, line);
+        const double simValues[3] = { 1.0 / sim.step, simLastFrame, rad2deg(sim.cur.J) };
+        TextFieldUpdate(&text.sim, 18, LIGHTGRAY, 0.001, "Simulação %.0f Hz: %.0f passos neste quadro, J(passo) = %.3f°",
+                        3, simValues);
+        TextLabelDraw(&text.sim.label, (float)pad, (float)y);
+        y += line;
+        if (multiOn && multi) {
+            const double mv[3] = { MultiTargetCount(multi), rad2deg(fovHalf), MultiTargetInside(multi) };
+            TextFieldUpdate(&text.multi, 18, RAYWHITE, 1.0, "Alvos: %.0f  |  no FOV (J ≤ %.0f°): %.0f", 3, mv);
+            TextLabelDraw(&text.multi.label, (float)pad, (float)y);
+            y += line;
+        }
+        if (live) {
+            uint64_t lost = LiveFeedOverruns(live);
+            const double lv[3] = { (double)LiveFeedReceived(live), (double)liveLastFrame, (double)lost };
+            TextFieldUpdate(&text.live, 18, lost ? RED : GREEN, 1.0,
+                            LiveFeedEnded(live) ? "Ao vivo (fim): %.0f registros (%.0f neste quadro), %.0f perdidos"
+                                                : "Ao vivo: %.0f registros (%.0f neste quadro), %.0f perdidos",
+                            3, lv);
+            TextLabelDraw(&text.live.label, (float)pad, (float)y);
+            y += line;
+        }
+        if (sub) {
+            uint64_t lost = StateClientOverruns(sub);
+            const double sv[4] = { (double)StateClientReceived(sub), (double)subLastFrame, subJ,
+                                   (double)(lost + StateClientResyncs(sub)) };
+            TextFieldUpdate(&text.sub, 18, lost ? RED : GREEN, 0.001,
+                            StateClientEnded(sub) ? "Assinatura (fim): %.0f estados (%.0f neste quadro), J = %.3f°, %.0f perdas"
+                                                  : "Assinatura: %.0f estados (%.0f neste quadro), J = %.3f°, %.0f perdas",
+                            4, sv);
+            TextLabelDraw(&text.sub.label, (float)pad, (float)y);
+        }
+
+        if (profOn) FrameProfilerDrawOverlay(prof, GetScreenWidth() - 290, pad);
+        if (eventMode) TextLabelDraw(&text.eventMode, (float)pad, (float)(GetScreenHeight()-52));
 
-        DrawText("Controles: T(A/D,W/S), R(J/L,I/K), Reset(R), Mouse Orbita", pad, GetScreenHeight()-28, 18, LIGHTGRAY);
+        TextLabelDraw(&text.controls, (float)pad, (float)(GetScreenHeight()-28));
+        FrameProfilerEnd(prof, PROF_HUD);
 
+        FrameProfilerBegin(prof, PROF_END_DRAWING);
         EndDrawing();
+        FrameProfilerEnd(prof, PROF_END_DRAWING);
+        FrameProfilerEndFrame(prof);
     }
 
+    LiveFeedStop(live);
+    StateClientStop(sub);
+    FrameProfilerDestroy(prof);
+    SphArenaDestroy(frame);
+    MultiTargetDestroy(multi);
+    CoverageViewDestroy(coverage);
+    LineMeshFree(&scene.arcs);
+    UnloadStaticGeometry();
+    if (simLog) fclose(simLog);
     CloseWindow();
     return 0;
 }
@@ -0,0 +1,227 @@
+/**
+ * \file multi_target.c
+ * \brief Implementação da visão com muitos alvos (instanciamento e lote de linhas).
+ */
+#include "multi_target.h"
+
+#include "arc_gpu.h"
+#include "spherical.h"
+#include "spherical_index.h"
+#include "spherical_simd.h"
+
+#include "rlgl.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MULTI_TARGET_ARC_STEPS 16
+
+static const float kTwoPi = 6.28318530717958647692f;
+
+// Shader mínimo de instanciamento (OpenGL 3.3): posição * transformação da instância
+static const char *kInstancingVs =
+    "#version 330\n"
+    "in vec3 vertexPosition;\n"
+    "in mat4 instanceTransform;\n"
+    "uniform mat4 mvp;\n"
+    "void main() { gl_Position = mvp*instanceTransform*vec4(vertexPosition, 1.0); }\n";
+
+static const char *kInstancingFs =
+    "#version 330\n"
+    "uniform vec4 colDiffuse;\n"
+    "out vec4 finalColor;\n"
+    "void main() { finalColor = colDiffuse; }\n";
+
+struct MultiTargetView {
+    int count;
+    int inside;
+    // Estado das trilhas (SoA, radianos)
+    float *az, *el, *azRate, *elRate;
+    float *x, *y, *z;
+    unsigned char *in;
+    SphIndex *index;      // trilhas por célula da esfera (teste de campo de visão)
+    uint32_t *hits;
+
+    // Recursos de GPU
+    Shader shader;
+    Material material;
+    Mesh marker, shaft, head;
+    Matrix *xfOut, *xfIn, *xfShaft, *xfHead;
+    ArcBatch *arcs;
+};
+
+static unsigned NextRand(unsigned *s) {
+    *s = *s * 1664525u + 1013904223u;
+    return *s;
+}
+
+static float RandRange(unsigned *s, float lo, float hi) {
+    return lo + (hi - lo) * (float)(NextRand(s) >> 8) / 16777216.0f;
+}
+
+/** Translação + escala uniforme (matriz em colunas, como a da Raylib). */
+static Matrix MarkerTransform(Vector3 p, float s) {
+    Matrix m = { 0 };
+    m.m0 = s; m.m5 = s; m.m10 = s; m.m15 = 1.0f;
+    m.m12 = p.x; m.m13 = p.y; m.m14 = p.z;
+    return m;
+}
+
+/**
+ * \brief Leva o eixo +Y da malha unitária para a direção \c d, com comprimento
+ *        \c len ao longo de \c d, raio \c rad nas outras direções e origem em \c o.
+ */
+static Matrix AlongDirection(Vector3 o, Vector3 d, float len, float rad) {
+    Vector3 helper = fabsf(d.z) < 0.9f ? (Vector3){ 0, 0, 1 } : (Vector3){ 1, 0, 0 };
+    // x' = normalize(helper × d); z' = x' × d (base ortonormal com y' = d)
+    Vector3 xa = { helper.y*d.z - helper.z*d.y, helper.z*d.x - helper.x*d.z, helper.x*d.y - helper.y*d.x };
+    float n = sqrtf(xa.x*xa.x + xa.y*xa.y + xa.z*xa.z);
+    xa.x /= n; xa.y /= n; xa.z /= n;
+    Vector3 za = { xa.y*d.z - xa.z*d.y, xa.z*d.x - xa.x*d.z, xa.x*d.y - xa.y*d.x };
+    Matrix m = { 0 };
+    m.m0 = xa.x*rad; m.m1 = xa.y*rad; m.m2 = xa.z*rad;
+    m.m4 = d.x*len;  m.m5 = d.y*len;  m.m6 = d.z*len;
+    m.m8 = za.x*rad; m.m9 = za.y*rad; m.m10 = za.z*rad;
+    m.m12 = o.x; m.m13 = o.y; m.m14 = o.z; m.m15 = 1.0f;
+    return m;
+}
+
+MultiTargetView *MultiTargetCreate(int count, unsigned seed) {
+    MultiTargetView *v = calloc(1, sizeof *v);
+    if (!v) return NULL;
+    v->count = count;
+    size_t n = (size_t)count;
+    v->az = malloc(7 * n * sizeof *v->az);
+    v->in = malloc(n);
+    v->hits = malloc(n * sizeof *v->hits);
+    v->index = SphIndexCreate(0, n);
+    v->xfOut = malloc(n * sizeof *v->xfOut);
+    v->xfIn = malloc(n * sizeof *v->xfIn);
+    v->xfShaft = malloc(n * sizeof *v->xfShaft);
+    v->xfHead = malloc(n * sizeof *v->xfHead);
+    if (!v->az || !v->in || !v->hits || !v->index || !v->xfOut || !v->xfIn || !v->xfShaft || !v->xfHead) {
+        v->count = 0;
+        MultiTargetDestroy(v);
+        return NULL;
+    }
+    v->el = v->az + n; v->azRate = v->el + n; v->elRate = v->azRate + n;
+    v->x = v->elRate + n; v->y = v->x + n; v->z = v->y + n;
+
+    unsigned s = seed;
+    for (size_t i = 0; i < n; ++i) {
+        v->az[i] = RandRange(&s, 0.0f, 2.0f*3.14159265f);
+        v->el[i] = RandRange(&s, -1.3f, 1.3f);
+        v->azRate[i] = RandRange(&s, -0.2f, 0.2f);
+        v->elRate[i] = RandRange(&s, -0.05f, 0.05f);
+    }
+
+    v->shader = LoadShaderFromMemory(kInstancingVs, kInstancingFs);
+    // Se a compilação falha, o raylib devolve o shader padrão: as posições
+    // escritas abaixo estragariam os locs dele, e ele não pode ser descarregado
+    if (v->shader.id == 0 || v->shader.id == rlGetShaderIdDefault()) {
+        v->count = 0;
+        MultiTargetDestroy(v);
+        return NULL;
+    }
+    v->shader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(v->shader, "mvp");
+    v->shader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(v->shader, "instanceTransform");
+    v->material = LoadMaterialDefault();
+    v->material.shader = v->shader;
+    v->marker = GenMeshSphere(1.0f, 4, 6);
+    v->shaft = GenMeshCylinder(1.0f, 1.0f, 6);
+    v->head = GenMeshCone(1.0f, 1.0f, 8);
+    // Um arco por trilha: com todas no campo de visão, nenhum arco é descartado
+    v->arcs = ArcBatchCreate(count, MULTI_TARGET_ARC_STEPS);
+    return v;
+}
+
+void MultiTargetUpdate(MultiTargetView *v, float dt, Vector3 axis, float fovHalf) {
+    const size_t n = (size_t)v->count;
+    const float elMax = 1.4f;
+    for (size_t i = 0; i < n; ++i) {
+        // Azimute em [0, 2π): somado quadro a quadro, cresceria sem limite e
+        // perderia os bits de fração que o movimento usa
+        float az = v->az[i] + v->azRate[i] * dt;
+        if (az < 0.0f || az >= kTwoPi) {
+            az -= kTwoPi * floorf(az / kTwoPi);
+            if (az >= kTwoPi) az = 0.0f; // -ε + 2π arredonda para 2π
+        }
+        v->az[i] = az;
+        v->el[i] += v->elRate[i] * dt;
+        // Reflete nas bordas de elevação
+        if (v->el[i] > elMax) { v->el[i] = 2.0f*elMax - v->el[i]; v->elRate[i] = -v->elRate[i]; }
+        if (v->el[i] < -elMax) { v->el[i] = -2.0f*elMax - v->el[i]; v->elRate[i] = -v->elRate[i]; }
+    }
+    SphAzElToVecSimd(v->az, v->el, n, v->x, v->y, v->z, SPH_ACCURACY_PRECISE);
+
+    // Campo de visão: J <= fovHalf  <=>  T·R >= cos(fovHalf), consultado no
+    // índice espacial (só as células perto do cone são visitadas)
+    if (SphIndexCount(v->index) != n) SphIndexBuild(v->index, v->x, v->y, v->z, n);
+    else SphIndexUpdateBatch(v->index, v->x, v->y, v->z, n);
+    SphVec3 r = { axis.x, axis.y, axis.z };
+    size_t hits = SphIndexCone(v->index, r, fovHalf, v->hits, n);
+    memset(v->in, 0, n);
+    for (size_t k = 0; k < hits; ++k) v->in[v->hits[k]] = 1;
+    v->inside = (int)hits;
+}
+
+void MultiTargetDraw3D(MultiTargetView *v, Vector3 axis) {
+    const float markerR = 0.012f, markerDist = 1.02f;
+    int nOut = 0, nIn = 0;
+    if (v->arcs) ArcBatchClear(v->arcs);
+    for (int i = 0; i < v->count; ++i) {
+        Vector3 d = { v->x[i], v->y[i], v->z[i] };
+        Vector3 p = { d.x*markerDist, d.y*markerDist, d.z*markerDist };
+        if (!v->in[i]) {
+            v->xfOut[nOut++] = MarkerTransform(p, markerR);
+            continue;
+        }
+        v->xfIn[nIn] = MarkerTransform(p, markerR*1.3f);
+        v->xfShaft[nIn] = AlongDirection((Vector3){ 0, 0, 0 }, d, 0.85f, 0.003f);
+        v->xfHead[nIn] = AlongDirection((Vector3){ d.x*0.85f, d.y*0.85f, d.z*0.85f }, d, 0.15f, 0.012f);
+        // Arco J do eixo R até o alvo (tesselado na GPU quando possível)
+        if (v->arcs) ArcBatchAdd(v->arcs, axis, d);
+        nIn++;
+    }
+
+    v->material.maps[MATERIAL_MAP_DIFFUSE].color = Fade(SKYBLUE, 0.7f);
+    if (nOut) DrawMeshInstanced(v->marker, v->material, v->xfOut, nOut);
+    if (nIn) {
+        v->material.maps[MATERIAL_MAP_DIFFUSE].color = YELLOW;
+        DrawMeshInstanced(v->marker, v->material, v->xfIn, nIn);
+        v->material.maps[MATERIAL_MAP_DIFFUSE].color = Fade(YELLOW, 0.6f);
+        DrawMeshInstanced(v->shaft, v->material, v->xfShaft, nIn);
+        DrawMeshInstanced(v->head, v->material, v->xfHead, nIn);
+    }
+    if (v->arcs) ArcBatchDraw(v->arcs, 1.002f, Fade(YELLOW, 0.35f));
+}
+
+int MultiTargetCount(const MultiTargetView *v) {
+    return v->count;
+}
+
+int MultiTargetInside(const MultiTargetView *v) {
+    return v->inside;
+}
+
+void MultiTargetDestroy(MultiTargetView *v) {
+    if (!v) return;
+    if (v->count > 0) {
+        UnloadMesh(v->marker);
+        UnloadMesh(v->shaft);
+        UnloadMesh(v->head);
+        // O shader pertence ao material: UnloadMaterial também o descarrega
+        UnloadMaterial(v->material);
+    }
+    ArcBatchDestroy(v->arcs);
+    free(v->az);
+    free(v->in);
+    free(v->hits);
+    SphIndexDestroy(v->index);
+    free(v->xfOut);
+    free(v->xfIn);
+    free(v->xfShaft);
+    free(v->xfHead);
+    free(v);
+}
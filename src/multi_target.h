@@ -0,0 +1,62 @@
+/**
+ * \file multi_target.h
+ * \brief Visão com muitos alvos: marcadores e setas instanciados na GPU e arcos J em lote.
+ *
+ * Milhares de trilhas são desenhadas com poucas chamadas de desenho:
+ * - Marcadores: uma malha de esfera pequena, desenhada com
+ *   \c DrawMeshInstanced (uma transformação por alvo), em dois grupos de cor
+ *   (dentro e fora do campo de visão).
+ * - Setas: haste (cilindro) e ponta (cone) unitárias, também instanciadas,
+ *   apenas para os alvos dentro do campo de visão.
+ * - Arcos J: todos os arcos de grande círculo entre o eixo R e os alvos no
+ *   campo de visão vão para um \ref ArcBatch (tesselados no vertex shader),
+ *   dimensionado com um arco por trilha: nenhum arco é descartado.
+ *
+ * As trilhas são sintéticas (movimento uniforme em Az/El) e servem para
+ * dimensionar o desenho; os vetores são calculados em lote com
+ * \ref SphAzElToVecSimd e o teste de campo de visão é uma consulta de cone no
+ * índice espacial (\ref SphIndexCone, com \f$\cos J\f$ e sem acos), atualizado
+ * de forma incremental a cada quadro.
+ */
+#ifndef MULTI_TARGET_H
+#define MULTI_TARGET_H
+
+#include "raylib.h"
+
+typedef struct MultiTargetView MultiTargetView;
+
+/**
+ * \brief Cria a visão com \c count trilhas sintéticas.
+ *
+ * Precisa ser chamada depois de \c InitWindow (carrega shader e malhas).
+ *
+ * \param count Quantidade de trilhas.
+ * \param seed Semente do gerador pseudoaleatório das trilhas.
+ * \return A visão, ou NULL sem memória ou se o shader de instanciamento não
+ *         compila (sem OpenGL 3.3).
+ */
+MultiTargetView *MultiTargetCreate(int count, unsigned seed);
+
+/**
+ * \brief Avança as trilhas e refaz o teste de campo de visão.
+ *
+ * \param view Visão.
+ * \param dt Passo de tempo (s).
+ * \param axis Eixo de rolagem R (unitário).
+ * \param fovHalf Semiângulo do campo de visão (rad).
+ */
+void MultiTargetUpdate(MultiTargetView *view, float dt, Vector3 axis, float fovHalf);
+
+/** \brief Desenha marcadores, setas e arcos (dentro de \c BeginMode3D). */
+void MultiTargetDraw3D(MultiTargetView *view, Vector3 axis);
+
+/** \brief Quantidade total de trilhas. */
+int MultiTargetCount(const MultiTargetView *view);
+
+/** \brief Quantidade de trilhas dentro do campo de visão na última atualização. */
+int MultiTargetInside(const MultiTargetView *view);
+
+/** \brief Libera shader, malhas e buffers. */
+void MultiTargetDestroy(MultiTargetView *view);
+
+#endif /* MULTI_TARGET_H */
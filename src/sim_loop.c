@@ -0,0 +1,90 @@
+/**
+ * \file sim_loop.c
+ * \brief Passos fixos, integração dos ângulos e interpolação para o desenho.
+ */
+#include "sim_loop.h"
+
+#include "spherical_frames.h"
+
+#include <math.h>
+
+static const float kRad2Deg = 180.0f / 3.14159265358979323846f;
+
+static float ClampEl(float el) { return el > 89.0f ? 89.0f : (el < -89.0f ? -89.0f : el); }
+
+/** Vetores e J a partir dos ângulos do estado. */
+static void Derive(SimState *s) {
+    s->vT = SphAzElToVecNeuDeg(s->azT, s->elT);
+    s->vR = SphAzElToVecNeuDeg(s->azR, s->elR);
+    s->J = SphAngleBetweenUnitAtan2(s->vT, s->vR);
+}
+
+/** Az/El (graus) de um vetor unitário, com o azimute na volta mais próxima de \c azNear. */
+static void VecToAzElNear(SphVec3 v, float azNear, float *az, float *el) {
+    float a = atan2f(v.y, v.x) * kRad2Deg;
+    float d = a - azNear;
+    d -= 360.0f * floorf((d + 180.0f) / 360.0f);
+    *az = azNear + d;
+    *el = asinf(v.z > 1.0f ? 1.0f : (v.z < -1.0f ? -1.0f : v.z)) * kRad2Deg;
+}
+
+void SimLoopInit(SimLoop *sim, double hz, float azT, float elT, float azR, float elR) {
+    sim->step = 1.0 / hz;
+    sim->accumulator = 0.0;
+    sim->ticks = 0;
+    sim->dropped = 0.0;
+    sim->onStep = NULL;
+    sim->onStepUser = NULL;
+    SimLoopSet(sim, azT, elT, azR, elR);
+}
+
+void SimLoopSet(SimLoop *sim, float azT, float elT, float azR, float elR) {
+    SimState s;
+    s.azT = azT; s.elT = ClampEl(elT);
+    s.azR = azR; s.elR = ClampEl(elR);
+    Derive(&s);
+    sim->prev = sim->cur = s;
+}
+
+void SimLoopSetSink(SimLoop *sim, SimStepFn fn, void *user) {
+    sim->onStep = fn;
+    sim->onStepUser = user;
+}
+
+int SimLoopAdvance(SimLoop *sim, double frameTime, SimRates rates) {
+    if (frameTime > 0.0) sim->accumulator += frameTime;
+    if (sim->accumulator > SIM_LOOP_MAX_CATCHUP) {
+        sim->dropped += sim->accumulator - SIM_LOOP_MAX_CATCHUP;
+        sim->accumulator = SIM_LOOP_MAX_CATCHUP;
+    }
+    // O passo em float é o mesmo em todos os passos: mesmos estados para as mesmas entradas
+    const float h = (float)sim->step;
+    int n = 0;
+    while (sim->accumulator >= sim->step) {
+        SimState s = sim->cur;
+        s.azT += rates.azT * h;
+        s.elT = ClampEl(s.elT + rates.elT * h);
+        s.azR += rates.azR * h;
+        s.elR = ClampEl(s.elR + rates.elR * h);
+        Derive(&s);
+        sim->prev = sim->cur;
+        sim->cur = s;
+        sim->accumulator -= sim->step;
+        ++n;
+        if (sim->onStep) sim->onStep((double)(sim->ticks + (uint64_t)n) * sim->step, &sim->cur, sim->onStepUser);
+    }
+    sim->ticks += (uint64_t)n;
+    return n;
+}
+
+SimState SimLoopDisplay(const SimLoop *sim) {
+    const float alpha = (float)(sim->accumulator / sim->step);
+    SimState d = sim->cur;
+    // Parado: o estado exato, para o cache da cena não ver mudança alguma
+    if (sim->prev.azT == d.azT && sim->prev.elT == d.elT && sim->prev.azR == d.azR && sim->prev.elR == d.elR) return d;
+    d.vT = SphSlerpUnit(sim->prev.vT, sim->cur.vT, alpha);
+    d.vR = SphSlerpUnit(sim->prev.vR, sim->cur.vR, alpha);
+    VecToAzElNear(d.vT, sim->cur.azT, &d.azT, &d.elT);
+    VecToAzElNear(d.vR, sim->cur.azR, &d.azR, &d.elR);
+    return d;
+}
@@ -0,0 +1,111 @@
+/**
+ * \file sim_loop.h
+ * \brief Simulação em passo fixo (1 kHz), independente da taxa de quadros.
+ *
+ * O laço de renderização mede o tempo real de cada quadro e o entrega a
+ * \ref SimLoopAdvance, que o acumula e executa quantos passos fixos de
+ * \f$1/f\f$ couberem. Cada passo integra as taxas de Az/El de T e R, refaz
+ * os vetores e calcula J: a sequência de estados depende só das entradas e
+ * da quantidade de passos, não de quantos quadros a GUI conseguiu desenhar
+ * (a 20 ou a 144 quadros/s, J sai a 1000 Hz).
+ *
+ * Para o desenho, os dois últimos estados são interpolados com
+ * \ref SphSlerpUnit pela fração do passo que sobrou no acumulador
+ * (\ref SimLoopDisplay), de modo que o movimento fica suave mesmo quando a
+ * taxa de quadros não é múltipla da de simulação.
+ *
+ * \c cur guarda só o último passo: um quadro de 16 ms executa 16 passos e
+ * sobrescreve 15 valores de J. Quem precisa da série completa de 1 kHz (um
+ * log, um publicador) registra um consumidor com \ref SimLoopSetSink, chamado
+ * uma vez por passo com o tempo simulado e o estado do passo.
+ */
+#ifndef SIM_LOOP_H
+#define SIM_LOOP_H
+
+#include "spherical.h"
+
+#include <stdint.h>
+
+/** Frequência padrão da simulação (Hz). */
+#define SIM_LOOP_HZ 1000.0
+
+/** Maior atraso recuperado em um quadro (s); o excedente é descartado. */
+#define SIM_LOOP_MAX_CATCHUP 0.25
+
+/** Estado de um passo: ângulos (graus), vetores unitários e J (rad). */
+typedef struct SimState {
+    float azT, elT, azR, elR;
+    SphVec3 vT, vR;
+    float J;
+} SimState;
+
+/** Taxas de variação dos ângulos durante um quadro (graus/s). */
+typedef struct SimRates {
+    float azT, elT, azR, elR;
+} SimRates;
+
+/**
+ * \brief Consumidor de cada passo, chamado de dentro de \ref SimLoopAdvance.
+ *
+ * Roda na thread que avança a simulação, no meio do laço de passos: deve ser
+ * curto (gravar em um buffer, empilhar em uma fila) e não pode chamar as
+ * funções \c SimLoop* sobre a mesma simulação.
+ *
+ * \param t Tempo simulado do passo (s): passos desde o início × \c step.
+ * \param s Estado do passo (válido só durante a chamada).
+ * \param user Ponteiro entregue a \ref SimLoopSetSink.
+ */
+typedef void (*SimStepFn)(double t, const SimState *s, void *user);
+
+/** Acumulador e os dois últimos estados da simulação. */
+typedef struct SimLoop {
+    double step;          ///< Passo fixo (s).
+    double accumulator;   ///< Tempo real ainda não simulado (s), sempre < step após Advance.
+    uint64_t ticks;       ///< Passos executados desde o início.
+    double dropped;       ///< Tempo descartado por \ref SIM_LOOP_MAX_CATCHUP (s).
+    SimState prev, cur;
+    SimStepFn onStep;     ///< Consumidor de cada passo (NULL: nenhum).
+    void *onStepUser;     ///< Argumento de \c onStep.
+} SimLoop;
+
+/**
+ * \brief Inicia a simulação parada nos ângulos dados (graus).
+ * \param hz Frequência dos passos (por exemplo \ref SIM_LOOP_HZ).
+ */
+void SimLoopInit(SimLoop *sim, double hz, float azT, float elT, float azR, float elR);
+
+/**
+ * \brief Salto para novos ângulos (graus), sem interpolação a partir do estado anterior.
+ *
+ * Para o reset e para registros de telemetria ao vivo.
+ */
+void SimLoopSet(SimLoop *sim, float azT, float elT, float azR, float elR);
+
+/**
+ * \brief Registra o consumidor de cada passo (NULL desliga).
+ *
+ * Os saltos de \ref SimLoopSet não são passos e não chegam ao consumidor.
+ */
+void SimLoopSetSink(SimLoop *sim, SimStepFn fn, void *user);
+
+/**
+ * \brief Executa os passos fixos que cabem em \c frameTime mais o acumulado.
+ *
+ * As taxas valem para todos os passos do quadro. Elevações ficam em ±89°.
+ * Cada passo é entregue ao consumidor de \ref SimLoopSetSink, se houver.
+ *
+ * \param frameTime Tempo real desde o quadro anterior (s).
+ * \return Passos executados neste quadro.
+ */
+int SimLoopAdvance(SimLoop *sim, double frameTime, SimRates rates);
+
+/**
+ * \brief Estado para o desenho: entre \c prev e \c cur pela fração do passo no acumulador.
+ *
+ * Os vetores vêm de \ref SphSlerpUnit; os ângulos são recalculados a partir
+ * deles, com o azimute desenrolado para perto do de \c cur (os arcos de
+ * azimute continuam contando voltas). J é o do passo corrente.
+ */
+SimState SimLoopDisplay(const SimLoop *sim);
+
+#endif /* SIM_LOOP_H */
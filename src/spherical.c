@@ -0,0 +1,297 @@
+/**
+ * \file spherical.c
+ * \brief Implementação do núcleo matemático (escalar e em lote SoA).
+ *
+ * Os laços em lote são escritos de forma "amigável" ao vetorizador: sem
+ * desvios dentro do laço, com ponteiros \c restrict e acessos contíguos.
+ * O clamp do produto escalar usa operadores ternários simples, que o
+ * compilador transforma em instruções min/max vetoriais.
+ */
+#include "spherical.h"
+
+#include "spherical_acos_poly.h"
+
+#include <math.h>
+
+#define M_PI_F 3.14159265358979323846f
+
+SphVec3 SphAzElToVec(float az, float el) {
+    float ce = cosf(el);
+    SphVec3 v = { ce * cosf(az), ce * sinf(az), sinf(el) };
+    float n = sqrtf(v.x*v.x + v.y*v.y + v.z*v.z);
+    if (n > 0.0f) {
+        v.x /= n; v.y /= n; v.z /= n;
+    }
+    return v;
+}
+
+float SphAngleBetweenUnit(SphVec3 a, SphVec3 b) {
+    float c = a.x*b.x + a.y*b.y + a.z*b.z;
+    if (c > 1.0f) c = 1.0f; else if (c < -1.0f) c = -1.0f;
+    return acosf(c);
+}
+
+SphVec3 SphSlerpUnit(SphVec3 a, SphVec3 b, float t) {
+    SphArcPlan p = SphArcPrepare(a, b);
+    return SphArcPoint(&p, t);
+}
+
+SphArcPlan SphArcPrepare(SphVec3 a, SphVec3 b) {
+    SphArcPlan p;
+    // sin θ = |a × b| e θ = atan2(|a × b|, a·b): com acos(a·b) e 1/sin θ, o erro
+    // de a·b perto de 0 e de π chegava amplificado de ~1/sin θ aos pesos
+    float dot = a.x*b.x + a.y*b.y + a.z*b.z;
+    SphVec3 c = { a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x };
+    float s = sqrtf(c.x*c.x + c.y*c.y + c.z*c.z);
+    p.a = a;
+    p.b = b;
+    p.theta = atan2f(s, dot);
+    p.invSin = s < 1e-12f ? 0.0f : 1.0f / s; // iguais (ou antípodas): degenerado
+    return p;
+}
+
+SphVec3 SphArcPoint(const SphArcPlan *p, float t) {
+    if (p->invSin == 0.0f) return p->a;
+    float w0 = sinf((1.0f - t)*p->theta)*p->invSin;
+    float w1 = sinf(t*p->theta)*p->invSin;
+    SphVec3 r = { p->a.x*w0 + p->b.x*w1, p->a.y*w0 + p->b.y*w1, p->a.z*w0 + p->b.z*w1 };
+    return r;
+}
+
+void SphGreatCircleArcPoints(SphVec3 a, SphVec3 b, int steps, float scale, SphVec3 *out) {
+    // Um seno/cosseno por arco (recorrência), em vez de dois senos por ponto
+    SphSlerpBasis p = SphSlerpPrepare(a, b);
+    SphSlerpBasisUniform(&p, 0.0f, 1.0f / (float)steps, (size_t)steps + 1, out);
+    out[0] = a;
+    if (p.theta > 0.0f) out[steps] = b;
+    for (int i = 0; i <= steps; ++i) {
+        out[i] = (SphVec3){ out[i].x*scale, out[i].y*scale, out[i].z*scale };
+    }
+}
+
+float SphAngleJ(float azT, float elT, float azR, float elR) {
+    return SphAngleBetweenUnit(SphAzElToVec(azT, elT), SphAzElToVec(azR, elR));
+}
+
+void SphBatchAzElToVec(const float *az, const float *el, size_t n,
+                       float *x, float *y, float *z) {
+    const float *restrict pa = az;
+    const float *restrict pe = el;
+    float *restrict px = x;
+    float *restrict py = y;
+    float *restrict pz = z;
+    // A normalização da versão escalar é omitida: (cos El cos Az, cos El sin Az, sin El)
+    // já tem norma 1 por construção (cos² + sin² = 1).
+    for (size_t i = 0; i < n; ++i) {
+        float ce = cosf(pe[i]);
+        px[i] = ce * cosf(pa[i]);
+        py[i] = ce * sinf(pa[i]);
+        pz[i] = sinf(pe[i]);
+    }
+}
+
+void SphBatchAngleBetweenUnit(const float *ax, const float *ay, const float *az,
+                              const float *bx, const float *by, const float *bz,
+                              size_t n, float *outJ) {
+    const float *restrict pax = ax, *restrict pay = ay, *restrict paz = az;
+    const float *restrict pbx = bx, *restrict pby = by, *restrict pbz = bz;
+    float *restrict out = outJ;
+    for (size_t i = 0; i < n; ++i) {
+        float c = pax[i]*pbx[i] + pay[i]*pby[i] + paz[i]*pbz[i];
+        c = c > 1.0f ? 1.0f : c;
+        c = c < -1.0f ? -1.0f : c;
+        out[i] = c;
+    }
+    // acos em um segundo laço: o primeiro fica puramente aritmético e vetoriza.
+    for (size_t i = 0; i < n; ++i) out[i] = acosf(out[i]);
+}
+
+void SphBatchAngleJ(const float *azT, const float *elT, size_t n,
+                    float azR, float elR, float *outJ) {
+    SphVec3 r = SphAzElToVec(azR, elR);
+    float tx[SPH_BATCH_BLOCK], ty[SPH_BATCH_BLOCK], tz[SPH_BATCH_BLOCK];
+    float *restrict out = outJ;
+    for (size_t base = 0; base < n; base += SPH_BATCH_BLOCK) {
+        size_t m = n - base < SPH_BATCH_BLOCK ? n - base : SPH_BATCH_BLOCK;
+        SphBatchAzElToVec(azT + base, elT + base, m, tx, ty, tz);
+        for (size_t i = 0; i < m; ++i) {
+            float c = tx[i]*r.x + ty[i]*r.y + tz[i]*r.z;
+            c = c > 1.0f ? 1.0f : c;
+            c = c < -1.0f ? -1.0f : c;
+            out[base + i] = c;
+        }
+        for (size_t i = 0; i < m; ++i) out[base + i] = acosf(out[base + i]);
+    }
+}
+
+void SphBatchAngleJPaired(const float *azT, const float *elT,
+                          const float *azR, const float *elR,
+                          size_t n, float *outJ) {
+    float tx[SPH_BATCH_BLOCK], ty[SPH_BATCH_BLOCK], tz[SPH_BATCH_BLOCK];
+    float rx[SPH_BATCH_BLOCK], ry[SPH_BATCH_BLOCK], rz[SPH_BATCH_BLOCK];
+    for (size_t base = 0; base < n; base += SPH_BATCH_BLOCK) {
+        size_t m = n - base < SPH_BATCH_BLOCK ? n - base : SPH_BATCH_BLOCK;
+        SphBatchAzElToVec(azT + base, elT + base, m, tx, ty, tz);
+        SphBatchAzElToVec(azR + base, elR + base, m, rx, ry, rz);
+        SphBatchAngleBetweenUnit(tx, ty, tz, rx, ry, rz, m, outJ + base);
+    }
+}
+
+float SphCosThreshold(float alpha) {
+    return cosf(alpha);
+}
+
+float SphCosJ(float azT, float elT, float azR, float elR) {
+    float c = sinf(elT)*sinf(elR) + cosf(elT)*cosf(elR)*cosf(azT - azR);
+    if (c > 1.0f) c = 1.0f; else if (c < -1.0f) c = -1.0f;
+    return c;
+}
+
+void SphBatchCosJ(const float *azT, const float *elT, size_t n,
+                  float azR, float elR, float *outCosJ) {
+    const float *restrict pa = azT;
+    const float *restrict pe = elT;
+    float *restrict out = outCosJ;
+    const float sR = sinf(elR), cR = cosf(elR);
+    for (size_t i = 0; i < n; ++i) {
+        float c = sinf(pe[i])*sR + cosf(pe[i])*cR*cosf(pa[i] - azR);
+        c = c > 1.0f ? 1.0f : c;
+        c = c < -1.0f ? -1.0f : c;
+        out[i] = c;
+    }
+}
+
+size_t SphBatchGateJ(const float *azT, const float *elT, size_t n,
+                     float azR, float elR, float cosThreshold,
+                     unsigned char *inside) {
+    float cj[SPH_BATCH_BLOCK];
+    size_t count = 0;
+    for (size_t base = 0; base < n; base += SPH_BATCH_BLOCK) {
+        size_t m = n - base < SPH_BATCH_BLOCK ? n - base : SPH_BATCH_BLOCK;
+        SphBatchCosJ(azT + base, elT + base, m, azR, elR, cj);
+        if (inside) {
+            for (size_t i = 0; i < m; ++i) {
+                unsigned char in = (unsigned char)(cj[i] >= cosThreshold);
+                inside[base + i] = in;
+                count += in;
+            }
+        } else {
+            for (size_t i = 0; i < m; ++i) count += (size_t)(cj[i] >= cosThreshold);
+        }
+    }
+    return count;
+}
+
+float SphAcosApprox(float x, SphAccuracy acc) {
+    return AcosPoly(x, acc == SPH_ACCURACY_FAST);
+}
+
+void SphBatchAcosApprox(const float *in, size_t n, float *out, SphAccuracy acc) {
+    // Sem restrict: a operação no próprio arranjo (in == out) é permitida.
+    if (acc == SPH_ACCURACY_FAST) {
+        for (size_t i = 0; i < n; ++i) out[i] = AcosPoly(in[i], 1);
+    } else {
+        for (size_t i = 0; i < n; ++i) out[i] = AcosPoly(in[i], 0);
+    }
+}
+
+/** Vetor unitário perpendicular a \c a, para arcos sem plano definido. */
+static SphVec3 AnyPerpendicular(SphVec3 a) {
+    SphVec3 h = fabsf(a.x) < 0.9f ? (SphVec3){ 1.0f, 0.0f, 0.0f } : (SphVec3){ 0.0f, 1.0f, 0.0f };
+    float d = h.x*a.x + h.y*a.y + h.z*a.z;
+    SphVec3 w = { h.x - d*a.x, h.y - d*a.y, h.z - d*a.z };
+    float n = sqrtf(w.x*w.x + w.y*w.y + w.z*w.z);
+    return (SphVec3){ w.x/n, w.y/n, w.z/n };
+}
+
+SphSlerpBasis SphSlerpPrepare(SphVec3 a, SphVec3 b) {
+    SphSlerpBasis p;
+    float dot = a.x*b.x + a.y*b.y + a.z*b.z;
+    // Componente de b perpendicular a a: norma sin θ, direção w
+    SphVec3 w = { b.x - dot*a.x, b.y - dot*a.y, b.z - dot*a.z };
+    float s = sqrtf(w.x*w.x + w.y*w.y + w.z*w.z);
+    p.u = a;
+    // Abaixo de ~1e-6, w é só o arredondamento de entradas com norma 1 ± 1e-7
+    // (em antípodas, quase paralelo a a): o arco é tratado como degenerado
+    if (s > 1e-6f) {
+        w = (SphVec3){ w.x/s, w.y/s, w.z/s };
+        // Segunda passada de Gram-Schmidt: perto de π, w ainda sai inclinado para a
+        float d = w.x*a.x + w.y*a.y + w.z*a.z;
+        w = (SphVec3){ w.x - d*a.x, w.y - d*a.y, w.z - d*a.z };
+        float n = sqrtf(w.x*w.x + w.y*w.y + w.z*w.z);
+        p.w = (SphVec3){ w.x/n, w.y/n, w.z/n };
+        p.theta = atan2f(s, dot);
+    } else {
+        p.w = AnyPerpendicular(a);
+        p.theta = dot > 0.0f ? 0.0f : M_PI_F;
+    }
+    return p;
+}
+
+SphVec3 SphSlerpBasisPoint(const SphSlerpBasis *p, float t) {
+    float c = cosf(t*p->theta), s = sinf(t*p->theta);
+    SphVec3 r = { c*p->u.x + s*p->w.x, c*p->u.y + s*p->w.y, c*p->u.z + s*p->w.z };
+    return r;
+}
+
+void SphSlerpBasisUniform(const SphSlerpBasis *p, float t0, float dt, size_t n, SphVec3 *out) {
+    // Quatro recorrências intercaladas (pontos k, k+1, k+2, k+3, cada uma com
+    // passo 4Δ): as cadeias de dependência são independentes e o laço não
+    // fica preso à latência de uma única rotação.
+    enum { LANES = 4, RENORM = 16 };
+    float c[LANES], s[LANES];
+    for (int j = 0; j < LANES; ++j) {
+        c[j] = cosf((t0 + (float)j*dt)*p->theta);
+        s[j] = sinf((t0 + (float)j*dt)*p->theta);
+    }
+    const float cd = cosf(LANES*dt*p->theta), sd = sinf(LANES*dt*p->theta);
+    const SphVec3 u = p->u, w = p->w;
+    size_t k = 0;
+    for (size_t it = 1; k < n; ++it) {
+        for (int j = 0; j < LANES && k + (size_t)j < n; ++j) {
+            out[k + (size_t)j] = (SphVec3){ c[j]*u.x + s[j]*w.x, c[j]*u.y + s[j]*w.y, c[j]*u.z + s[j]*w.z };
+        }
+        k += LANES;
+        for (int j = 0; j < LANES; ++j) {
+            float cn = c[j]*cd - s[j]*sd;
+            float sn = s[j]*cd + c[j]*sd;
+            c[j] = cn;
+            s[j] = sn;
+        }
+        if (it % RENORM == 0) {
+            // Um passo de Newton para 1/sqrt(c² + s²) perto de 1: a norma não deriva
+            for (int j = 0; j < LANES; ++j) {
+                float g = 1.5f - 0.5f*(c[j]*c[j] + s[j]*s[j]);
+                c[j] *= g;
+                s[j] *= g;
+            }
+        }
+    }
+}
+
+void SphBatchSlerpPrepare(const float *ax, const float *ay, const float *az,
+                          const float *bx, const float *by, const float *bz,
+                          size_t n, const SphSlerpBatch *out) {
+    for (size_t i = 0; i < n; ++i) {
+        SphSlerpBasis p = SphSlerpPrepare((SphVec3){ ax[i], ay[i], az[i] }, (SphVec3){ bx[i], by[i], bz[i] });
+        out->ux[i] = p.u.x; out->uy[i] = p.u.y; out->uz[i] = p.u.z;
+        out->wx[i] = p.w.x; out->wy[i] = p.w.y; out->wz[i] = p.w.z;
+        out->theta[i] = p.theta;
+    }
+}
+
+void SphBatchSlerpEval(const SphSlerpBatch *bases, size_t n, float t,
+                       float *x, float *y, float *z) {
+    const float *restrict ux = bases->ux, *restrict uy = bases->uy, *restrict uz = bases->uz;
+    const float *restrict wx = bases->wx, *restrict wy = bases->wy, *restrict wz = bases->wz;
+    const float *restrict th = bases->theta;
+    float *restrict px = x;
+    float *restrict py = y;
+    float *restrict pz = z;
+    for (size_t i = 0; i < n; ++i) {
+        float c = cosf(t*th[i]), s = sinf(t*th[i]);
+        px[i] = c*ux[i] + s*wx[i];
+        py[i] = c*uy[i] + s*wy[i];
+        pz[i] = c*uz[i] + s*wz[i];
+    }
+}
@@ -0,0 +1,380 @@
+/**
+ * \file spherical.h
+ * \brief Núcleo matemático de trigonometria esférica (biblioteca \c spherical_core).
+ *
+ * Este cabeçalho expõe as mesmas funções usadas pelo visualizador
+ * (\ref SphAzElToVec, \ref SphAngleBetweenUnit, \ref SphSlerpUnit), agora sem
+ * dependência da Raylib, para que outros programas (por exemplo, um serviço
+ * de fusão de sensores) possam ligar a biblioteca diretamente.
+ *
+ * Além das versões escalares (um vetor por chamada), há versões em \b lote no
+ * formato \b SoA (structure-of-arrays): em vez de um vetor de estruturas
+ * {az, el}, recebemos um arranjo só de azimutes e outro só de elevações.
+ * Esse formato deixa os laços simples e contíguos na memória, o que permite
+ * ao compilador vetorizá-los (SIMD) e elimina o custo de uma chamada por alvo.
+ *
+ * Convenção de eixos (a mesma do visualizador): X = Norte, Y = Leste, Z = Cima.
+ * Todos os ângulos estão em radianos.
+ */
+#ifndef SPHERICAL_H
+#define SPHERICAL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Vetor 3D simples (mesmo layout do \c Vector3 da Raylib).
+ */
+typedef struct SphVec3 {
+    float x, y, z;
+} SphVec3;
+
+/**
+ * \brief Orçamento de precisão das aproximações polinomiais.
+ *
+ * Os erros indicados abaixo são os do seno/cosseno (\c SphAzElToVecSimd); os
+ * do acos estão em \ref SphAcosApprox.
+ */
+typedef enum SphAccuracy {
+    SPH_ACCURACY_PRECISE = 0, ///< Erro absoluto máximo ~1e-7 (abaixo de 1e-6 rad).
+    SPH_ACCURACY_FAST    = 1  ///< Erro ~3.3e-4 por seno/cosseno; ~4.6e-4 por componente do vetor Az/El (produto de dois), desvio abaixo de 1e-3 rad.
+} SphAccuracy;
+
+/**
+ * \brief Quantidade de elementos processados por bloco nos laços em lote.
+ *
+ * Os cálculos em lote são feitos em blocos pequenos, guardados na pilha, para
+ * que os dados intermediários (componentes x, y, z) permaneçam na cache L1.
+ */
+#define SPH_BATCH_BLOCK 256
+
+/**
+ * \brief Converte azimute/elevação (rad) em um vetor 3D unitário.
+ *
+ * \f$x = \cos(El)\cos(Az)\f$, \f$y = \cos(El)\sin(Az)\f$, \f$z = \sin(El)\f$.
+ *
+ * \param az Azimute em radianos.
+ * \param el Elevação em radianos.
+ * \return Vetor unitário correspondente.
+ */
+SphVec3 SphAzElToVec(float az, float el);
+
+/**
+ * \brief Ângulo (rad) entre dois vetores unitários: \f$\arccos(\operatorname{clamp}(a\cdot b, -1, 1))\f$.
+ */
+float SphAngleBetweenUnit(SphVec3 a, SphVec3 b);
+
+/**
+ * \brief Slerp (interpolação esférica) entre dois vetores unitários.
+ *
+ * \param a Vetor inicial (t = 0).
+ * \param b Vetor final (t = 1).
+ * \param t Parâmetro de interpolação em [0, 1].
+ */
+SphVec3 SphSlerpUnit(SphVec3 a, SphVec3 b, float t);
+
+/**
+ * \brief Arco de grande círculo pré-calculado para avaliar muitos pontos.
+ *
+ * O ângulo \f$\theta\f$ entre as extremidades e \f$1/\sin\theta\f$ são
+ * calculados uma única vez por arco (\ref SphArcPrepare), em vez de uma vez
+ * por ponto como em chamadas repetidas de \ref SphSlerpUnit.
+ */
+typedef struct SphArcPlan {
+    SphVec3 a, b;   ///< Extremidades (unitárias).
+    float theta;    ///< Ângulo entre \c a e \c b (rad).
+    float invSin;   ///< \f$1/\sin\theta\f$ (0 se o arco é degenerado).
+} SphArcPlan;
+
+/** \brief Prepara o arco de \c a até \c b (vetores unitários). */
+SphArcPlan SphArcPrepare(SphVec3 a, SphVec3 b);
+
+/** \brief Ponto do arco no parâmetro \c t em [0, 1] (igual a \ref SphSlerpUnit). */
+SphVec3 SphArcPoint(const SphArcPlan *plan, float t);
+
+/**
+ * \brief Tessela o arco de \c a até \c b em \c steps segmentos.
+ *
+ * \param a,b Extremidades (unitárias).
+ * \param steps Quantidade de segmentos (>= 1).
+ * \param scale Fator aplicado a cada ponto (por exemplo, o raio da esfera).
+ * \param out Saída com \c steps + 1 pontos (o primeiro é \c a, o último é \c b).
+ */
+void SphGreatCircleArcPoints(SphVec3 a, SphVec3 b, int steps, float scale, SphVec3 *out);
+
+/**
+ * \brief Converte N pares (az, el) em N vetores unitários, no formato SoA.
+ *
+ * \param az Arranjo com N azimutes (rad).
+ * \param el Arranjo com N elevações (rad).
+ * \param n Quantidade de elementos.
+ * \param x,y,z Arranjos de saída com N componentes cada.
+ */
+void SphBatchAzElToVec(const float *az, const float *el, size_t n,
+                       float *x, float *y, float *z);
+
+/**
+ * \brief Ângulo entre N pares de vetores unitários, no formato SoA.
+ *
+ * Equivale a chamar \ref SphAngleBetweenUnit para cada índice i.
+ *
+ * \param ax,ay,az Componentes dos vetores A.
+ * \param bx,by,bz Componentes dos vetores B.
+ * \param n Quantidade de pares.
+ * \param outJ Arranjo de saída com N ângulos (rad).
+ */
+void SphBatchAngleBetweenUnit(const float *ax, const float *ay, const float *az,
+                              const float *bx, const float *by, const float *bz,
+                              size_t n, float *outJ);
+
+/**
+ * \brief Calcula J para N alvos contra um único eixo de rolagem.
+ *
+ * O vetor do eixo R é calculado uma única vez; os vetores dos alvos são
+ * calculados em blocos de \ref SPH_BATCH_BLOCK elementos.
+ *
+ * \param azT,elT Arranjos com N azimutes/elevações dos alvos (rad).
+ * \param n Quantidade de alvos.
+ * \param azR,elR Azimute/elevação do eixo de rolagem (rad).
+ * \param outJ Arranjo de saída com N ângulos J (rad).
+ */
+void SphBatchAngleJ(const float *azT, const float *elT, size_t n,
+                    float azR, float elR, float *outJ);
+
+/**
+ * \brief Calcula J para N alvos, cada um contra o seu próprio eixo de rolagem.
+ *
+ * Útil quando cada amostra traz o eixo R do instante em que foi medida.
+ *
+ * \param azT,elT Arranjos com N azimutes/elevações dos alvos (rad).
+ * \param azR,elR Arranjos com N azimutes/elevações dos eixos (rad).
+ * \param n Quantidade de pares.
+ * \param outJ Arranjo de saída com N ângulos J (rad).
+ */
+void SphBatchAngleJPaired(const float *azT, const float *elT,
+                          const float *azR, const float *elR,
+                          size_t n, float *outJ);
+
+/**
+ * \name Modos de precisão do ângulo
+ *
+ * \f$\arccos\f$ tem derivada infinita em \f$\pm 1\f$: com \f$\cos J\f$ em
+ * float, o erro de J perto de 0° (mira) e de 180° chega a
+ * \f$\sqrt{2\varepsilon} \approx 3.5\cdot10^{-4}\f$ rad. Além da versão
+ * \c float com \c acosf (as funções sem sufixo, o caminho rápido), há:
+ * - \c Acosd: toda a conta em \c double (incluindo Az/El -> vetor no caso
+ *   de \ref SphAngleJAcosd); ajuda quando vale pagar pelo \c double.
+ * - \c Atan2: \f$J = \operatorname{atan2}(|a \times b|, a \cdot b)\f$ em
+ *   \c float, com erro da ordem de \f$10^{-7}\f$ rad em qualquer J. Note que
+ *   \ref SphAngleBetweenUnitAtan2 só é tão preciso quanto os vetores de entrada.
+ *
+ * As variantes são geradas em tempo de compilação a partir de um mesmo modelo
+ * (\c spherical_angle_kernel.h). Para escolher o modo em tempo de compilação,
+ * use \ref SPH_ANGLE_FN com \c ACOSF, \c ACOSD ou \c ATAN2:
+ * \code
+ * #define APP_ANGLE_MODE ATAN2
+ * float j = SPH_ANGLE_FN(SphAngleBetweenUnit, APP_ANGLE_MODE)(a, b);
+ * \endcode
+ * @{
+ */
+
+/** \brief Nome da variante \c base no modo \c mode (\c ACOSF, \c ACOSD ou \c ATAN2). */
+#define SPH_ANGLE_FN(base, mode) SPH_ANGLE_FN_(base, mode)
+#define SPH_ANGLE_FN_(base, mode) SPH_ANGLE_FN_##mode(base)
+#define SPH_ANGLE_FN_ACOSF(base) base
+#define SPH_ANGLE_FN_ACOSD(base) base##Acosd
+#define SPH_ANGLE_FN_ATAN2(base) base##Atan2
+
+/**
+ * \brief J entre as direções (azT, elT) e (azR, elR), em float com \c acosf.
+ */
+float SphAngleJ(float azT, float elT, float azR, float elR);
+
+/** \brief \ref SphAngleBetweenUnit com as contas em \c double. */
+float SphAngleBetweenUnitAcosd(SphVec3 a, SphVec3 b);
+/** \brief \ref SphBatchAngleBetweenUnit com as contas em \c double. */
+void SphBatchAngleBetweenUnitAcosd(const float *ax, const float *ay, const float *az,
+                                   const float *bx, const float *by, const float *bz,
+                                   size_t n, float *outJ);
+/** \brief \ref SphAngleJ com Az/El -> vetor e produto escalar em \c double. */
+float SphAngleJAcosd(float azT, float elT, float azR, float elR);
+/** \brief \ref SphBatchAngleJPaired com as contas em \c double. */
+void SphBatchAngleJPairedAcosd(const float *azT, const float *elT,
+                               const float *azR, const float *elR,
+                               size_t n, float *outJ);
+
+/** \brief \ref SphAngleBetweenUnit pela forma \f$\operatorname{atan2}(|a \times b|, a \cdot b)\f$. */
+float SphAngleBetweenUnitAtan2(SphVec3 a, SphVec3 b);
+/** \brief \ref SphBatchAngleBetweenUnit pela forma atan2. */
+void SphBatchAngleBetweenUnitAtan2(const float *ax, const float *ay, const float *az,
+                                   const float *bx, const float *by, const float *bz,
+                                   size_t n, float *outJ);
+/** \brief \ref SphAngleJ pela forma atan2. */
+float SphAngleJAtan2(float azT, float elT, float azR, float elR);
+/** \brief \ref SphBatchAngleJPaired pela forma atan2. */
+void SphBatchAngleJPairedAtan2(const float *azT, const float *elT,
+                               const float *azR, const float *elR,
+                               size_t n, float *outJ);
+
+/** @} */
+
+/**
+ * \name Teste de cone sem acos
+ *
+ * Em produção, muitas vezes só precisamos saber se "J < semiângulo do FOV".
+ * Como \f$\cos\f$ é decrescente em \f$[0, \pi]\f$, vale
+ * \f$J \le \alpha \iff \cos J \ge \cos\alpha\f$: basta comparar
+ * \f$\cos J\f$ (forma analítica ou produto escalar) com \f$\cos\alpha\f$
+ * calculado uma única vez, sem nenhum \c acosf por alvo.
+ * @{
+ */
+
+/**
+ * \brief Pré-calcula o limiar \f$\cos\alpha\f$ para um semiângulo \c alpha (rad).
+ */
+float SphCosThreshold(float alpha);
+
+/**
+ * \brief \f$\cos J\f$ pela lei dos cossenos esférica, já limitado a [-1, 1].
+ *
+ * \f$\cos J = \sin(El_T)\sin(El_R) + \cos(El_T)\cos(El_R)\cos(Az_T - Az_R)\f$.
+ */
+float SphCosJ(float azT, float elT, float azR, float elR);
+
+/**
+ * \brief Calcula \f$\cos J\f$ (forma analítica) para N alvos contra um eixo.
+ *
+ * Seno e cosseno da elevação do eixo são calculados uma única vez.
+ *
+ * \param azT,elT Arranjos com N azimutes/elevações dos alvos (rad).
+ * \param n Quantidade de alvos.
+ * \param azR,elR Azimute/elevação do eixo de rolagem (rad).
+ * \param outCosJ Arranjo de saída com N valores de \f$\cos J\f$ em [-1, 1].
+ */
+void SphBatchCosJ(const float *azT, const float *elT, size_t n,
+                  float azR, float elR, float *outCosJ);
+
+/**
+ * \brief Marca os alvos dentro do cone \f$J \le \alpha\f$ em torno do eixo R.
+ *
+ * \param azT,elT Arranjos com N azimutes/elevações dos alvos (rad).
+ * \param n Quantidade de alvos.
+ * \param azR,elR Azimute/elevação do eixo de rolagem (rad).
+ * \param cosThreshold Limiar obtido com \ref SphCosThreshold.
+ * \param inside Saída: 1 se o alvo i está dentro do cone, 0 caso contrário (pode ser NULL).
+ * \return Quantidade de alvos dentro do cone.
+ */
+size_t SphBatchGateJ(const float *azT, const float *elT, size_t n,
+                     float azR, float elR, float cosThreshold,
+                     unsigned char *inside);
+
+/**
+ * \brief Aproximação polinomial de \f$\arccos x\f$ (Abramowitz & Stegun 4.4.45/4.4.46).
+ *
+ * \f$\arccos x \approx \sqrt{1 - x}\,P(x)\f$ para \f$0 \le x \le 1\f$ e
+ * \f$\arccos(-x) = \pi - \arccos x\f$. Erros máximos (em radianos):
+ * - \ref SPH_ACCURACY_PRECISE: grau 7, \f$|\varepsilon| \le 2\cdot10^{-8}\f$ na
+ *   fórmula; avaliado em float, o erro medido fica em \f$4.3\cdot10^{-7}\f$.
+ * - \ref SPH_ACCURACY_FAST: grau 3, \f$|\varepsilon| \le 6.8\cdot10^{-5}\f$.
+ *
+ * Perto de \f$x = \pm 1\f$ (J perto de 0 ou 180°), a precisão é limitada pelo
+ * próprio \f$\cos J\f$ em float, não pelo polinômio.
+ *
+ * \param x Valor em [-1, 1] (valores fora são limitados).
+ * \param acc Orçamento de precisão.
+ */
+float SphAcosApprox(float x, SphAccuracy acc);
+
+/**
+ * \brief Aplica \ref SphAcosApprox a N valores (pode ser feito no próprio arranjo).
+ */
+void SphBatchAcosApprox(const float *in, size_t n, float *out, SphAccuracy acc);
+
+/** @} */
+
+/**
+ * \name Slerp com base pré-calculada
+ *
+ * Escrevendo o arco de \c a até \c b em uma base ortonormal do seu plano,
+ * \f$u = a\f$ e \f$w = (b - (a\cdot b)\,a)/\sin\theta\f$, o ponto no parâmetro
+ * \c t é simplesmente \f$p(t) = \cos(t\theta)\,u + \sin(t\theta)\,w\f$: um
+ * seno e um cosseno por ponto, sem divisões, e \f$\theta\f$ (com \c atan2,
+ * preciso inclusive para arcos minúsculos) só uma vez por par.
+ *
+ * Dois usos:
+ * - Um arco, muitos \c t igualmente espaçados (tesselação): a recorrência de
+ *   rotação de \ref SphSlerpBasisUniform dispensa até o seno e o cosseno.
+ * - Muitas trilhas, um \c t comum (interpolar radar de 1 Hz para a tela a
+ *   120 Hz): bases em SoA (\ref SphSlerpBatch), preparadas a cada atualização
+ *   do radar com \ref SphBatchSlerpPrepare e avaliadas a cada quadro com
+ *   \ref SphBatchSlerpEval ou, em SIMD, \c SphSlerpEvalSimd.
+ * @{
+ */
+
+/** \brief Base ortonormal de um arco: \f$p(t) = \cos(t\theta)\,u + \sin(t\theta)\,w\f$. */
+typedef struct SphSlerpBasis {
+    SphVec3 u, w;  ///< \c u = início do arco; \c w perpendicular a \c u, no plano do arco.
+    float theta;   ///< Ângulo do arco (rad), em [0, \f$\pi\f$].
+} SphSlerpBasis;
+
+/**
+ * \brief Prepara a base do arco de \c a até \c b (vetores unitários).
+ *
+ * Extremidades iguais dão \c theta = 0 (todo ponto é \c a); antípodas dão
+ * \c theta = \f$\pi\f$ com um \c w perpendicular qualquer (o arco não é único).
+ */
+SphSlerpBasis SphSlerpPrepare(SphVec3 a, SphVec3 b);
+
+/** \brief Ponto do arco no parâmetro \c t (igual a \ref SphSlerpUnit, até o arredondamento). */
+SphVec3 SphSlerpBasisPoint(const SphSlerpBasis *basis, float t);
+
+/**
+ * \brief Pontos em \f$t_k = t_0 + k\,\Delta t\f$, \f$k = 0..n-1\f$, por recorrência.
+ *
+ * Só os primeiros pontos usam seno e cosseno; os seguintes giram
+ * \f$(\cos, \sin)\f$ por um passo fixo (quatro multiplicações), com a norma
+ * corrigida periodicamente. O erro cresce devagar com \c n (~1e-6 após
+ * alguns milhares de passos).
+ */
+void SphSlerpBasisUniform(const SphSlerpBasis *basis, float t0, float dt, size_t n, SphVec3 *out);
+
+/** \brief Bases de N arcos em SoA (arranjos fornecidos por quem chama, N elementos cada). */
+typedef struct SphSlerpBatch {
+    float *ux, *uy, *uz;
+    float *wx, *wy, *wz;
+    float *theta;
+} SphSlerpBatch;
+
+/**
+ * \brief Prepara as bases dos N arcos de \c a[i] até \c b[i] (SoA).
+ *
+ * \param ax,ay,az Inícios (unitários), por exemplo a penúltima amostra de cada trilha.
+ * \param bx,by,bz Fins (unitários), por exemplo a última amostra.
+ * \param n Quantidade de arcos.
+ * \param out Bases (mesmo resultado de \ref SphSlerpPrepare por índice).
+ */
+void SphBatchSlerpPrepare(const float *ax, const float *ay, const float *az,
+                          const float *bx, const float *by, const float *bz,
+                          size_t n, const SphSlerpBatch *out);
+
+/**
+ * \brief Avalia os N arcos no mesmo parâmetro \c t (SoA, \c sinf / \c cosf da libm).
+ *
+ * \param bases Bases preparadas com \ref SphBatchSlerpPrepare.
+ * \param n Quantidade de arcos.
+ * \param t Parâmetro comum (0 = início, 1 = fim; valores fora de [0, 1] extrapolam ao longo do grande círculo).
+ * \param x,y,z Saída com N pontos.
+ */
+void SphBatchSlerpEval(const SphSlerpBatch *bases, size_t n, float t,
+                       float *x, float *y, float *z);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPHERICAL_H */
@@ -0,0 +1,41 @@
+/**
+ * \file spherical_acos_poly.h
+ * \brief Núcleo inline de \ref SphAcosApprox, compartilhado pelos kernels que o fundem no laço.
+ *
+ * Uso interno da \c spherical_core: \c spherical.c (\ref SphAcosApprox e
+ * \ref SphBatchAcosApprox) e \c spherical_jmatrix.c (epílogo da matriz J).
+ */
+#ifndef SPHERICAL_ACOS_POLY_H
+#define SPHERICAL_ACOS_POLY_H
+
+#include <math.h>
+
+/**
+ * \brief \f$\arccos x\f$ sem desvios, para que os laços em lote vetorizem.
+ *
+ * O limite |x| <= 1 vira 1 - |x| >= 0 e o reflexo para x < 0 é aritmético.
+ * \c fast seleciona o polinômio de grau 3 (deve ser constante no laço).
+ */
+static inline float AcosPoly(float x, int fast) {
+    float ax = fabsf(x);
+    float p;
+    if (fast) {
+        p = ((-0.0187293f*ax + 0.0742610f)*ax - 0.2121144f)*ax + 1.5707288f;
+    } else {
+        p = -0.0012624911f;
+        p = p*ax + 0.0066700901f;
+        p = p*ax - 0.0170881256f;
+        p = p*ax + 0.0308918810f;
+        p = p*ax - 0.0501743046f;
+        p = p*ax + 0.0889789874f;
+        p = p*ax - 0.2145988016f;
+        p = p*ax + 1.5707963050f;
+    }
+    float d = 1.0f - ax;
+    d = d > 0.0f ? d : 0.0f;
+    float r = sqrtf(d) * p;
+    float neg = x < 0.0f ? 1.0f : 0.0f;
+    return r + neg*(3.14159265358979323846f - 2.0f*r);
+}
+
+#endif /* SPHERICAL_ACOS_POLY_H */
@@ -0,0 +1,37 @@
+/**
+ * \file spherical_angle.c
+ * \brief Especializações de precisão das funções de ângulo (veja \ref spherical_angle_kernel.h).
+ */
+#include "spherical.h"
+
+#include <math.h>
+
+/* double + acos: a conversão Az/El -> vetor e o produto escalar em double */
+#define SPH_ANGLE_SUFFIX Acosd
+#define SPH_ANGLE_REAL double
+#define SPH_ANGLE_ATAN2 0
+#define SPH_ANGLE_SIN(x) sin(x)
+#define SPH_ANGLE_COS(x) cos(x)
+#define SPH_ANGLE_SQRT(x) sqrt(x)
+#define SPH_ANGLE_ACOS(x) acos(x)
+#define SPH_ANGLE_ATAN2F(y, x) atan2(y, x)
+#include "spherical_angle_kernel.h"
+#undef SPH_ANGLE_SUFFIX
+#undef SPH_ANGLE_REAL
+#undef SPH_ANGLE_ATAN2
+#undef SPH_ANGLE_SIN
+#undef SPH_ANGLE_COS
+#undef SPH_ANGLE_SQRT
+#undef SPH_ANGLE_ACOS
+#undef SPH_ANGLE_ATAN2F
+
+/* float + atan2(|a×b|, a·b): preciso perto de 0 e de π, sem sair de float */
+#define SPH_ANGLE_SUFFIX Atan2
+#define SPH_ANGLE_REAL float
+#define SPH_ANGLE_ATAN2 1
+#define SPH_ANGLE_SIN(x) sinf(x)
+#define SPH_ANGLE_COS(x) cosf(x)
+#define SPH_ANGLE_SQRT(x) sqrtf(x)
+#define SPH_ANGLE_ACOS(x) acosf(x)
+#define SPH_ANGLE_ATAN2F(y, x) atan2f(y, x)
+#include "spherical_angle_kernel.h"
@@ -0,0 +1,76 @@
+/**
+ * \file spherical_angle_kernel.h
+ * \brief Modelo (template) das funções de ângulo, especializado por modo de precisão.
+ *
+ * Como \ref spherical_simd_kernel.h, este arquivo \b não tem proteção contra
+ * inclusão múltipla: \c spherical_angle.c define as macros abaixo e o inclui
+ * uma vez por modo, gerando as funções com o sufixo do modo. A versão
+ * \c float com \c acosf continua escrita à mão em \c spherical.c e não passa
+ * por aqui.
+ *
+ * Macros exigidas:
+ * - \c SPH_ANGLE_SUFFIX   sufixo dos nomes gerados (\c Acosd, \c Atan2)
+ * - \c SPH_ANGLE_REAL     tipo usado nas contas (\c float ou \c double)
+ * - \c SPH_ANGLE_ATAN2    1: \f$J = \operatorname{atan2}(|a \times b|, a \cdot b)\f$;
+ *                         0: \f$J = \arccos(\mathrm{clamp}(a \cdot b))\f$
+ * - \c SPH_ANGLE_SIN(x) \c SPH_ANGLE_COS(x) \c SPH_ANGLE_SQRT(x)
+ *   \c SPH_ANGLE_ACOS(x) \c SPH_ANGLE_ATAN2F(y, x)  funções no tipo \c SPH_ANGLE_REAL
+ */
+
+#define SPH_ACAT_(a, b) a##b
+#define SPH_ACAT(a, b) SPH_ACAT_(a, b)
+#define SPH_AFN(name) SPH_ACAT(name, SPH_ANGLE_SUFFIX)
+
+/** Ângulo entre os vetores (ax, ay, az) e (bx, by, bz), no tipo do modo. */
+static inline SPH_ANGLE_REAL SPH_AFN(SphAngleOf)(SPH_ANGLE_REAL ax, SPH_ANGLE_REAL ay, SPH_ANGLE_REAL az,
+                                                 SPH_ANGLE_REAL bx, SPH_ANGLE_REAL by, SPH_ANGLE_REAL bz) {
+    const SPH_ANGLE_REAL d = ax*bx + ay*by + az*bz;
+#if SPH_ANGLE_ATAN2
+    // |a×b| = sin J e a·b = cos J: o atan2 não perde precisão perto de 0 nem de π
+    const SPH_ANGLE_REAL cx = ay*bz - az*by, cy = az*bx - ax*bz, cz = ax*by - ay*bx;
+    return SPH_ANGLE_ATAN2F(SPH_ANGLE_SQRT(cx*cx + cy*cy + cz*cz), d);
+#else
+    const SPH_ANGLE_REAL one = 1;
+    return SPH_ANGLE_ACOS(d > one ? one : (d < -one ? -one : d));
+#endif
+}
+
+/** Vetor unitário de (az, el) no tipo do modo. */
+static inline void SPH_AFN(SphDirOf)(float az, float el, SPH_ANGLE_REAL *x, SPH_ANGLE_REAL *y, SPH_ANGLE_REAL *z) {
+    const SPH_ANGLE_REAL a = az, e = el;
+    const SPH_ANGLE_REAL ce = SPH_ANGLE_COS(e);
+    *x = ce * SPH_ANGLE_COS(a);
+    *y = ce * SPH_ANGLE_SIN(a);
+    *z = SPH_ANGLE_SIN(e);
+}
+
+float SPH_AFN(SphAngleBetweenUnit)(SphVec3 a, SphVec3 b) {
+    return (float)SPH_AFN(SphAngleOf)(a.x, a.y, a.z, b.x, b.y, b.z);
+}
+
+void SPH_AFN(SphBatchAngleBetweenUnit)(const float *ax, const float *ay, const float *az,
+                                       const float *bx, const float *by, const float *bz,
+                                       size_t n, float *outJ) {
+    float *restrict out = outJ;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = (float)SPH_AFN(SphAngleOf)(ax[i], ay[i], az[i], bx[i], by[i], bz[i]);
+    }
+}
+
+float SPH_AFN(SphAngleJ)(float azT, float elT, float azR, float elR) {
+    SPH_ANGLE_REAL tx, ty, tz, rx, ry, rz;
+    SPH_AFN(SphDirOf)(azT, elT, &tx, &ty, &tz);
+    SPH_AFN(SphDirOf)(azR, elR, &rx, &ry, &rz);
+    return (float)SPH_AFN(SphAngleOf)(tx, ty, tz, rx, ry, rz);
+}
+
+void SPH_AFN(SphBatchAngleJPaired)(const float *azT, const float *elT,
+                                   const float *azR, const float *elR,
+                                   size_t n, float *outJ) {
+    float *restrict out = outJ;
+    for (size_t i = 0; i < n; ++i) out[i] = SPH_AFN(SphAngleJ)(azT[i], elT[i], azR[i], elR[i]);
+}
+
+#undef SPH_AFN
+#undef SPH_ACAT
+#undef SPH_ACAT_
@@ -0,0 +1,211 @@
+/**
+ * \file spherical_arena.c
+ * \brief Implementação da arena em blocos e do pool de buffers por classe de tamanho.
+ *
+ * A arena é uma lista de blocos. O bloco atual é consumido com um ponteiro
+ * que só avança; quando acaba, passa-se ao próximo bloco da lista (já
+ * alocado em um quadro anterior) ou, só no aquecimento, aloca-se um novo.
+ * \ref SphArenaReset volta ao primeiro bloco.
+ *
+ * No pool, cada buffer tem um cabeçalho de \ref SPH_ARENA_ALIGN bytes logo
+ * antes do endereço entregue, com a classe do buffer e o elo da lista livre.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "spherical_arena.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define ARENA_DEFAULT_CHUNK (1u << 20)
+
+typedef struct ArenaChunk {
+    struct ArenaChunk *next;
+    size_t size;
+    unsigned char *data;  // alinhado a SPH_ARENA_ALIGN
+} ArenaChunk;
+
+struct SphArena {
+    ArenaChunk *first, *cur;
+    size_t offset;      // próximo byte livre em cur
+    size_t used, peak;
+    size_t chunkBytes;
+};
+
+static size_t AlignUp(size_t n) {
+    return (n + SPH_ARENA_ALIGN - 1) & ~(size_t)(SPH_ARENA_ALIGN - 1);
+}
+
+static ArenaChunk *ChunkNew(size_t size) {
+    ArenaChunk *c = malloc(sizeof *c);
+    if (!c) return NULL;
+    void *data;
+    if (posix_memalign(&data, SPH_ARENA_ALIGN, size) != 0) {
+        free(c);
+        return NULL;
+    }
+    c->next = NULL;
+    c->size = size;
+    c->data = data;
+    return c;
+}
+
+SphArena *SphArenaCreate(size_t chunkBytes) {
+    SphArena *a = calloc(1, sizeof *a);
+    if (!a) return NULL;
+    a->chunkBytes = AlignUp(chunkBytes ? chunkBytes : ARENA_DEFAULT_CHUNK);
+    a->first = a->cur = ChunkNew(a->chunkBytes);
+    if (!a->first) {
+        free(a);
+        return NULL;
+    }
+    return a;
+}
+
+void SphArenaDestroy(SphArena *a) {
+    if (!a) return;
+    for (ArenaChunk *c = a->first; c;) {
+        ArenaChunk *next = c->next;
+        free(c->data);
+        free(c);
+        c = next;
+    }
+    free(a);
+}
+
+void *SphArenaAlloc(SphArena *a, size_t bytes) {
+    // Perto de SIZE_MAX, o arredondamento daria 0 e a reserva "caberia"
+    if (bytes > SIZE_MAX - (SPH_ARENA_ALIGN - 1)) return NULL;
+    bytes = AlignUp(bytes ? bytes : 1);
+    while (bytes > a->cur->size - a->offset) {
+        ArenaChunk *next = a->cur->next;
+        if (!next || next->size < bytes) {
+            // Aquecimento: o bloco novo entra logo depois do atual e fica para os próximos quadros
+            ArenaChunk *c = ChunkNew(bytes > a->chunkBytes ? bytes : a->chunkBytes);
+            if (!c) return NULL;
+            c->next = next;
+            a->cur->next = c;
+            next = c;
+        }
+        a->used += a->cur->size - a->offset; // a sobra do bloco conta como usada
+        a->cur = next;
+        a->offset = 0;
+    }
+    void *p = a->cur->data + a->offset;
+    a->offset += bytes;
+    a->used += bytes;
+    if (a->used > a->peak) a->peak = a->used;
+    return p;
+}
+
+void *SphArenaAllocArray(SphArena *a, size_t n, size_t size) {
+    if (size && n > SIZE_MAX / size) return NULL;
+    return SphArenaAlloc(a, n * size);
+}
+
+SphArenaMark SphArenaGetMark(const SphArena *a) {
+    SphArenaMark m = { a->cur, a->offset, a->used };
+    return m;
+}
+
+void SphArenaRewind(SphArena *a, SphArenaMark m) {
+    a->cur = m.chunk;
+    a->offset = m.offset;
+    a->used = m.used;
+}
+
+void SphArenaReset(SphArena *a) {
+    a->cur = a->first;
+    a->offset = 0;
+    a->used = 0;
+}
+
+size_t SphArenaUsed(const SphArena *a) {
+    return a->used;
+}
+
+size_t SphArenaPeak(const SphArena *a) {
+    return a->peak;
+}
+
+/* --- Pool de buffers --- */
+
+#define POOL_MIN_CLASS 8   // 256 bytes
+#define POOL_CLASSES 48
+// Maior classe: 2^47 bytes ou, com size_t de 32 bits, 2^30 (o cabeçalho precisa caber junto)
+#define POOL_MAX_CLASS (sizeof(size_t) * CHAR_BIT - 2 < POOL_CLASSES - 1 \
+                        ? (unsigned)(sizeof(size_t) * CHAR_BIT - 2) : POOL_CLASSES - 1)
+
+typedef union PoolHeader {
+    struct {
+        union PoolHeader *next;  // elo na lista livre da classe
+        unsigned cls;
+    } h;
+    unsigned char pad[SPH_ARENA_ALIGN];
+} PoolHeader;
+
+struct SphBufferPool {
+    PoolHeader *free[POOL_CLASSES];
+    size_t cached;
+};
+
+static unsigned ClassOf(size_t bytes) {
+    unsigned cls = POOL_MIN_CLASS;
+    while (cls < POOL_MAX_CLASS && ((size_t)1 << cls) < bytes) ++cls;
+    return cls;
+}
+
+static PoolHeader *HeaderOf(void *buffer) {
+    return (PoolHeader *)((unsigned char *)buffer - sizeof(PoolHeader));
+}
+
+SphBufferPool *SphBufferPoolCreate(void) {
+    return calloc(1, sizeof(SphBufferPool));
+}
+
+void SphBufferPoolDestroy(SphBufferPool *p) {
+    if (!p) return;
+    for (unsigned k = 0; k < POOL_CLASSES; ++k) {
+        for (PoolHeader *h = p->free[k]; h;) {
+            PoolHeader *next = h->h.next;
+            free(h);
+            h = next;
+        }
+    }
+    free(p);
+}
+
+void *SphBufferPoolAcquire(SphBufferPool *p, size_t bytes) {
+    // Acima da maior classe, a potência de 2 seguinte não caberia em size_t
+    if (bytes > ((size_t)1 << POOL_MAX_CLASS)) return NULL;
+    unsigned cls = ClassOf(bytes);
+    PoolHeader *h = p ? p->free[cls] : NULL;
+    if (h) {
+        p->free[cls] = h->h.next;
+        p->cached -= (size_t)1 << cls;
+    } else {
+        void *mem;
+        if (posix_memalign(&mem, SPH_ARENA_ALIGN, sizeof(PoolHeader) + ((size_t)1 << cls)) != 0) return NULL;
+        h = mem;
+        h->h.cls = cls;
+    }
+    h->h.next = NULL;
+    return h + 1;
+}
+
+void SphBufferPoolRelease(SphBufferPool *p, void *buffer) {
+    if (!buffer) return;
+    PoolHeader *h = HeaderOf(buffer);
+    if (!p) {
+        free(h);
+        return;
+    }
+    h->h.next = p->free[h->h.cls];
+    p->free[h->h.cls] = h;
+    p->cached += (size_t)1 << h->h.cls;
+}
+
+size_t SphBufferPoolCached(const SphBufferPool *p) {
+    return p ? p->cached : 0;
+}
@@ -0,0 +1,132 @@
+/**
+ * \file spherical_arena.h
+ * \brief Arena por quadro/lote e pool de buffers reutilizáveis.
+ *
+ * Os caminhos de tempo real (cálculo de J em lote, tesselação dos arcos,
+ * leitura de telemetria) não devem chamar \c malloc a cada quadro: além do
+ * custo, o lock do alocador aparece no p99 da latência. Dois alocadores
+ * cobrem os dois tempos de vida que aparecem nesses caminhos:
+ *
+ * - \ref SphArena: memória temporária de um quadro (ou de um lote).
+ *   \ref SphArenaAlloc só avança um ponteiro e \ref SphArenaReset devolve
+ *   tudo de uma vez, em O(1). Quando um quadro precisa de mais memória do que
+ *   a arena tem, um novo bloco é alocado e \b mantido: depois do aquecimento,
+ *   a arena não chama mais \c malloc.
+ * - \ref SphBufferPool: buffers que vivem mais que um quadro (lotes de
+ *   telemetria, buffers de saída). Os tamanhos são arredondados para
+ *   potências de 2 e os buffers liberados voltam para uma lista por classe,
+ *   prontos para a próxima aquisição do mesmo tamanho, em O(1).
+ *
+ * Nenhum dos dois usa locks: cada arena ou pool pertence a uma thread (ou é
+ * usado por várias apenas com sincronização externa). Todos os endereços
+ * devolvidos são alinhados a \ref SPH_ARENA_ALIGN bytes (linha de cache e
+ * registradores AVX-512).
+ */
+#ifndef SPHERICAL_ARENA_H
+#define SPHERICAL_ARENA_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Alinhamento, em bytes, de toda memória devolvida pela arena e pelo pool. */
+#define SPH_ARENA_ALIGN 64
+
+/** Arena opaca. */
+typedef struct SphArena SphArena;
+
+/** Posição da arena, para liberar só o que foi alocado depois dela (\ref SphArenaRewind). */
+typedef struct SphArenaMark {
+    void *chunk;
+    size_t offset;
+    size_t used;
+} SphArenaMark;
+
+/**
+ * \brief Cria uma arena com um primeiro bloco de \c chunkBytes bytes.
+ * \param chunkBytes Tamanho dos blocos (0 usa 1 MiB). Pedidos maiores ganham um bloco do próprio tamanho.
+ * \return Arena, ou NULL sem memória.
+ */
+SphArena *SphArenaCreate(size_t chunkBytes);
+
+/** \brief Libera todos os blocos da arena. */
+void SphArenaDestroy(SphArena *arena);
+
+/**
+ * \brief Reserva \c bytes bytes, alinhados a \ref SPH_ARENA_ALIGN.
+ *
+ * O conteúdo não é inicializado. A memória vale até o próximo
+ * \ref SphArenaReset (ou \ref SphArenaRewind para uma marca anterior).
+ *
+ * \return Ponteiro, ou NULL se foi preciso um novo bloco e não havia memória
+ *         (ou se \c bytes arredondado para o alinhamento não cabe em \c size_t).
+ */
+void *SphArenaAlloc(SphArena *arena, size_t bytes);
+
+/**
+ * \brief \ref SphArenaAlloc para \c n elementos de \c size bytes.
+ * \return Ponteiro, ou NULL sem memória ou se \c n × \c size não cabe em \c size_t.
+ */
+void *SphArenaAllocArray(SphArena *arena, size_t n, size_t size);
+
+/** \brief \ref SphArenaAllocArray para \c n elementos do tipo \c type. */
+#define SPH_ARENA_NEW(arena, type, n) ((type *)SphArenaAllocArray((arena), (size_t)(n), sizeof(type)))
+
+/** \brief Posição atual da arena. */
+SphArenaMark SphArenaGetMark(const SphArena *arena);
+
+/** \brief Devolve tudo o que foi alocado depois de \c mark. */
+void SphArenaRewind(SphArena *arena, SphArenaMark mark);
+
+/** \brief Devolve toda a memória da arena em O(1), mantendo os blocos para o próximo quadro. */
+void SphArenaReset(SphArena *arena);
+
+/** \brief Bytes em uso desde o último \ref SphArenaReset. */
+size_t SphArenaUsed(const SphArena *arena);
+
+/** \brief Maior valor de \ref SphArenaUsed já observado (para dimensionar \c chunkBytes). */
+size_t SphArenaPeak(const SphArena *arena);
+
+/** Pool de buffers opaco. */
+typedef struct SphBufferPool SphBufferPool;
+
+/** \brief Cria um pool vazio. \return Pool, ou NULL sem memória. */
+SphBufferPool *SphBufferPoolCreate(void);
+
+/**
+ * \brief Libera os buffers guardados no pool.
+ *
+ * Buffers ainda adquiridos continuam válidos e devem ser devolvidos com
+ * \ref SphBufferPoolRelease passando \c NULL como pool.
+ */
+void SphBufferPoolDestroy(SphBufferPool *pool);
+
+/**
+ * \brief Obtém um buffer de pelo menos \c bytes bytes, alinhado a \ref SPH_ARENA_ALIGN.
+ *
+ * Reaproveita um buffer da mesma classe (potência de 2) quando houver; senão,
+ * aloca um novo.
+ *
+ * \param pool Pool (NULL aloca diretamente, sem reaproveitamento).
+ * \return Buffer, ou NULL sem memória ou acima da maior classe (2^47 bytes;
+ *         2^30 com \c size_t de 32 bits).
+ */
+void *SphBufferPoolAcquire(SphBufferPool *pool, size_t bytes);
+
+/**
+ * \brief Devolve um buffer obtido com \ref SphBufferPoolAcquire.
+ * \param pool Pool que vai guardá-lo (NULL libera a memória).
+ * \param buffer Buffer (NULL não faz nada).
+ */
+void SphBufferPoolRelease(SphBufferPool *pool, void *buffer);
+
+/** \brief Bytes guardados no pool, prontos para reaproveitamento. */
+size_t SphBufferPoolCached(const SphBufferPool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPHERICAL_ARENA_H */
@@ -0,0 +1,147 @@
+/**
+ * \file spherical_attitude.c
+ * \brief Implementação das transformações de atitude.
+ *
+ * No referencial Norte-Leste-Cima, nariz para cima e asa direita para baixo
+ * são rotações \e negativas em torno de Y e de X (o contrário de
+ * Norte-Leste-Baixo). Por isso a matriz é a de NED conjugada por
+ * \f$F = \mathrm{diag}(1, 1, -1)\f$, e o quatérnio usa \f$-\theta\f$ e \f$-\phi\f$.
+ */
+#include "spherical_attitude.h"
+
+#include "spherical_simd.h"
+
+#include <math.h>
+
+SphQuat SphQuatFromYawPitchRoll(float yaw, float pitch, float roll) {
+    // q = qz(ψ) ⊗ qy(-θ) ⊗ qx(-φ)
+    float cy = cosf(0.5f*yaw), sy = sinf(0.5f*yaw);
+    float cp = cosf(0.5f*pitch), sp = -sinf(0.5f*pitch);
+    float cr = cosf(0.5f*roll), sr = -sinf(0.5f*roll);
+    SphQuat q = {
+        cr*cp*cy + sr*sp*sy,
+        sr*cp*cy - cr*sp*sy,
+        cr*sp*cy + sr*cp*sy,
+        cr*cp*sy - sr*sp*cy
+    };
+    return q;
+}
+
+SphQuat SphQuatMultiply(SphQuat a, SphQuat b) {
+    SphQuat q = {
+        a.w*b.w - a.x*b.x - a.y*b.y - a.z*b.z,
+        a.w*b.x + a.x*b.w + a.y*b.z - a.z*b.y,
+        a.w*b.y - a.x*b.z + a.y*b.w + a.z*b.x,
+        a.w*b.z + a.x*b.y - a.y*b.x + a.z*b.w
+    };
+    return q;
+}
+
+SphQuat SphQuatNormalize(SphQuat q) {
+    float n = sqrtf(q.w*q.w + q.x*q.x + q.y*q.y + q.z*q.z);
+    if (n > 0.0f) {
+        q.w /= n; q.x /= n; q.y /= n; q.z /= n;
+    }
+    return q;
+}
+
+SphMat3 SphQuatToMat3(SphQuat q) {
+    float xx = q.x*q.x, yy = q.y*q.y, zz = q.z*q.z;
+    float xy = q.x*q.y, xz = q.x*q.z, yz = q.y*q.z;
+    float wx = q.w*q.x, wy = q.w*q.y, wz = q.w*q.z;
+    SphMat3 m = {{
+        { 1.0f - 2.0f*(yy + zz), 2.0f*(xy - wz),        2.0f*(xz + wy) },
+        { 2.0f*(xy + wz),        1.0f - 2.0f*(xx + zz), 2.0f*(yz - wx) },
+        { 2.0f*(xz - wy),        2.0f*(yz + wx),        1.0f - 2.0f*(xx + yy) }
+    }};
+    return m;
+}
+
+SphMat3 SphAttitudeMat3(float yaw, float pitch, float roll) {
+    float cy = cosf(yaw), sy = sinf(yaw);
+    float cp = cosf(pitch), sp = sinf(pitch);
+    float cr = cosf(roll), sr = sinf(roll);
+    SphMat3 m = {{
+        { cy*cp, cy*sp*sr - sy*cr, -(cy*sp*cr + sy*sr) },
+        { sy*cp, sy*sp*sr + cy*cr, -(sy*sp*cr - cy*sr) },
+        { sp,    -cp*sr,           cp*cr }
+    }};
+    return m;
+}
+
+SphVec3 SphMat3Apply(const SphMat3 *m, SphVec3 v) {
+    SphVec3 r = {
+        m->m[0][0]*v.x + m->m[0][1]*v.y + m->m[0][2]*v.z,
+        m->m[1][0]*v.x + m->m[1][1]*v.y + m->m[1][2]*v.z,
+        m->m[2][0]*v.x + m->m[2][1]*v.y + m->m[2][2]*v.z
+    };
+    return r;
+}
+
+SphVec3 SphMat3ApplyTranspose(const SphMat3 *m, SphVec3 v) {
+    SphVec3 r = {
+        m->m[0][0]*v.x + m->m[1][0]*v.y + m->m[2][0]*v.z,
+        m->m[0][1]*v.x + m->m[1][1]*v.y + m->m[2][1]*v.z,
+        m->m[0][2]*v.x + m->m[1][2]*v.y + m->m[2][2]*v.z
+    };
+    return r;
+}
+
+void SphBatchRotate(const SphMat3 *m, const float *x, const float *y, const float *z,
+                    size_t n, float *outX, float *outY, float *outZ) {
+    // Coeficientes em registradores; sem restrict porque a rotação pode ser no lugar
+    const float m00 = m->m[0][0], m01 = m->m[0][1], m02 = m->m[0][2];
+    const float m10 = m->m[1][0], m11 = m->m[1][1], m12 = m->m[1][2];
+    const float m20 = m->m[2][0], m21 = m->m[2][1], m22 = m->m[2][2];
+    for (size_t i = 0; i < n; ++i) {
+        float vx = x[i], vy = y[i], vz = z[i];
+        outX[i] = m00*vx + m01*vy + m02*vz;
+        outY[i] = m10*vx + m11*vy + m12*vz;
+        outZ[i] = m20*vx + m21*vy + m22*vz;
+    }
+}
+
+void SphBatchBodyAzElToVec(const SphMat3 *bodyToLocal, const float *azB, const float *elB,
+                           size_t n, float *x, float *y, float *z, SphAccuracy acc) {
+    for (size_t base = 0; base < n; base += SPH_BATCH_BLOCK) {
+        size_t m = n - base < SPH_BATCH_BLOCK ? n - base : SPH_BATCH_BLOCK;
+        // O bloco recém-escrito ainda está na L1 quando é girado
+        SphAzElToVecSimd(azB + base, elB + base, m, x + base, y + base, z + base, acc);
+        SphBatchRotate(bodyToLocal, x + base, y + base, z + base, m, x + base, y + base, z + base);
+    }
+}
+
+void SphBatchBodyAzElToAzEl(const SphMat3 *bodyToLocal, const float *azB, const float *elB,
+                            size_t n, float *azL, float *elL, SphAccuracy acc) {
+    float tx[SPH_BATCH_BLOCK], ty[SPH_BATCH_BLOCK], tz[SPH_BATCH_BLOCK];
+    for (size_t base = 0; base < n; base += SPH_BATCH_BLOCK) {
+        size_t m = n - base < SPH_BATCH_BLOCK ? n - base : SPH_BATCH_BLOCK;
+        SphBatchBodyAzElToVec(bodyToLocal, azB + base, elB + base, m, tx, ty, tz, acc);
+        for (size_t i = 0; i < m; ++i) {
+            float s = tz[i];
+            s = s > 1.0f ? 1.0f : s;
+            s = s < -1.0f ? -1.0f : s;
+            azL[base + i] = atan2f(ty[i], tx[i]);
+            elL[base + i] = asinf(s);
+        }
+    }
+}
+
+void SphBatchAngleJBody(const SphMat3 *bodyToLocal, const float *azTB, const float *elTB,
+                        size_t n, float azR, float elR, float *outJ, SphAccuracy acc) {
+    // J não muda com uma rotação comum: leva-se R ao corpo uma vez, e não os N alvos ao local
+    SphVec3 r = SphMat3ApplyTranspose(bodyToLocal, SphAzElToVec(azR, elR));
+    float tx[SPH_BATCH_BLOCK], ty[SPH_BATCH_BLOCK], tz[SPH_BATCH_BLOCK];
+    float *restrict out = outJ;
+    for (size_t base = 0; base < n; base += SPH_BATCH_BLOCK) {
+        size_t m = n - base < SPH_BATCH_BLOCK ? n - base : SPH_BATCH_BLOCK;
+        SphAzElToVecSimd(azTB + base, elTB + base, m, tx, ty, tz, acc);
+        for (size_t i = 0; i < m; ++i) {
+            float c = tx[i]*r.x + ty[i]*r.y + tz[i]*r.z;
+            c = c > 1.0f ? 1.0f : c;
+            c = c < -1.0f ? -1.0f : c;
+            out[base + i] = c;
+        }
+        for (size_t i = 0; i < m; ++i) out[base + i] = acosf(out[base + i]);
+    }
+}
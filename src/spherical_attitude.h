@@ -0,0 +1,130 @@
+/**
+ * \file spherical_attitude.h
+ * \brief Atitude da aeronave (guinada/arfagem/rolamento): quatérnios, matrizes e transformações em lote.
+ *
+ * Os sensores medem Az/El no referencial do \b corpo da aeronave; o resto da
+ * biblioteca trabalha no referencial \b local (X = Norte, Y = Leste, Z = Cima).
+ * A atitude chega em alta taxa como guinada/arfagem/rolamento (ou como
+ * quatérnio, de uma central inercial) e vale para todos os alvos daquele
+ * instante: a matriz de rotação é montada \b uma vez por atitude
+ * (\ref SphAttitudeMat3 ou \ref SphQuatToMat3) e aplicada a N alvos em um só
+ * passe, sem nenhum trabalho de atitude por alvo.
+ *
+ * Convenção do corpo: X = nariz, Y = asa direita, Z = para cima (pela
+ * cabine). Com atitude nula, corpo e local coincidem. Os ângulos de atitude
+ * seguem a ordem aeronáutica usual (guinada, depois arfagem, depois
+ * rolamento, em torno dos eixos já girados):
+ * - guinada \f$\psi\f$: proa, positiva do Norte para o Leste;
+ * - arfagem \f$\theta\f$: positiva com o nariz para cima;
+ * - rolamento \f$\phi\f$: positivo com a asa direita para baixo.
+ *
+ * Az/El no corpo: azimute a partir do nariz, positivo para a asa direita;
+ * elevação positiva para cima, como em \ref SphAzElToVec. Todos os ângulos
+ * estão em radianos.
+ */
+#ifndef SPHERICAL_ATTITUDE_H
+#define SPHERICAL_ATTITUDE_H
+
+#include "spherical.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Quatérnio unitário de rotação \f$w + xi + yj + zk\f$. */
+typedef struct SphQuat {
+    float w, x, y, z;
+} SphQuat;
+
+/**
+ * \brief Matriz de rotação 3×3 (por linhas).
+ *
+ * Como matriz corpo → local, as colunas são os eixos do corpo (nariz, asa
+ * direita, cima) escritos no referencial local.
+ */
+typedef struct SphMat3 {
+    float m[3][3];
+} SphMat3;
+
+/** \brief Quatérnio corpo → local da atitude guinada/arfagem/rolamento. */
+SphQuat SphQuatFromYawPitchRoll(float yaw, float pitch, float roll);
+
+/** \brief Produto \f$a \otimes b\f$ (aplica \c b e depois \c a). */
+SphQuat SphQuatMultiply(SphQuat a, SphQuat b);
+
+/** \brief Normaliza \c q (para corrigir a deriva ao integrar a atitude). */
+SphQuat SphQuatNormalize(SphQuat q);
+
+/** \brief Matriz de rotação equivalente a um quatérnio unitário. */
+SphMat3 SphQuatToMat3(SphQuat q);
+
+/**
+ * \brief Matriz corpo → local da atitude, montada diretamente (seis senos/cossenos).
+ *
+ * Igual a \c SphQuatToMat3(SphQuatFromYawPitchRoll(yaw, pitch, roll)).
+ */
+SphMat3 SphAttitudeMat3(float yaw, float pitch, float roll);
+
+/** \brief \f$M v\f$ (corpo → local, para uma matriz de atitude). */
+SphVec3 SphMat3Apply(const SphMat3 *m, SphVec3 v);
+
+/** \brief \f$M^T v\f$: a rotação inversa (local → corpo). */
+SphVec3 SphMat3ApplyTranspose(const SphMat3 *m, SphVec3 v);
+
+/**
+ * \brief Aplica \c m a N vetores (SoA).
+ *
+ * As saídas podem ser os próprios arranjos de entrada (rotação no lugar).
+ */
+void SphBatchRotate(const SphMat3 *m, const float *x, const float *y, const float *z,
+                    size_t n, float *outX, float *outY, float *outZ);
+
+/**
+ * \brief Converte Az/El medidos no corpo em vetores unitários no referencial local.
+ *
+ * A conversão Az/El → vetor usa os kernels SIMD (\c SphAzElToVecSimd) e a
+ * rotação é feita em blocos de \ref SPH_BATCH_BLOCK ainda na L1.
+ *
+ * \param bodyToLocal Matriz de atitude (uma para todos os alvos).
+ * \param azB,elB Arranjos com N azimutes e N elevações no corpo (rad).
+ * \param n Quantidade de alvos.
+ * \param x,y,z Arranjos de saída com N componentes cada (local).
+ * \param acc Precisão do seno/cosseno.
+ */
+void SphBatchBodyAzElToVec(const SphMat3 *bodyToLocal, const float *azB, const float *elB,
+                           size_t n, float *x, float *y, float *z, SphAccuracy acc);
+
+/**
+ * \brief Converte Az/El do corpo em Az/El locais (rad), para os kernels que recebem ângulos.
+ *
+ * Azimute local em \f$(-\pi, \pi]\f$, elevação em \f$[-\pi/2, \pi/2]\f$.
+ * As saídas podem ser os próprios arranjos de entrada.
+ */
+void SphBatchBodyAzElToAzEl(const SphMat3 *bodyToLocal, const float *azB, const float *elB,
+                            size_t n, float *azL, float *elL, SphAccuracy acc);
+
+/**
+ * \brief Ângulo J entre alvos medidos no corpo e o eixo R dado no referencial local.
+ *
+ * Equivale a converter os alvos para o referencial local
+ * (\ref SphBatchBodyAzElToVec) e chamar \ref SphBatchAngleBetweenUnit contra
+ * R, mas, como o ângulo não muda com uma rotação comum, é R que vai para o
+ * corpo (\f$M^T R\f$, uma vez por lote) e os alvos não são girados.
+ *
+ * \param bodyToLocal Matriz de atitude.
+ * \param azTB,elTB Arranjos com N azimutes e N elevações dos alvos no corpo (rad).
+ * \param n Quantidade de alvos.
+ * \param azR,elR Eixo R no referencial local (rad).
+ * \param outJ Arranjo de saída com N ângulos (rad).
+ * \param acc Precisão do seno/cosseno dos alvos.
+ */
+void SphBatchAngleJBody(const SphMat3 *bodyToLocal, const float *azTB, const float *elTB,
+                        size_t n, float azR, float elR, float *outJ, SphAccuracy acc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPHERICAL_ATTITUDE_H */
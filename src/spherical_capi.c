@@ -0,0 +1,88 @@
+/**
+ * \file spherical_capi.c
+ * \brief ABI C estável: validação dos parâmetros e repasse para a \c spherical_core.
+ */
+#include "spherical_capi.h"
+
+#include "spherical.h"
+#include "spherical_geodesy.h"
+#include "spherical_simd.h"
+
+#include <math.h>
+
+/** Converte o inteiro da ABI; -1 se inválido. */
+static int ToAccuracy(int accuracy, SphAccuracy *acc) {
+    if (accuracy == SPH_LIB_PRECISE) *acc = SPH_ACCURACY_PRECISE;
+    else if (accuracy == SPH_LIB_FAST) *acc = SPH_ACCURACY_FAST;
+    else return -1;
+    return 0;
+}
+
+int SphLibAbiVersion(void) {
+    return SPH_LIB_ABI_VERSION;
+}
+
+const char *SphLibIsaName(void) {
+    return SphIsaName(SphIsaActive());
+}
+
+int SphLibAzElToVec(const float *az, const float *el, size_t n,
+                    float *x, float *y, float *z, int accuracy) {
+    SphAccuracy acc;
+    if (ToAccuracy(accuracy, &acc) != 0) return -1;
+    if (n == 0) return 0;
+    if (!az || !el || !x || !y || !z) return -1;
+    SphAzElToVecSimd(az, el, n, x, y, z, acc);
+    return 0;
+}
+
+int SphLibAngleBetween(const float *ax, const float *ay, const float *az,
+                       const float *bx, const float *by, const float *bz,
+                       size_t n, float *out, int mode) {
+    if (n == 0) return mode >= SPH_LIB_ANGLE_ACOSF && mode <= SPH_LIB_ANGLE_ATAN2 ? 0 : -1;
+    if (!ax || !ay || !az || !bx || !by || !bz || !out) return -1;
+    switch (mode) {
+    case SPH_LIB_ANGLE_ACOSF: SphBatchAngleBetweenUnit(ax, ay, az, bx, by, bz, n, out); return 0;
+    case SPH_LIB_ANGLE_ACOSD: SphBatchAngleBetweenUnitAcosd(ax, ay, az, bx, by, bz, n, out); return 0;
+    case SPH_LIB_ANGLE_ATAN2: SphBatchAngleBetweenUnitAtan2(ax, ay, az, bx, by, bz, n, out); return 0;
+    default: return -1;
+    }
+}
+
+int SphLibAngleJ(const float *azT, const float *elT, size_t n,
+                 float azR, float elR, float *out) {
+    if (n == 0) return 0;
+    if (!azT || !elT || !out) return -1;
+    SphBatchAngleJ(azT, elT, n, azR, elR, out);
+    return 0;
+}
+
+int SphLibAngleJPaired(const float *azT, const float *elT,
+                       const float *azR, const float *elR,
+                       size_t n, float *out, int mode) {
+    if (n == 0) return mode >= SPH_LIB_ANGLE_ACOSF && mode <= SPH_LIB_ANGLE_ATAN2 ? 0 : -1;
+    if (!azT || !elT || !azR || !elR || !out) return -1;
+    switch (mode) {
+    case SPH_LIB_ANGLE_ACOSF: SphBatchAngleJPaired(azT, elT, azR, elR, n, out); return 0;
+    case SPH_LIB_ANGLE_ACOSD: SphBatchAngleJPairedAcosd(azT, elT, azR, elR, n, out); return 0;
+    case SPH_LIB_ANGLE_ATAN2: SphBatchAngleJPairedAtan2(azT, elT, azR, elR, n, out); return 0;
+    default: return -1;
+    }
+}
+
+long long SphLibGateJ(const float *azT, const float *elT, size_t n,
+                      float azR, float elR, float halfAngle, unsigned char *inside) {
+    if (n == 0) return 0;
+    if (!azT || !elT || !isfinite(halfAngle)) return -1;
+    return (long long)SphBatchGateJ(azT, elT, n, azR, elR, SphCosThreshold(halfAngle), inside);
+}
+
+int SphLibHaversine(const float *lat1, const float *lon1, const float *lat2, const float *lon2,
+                    size_t n, float *out, int accuracy) {
+    SphAccuracy acc;
+    if (ToAccuracy(accuracy, &acc) != 0) return -1;
+    if (n == 0) return 0;
+    if (!lat1 || !lon1 || !lat2 || !lon2 || !out) return -1;
+    SphBatchHaversine(lat1, lon1, lat2, lon2, n, out, acc);
+    return 0;
+}
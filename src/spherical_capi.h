@@ -0,0 +1,114 @@
+/**
+ * \file spherical_capi.h
+ * \brief ABI C estável da biblioteca compartilhada \c libspherical (Python, outras linguagens).
+ *
+ * Os cabeçalhos da \c spherical_core mudam junto com o código: estruturas
+ * (\ref SphSlerpBatch, \ref SphMat3), enums e macros de tamanho de bloco são
+ * detalhes que um programa ligado estaticamente recompila sem perceber. Para
+ * quem carrega a biblioteca em tempo de execução (\c ctypes, \c cffi, outras
+ * linguagens), esta é a fronteira estável:
+ * - só tipos escalares e ponteiros para arranjos \c float contíguos, sem
+ *   estruturas nem enums na assinatura;
+ * - os buffers são sempre do chamador: nada é alocado nem guardado entre
+ *   chamadas, e as funções podem ser chamadas de várias threads ao mesmo tempo;
+ * - erros de parâmetro voltam como código (0 ou -1), nunca abortam;
+ * - só os símbolos \c SphLib* são exportados (o resto fica oculto).
+ *
+ * Mudanças que quebram a ABI incrementam \ref SPH_LIB_ABI_VERSION; funções
+ * novas podem ser acrescentadas sem incrementar. Os números são os mesmos da
+ * \c spherical_core (as funções só repassam os arranjos).
+ */
+#ifndef SPHERICAL_CAPI_H
+#define SPHERICAL_CAPI_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Versão da ABI (a de \ref SphLibAbiVersion quando o cabeçalho e a biblioteca batem). */
+#define SPH_LIB_ABI_VERSION 1
+
+#if defined(_WIN32)
+#  ifdef SPH_LIB_BUILD
+#    define SPH_LIB_API __declspec(dllexport)
+#  else
+#    define SPH_LIB_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__) || defined(__clang__)
+#  define SPH_LIB_API __attribute__((visibility("default")))
+#else
+#  define SPH_LIB_API
+#endif
+
+/** \name Parâmetros inteiros
+ * @{
+ */
+#define SPH_LIB_PRECISE 0       ///< Polinômios de seno/cosseno com erro ~1e-7 (\c SPH_ACCURACY_PRECISE).
+#define SPH_LIB_FAST 1          ///< Polinômios com erro ~5e-4 (\c SPH_ACCURACY_FAST).
+
+#define SPH_LIB_ANGLE_ACOSF 0   ///< \f$\arccos\f$ do produto escalar em float (o mais rápido).
+#define SPH_LIB_ANGLE_ACOSD 1   ///< Contas em \c double.
+#define SPH_LIB_ANGLE_ATAN2 2   ///< \f$\operatorname{atan2}(|a \times b|, a \cdot b)\f$: preciso em qualquer J.
+/** @} */
+
+/** \brief Versão da ABI compilada na biblioteca. */
+SPH_LIB_API int SphLibAbiVersion(void);
+
+/** \brief ISA usada pelos kernels SIMD nesta CPU ("avx2", "neon", ...). */
+SPH_LIB_API const char *SphLibIsaName(void);
+
+/**
+ * \brief Az/El (rad) -> vetores unitários (SoA), no back end SIMD.
+ * \param accuracy \ref SPH_LIB_PRECISE ou \ref SPH_LIB_FAST.
+ * \return 0, ou -1 se algum ponteiro for NULL com \c n > 0 ou \c accuracy for inválido.
+ */
+SPH_LIB_API int SphLibAzElToVec(const float *az, const float *el, size_t n,
+                                float *x, float *y, float *z, int accuracy);
+
+/**
+ * \brief Ângulo (rad) entre N pares de vetores unitários (SoA).
+ * \param mode \ref SPH_LIB_ANGLE_ACOSF, \ref SPH_LIB_ANGLE_ACOSD ou \ref SPH_LIB_ANGLE_ATAN2.
+ * \return 0 ou -1.
+ */
+SPH_LIB_API int SphLibAngleBetween(const float *ax, const float *ay, const float *az,
+                                   const float *bx, const float *by, const float *bz,
+                                   size_t n, float *out, int mode);
+
+/**
+ * \brief J (rad) de N alvos contra um único eixo (azR, elR), com \c acosf.
+ * \return 0 ou -1.
+ */
+SPH_LIB_API int SphLibAngleJ(const float *azT, const float *elT, size_t n,
+                             float azR, float elR, float *out);
+
+/**
+ * \brief J (rad) de N alvos, cada um contra o seu eixo.
+ * \param mode Como em \ref SphLibAngleBetween.
+ * \return 0 ou -1.
+ */
+SPH_LIB_API int SphLibAngleJPaired(const float *azT, const float *elT,
+                                   const float *azR, const float *elR,
+                                   size_t n, float *out, int mode);
+
+/**
+ * \brief Marca os alvos com \f$J \le\f$ \c halfAngle (rad) em torno do eixo.
+ * \param inside Saída com N bytes 0/1 (pode ser NULL, só para contar).
+ * \return Quantidade de alvos no cone, ou -1 se os parâmetros forem inválidos.
+ */
+SPH_LIB_API long long SphLibGateJ(const float *azT, const float *elT, size_t n,
+                                  float azR, float elR, float halfAngle, unsigned char *inside);
+
+/**
+ * \brief Ângulo central (rad) entre N pares de posições (lat/lon em rad), pela haversine.
+ * \return 0 ou -1.
+ */
+SPH_LIB_API int SphLibHaversine(const float *lat1, const float *lon1, const float *lat2, const float *lon2,
+                                size_t n, float *out, int accuracy);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPHERICAL_CAPI_H */
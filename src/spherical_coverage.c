@@ -0,0 +1,130 @@
+/**
+ * \file spherical_coverage.c
+ * \brief Implementação do mapa de cobertura por fatores separáveis e blocos paralelos.
+ *
+ * Dentro de um bloco, o laço externo é o dos eixos: para cada eixo, os
+ * fatores de coluna do bloco são calculados uma vez e reaproveitados em
+ * todas as linhas. Enquanto os eixos são percorridos, a saída \c outJ guarda
+ * o maior \f$\cos J\f$ da célula; o \c acos é aplicado uma única vez por
+ * célula, ao final do bloco.
+ */
+#include "spherical_coverage.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define M_PI_F 3.14159265358979323846f
+
+typedef struct CoverageJob {
+    const SphCoverageGrid *grid;
+    size_t nAxes;
+    float cosHalf;
+    const float *sinEl, *cosEl;    // por linha da grade
+    const float *cosAz, *sinAz;    // por coluna da grade
+    const float *sR, *cR;          // sin/cos da elevação de cada eixo
+    const float *caR, *saR;        // cos/sin do azimute de cada eixo
+    size_t tilesPerRow;
+    float *outJ;
+    uint16_t *outCount;
+} CoverageJob;
+
+SphCoverageGrid SphCoverageGridFull(float step) {
+    SphCoverageGrid g = { 0.0f, 0.0f, 0.0f, 0.0f, 0, 0 };
+    // NaN, passo <= 0 ou contagem que não cabe no size_t: grade vazia, recusada por SphCoverageCompute
+    if (!(step > 0.0f) || !(2.0f*M_PI_F / step <= SPH_COVERAGE_MAX_SIDE)) return g;
+    g.cols = (size_t)ceilf(2.0f*M_PI_F / step);
+    g.rows = (size_t)ceilf(M_PI_F / step);
+    g.dAz = 2.0f*M_PI_F / (float)g.cols;
+    g.dEl = -M_PI_F / (float)g.rows;
+    g.az0 = -M_PI_F + 0.5f*g.dAz;
+    g.el0 = 0.5f*M_PI_F + 0.5f*g.dEl;
+    return g;
+}
+
+static void CoverageTile(const CoverageJob *job, size_t tile) {
+    const size_t cols = job->grid->cols;
+    const size_t r0 = tile / job->tilesPerRow * SPH_COVERAGE_TILE_ROWS;
+    const size_t c0 = tile % job->tilesPerRow * SPH_COVERAGE_TILE_COLS;
+    const size_t nr = job->grid->rows - r0 < SPH_COVERAGE_TILE_ROWS ? job->grid->rows - r0 : SPH_COVERAGE_TILE_ROWS;
+    const size_t nc = cols - c0 < SPH_COVERAGE_TILE_COLS ? cols - c0 : SPH_COVERAGE_TILE_COLS;
+    float colF[SPH_COVERAGE_TILE_COLS];
+
+    for (size_t i = 0; i < nr; ++i) {
+        if (job->outJ) for (size_t j = 0; j < nc; ++j) job->outJ[(r0 + i)*cols + c0 + j] = -1.0f;
+        if (job->outCount) for (size_t j = 0; j < nc; ++j) job->outCount[(r0 + i)*cols + c0 + j] = 0;
+    }
+    for (size_t k = 0; k < job->nAxes; ++k) {
+        // Fatores de coluna do eixo k: cos(Az_j - Az_R)
+        const float *restrict ca = job->cosAz + c0;
+        const float *restrict sa = job->sinAz + c0;
+        const float caR = job->caR[k], saR = job->saR[k];
+        for (size_t j = 0; j < nc; ++j) colF[j] = ca[j]*caR + sa[j]*saR;
+        for (size_t i = 0; i < nr; ++i) {
+            const float a = job->sinEl[r0 + i]*job->sR[k];
+            const float b = job->cosEl[r0 + i]*job->cR[k];
+            if (job->outJ) {
+                float *restrict best = job->outJ + (r0 + i)*cols + c0;
+                for (size_t j = 0; j < nc; ++j) {
+                    float c = a + b*colF[j];
+                    best[j] = c > best[j] ? c : best[j];
+                }
+            }
+            if (job->outCount) {
+                uint16_t *restrict cnt = job->outCount + (r0 + i)*cols + c0;
+                const float th = job->cosHalf;
+                for (size_t j = 0; j < nc; ++j) cnt[j] += (uint16_t)(a + b*colF[j] >= th);
+            }
+        }
+    }
+    if (job->outJ) {
+        for (size_t i = 0; i < nr; ++i) {
+            float *row = job->outJ + (r0 + i)*cols + c0;
+            SphBatchAcosApprox(row, nc, row, SPH_ACCURACY_PRECISE);
+        }
+    }
+}
+
+static void CoverageRange(size_t begin, size_t end, void *user) {
+    for (size_t t = begin; t < end; ++t) CoverageTile(user, t);
+}
+
+int SphCoverageCompute(SphPool *pool, const SphCoverageGrid *grid,
+                       const float *azR, const float *elR, size_t nAxes, float halfAngle,
+                       float *outJ, uint16_t *outCount) {
+    if (!grid || grid->rows == 0 || grid->cols == 0 || nAxes == 0 || nAxes > UINT16_MAX) return -1;
+    // As saídas têm rows × cols células, e os fatores 2·rows + 2·cols + 4·nAxes floats
+    const size_t maxFloats = SIZE_MAX / sizeof(float);
+    if (grid->rows > SIZE_MAX / grid->cols) return -1;
+    if (grid->rows > (maxFloats - 4*nAxes) / 4 || grid->cols > (maxFloats - 4*nAxes) / 4) return -1;
+    // Um único bloco de memória para os fatores da grade e dos eixos
+    float *mem = malloc((2*grid->rows + 2*grid->cols + 4*nAxes) * sizeof(float));
+    if (!mem) return -1;
+    float *sinEl = mem, *cosEl = sinEl + grid->rows;
+    float *cosAz = cosEl + grid->rows, *sinAz = cosAz + grid->cols;
+    float *sR = sinAz + grid->cols, *cR = sR + nAxes, *caR = cR + nAxes, *saR = caR + nAxes;
+    for (size_t i = 0; i < grid->rows; ++i) {
+        float el = grid->el0 + (float)i*grid->dEl;
+        sinEl[i] = sinf(el);
+        cosEl[i] = cosf(el);
+    }
+    for (size_t j = 0; j < grid->cols; ++j) {
+        float az = grid->az0 + (float)j*grid->dAz;
+        cosAz[j] = cosf(az);
+        sinAz[j] = sinf(az);
+    }
+    for (size_t k = 0; k < nAxes; ++k) {
+        sR[k] = sinf(elR[k]);
+        cR[k] = cosf(elR[k]);
+        caR[k] = cosf(azR[k]);
+        saR[k] = sinf(azR[k]);
+    }
+    CoverageJob job = {
+        grid, nAxes, SphCosThreshold(halfAngle), sinEl, cosEl, cosAz, sinAz, sR, cR, caR, saR,
+        (grid->cols + SPH_COVERAGE_TILE_COLS - 1) / SPH_COVERAGE_TILE_COLS, outJ, outCount
+    };
+    size_t tiles = job.tilesPerRow * ((grid->rows + SPH_COVERAGE_TILE_ROWS - 1) / SPH_COVERAGE_TILE_ROWS);
+    SphPoolParallelFor(pool, tiles, 1, CoverageRange, &job);
+    free(mem);
+    return 0;
+}
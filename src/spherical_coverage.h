@@ -0,0 +1,99 @@
+/**
+ * \file spherical_coverage.h
+ * \brief Mapa de cobertura: J e pertinência ao FOV em uma grade Az/El densa, contra muitos eixos.
+ *
+ * Para estudos de posicionamento de sensores, avaliamos cada célula de uma
+ * grade Az/El (por exemplo, 0.01°: 36000 × 18000 células) contra vários
+ * eixos de rolagem candidatos. Chamar \ref SphAzElToVec e
+ * \ref SphAngleBetweenUnit por célula e por eixo custaria bilhões de senos.
+ *
+ * A lei dos cossenos esférica é separável na grade:
+ * \f[
+ *   \cos J_{ij} = \underbrace{\sin El_i \sin El_R}_{a_i}
+ *               + \underbrace{\cos El_i \cos El_R}_{b_i}\,
+ *                 \underbrace{(\cos Az_j \cos Az_R + \sin Az_j \sin Az_R)}_{c_j}
+ * \f]
+ * Os senos e cossenos da grade são calculados uma vez por linha e por
+ * coluna; para cada eixo, \f$a_i, b_i\f$ (por linha) e \f$c_j\f$ (por coluna
+ * do bloco) custam algumas multiplicações, e cada célula custa uma
+ * multiplicação-soma e uma comparação.
+ *
+ * A grade é dividida em blocos de \ref SPH_COVERAGE_TILE_ROWS ×
+ * \ref SPH_COVERAGE_TILE_COLS células, executados em paralelo pelo
+ * \ref SphPool. Cada bloco escreve só as suas células, com o mesmo código: o
+ * resultado é idêntico qualquer que seja o número de threads.
+ */
+#ifndef SPHERICAL_COVERAGE_H
+#define SPHERICAL_COVERAGE_H
+
+#include "spherical.h"
+#include "spherical_parallel.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Linhas por bloco paralelo. */
+#define SPH_COVERAGE_TILE_ROWS 16
+
+/**
+ * \brief Colunas por bloco paralelo.
+ *
+ * Os fatores \f$c_j\f$ de um eixo (8 KiB) ficam na L1 enquanto percorrem as
+ * linhas do bloco; as saídas do bloco (16 linhas, 192 KiB) ficam na L2.
+ */
+#define SPH_COVERAGE_TILE_COLS 2048
+
+/** Maior quantidade de linhas ou de colunas aceita por \ref SphCoverageGridFull. */
+#define SPH_COVERAGE_MAX_SIDE 2147483648.0f
+
+/**
+ * \brief Grade Az/El regular: a célula (i, j) está em
+ *        \f$(Az_0 + j\,\Delta Az,\; El_0 + i\,\Delta El)\f$.
+ *
+ * Os passos podem ser negativos. As saídas são matrizes \c rows × \c cols por
+ * linhas (a célula (i, j) no índice \f$i\cdot cols + j\f$).
+ */
+typedef struct SphCoverageGrid {
+    float az0, el0;    ///< Centro da primeira célula (rad).
+    float dAz, dEl;    ///< Passos entre colunas e entre linhas (rad).
+    size_t cols, rows;
+} SphCoverageGrid;
+
+/**
+ * \brief Grade da esfera inteira com passo \c step (rad), em ordem de imagem.
+ *
+ * Colunas de \f$-\pi\f$ a \f$\pi\f$ (Az crescente) e linhas de \f$+\pi/2\f$ a
+ * \f$-\pi/2\f$ (a primeira linha é a de maior elevação), com os valores nos
+ * centros das células. Com \c step não finito, não positivo ou tão pequeno
+ * que passaria de \ref SPH_COVERAGE_MAX_SIDE colunas, devolve uma grade
+ * vazia (0 × 0), recusada por \ref SphCoverageCompute.
+ */
+SphCoverageGrid SphCoverageGridFull(float step);
+
+/**
+ * \brief Calcula o mapa de cobertura da grade contra \c nAxes eixos.
+ *
+ * \param pool Pool de threads (NULL executa tudo na thread atual).
+ * \param grid Grade.
+ * \param azR,elR Arranjos com os \c nAxes eixos candidatos (rad).
+ * \param nAxes Quantidade de eixos (1 a 65535).
+ * \param halfAngle Semiângulo do FOV (rad); célula coberta por um eixo se \f$J \le\f$ \c halfAngle.
+ * \param outJ Saída (ou NULL): por célula, o menor J entre os eixos (rad),
+ *             por \ref SphAcosApprox com \ref SPH_ACCURACY_PRECISE.
+ * \param outCount Saída (ou NULL): por célula, quantos eixos a cobrem.
+ * \return 0, ou -1 se os parâmetros forem inválidos (grade vazia ou com
+ *         \c rows × \c cols fora do \c size_t) ou faltar memória.
+ */
+int SphCoverageCompute(SphPool *pool, const SphCoverageGrid *grid,
+                       const float *azR, const float *elR, size_t nAxes, float halfAngle,
+                       float *outJ, uint16_t *outCount);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPHERICAL_COVERAGE_H */
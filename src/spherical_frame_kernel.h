@@ -0,0 +1,55 @@
+/**
+ * \file spherical_frame_kernel.h
+ * \brief Modelo (template) de Az/El -> vetor, especializado por convenção de eixos e unidade.
+ *
+ * Como \ref spherical_angle_kernel.h, este arquivo \b não tem proteção contra
+ * inclusão múltipla: \c spherical_frames.c define as macros abaixo e o inclui
+ * uma vez por combinação, gerando \c SphAzElToVec<Conv><Unid> e
+ * \c SphBatchAzElToVec<Conv><Unid>.
+ *
+ * Macros exigidas:
+ * - \c SPH_FRAME_NAME   nome da convenção nos identificadores (\c Neu, \c Ned, \c Enu)
+ * - \c SPH_FRAME_XYZ(n, e, u)  os destinos Norte/Leste/"Cima" na ordem X, Y, Z da convenção
+ * - \c SPH_FRAME_EL_SIGN  -1.0f se o eixo vertical aponta para baixo, senão 1.0f
+ * - \c SPH_FRAME_UNIT   unidade (\c RAD, \c DEG ou \c MIL, veja \ref spherical_frames.h)
+ *
+ * Nada aqui faz conta por elemento: a troca de eixos é só a ordem dos
+ * ponteiros de saída, e a unidade e o eixo vertical são parâmetros
+ * constantes de \ref SphAzElToVecUnitSimd (redução na própria unidade e
+ * \f$z = -\sin El\f$). \c NeuRad chama \ref SphAzElToVecSimd direto.
+ */
+
+#define SPH_FCAT_(a, b) a##b
+#define SPH_FCAT(a, b) SPH_FCAT_(a, b)
+#define SPH_FFN(name) SPH_FCAT(SPH_FCAT(name, SPH_FRAME_NAME), SPH_FCAT(SPH_UNIT_NAME_, SPH_FRAME_UNIT))
+#define SPH_FTURN SPH_FCAT(SPH_UNIT_TURN_, SPH_FRAME_UNIT)
+
+#define SPH_FRAD (SPH_UNIT_TURN_RAD / SPH_FTURN)
+
+/** Grava \c v nos eixos da convenção (ordem dada por \c SPH_FRAME_XYZ). */
+static inline void SPH_FFN(Store)(float *px, float *py, float *pz, SphVec3 v) {
+    *px = v.x; *py = v.y; *pz = v.z;
+}
+
+SphVec3 SPH_FFN(SphAzElToVec)(float az, float el) {
+    SphVec3 out;
+    SPH_FFN(Store)(SPH_FRAME_XYZ(&out.x, &out.y, &out.z),
+                   SphAzElToVec(az * SPH_FRAD, el * (SPH_FRAME_EL_SIGN * SPH_FRAD)));
+    return out;
+}
+
+void SPH_FFN(SphBatchAzElToVec)(const float *az, const float *el, size_t n,
+                                float *x, float *y, float *z, SphAccuracy acc) {
+    // Condição constante: cada especialização compila para uma única chamada
+    if (SPH_FRAD == 1.0f && SPH_FRAME_EL_SIGN == 1.0f) {
+        SphAzElToVecSimd(az, el, n, SPH_FRAME_XYZ(x, y, z), acc);
+    } else {
+        SphAzElToVecUnitSimd(az, el, n, SPH_FRAME_XYZ(x, y, z), SPH_FTURN, SPH_FRAME_EL_SIGN < 0.0f, acc);
+    }
+}
+
+#undef SPH_FRAD
+#undef SPH_FTURN
+#undef SPH_FFN
+#undef SPH_FCAT
+#undef SPH_FCAT_
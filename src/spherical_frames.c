@@ -0,0 +1,58 @@
+/**
+ * \file spherical_frames.c
+ * \brief Especializações por convenção e unidade de Az/El -> vetor (veja \ref spherical_frame_kernel.h).
+ */
+#include "spherical_frames.h"
+
+#include "spherical_simd.h"
+
+/* X = Norte, Y = Leste, Z = Cima (o padrão da biblioteca) */
+#define SPH_FRAME_NAME Neu
+#define SPH_FRAME_XYZ(n, e, u) n, e, u
+#define SPH_FRAME_EL_SIGN 1.0f
+#define SPH_FRAME_UNIT RAD
+#include "spherical_frame_kernel.h"
+#undef SPH_FRAME_UNIT
+#define SPH_FRAME_UNIT DEG
+#include "spherical_frame_kernel.h"
+#undef SPH_FRAME_UNIT
+#define SPH_FRAME_UNIT MIL
+#include "spherical_frame_kernel.h"
+#undef SPH_FRAME_UNIT
+#undef SPH_FRAME_EL_SIGN
+#undef SPH_FRAME_XYZ
+#undef SPH_FRAME_NAME
+
+/* X = Norte, Y = Leste, Z = Baixo */
+#define SPH_FRAME_NAME Ned
+#define SPH_FRAME_XYZ(n, e, u) n, e, u
+#define SPH_FRAME_EL_SIGN -1.0f
+#define SPH_FRAME_UNIT RAD
+#include "spherical_frame_kernel.h"
+#undef SPH_FRAME_UNIT
+#define SPH_FRAME_UNIT DEG
+#include "spherical_frame_kernel.h"
+#undef SPH_FRAME_UNIT
+#define SPH_FRAME_UNIT MIL
+#include "spherical_frame_kernel.h"
+#undef SPH_FRAME_UNIT
+#undef SPH_FRAME_EL_SIGN
+#undef SPH_FRAME_XYZ
+#undef SPH_FRAME_NAME
+
+/* X = Leste, Y = Norte, Z = Cima */
+#define SPH_FRAME_NAME Enu
+#define SPH_FRAME_XYZ(n, e, u) e, n, u
+#define SPH_FRAME_EL_SIGN 1.0f
+#define SPH_FRAME_UNIT RAD
+#include "spherical_frame_kernel.h"
+#undef SPH_FRAME_UNIT
+#define SPH_FRAME_UNIT DEG
+#include "spherical_frame_kernel.h"
+#undef SPH_FRAME_UNIT
+#define SPH_FRAME_UNIT MIL
+#include "spherical_frame_kernel.h"
+#undef SPH_FRAME_UNIT
+#undef SPH_FRAME_EL_SIGN
+#undef SPH_FRAME_XYZ
+#undef SPH_FRAME_NAME
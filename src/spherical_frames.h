@@ -0,0 +1,121 @@
+/**
+ * \file spherical_frames.h
+ * \brief Convenções de eixos e unidades de ângulo especializadas em tempo de compilação.
+ *
+ * \ref SphAzElToVec fixa X = Norte, Y = Leste, Z = Cima e ângulos em
+ * radianos. Os sensores, porém, falam outras línguas: a central inercial usa
+ * NED, o mapa usa ENU e o radar relata em graus ou em milésimos. Converter
+ * no caminho quente custa uma multiplicação por ângulo (graus -> rad) e uma
+ * troca de eixos por vetor, e escolher a convenção em tempo de execução
+ * custaria um desvio por chamada.
+ *
+ * Aqui cada combinação convenção × unidade é uma função própria, gerada em
+ * tempo de compilação a partir de um mesmo modelo
+ * (\c spherical_frame_kernel.h, como em \c spherical_angle_kernel.h):
+ * - a convenção só decide qual componente vai para qual eixo e com que
+ *   sinal, sem nenhuma conta;
+ * - nas versões em lote, a unidade entra na redução de argumento do
+ *   seno/cosseno. Em graus e milésimos o quarto de volta (90°, 1600 mil) é
+ *   exato em float, e a redução \f$r = x - k\cdot\frac{1}{4}\text{volta}\f$
+ *   dispensa as três parcelas de Cody-Waite do radiano: a conversão de
+ *   unidade sai de graça, sem passada de conversão pela memória.
+ *
+ * | Convenção | X      | Y     | Z     |
+ * |-----------|--------|-------|-------|
+ * | \c NEU    | Norte  | Leste | Cima  |
+ * | \c NED    | Norte  | Leste | Baixo |
+ * | \c ENU    | Leste  | Norte | Cima  |
+ *
+ * Azimute e elevação mantêm o significado de sempre (do Norte para o Leste;
+ * positiva para cima); muda apenas o referencial do vetor de saída. Para
+ * direções no corpo da aeronave, \c NEU corresponde a nariz-asa
+ * direita-cima (a convenção de \ref spherical_attitude.h) e \c NED a
+ * nariz-asa direita-baixo (FRD).
+ *
+ * Unidades: \c RAD, \c DEG e \c MIL (milésimo OTAN, 6400 por volta).
+ * \c NEU + \c RAD é o comportamento atual de \ref SphAzElToVec, que continua
+ * sendo o padrão. Para fixar a escolha por macro, use \ref SPH_FRAME_FN:
+ * \code
+ * #define RADAR_FRAME NED
+ * #define RADAR_UNIT DEG
+ * SPH_FRAME_FN(SphBatchAzElToVec, RADAR_FRAME, RADAR_UNIT)(az, el, n, x, y, z, SPH_ACCURACY_PRECISE);
+ * // = SphBatchAzElToVecNedDeg
+ * \endcode
+ */
+#ifndef SPHERICAL_FRAMES_H
+#define SPHERICAL_FRAMES_H
+
+#include "spherical.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \name Unidades de ângulo
+ * Unidades por volta completa; as conversões são constantes dobradas pelo compilador.
+ * @{
+ */
+#define SPH_UNIT_TURN_RAD 6.28318530717958647692f
+#define SPH_UNIT_TURN_DEG 360.0f
+#define SPH_UNIT_TURN_MIL 6400.0f
+
+/** \brief Radianos por \c unit (\c RAD, \c DEG ou \c MIL). */
+#define SPH_RAD_PER(unit) (SPH_UNIT_TURN_RAD / SPH_UNIT_TURN_##unit)
+/** \brief Converte \c x de \c unit para radianos. */
+#define SPH_TO_RAD(x, unit) ((x) * SPH_RAD_PER(unit))
+/** \brief Converte \c x de radianos para \c unit. */
+#define SPH_FROM_RAD(x, unit) ((x) * (SPH_UNIT_TURN_##unit / SPH_UNIT_TURN_RAD))
+/** @} */
+
+/** \brief Nome da variante \c base na convenção \c frame (\c NEU, \c NED, \c ENU) e unidade \c unit. */
+#define SPH_FRAME_FN(base, frame, unit) SPH_FRAME_FN_(base, SPH_FRAME_NAME_##frame, SPH_UNIT_NAME_##unit)
+#define SPH_FRAME_FN_(base, f, u) SPH_FRAME_FN__(base, f, u)
+#define SPH_FRAME_FN__(base, f, u) base##f##u
+#define SPH_FRAME_NAME_NEU Neu
+#define SPH_FRAME_NAME_NED Ned
+#define SPH_FRAME_NAME_ENU Enu
+#define SPH_UNIT_NAME_RAD Rad
+#define SPH_UNIT_NAME_DEG Deg
+#define SPH_UNIT_NAME_MIL Mil
+
+/**
+ * \name Az/El -> vetor por convenção e unidade
+ *
+ * \c SphAzElToVec<Conv><Unid>: um vetor, com \c sinf/\c cosf (igual a
+ * \ref SphAzElToVec em \c NeuRad).
+ *
+ * \c SphBatchAzElToVec<Conv><Unid>: N ângulos (SoA) no back end SIMD
+ * (\ref SphAzElToVecUnitSimd), com a mesma precisão de
+ * \ref SphAzElToVecSimd para cada \c acc.
+ * @{
+ */
+
+SphVec3 SphAzElToVecNeuRad(float az, float el);
+SphVec3 SphAzElToVecNeuDeg(float az, float el);
+SphVec3 SphAzElToVecNeuMil(float az, float el);
+SphVec3 SphAzElToVecNedRad(float az, float el);
+SphVec3 SphAzElToVecNedDeg(float az, float el);
+SphVec3 SphAzElToVecNedMil(float az, float el);
+SphVec3 SphAzElToVecEnuRad(float az, float el);
+SphVec3 SphAzElToVecEnuDeg(float az, float el);
+SphVec3 SphAzElToVecEnuMil(float az, float el);
+
+void SphBatchAzElToVecNeuRad(const float *az, const float *el, size_t n, float *x, float *y, float *z, SphAccuracy acc);
+void SphBatchAzElToVecNeuDeg(const float *az, const float *el, size_t n, float *x, float *y, float *z, SphAccuracy acc);
+void SphBatchAzElToVecNeuMil(const float *az, const float *el, size_t n, float *x, float *y, float *z, SphAccuracy acc);
+void SphBatchAzElToVecNedRad(const float *az, const float *el, size_t n, float *x, float *y, float *z, SphAccuracy acc);
+void SphBatchAzElToVecNedDeg(const float *az, const float *el, size_t n, float *x, float *y, float *z, SphAccuracy acc);
+void SphBatchAzElToVecNedMil(const float *az, const float *el, size_t n, float *x, float *y, float *z, SphAccuracy acc);
+void SphBatchAzElToVecEnuRad(const float *az, const float *el, size_t n, float *x, float *y, float *z, SphAccuracy acc);
+void SphBatchAzElToVecEnuDeg(const float *az, const float *el, size_t n, float *x, float *y, float *z, SphAccuracy acc);
+void SphBatchAzElToVecEnuMil(const float *az, const float *el, size_t n, float *x, float *y, float *z, SphAccuracy acc);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPHERICAL_FRAMES_H */
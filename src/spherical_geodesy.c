@@ -0,0 +1,249 @@
+/**
+ * \file spherical_geodesy.c
+ * \brief Distância, rumo e desvio lateral: fórmulas escalares, lotes e todos os pares.
+ *
+ * Os lotes calculam os senos e cossenos de um bloco de \ref SPH_BATCH_BLOCK
+ * (\c SphAzElToVecSimd, na pilha) e, ainda na L1, aplicam as fórmulas.
+ * \ref AsinPoly e \ref Atan2Poly seguem a ideia do \c AcosPoly de
+ * \c spherical_acos_poly.h: seleções em vez de desvios, para que o laço vetorize
+ * (com \c -fno-math-errno, \c sqrtf também vira instrução; com
+ * \c -fno-trapping-math, as seleções viram máscaras em vez de desvios).
+ */
+#include "spherical_geodesy.h"
+
+#include "spherical_simd.h"
+
+#include <math.h>
+
+#define PI_F 3.14159265358979323846f
+#define PI_2_F 1.57079632679489661923f
+#define PI_4_F 0.78539816339744830962f
+
+/**
+ * \brief \f$\arcsin x\f$ em float (polinômio minimax do Cephes), erro relativo ~2.5e-7.
+ *
+ * Para \f$|x| > 1/2\f$ usa \f$\arcsin x = \pi/2 - 2\arcsin\sqrt{(1 - x)/2}\f$.
+ * Valores fora de [-1, 1] são limitados.
+ */
+static inline float AsinPoly(float x) {
+    float ax = fabsf(x);
+    ax = ax < 1.0f ? ax : 1.0f;
+    const int big = ax > 0.5f;
+    const float z = big ? 0.5f*(1.0f - ax) : ax*ax;
+    const float s = big ? sqrtf(z) : ax;
+    float p = ((((4.2163199048e-2f*z + 2.4181311049e-2f)*z + 4.5470025998e-2f)*z
+                + 7.4953002686e-2f)*z + 1.6666752422e-1f)*z*s + s;
+    p = big ? PI_2_F - 2.0f*p : p;
+    return x < 0.0f ? -p : p;
+}
+
+/**
+ * \brief \f$\operatorname{atan2}(y, x)\f$ em float (polinômio do Cephes \c atanf), erro ~1e-7 rad.
+ *
+ * Reduz para \f$a = \min/\max \in [0, 1]\f$ e, acima de \f$\tan(\pi/8)\f$, para
+ * \f$(a - 1)/(a + 1)\f$; os quadrantes são refeitos por seleções.
+ * \f$\operatorname{atan2}(0, 0) = 0\f$.
+ */
+static inline float Atan2Poly(float y, float x) {
+    const float ax = fabsf(x), ay = fabsf(y);
+    const float mx = ax > ay ? ax : ay, mn = ax > ay ? ay : ax;
+    const float a = mn / (mx > 0.0f ? mx : 1.0f);
+    const int red = a > 0.41421356f;
+    const float t = red ? (a - 1.0f) / (a + 1.0f) : a;
+    const float z = t*t;
+    float r = (((8.05374449538e-2f*z - 1.38776856032e-1f)*z + 1.99777106478e-1f)*z
+               - 3.33329491539e-1f)*z*t + t;
+    r += red ? PI_4_F : 0.0f;
+    r = ay > ax ? PI_2_F - r : r;
+    r = x < 0.0f ? PI_F - r : r;
+    return y < 0.0f ? -r : r;
+}
+
+/* --- Escalares --- */
+
+float SphHaversine(float lat1, float lon1, float lat2, float lon2) {
+    const float sdLat = sinf(0.5f*(lat2 - lat1)), sdLon = sinf(0.5f*(lon2 - lon1));
+    float h = sdLat*sdLat + cosf(lat1)*cosf(lat2)*sdLon*sdLon;
+    h = h < 1.0f ? h : 1.0f;
+    return 2.0f*asinf(sqrtf(h));
+}
+
+float SphInitialBearing(float lat1, float lon1, float lat2, float lon2) {
+    const float dLon = lon2 - lon1;
+    const float c2 = cosf(lat2);
+    return atan2f(sinf(dLon)*c2, cosf(lat1)*sinf(lat2) - sinf(lat1)*c2*cosf(dLon));
+}
+
+float SphCrossTrack(float lat1, float lon1, float lat2, float lon2, float latP, float lonP) {
+    if (lat1 == lat2 && lon1 == lon2) return 0.0f;
+    const float d1P = SphHaversine(lat1, lon1, latP, lonP);
+    const float dBearing = SphInitialBearing(lat1, lon1, latP, lonP) - SphInitialBearing(lat1, lon1, lat2, lon2);
+    float s = sinf(d1P)*sinf(dBearing);
+    s = s > 1.0f ? 1.0f : (s < -1.0f ? -1.0f : s);
+    return asinf(s);
+}
+
+/* --- Lotes por índice --- */
+
+// Com El = 0, SphAzElToVecSimd devolve (cos v, sin v, 0): seno e cosseno em lote no back end SIMD
+static const float kZeros[SPH_BATCH_BLOCK];
+
+static void BlockSinCos(const float *v, size_t m, float *s, float *c, SphAccuracy acc) {
+    float unused[SPH_BATCH_BLOCK];
+    SphAzElToVecSimd(v, kZeros, m, c, s, unused, acc);
+}
+
+/** Haversine de um bloco pelas diferenças de ângulo (precisa também para poucos metros). */
+static void BlockHaversine(const float *lat1, const float *lon1, const float *lat2, const float *lon2,
+                           size_t m, float *out, SphAccuracy acc) {
+    float hLat[SPH_BATCH_BLOCK], hLon[SPH_BATCH_BLOCK], sLat[SPH_BATCH_BLOCK], sLon[SPH_BATCH_BLOCK];
+    float cc[SPH_BATCH_BLOCK], t1[SPH_BATCH_BLOCK], t2[SPH_BATCH_BLOCK];
+    for (size_t i = 0; i < m; ++i) {
+        hLat[i] = 0.5f*(lat2[i] - lat1[i]);
+        hLon[i] = 0.5f*(lon2[i] - lon1[i]);
+    }
+    BlockSinCos(hLat, m, sLat, t1, acc);
+    BlockSinCos(hLon, m, sLon, t1, acc);
+    // Az = lat1, El = lat2: x = cos(lat1)·cos(lat2)
+    SphAzElToVecSimd(lat1, lat2, m, cc, t1, t2, acc);
+    for (size_t i = 0; i < m; ++i) {
+        float h = sLat[i]*sLat[i] + cc[i]*sLon[i]*sLon[i];
+        h = h < 1.0f ? h : 1.0f;
+        out[i] = 2.0f*AsinPoly(sqrtf(h));
+    }
+}
+
+/** Rumo inicial de um bloco: atan2(cos φ2 sin Δλ, cos φ1 sin φ2 - sin φ1 cos φ2 cos Δλ). */
+static void BlockBearing(const float *lat1, const float *lon1, const float *lat2, const float *lon2,
+                         size_t m, float *out, SphAccuracy acc) {
+    float dLon[SPH_BATCH_BLOCK], x[SPH_BATCH_BLOCK], y[SPH_BATCH_BLOCK], z[SPH_BATCH_BLOCK];
+    float s1[SPH_BATCH_BLOCK], c1[SPH_BATCH_BLOCK];
+    for (size_t i = 0; i < m; ++i) dLon[i] = lon2[i] - lon1[i];
+    // Az = Δλ, El = lat2: (cos φ2 cos Δλ, cos φ2 sin Δλ, sin φ2)
+    SphAzElToVecSimd(dLon, lat2, m, x, y, z, acc);
+    BlockSinCos(lat1, m, s1, c1, acc);
+    for (size_t i = 0; i < m; ++i) out[i] = Atan2Poly(y[i], c1[i]*z[i] - s1[i]*x[i]);
+}
+
+void SphBatchHaversine(const float *lat1, const float *lon1, const float *lat2, const float *lon2,
+                       size_t n, float *out, SphAccuracy acc) {
+    for (size_t base = 0; base < n; base += SPH_BATCH_BLOCK) {
+        const size_t m = n - base < SPH_BATCH_BLOCK ? n - base : SPH_BATCH_BLOCK;
+        BlockHaversine(lat1 + base, lon1 + base, lat2 + base, lon2 + base, m, out + base, acc);
+    }
+}
+
+void SphBatchInitialBearing(const float *lat1, const float *lon1, const float *lat2, const float *lon2,
+                            size_t n, float *out, SphAccuracy acc) {
+    for (size_t base = 0; base < n; base += SPH_BATCH_BLOCK) {
+        const size_t m = n - base < SPH_BATCH_BLOCK ? n - base : SPH_BATCH_BLOCK;
+        BlockBearing(lat1 + base, lon1 + base, lat2 + base, lon2 + base, m, out + base, acc);
+    }
+}
+
+void SphBatchCrossTrack(const float *lat1, const float *lon1, const float *lat2, const float *lon2,
+                        const float *latP, const float *lonP, size_t n, float *out, SphAccuracy acc) {
+    float d1P[SPH_BATCH_BLOCK], b1P[SPH_BATCH_BLOCK], b12[SPH_BATCH_BLOCK];
+    float sd[SPH_BATCH_BLOCK], sb[SPH_BATCH_BLOCK], unused[SPH_BATCH_BLOCK];
+    for (size_t base = 0; base < n; base += SPH_BATCH_BLOCK) {
+        const size_t m = n - base < SPH_BATCH_BLOCK ? n - base : SPH_BATCH_BLOCK;
+        // A fórmula clássica, montada com os blocos acima (a normal da rota em float
+        // perderia a direção em rotas curtas, de poucas centenas de metros)
+        BlockHaversine(lat1 + base, lon1 + base, latP + base, lonP + base, m, d1P, acc);
+        BlockBearing(lat1 + base, lon1 + base, latP + base, lonP + base, m, b1P, acc);
+        BlockBearing(lat1 + base, lon1 + base, lat2 + base, lon2 + base, m, b12, acc);
+        for (size_t i = 0; i < m; ++i) b1P[i] -= b12[i];
+        BlockSinCos(d1P, m, sd, unused, acc);
+        BlockSinCos(b1P, m, sb, unused, acc);
+        float *restrict o = out + base;
+        for (size_t i = 0; i < m; ++i) {
+            const int degenerate = lat1[base + i] == lat2[base + i] && lon1[base + i] == lon2[base + i];
+            o[i] = degenerate ? 0.0f : AsinPoly(sd[i]*sb[i]);
+        }
+    }
+}
+
+/* --- Todos os pares --- */
+
+/** Ângulo central entre vetores unitários: atan2(|a × b|, a · b), bem condicionado em todo o intervalo. */
+static inline float PairAngle(float ax, float ay, float az, float bx, float by, float bz) {
+    const float cx = ay*bz - az*by, cy = az*bx - ax*bz, cz = ax*by - ay*bx;
+    return Atan2Poly(sqrtf(cx*cx + cy*cy + cz*cz), ax*bx + ay*by + az*bz);
+}
+
+typedef struct AllPairsJob {
+    const float *ax, *ay, *az, *bx, *by, *bz;
+    size_t n, m, tilesPerRow;
+    float *out;
+} AllPairsJob;
+
+static void AllPairsTile(const AllPairsJob *job, size_t tile) {
+    const size_t r0 = tile / job->tilesPerRow * SPH_GEO_TILE_ROWS;
+    const size_t c0 = tile % job->tilesPerRow * SPH_GEO_TILE_COLS;
+    const size_t nr = job->n - r0 < SPH_GEO_TILE_ROWS ? job->n - r0 : SPH_GEO_TILE_ROWS;
+    const size_t nc = job->m - c0 < SPH_GEO_TILE_COLS ? job->m - c0 : SPH_GEO_TILE_COLS;
+    const float *restrict bx = job->bx + c0;
+    const float *restrict by = job->by + c0;
+    const float *restrict bz = job->bz + c0;
+    for (size_t i = r0; i < r0 + nr; ++i) {
+        const float ax = job->ax[i], ay = job->ay[i], az = job->az[i];
+        float *restrict o = job->out + i*job->m + c0;
+        for (size_t j = 0; j < nc; ++j) o[j] = PairAngle(ax, ay, az, bx[j], by[j], bz[j]);
+    }
+}
+
+static void AllPairsRange(size_t begin, size_t end, void *user) {
+    for (size_t t = begin; t < end; ++t) AllPairsTile(user, t);
+}
+
+int SphAllPairsDistance(SphPool *pool,
+                        const float *ax, const float *ay, const float *az, size_t n,
+                        const float *bx, const float *by, const float *bz, size_t m,
+                        float *out) {
+    if (!out || (n && (!ax || !ay || !az)) || (m && (!bx || !by || !bz))) return -1;
+    if (n == 0 || m == 0) return 0;
+    AllPairsJob job = { ax, ay, az, bx, by, bz, n, m, (m + SPH_GEO_TILE_COLS - 1) / SPH_GEO_TILE_COLS, out };
+    const size_t tiles = job.tilesPerRow * ((n + SPH_GEO_TILE_ROWS - 1) / SPH_GEO_TILE_ROWS);
+    SphPoolParallelFor(pool, tiles, 1, AllPairsRange, &job);
+    return 0;
+}
+
+size_t SphAllPairsGate(const float *ax, const float *ay, const float *az, size_t n,
+                       const float *bx, const float *by, const float *bz, size_t m,
+                       float maxAngle, SphGeoPair *out, size_t cap) {
+    // δ <= janela  <=>  corda² <= (2 sin(janela/2))²; a folga cobre o arredondamento
+    // e o ângulo exato decide os pares na borda
+    const float half = sinf(0.5f*(maxAngle < PI_F ? maxAngle : PI_F));
+    const float c2max = 4.0f*half*half*(1.0f + 1e-5f) + 1e-6f;
+    float c2[SPH_GEO_TILE_COLS];
+    size_t found = 0;
+    for (size_t r0 = 0; r0 < n; r0 += SPH_GEO_TILE_ROWS) {
+        const size_t r1 = n - r0 < SPH_GEO_TILE_ROWS ? n : r0 + SPH_GEO_TILE_ROWS;
+        for (size_t c0 = 0; c0 < m; c0 += SPH_GEO_TILE_COLS) {
+            const size_t nc = m - c0 < SPH_GEO_TILE_COLS ? m - c0 : SPH_GEO_TILE_COLS;
+            const float *restrict tbx = bx + c0;
+            const float *restrict tby = by + c0;
+            const float *restrict tbz = bz + c0;
+            for (size_t i = r0; i < r1; ++i) {
+                const float x = ax[i], y = ay[i], z = az[i];
+                for (size_t j = 0; j < nc; ++j) {
+                    const float dx = x - tbx[j], dy = y - tby[j], dz = z - tbz[j];
+                    c2[j] = dx*dx + dy*dy + dz*dz;
+                }
+                // Poucos pares passam na janela: o ângulo só é calculado para eles
+                for (size_t j = 0; j < nc; ++j) {
+                    if (c2[j] > c2max) continue;
+                    float d = PairAngle(x, y, z, tbx[j], tby[j], tbz[j]);
+                    if (d > maxAngle) continue;
+                    if (found < cap) {
+                        out[found].i = (uint32_t)i;
+                        out[found].j = (uint32_t)(c0 + j);
+                        out[found].distance = d;
+                    }
+                    ++found;
+                }
+            }
+        }
+    }
+    return found;
+}
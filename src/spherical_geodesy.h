@@ -0,0 +1,160 @@
+/**
+ * \file spherical_geodesy.h
+ * \brief Distância de grande círculo, rumo inicial e desvio lateral (modelo esférico da Terra).
+ *
+ * A mesma trigonometria esférica do ângulo J serve ao trabalho geodésico:
+ * associar trilhas de radar a relatos ADS-B pede a distância entre posições,
+ * o rumo de uma para a outra e o desvio lateral em relação a uma rota.
+ *
+ * Uma posição (latitude \f$\varphi\f$, longitude \f$\lambda\f$) é o vetor
+ * unitário \f$(\cos\varphi\cos\lambda, \cos\varphi\sin\lambda, \sin\varphi)\f$:
+ * exatamente \ref SphAzElToVec com Az = \f$\lambda\f$ e El = \f$\varphi\f$.
+ * As versões em lote (SoA) usam o mesmo back end SIMD de
+ * \ref SphAzElToVecSimd para todos os senos e cossenos, em blocos de
+ * \ref SPH_BATCH_BLOCK na pilha:
+ * - distância: haversine,
+ *   \f$\operatorname{hav}\delta = \sin^2\frac{\Delta\varphi}{2} + \cos\varphi_1\cos\varphi_2\sin^2\frac{\Delta\lambda}{2}\f$;
+ * - rumo: \f$\operatorname{atan2}(\cos\varphi_2\sin\Delta\lambda,\;
+ *   \cos\varphi_1\sin\varphi_2 - \sin\varphi_1\cos\varphi_2\cos\Delta\lambda)\f$;
+ * - desvio lateral: \f$\arcsin(\sin\delta_{1P}\,\sin(\theta_{1P} - \theta_{12}))\f$.
+ *
+ * As fórmulas partem das diferenças de ângulo, e não de diferenças entre
+ * vetores em float, para continuarem precisas em distâncias de poucos metros
+ * e em rotas curtas. \c asin e \c atan2 são polinômios sem desvios de fluxo,
+ * que o compilador vetoriza; o erro absoluto fica na ordem de
+ * \f$3\cdot10^{-7}\f$ rad (2 m na Terra). Como toda haversine, perde precisão
+ * perto das antípodas.
+ *
+ * Para a associação N × M, \ref SphAllPairsDistance e \ref SphAllPairsGate
+ * recebem as posições já convertidas em vetores (uma conversão por posição,
+ * não por par), usam \f$\operatorname{atan2}(|a \times b|, a\cdot b)\f$,
+ * bem condicionado em todo o intervalo, e percorrem a matriz em blocos que
+ * mantêm as posições do bloco na L1.
+ *
+ * Ângulos em radianos; distâncias são ângulos centrais (multiplique pelo
+ * raio, por exemplo \ref SPH_EARTH_RADIUS_M). O rumo segue o azimute da
+ * biblioteca: do Norte para o Leste, em \f$(-\pi, \pi]\f$. O desvio lateral é
+ * positivo à direita de quem percorre a rota.
+ */
+#ifndef SPHERICAL_GEODESY_H
+#define SPHERICAL_GEODESY_H
+
+#include "spherical.h"
+#include "spherical_parallel.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Raio médio da Terra (m), IUGG. */
+#define SPH_EARTH_RADIUS_M 6371008.8f
+
+/** Linhas (posições A) por bloco da matriz N × M. */
+#define SPH_GEO_TILE_ROWS 32
+
+/**
+ * \brief Colunas (posições B) por bloco da matriz N × M.
+ *
+ * Os 1024 vetores B do bloco (12 KiB) ficam na L1 enquanto as linhas do
+ * bloco os percorrem; a saída do bloco (128 KiB) fica na L2.
+ */
+#define SPH_GEO_TILE_COLS 1024
+
+/**
+ * \name Escalares (libm)
+ * Fórmulas clássicas, também usadas como referência das versões em lote.
+ * @{
+ */
+
+/** \brief Ângulo central entre duas posições pela fórmula de haversine. */
+float SphHaversine(float lat1, float lon1, float lat2, float lon2);
+
+/** \brief Rumo inicial de 1 para 2 (rad, do Norte para o Leste, em \f$(-\pi, \pi]\f$). */
+float SphInitialBearing(float lat1, float lon1, float lat2, float lon2);
+
+/**
+ * \brief Desvio lateral (ângulo central com sinal) de P em relação à rota 1 -> 2.
+ *
+ * \f$\arcsin(\sin\delta_{1P}\,\sin(\theta_{1P} - \theta_{12}))\f$: positivo à
+ * direita da rota. Rotas degeneradas (1 = 2) dão 0.
+ */
+float SphCrossTrack(float lat1, float lon1, float lat2, float lon2, float latP, float lonP);
+
+/** @} */
+
+/**
+ * \name Lotes por índice (SoA)
+ * Saída \c i a partir das entradas \c i. \c acc é o orçamento dos polinômios
+ * de seno/cosseno.
+ * @{
+ */
+
+/** \brief Ângulo central entre as posições 1 e 2 de cada índice. */
+void SphBatchHaversine(const float *lat1, const float *lon1, const float *lat2, const float *lon2,
+                       size_t n, float *out, SphAccuracy acc);
+
+/** \brief Rumo inicial de 1 para 2 em cada índice. */
+void SphBatchInitialBearing(const float *lat1, const float *lon1, const float *lat2, const float *lon2,
+                            size_t n, float *out, SphAccuracy acc);
+
+/** \brief Desvio lateral de P[i] em relação à rota 1[i] -> 2[i]. */
+void SphBatchCrossTrack(const float *lat1, const float *lon1, const float *lat2, const float *lon2,
+                        const float *latP, const float *lonP, size_t n, float *out, SphAccuracy acc);
+
+/** @} */
+
+/**
+ * \name Todos os pares (N × M)
+ * Posições como vetores unitários em SoA, por exemplo de
+ * \c SphAzElToVecSimd(lon, lat, ...).
+ * @{
+ */
+
+/**
+ * \brief Ângulo central entre cada A[i] e cada B[j].
+ *
+ * Blocos de \ref SPH_GEO_TILE_ROWS × \ref SPH_GEO_TILE_COLS em paralelo no
+ * \c pool; o resultado não depende do número de threads.
+ *
+ * \param pool Pool de threads (NULL executa tudo na thread atual).
+ * \param out Matriz \c n × \c m por linhas: \c out[i*m + j].
+ * \return 0, ou -1 se os parâmetros forem inválidos.
+ */
+int SphAllPairsDistance(SphPool *pool,
+                        const float *ax, const float *ay, const float *az, size_t n,
+                        const float *bx, const float *by, const float *bz, size_t m,
+                        float *out);
+
+/** Par (A[i], B[j]) dentro da janela de associação. */
+typedef struct SphGeoPair {
+    uint32_t i, j;
+    float distance;  ///< Ângulo central (rad).
+} SphGeoPair;
+
+/**
+ * \brief Pares com ângulo central até \c maxAngle, sem a matriz N × M.
+ *
+ * A janela é testada pela corda ao quadrado (três multiplicações-somas por
+ * par); o ângulo só é calculado para os pares aceitos. Os pares saem em
+ * ordem de bloco (dentro de um bloco, por \c i e depois por \c j). Para usar
+ * várias threads, divida A entre elas.
+ *
+ * \param maxAngle Janela (rad, em [0, \f$\pi\f$]).
+ * \param out Saída com até \c cap pares (pode ser NULL com \c cap = 0, só para contar).
+ * \return Quantidade total de pares na janela (pode passar de \c cap: só os
+ *         \c cap primeiros são escritos).
+ */
+size_t SphAllPairsGate(const float *ax, const float *ay, const float *az, size_t n,
+                       const float *bx, const float *by, const float *bz, size_t m,
+                       float maxAngle, SphGeoPair *out, size_t cap);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPHERICAL_GEODESY_H */
@@ -0,0 +1,428 @@
+/**
+ * \file spherical_index.c
+ * \brief Implementação do índice espacial em grade de cubo.
+ */
+#include "spherical_index.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SPH_PI_F 3.14159265358979323846f
+
+/** Resumo de uma região (célula ou bloco): centro e raio angular. */
+typedef struct SphCap {
+    float x, y, z;      ///< Centro (unitário).
+    float r;            ///< Raio angular até o canto mais distante (rad).
+    float cosR, sinR;
+} SphCap;
+
+struct SphIndex {
+    int grid, blocksPerEdge;
+    size_t cells, blocks;
+    size_t capacity, count;
+
+    SphCap *cellCaps, *blockCaps;
+
+    // Itens por identificador: coordenadas e célula atual
+    float *x, *y, *z;
+    uint32_t *cellOf, *slotOf;
+
+    // Itens em ordem de célula (SoA), com folga no fim de cada célula:
+    // a célula c ocupa [start[c], start[c] + len[c]) de [start[c], start[c+1])
+    float *sx, *sy, *sz;
+    uint32_t *sid;
+    uint32_t *start, *len;
+    size_t slots;
+};
+
+/* --- Geometria da grade --- */
+
+/** Transformação quadrática do S2: u em [-1, 1] -> s em [0, 1]. */
+static float UvToSt(float u) {
+    return u >= 0.0f ? 0.5f * sqrtf(1.0f + 3.0f*u) : 1.0f - 0.5f * sqrtf(1.0f - 3.0f*u);
+}
+
+static float StToUv(float s) {
+    return s >= 0.5f ? (4.0f*s*s - 1.0f) / 3.0f : (1.0f - 4.0f*(1.0f - s)*(1.0f - s)) / 3.0f;
+}
+
+/** Face (0..5: +X, +Y, +Z, -X, -Y, -Z) e coordenadas (u, v) de um vetor. */
+static int FaceUv(float x, float y, float z, float *u, float *v) {
+    const float ax = fabsf(x), ay = fabsf(y), az = fabsf(z);
+    if (ax >= ay && ax >= az) { *u = y / ax; *v = z / ax; return x >= 0.0f ? 0 : 3; }
+    if (ay >= az)            { *u = z / ay; *v = x / ay; return y >= 0.0f ? 1 : 4; }
+    *u = x / az; *v = y / az; return z >= 0.0f ? 2 : 5;
+}
+
+/** Inverso de \ref FaceUv (vetor unitário). */
+static SphVec3 FaceUvToVec(int face, float u, float v) {
+    const float sg = face < 3 ? 1.0f : -1.0f;
+    float c[3];
+    const int a = face % 3;
+    c[a] = sg;
+    c[(a + 1) % 3] = u;
+    c[(a + 2) % 3] = v;
+    const float n = 1.0f / sqrtf(c[0]*c[0] + c[1]*c[1] + c[2]*c[2]);
+    SphVec3 r = { c[0]*n, c[1]*n, c[2]*n };
+    return r;
+}
+
+static uint32_t CellOf(const SphIndex *ix, float x, float y, float z) {
+    float u, v;
+    const int face = FaceUv(x, y, z, &u, &v);
+    const int g = ix->grid;
+    int i = (int)(UvToSt(u) * (float)g);
+    int j = (int)(UvToSt(v) * (float)g);
+    i = i < 0 ? 0 : (i >= g ? g - 1 : i);
+    j = j < 0 ? 0 : (j >= g ? g - 1 : j);
+    // Células numeradas por bloco, para que as de um bloco fiquem contíguas
+    const int b = SPH_INDEX_BLOCK, bpe = ix->blocksPerEdge;
+    const size_t block = ((size_t)face * (size_t)bpe + (size_t)(j / b)) * (size_t)bpe + (size_t)(i / b);
+    return (uint32_t)(block * (size_t)(b * b) + (size_t)((j % b) * b + i % b));
+}
+
+static float AngleTo(SphVec3 a, SphVec3 b) {
+    float d = a.x*b.x + a.y*b.y + a.z*b.z;
+    d = d > 1.0f ? 1.0f : (d < -1.0f ? -1.0f : d);
+    return acosf(d);
+}
+
+/** Resumo da região [s0, s1] x [t0, t1] de uma face (coordenadas s, t). */
+static SphCap MakeCap(int face, float s0, float s1, float t0, float t1) {
+    SphVec3 c = FaceUvToVec(face, StToUv(0.5f*(s0 + s1)), StToUv(0.5f*(t0 + t1)));
+    const float ss[2] = { s0, s1 }, ts[2] = { t0, t1 };
+    float r = 0.0f;
+    for (int k = 0; k < 4; ++k) {
+        float a = AngleTo(c, FaceUvToVec(face, StToUv(ss[k & 1]), StToUv(ts[k >> 1])));
+        if (a > r) r = a;
+    }
+    r *= 1.0001f; // folga para arredondamentos
+    SphCap cap = { c.x, c.y, c.z, r, cosf(r), sinf(r) };
+    return cap;
+}
+
+/* --- Criação e atualização --- */
+
+SphIndex *SphIndexCreate(int gridSize, size_t capacity) {
+    if (gridSize == 0) gridSize = 64;
+    if (gridSize < SPH_INDEX_BLOCK || gridSize % SPH_INDEX_BLOCK != 0) return NULL;
+    if (capacity >= UINT32_MAX / 2) return NULL;
+    SphIndex *ix = calloc(1, sizeof *ix);
+    if (!ix) return NULL;
+    ix->grid = gridSize;
+    ix->blocksPerEdge = gridSize / SPH_INDEX_BLOCK;
+    ix->cells = 6u * (size_t)gridSize * (size_t)gridSize;
+    ix->blocks = 6u * (size_t)ix->blocksPerEdge * (size_t)ix->blocksPerEdge;
+    ix->capacity = capacity;
+    ix->cellCaps = malloc(ix->cells * sizeof *ix->cellCaps);
+    ix->blockCaps = malloc(ix->blocks * sizeof *ix->blockCaps);
+    ix->start = calloc(ix->cells + 1, sizeof *ix->start);
+    ix->len = calloc(ix->cells, sizeof *ix->len);
+    ix->x = malloc((capacity ? capacity : 1) * 3 * sizeof *ix->x);
+    ix->cellOf = malloc((capacity ? capacity : 1) * 2 * sizeof *ix->cellOf);
+    if (!ix->cellCaps || !ix->blockCaps || !ix->start || !ix->len || !ix->x || !ix->cellOf) {
+        SphIndexDestroy(ix);
+        return NULL;
+    }
+    ix->y = ix->x + capacity; ix->z = ix->y + capacity;
+    ix->slotOf = ix->cellOf + capacity;
+    // Pior caso do Relayout: capacity + capacity/4 + 2 por célula
+    ix->slots = capacity + capacity / 4 + 2 * ix->cells;
+    ix->sx = malloc(ix->slots * 3 * sizeof *ix->sx);
+    ix->sid = malloc(ix->slots * sizeof *ix->sid);
+    if (!ix->sx || !ix->sid) {
+        SphIndexDestroy(ix);
+        return NULL;
+    }
+    ix->sy = ix->sx + ix->slots; ix->sz = ix->sy + ix->slots;
+
+    const int b = SPH_INDEX_BLOCK, bpe = ix->blocksPerEdge;
+    const float inv = 1.0f / (float)gridSize;
+    for (int face = 0; face < 6; ++face) {
+        for (int bj = 0; bj < bpe; ++bj) {
+            for (int bi = 0; bi < bpe; ++bi) {
+                const size_t block = ((size_t)face * (size_t)bpe + (size_t)bj) * (size_t)bpe + (size_t)bi;
+                ix->blockCaps[block] = MakeCap(face, (float)(bi*b) * inv, (float)((bi + 1)*b) * inv,
+                                               (float)(bj*b) * inv, (float)((bj + 1)*b) * inv);
+                for (int cj = 0; cj < b; ++cj) {
+                    for (int ci = 0; ci < b; ++ci) {
+                        const int i = bi*b + ci, j = bj*b + cj;
+                        ix->cellCaps[block * (size_t)(b*b) + (size_t)(cj*b + ci)] =
+                            MakeCap(face, (float)i * inv, (float)(i + 1) * inv, (float)j * inv, (float)(j + 1) * inv);
+                    }
+                }
+            }
+        }
+    }
+    return ix;
+}
+
+void SphIndexDestroy(SphIndex *ix) {
+    if (!ix) return;
+    free(ix->cellCaps);
+    free(ix->blockCaps);
+    free(ix->start);
+    free(ix->len);
+    free(ix->x);
+    free(ix->cellOf);
+    free(ix->sx);
+    free(ix->sid);
+    free(ix);
+}
+
+size_t SphIndexCount(const SphIndex *ix) {
+    return ix->count;
+}
+
+/**
+ * \brief Redistribui os itens em ordem de célula, com folga de ~25% + 2 por célula.
+ *
+ * Cabe sempre nos \c slots reservados na criação, então nunca aloca memória.
+ */
+static void Relayout(SphIndex *ix) {
+    const size_t cells = ix->cells, n = ix->count;
+    uint32_t *start = ix->start, *len = ix->len;
+    memset(len, 0, cells * sizeof *len);
+    for (size_t i = 0; i < n; ++i) len[ix->cellOf[i]]++;
+    size_t total = 0;
+    for (size_t c = 0; c < cells; ++c) {
+        start[c] = (uint32_t)total;
+        total += len[c] + len[c] / 4 + 2;
+    }
+    start[cells] = (uint32_t)total;
+    memset(len, 0, cells * sizeof *len);
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t c = ix->cellOf[i];
+        const uint32_t slot = start[c] + len[c]++;
+        ix->sx[slot] = ix->x[i]; ix->sy[slot] = ix->y[i]; ix->sz[slot] = ix->z[i];
+        ix->sid[slot] = (uint32_t)i;
+        ix->slotOf[i] = slot;
+    }
+}
+
+int SphIndexBuild(SphIndex *ix, const float *x, const float *y, const float *z, size_t n) {
+    if (n > ix->capacity) return -1;
+    memcpy(ix->x, x, n * sizeof *x);
+    memcpy(ix->y, y, n * sizeof *y);
+    memcpy(ix->z, z, n * sizeof *z);
+    for (size_t i = 0; i < n; ++i) ix->cellOf[i] = CellOf(ix, x[i], y[i], z[i]);
+    ix->count = n;
+    Relayout(ix);
+    return 0;
+}
+
+/**
+ * \brief Move o item \c id para \c v mantendo o layout por célula.
+ * \return 0, ou -1 se a nova célula não tem folga (nesse caso o item já foi
+ *         retirado da célula antiga e só \c cellOf e as coordenadas estão
+ *         atualizadas: é preciso chamar \ref Relayout).
+ */
+static int MoveItem(SphIndex *ix, size_t id, SphVec3 v, uint32_t cell) {
+    const uint32_t old = ix->cellOf[id];
+    ix->x[id] = v.x; ix->y[id] = v.y; ix->z[id] = v.z;
+    if (cell == old) {
+        const uint32_t slot = ix->slotOf[id];
+        ix->sx[slot] = v.x; ix->sy[slot] = v.y; ix->sz[slot] = v.z;
+        return 0;
+    }
+    // Sai da célula antiga: o último item dela ocupa o lugar vago
+    const uint32_t hole = ix->slotOf[id], last = ix->start[old] + --ix->len[old];
+    if (hole != last) {
+        ix->sx[hole] = ix->sx[last]; ix->sy[hole] = ix->sy[last]; ix->sz[hole] = ix->sz[last];
+        ix->sid[hole] = ix->sid[last];
+        ix->slotOf[ix->sid[hole]] = hole;
+    }
+    ix->cellOf[id] = cell;
+    if (ix->start[cell] + ix->len[cell] >= ix->start[cell + 1]) return -1;
+    const uint32_t slot = ix->start[cell] + ix->len[cell]++;
+    ix->sx[slot] = v.x; ix->sy[slot] = v.y; ix->sz[slot] = v.z;
+    ix->sid[slot] = (uint32_t)id;
+    ix->slotOf[id] = slot;
+    return 0;
+}
+
+void SphIndexUpdate(SphIndex *ix, size_t id, SphVec3 v) {
+    if (id >= ix->count) return;
+    // Sem folga na nova célula: refaz o layout inteiro (raro)
+    if (MoveItem(ix, id, v, CellOf(ix, v.x, v.y, v.z)) != 0) Relayout(ix);
+}
+
+void SphIndexUpdateBatch(SphIndex *ix, const float *x, const float *y, const float *z, size_t n) {
+    if (n > ix->count) n = ix->count;
+    size_t i = 0;
+    for (; i < n; ++i) {
+        SphVec3 v = { x[i], y[i], z[i] };
+        if (MoveItem(ix, i, v, CellOf(ix, v.x, v.y, v.z)) != 0) break;
+    }
+    if (i == n) return;
+    // Muitos itens mudando de célula: em vez de um Relayout a cada célula cheia,
+    // atualiza só as células do restante e refaz o layout uma vez no fim
+    memcpy(ix->x + i + 1, x + i + 1, (n - i - 1) * sizeof *x);
+    memcpy(ix->y + i + 1, y + i + 1, (n - i - 1) * sizeof *y);
+    memcpy(ix->z + i + 1, z + i + 1, (n - i - 1) * sizeof *z);
+    for (size_t k = i + 1; k < n; ++k) ix->cellOf[k] = CellOf(ix, x[k], y[k], z[k]);
+    Relayout(ix);
+}
+
+/* --- Consultas --- */
+
+/** A região pode tocar o cone?  ângulo(eixo, centro) <= h + r. */
+static int CapIntersects(const SphCap *c, float d, float h, float ch, float sh) {
+    if (h + c->r >= SPH_PI_F) return 1;
+    return d >= ch*c->cosR - sh*c->sinR - 1e-6f;
+}
+
+/** A região está inteira no cone?  ângulo(eixo, centro) + r <= h. */
+static int CapInside(const SphCap *c, float d, float h, float ch, float sh) {
+    if (h < c->r) return 0;
+    return d >= ch*c->cosR + sh*c->sinR + 1e-6f;
+}
+
+size_t SphIndexCone(const SphIndex *ix, SphVec3 axis, float halfAngle, uint32_t *out, size_t maxOut) {
+    const float h = halfAngle < 0.0f ? 0.0f : (halfAngle > SPH_PI_F ? SPH_PI_F : halfAngle);
+    const float ch = SphCosThreshold(h), sh = sinf(h);
+    const size_t perBlock = (size_t)SPH_INDEX_BLOCK * SPH_INDEX_BLOCK;
+    size_t found = 0;
+    if (!out) maxOut = 0;
+    for (size_t b = 0; b < ix->blocks; ++b) {
+        const SphCap *bc = &ix->blockCaps[b];
+        const float db = axis.x*bc->x + axis.y*bc->y + axis.z*bc->z;
+        if (!CapIntersects(bc, db, h, ch, sh)) continue;
+        const int blockInside = CapInside(bc, db, h, ch, sh);
+        for (size_t c = b * perBlock; c < (b + 1) * perBlock; ++c) {
+            const uint32_t s0 = ix->start[c], s1 = s0 + ix->len[c];
+            if (s0 == s1) continue;
+            const SphCap *cc = &ix->cellCaps[c];
+            const float dc = axis.x*cc->x + axis.y*cc->y + axis.z*cc->z;
+            int inside = blockInside;
+            if (!inside) {
+                if (!CapIntersects(cc, dc, h, ch, sh)) continue;
+                inside = CapInside(cc, dc, h, ch, sh);
+            }
+            if (inside) {
+                for (uint32_t k = s0; k < s1 && found + (k - s0) < maxOut; ++k) out[found + (k - s0)] = ix->sid[k];
+                found += s1 - s0;
+                continue;
+            }
+            for (uint32_t k = s0; k < s1; ++k) {
+                if (axis.x*ix->sx[k] + axis.y*ix->sy[k] + axis.z*ix->sz[k] < ch) continue;
+                if (found < maxOut) out[found] = ix->sid[k];
+                found++;
+            }
+        }
+    }
+    return found;
+}
+
+/** Par (limite inferior, bloco) para a ordem de visita do kNN. */
+typedef struct BlockBound {
+    float lb;
+    uint32_t block;
+} BlockBound;
+
+/** Min-heap de blocos pelo limite inferior. */
+static void BoundSiftDown(BlockBound *h, size_t n, size_t i) {
+    for (;;) {
+        size_t l = 2*i + 1, r = l + 1, m = i;
+        if (l < n && h[l].lb < h[m].lb) m = l;
+        if (r < n && h[r].lb < h[m].lb) m = r;
+        if (m == i) return;
+        BlockBound t = h[i]; h[i] = h[m]; h[m] = t;
+        i = m;
+    }
+}
+
+/** Quadrado da corda entre dois pontos (crescente com o ângulo e preciso perto de 0). */
+static float Chord2(SphVec3 q, float x, float y, float z) {
+    const float dx = q.x - x, dy = q.y - y, dz = q.z - z;
+    return dx*dx + dy*dy + dz*dz;
+}
+
+/** Ângulo correspondente a um quadrado de corda. */
+static float Chord2ToAngle(float c2) {
+    float h = 0.5f * sqrtf(c2);
+    return 2.0f * asinf(h > 1.0f ? 1.0f : h);
+}
+
+/** Max-heap (pela corda) com os k melhores até agora. */
+static void HeapSiftDown(float *key, uint32_t *id, size_t n, size_t i) {
+    for (;;) {
+        size_t l = 2*i + 1, r = l + 1, m = i;
+        if (l < n && key[l] > key[m]) m = l;
+        if (r < n && key[r] > key[m]) m = r;
+        if (m == i) return;
+        float tk = key[i]; key[i] = key[m]; key[m] = tk;
+        uint32_t ti = id[i]; id[i] = id[m]; id[m] = ti;
+        i = m;
+    }
+}
+
+static void HeapSiftUp(float *key, uint32_t *id, size_t i) {
+    while (i > 0) {
+        size_t p = (i - 1) / 2;
+        if (key[p] >= key[i]) return;
+        float tk = key[i]; key[i] = key[p]; key[p] = tk;
+        uint32_t ti = id[i]; id[i] = id[p]; id[p] = ti;
+        i = p;
+    }
+}
+
+size_t SphIndexNearestScratchSize(const SphIndex *ix, size_t k) {
+    if (k > ix->capacity) k = ix->capacity;
+    return ix->blocks * sizeof(BlockBound) + k * sizeof(float);
+}
+
+size_t SphIndexNearest(const SphIndex *ix, SphVec3 q, size_t k, uint32_t *outIds, float *outAngles, void *scratch) {
+    if (k > ix->count) k = ix->count;
+    if (k == 0) return 0;
+    BlockBound *order = scratch;
+    float *key = (float *)(order + ix->blocks);
+    for (size_t b = 0; b < ix->blocks; ++b) {
+        const SphCap *bc = &ix->blockCaps[b];
+        const float lb = AngleTo(q, (SphVec3){ bc->x, bc->y, bc->z }) - bc->r;
+        order[b] = (BlockBound){ lb > 0.0f ? lb : 0.0f, (uint32_t)b };
+    }
+    // Heap em O(blocos); só os blocos visitados pagam O(log blocos) para sair dele
+    size_t pending = ix->blocks;
+    for (size_t i = pending / 2; i-- > 0;) BoundSiftDown(order, pending, i);
+
+    const size_t perBlock = (size_t)SPH_INDEX_BLOCK * SPH_INDEX_BLOCK;
+    size_t n = 0;
+    float worst = SPH_PI_F; // ângulo do k-ésimo melhor (π enquanto o heap não enche)
+    while (pending > 0) {
+        if (n == k && order[0].lb > worst) break;
+        const size_t b = order[0].block;
+        order[0] = order[--pending];
+        BoundSiftDown(order, pending, 0);
+        for (size_t c = b * perBlock; c < (b + 1) * perBlock; ++c) {
+            const uint32_t s0 = ix->start[c], s1 = s0 + ix->len[c];
+            if (s0 == s1) continue;
+            const SphCap *cc = &ix->cellCaps[c];
+            if (n == k && AngleTo(q, (SphVec3){ cc->x, cc->y, cc->z }) - cc->r > worst) continue;
+            for (uint32_t s = s0; s < s1; ++s) {
+                const float c2 = Chord2(q, ix->sx[s], ix->sy[s], ix->sz[s]);
+                if (n < k) {
+                    key[n] = c2; outIds[n] = ix->sid[s];
+                    HeapSiftUp(key, outIds, n++);
+                    if (n == k) worst = Chord2ToAngle(key[0]);
+                } else if (c2 < key[0]) {
+                    key[0] = c2; outIds[0] = ix->sid[s];
+                    HeapSiftDown(key, outIds, n, 0);
+                    worst = Chord2ToAngle(key[0]);
+                }
+            }
+        }
+    }
+
+    // Do heap para a ordem crescente: retira o maior para o fim, repetidamente
+    for (size_t m = n; m > 1; --m) {
+        float tk = key[0]; key[0] = key[m - 1]; key[m - 1] = tk;
+        uint32_t ti = outIds[0]; outIds[0] = outIds[m - 1]; outIds[m - 1] = ti;
+        HeapSiftDown(key, outIds, m - 1, 0);
+    }
+    if (outAngles) {
+        for (size_t i = 0; i < n; ++i) outAngles[i] = Chord2ToAngle(key[i]);
+    }
+    return n;
+}
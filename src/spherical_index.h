@@ -0,0 +1,138 @@
+/**
+ * \file spherical_index.h
+ * \brief Índice espacial sobre a esfera unitária (grade de cubo) para consultas por ângulo.
+ *
+ * A esfera é projetada nas 6 faces de um cubo e cada face é dividida em
+ * G x G células. A coordenada de cada face passa pela transformação
+ * quadrática do S2 (\f$s = \tfrac12\sqrt{1 + 3u}\f$ para \f$u \ge 0\f$), que
+ * deixa as áreas das células dentro de um fator ~2 entre si e mantém as
+ * bordas como arcos de grande círculo. Cada célula guarda o seu centro e o
+ * seu raio angular (até o canto mais distante); blocos de 8 x 8 células têm o
+ * mesmo resumo, o que permite descartar regiões inteiras com poucos produtos
+ * escalares.
+ *
+ * Consultas:
+ * - Cone (\ref SphIndexCone): todos os itens com \f$J \le \alpha\f$ do eixo,
+ *   com o mesmo critério de \ref SphBatchGateJ (\f$a \cdot b \ge \cos\alpha\f$).
+ *   Células inteiramente dentro do cone entram sem teste por item.
+ * - Vizinhos mais próximos por grande círculo (\ref SphIndexNearest): busca
+ *   pela melhor primeiro, em ordem do limite inferior de distância de cada
+ *   bloco. Os blocos saem de um heap, que só é esvaziado até o primeiro bloco
+ *   mais distante que o k-ésimo vizinho, e a memória de trabalho vem do
+ *   chamador: a consulta não aloca.
+ *
+ * Layout: os itens ficam em um único arranjo SoA em ordem de célula; cada
+ * célula ocupa uma faixa contígua com folga no fim (~25% dos seus itens + 2
+ * posições), de modo que as consultas leem as coordenadas de uma célula em
+ * sequência.
+ *
+ * Atualização incremental (\ref SphIndexUpdate, \ref SphIndexUpdateBatch):
+ * itens que continuam na mesma célula só têm as coordenadas trocadas. Um item
+ * que muda de célula sai da antiga trocando de lugar com o último item dela
+ * e entra na folga da nova, em O(1). Se a nova célula não tem folga, o
+ * arranjo inteiro é redistribuído, em O(N + células) e sem alocar memória, e
+ * cada célula volta a ter ~25% de folga: uma célula que recebe k itens
+ * seguidos provoca O(log k) redistribuições. O custo amortizado fica em O(1)
+ * por movimento enquanto as chegadas se espalham pelas células, mas um item
+ * pode pagar O(N).
+ *
+ * Não é seguro para threads: consultas concorrentes são permitidas, mas não
+ * durante uma atualização.
+ */
+#ifndef SPHERICAL_INDEX_H
+#define SPHERICAL_INDEX_H
+
+#include "spherical.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Células por lado de bloco (a resolução da grade precisa ser múltipla disto). */
+#define SPH_INDEX_BLOCK 8
+
+/** Índice opaco. */
+typedef struct SphIndex SphIndex;
+
+/**
+ * \brief Cria um índice vazio.
+ * \param gridSize Células por lado de cada face (múltiplo de \ref SPH_INDEX_BLOCK;
+ *        0 usa 64, isto é, 24.576 células).
+ * \param capacity Quantidade máxima de itens (identificadores 0 .. capacity-1).
+ * \return Índice, ou NULL se os parâmetros são inválidos ou faltou memória.
+ */
+SphIndex *SphIndexCreate(int gridSize, size_t capacity);
+
+/** \brief Libera o índice. */
+void SphIndexDestroy(SphIndex *index);
+
+/** \brief Quantidade de itens indexados. */
+size_t SphIndexCount(const SphIndex *index);
+
+/**
+ * \brief (Re)constrói o índice com os itens 0 .. n-1 (vetores unitários, SoA).
+ * \return 0, ou -1 se \c n excede a capacidade.
+ */
+int SphIndexBuild(SphIndex *index, const float *x, const float *y, const float *z, size_t n);
+
+/**
+ * \brief Atualiza a posição do item \c id (já indexado).
+ *
+ * O(1), ou O(N + células) quando a nova célula não tem folga. Um \c id fora
+ * de 0 .. \ref SphIndexCount - 1 é ignorado.
+ */
+void SphIndexUpdate(SphIndex *index, size_t id, SphVec3 v);
+
+/**
+ * \brief Atualiza as posições dos itens 0 .. n-1 (\c n = \ref SphIndexCount).
+ *
+ * Só os itens que mudaram de célula são movidos no arranjo. Se uma célula de
+ * destino enche, as células dos itens restantes são atualizadas e o arranjo é
+ * redistribuído uma única vez no fim: no máximo O(N + células) por chamada.
+ */
+void SphIndexUpdateBatch(SphIndex *index, const float *x, const float *y, const float *z, size_t n);
+
+/**
+ * \brief Itens dentro do cone de semiângulo \c halfAngle em torno de \c axis.
+ *
+ * \param index Índice.
+ * \param axis Eixo do cone (unitário).
+ * \param halfAngle Semiângulo (rad).
+ * \param out Identificadores encontrados, em ordem de célula (pode ser NULL).
+ * \param maxOut Capacidade de \c out.
+ * \return Quantidade total de itens no cone (pode exceder \c maxOut; só os
+ *         primeiros \c maxOut são gravados).
+ */
+size_t SphIndexCone(const SphIndex *index, SphVec3 axis, float halfAngle,
+                    uint32_t *out, size_t maxOut);
+
+/**
+ * \brief Bytes de memória de trabalho que \ref SphIndexNearest precisa para
+ *        até \c k vizinhos (um valor por bloco e um por vizinho).
+ */
+size_t SphIndexNearestScratchSize(const SphIndex *index, size_t k);
+
+/**
+ * \brief Os \c k itens mais próximos de \c q pela distância de grande círculo.
+ *
+ * \param index Índice.
+ * \param q Ponto de consulta (unitário).
+ * \param k Quantidade pedida.
+ * \param outIds Identificadores, do mais próximo ao mais distante.
+ * \param outAngles Ângulos correspondentes (rad; pode ser NULL).
+ * \param scratch Memória de trabalho com ao menos
+ *        \ref SphIndexNearestScratchSize(index, k) bytes, alinhada como um
+ *        \c float; reaproveitável entre consultas, uma por thread.
+ * \return Quantidade encontrada (\c k, ou menos se o índice tem menos itens).
+ */
+size_t SphIndexNearest(const SphIndex *index, SphVec3 q, size_t k,
+                       uint32_t *outIds, float *outAngles, void *scratch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPHERICAL_INDEX_H */
@@ -0,0 +1,146 @@
+/**
+ * \file spherical_jmatrix.c
+ * \brief Matriz J eixos × alvos: blocos paralelos e epílogos (veja \ref spherical_jmatrix_kernel.h).
+ *
+ * Os epílogos são expressões sem desvios (min/max, \ref AcosPoly, comparação):
+ * com \c -fno-math-errno, o laço do micronúcleo vetoriza inteiro, do
+ * produto escalar à escrita.
+ */
+#include "spherical_jmatrix.h"
+
+#include "spherical_acos_poly.h"
+
+#include <math.h>
+#include <stdatomic.h>
+
+typedef struct JMatrixJob {
+    const float *rx, *ry, *rz, *tx, *ty, *tz;
+    size_t nAxes, nTargets, tilesPerRow;
+    float thr;
+    void *out;
+    _Atomic size_t count;
+} JMatrixJob;
+
+static inline float ClampUnit(float d) {
+    return d > 1.0f ? 1.0f : (d < -1.0f ? -1.0f : d);
+}
+
+/* cos J limitado */
+#define SPH_JMAT_SUFFIX Cos
+#define SPH_JMAT_OUT float
+#define SPH_JMAT_STORE 1
+#define SPH_JMAT_EMIT(d) ClampUnit(d)
+#define SPH_JMAT_COUNTS 0
+#include "spherical_jmatrix_kernel.h"
+#undef SPH_JMAT_SUFFIX
+#undef SPH_JMAT_OUT
+#undef SPH_JMAT_STORE
+#undef SPH_JMAT_EMIT
+#undef SPH_JMAT_COUNTS
+
+/* J com o polinômio preciso (AcosPoly já limita |x| <= 1) */
+#define SPH_JMAT_SUFFIX Acos
+#define SPH_JMAT_OUT float
+#define SPH_JMAT_STORE 1
+#define SPH_JMAT_EMIT(d) AcosPoly(d, 0)
+#define SPH_JMAT_COUNTS 0
+#include "spherical_jmatrix_kernel.h"
+#undef SPH_JMAT_SUFFIX
+#undef SPH_JMAT_OUT
+#undef SPH_JMAT_STORE
+#undef SPH_JMAT_EMIT
+#undef SPH_JMAT_COUNTS
+
+/* J com o polinômio de grau 3 */
+#define SPH_JMAT_SUFFIX AcosFast
+#define SPH_JMAT_OUT float
+#define SPH_JMAT_STORE 1
+#define SPH_JMAT_EMIT(d) AcosPoly(d, 1)
+#define SPH_JMAT_COUNTS 0
+#include "spherical_jmatrix_kernel.h"
+#undef SPH_JMAT_SUFFIX
+#undef SPH_JMAT_OUT
+#undef SPH_JMAT_STORE
+#undef SPH_JMAT_EMIT
+#undef SPH_JMAT_COUNTS
+
+/* Cone: máscara e contagem */
+#define SPH_JMAT_SUFFIX Gate
+#define SPH_JMAT_OUT unsigned char
+#define SPH_JMAT_STORE 1
+#define SPH_JMAT_EMIT(d) (unsigned char)((d) >= thr)
+#define SPH_JMAT_COUNTS 1
+#include "spherical_jmatrix_kernel.h"
+#undef SPH_JMAT_SUFFIX
+#undef SPH_JMAT_OUT
+#undef SPH_JMAT_STORE
+#undef SPH_JMAT_EMIT
+#undef SPH_JMAT_COUNTS
+
+/* Cone: só a contagem */
+#define SPH_JMAT_SUFFIX Count
+#define SPH_JMAT_OUT unsigned char
+#define SPH_JMAT_STORE 0
+#define SPH_JMAT_EMIT(d) (unsigned char)((d) >= thr)
+#define SPH_JMAT_COUNTS 1
+#include "spherical_jmatrix_kernel.h"
+#undef SPH_JMAT_SUFFIX
+#undef SPH_JMAT_OUT
+#undef SPH_JMAT_STORE
+#undef SPH_JMAT_EMIT
+#undef SPH_JMAT_COUNTS
+
+#define SPH_JMAT_RANGE(suffix)                                            \
+    static void JMatrixRange##suffix(size_t begin, size_t end, void *user) { \
+        JMatrixJob *job = user;                                           \
+        size_t count = 0;                                                 \
+        for (size_t t = begin; t < end; ++t) count += JMatrixTile##suffix(job, t); \
+        if (count) atomic_fetch_add_explicit(&job->count, count, memory_order_relaxed); \
+    }
+SPH_JMAT_RANGE(Cos)
+SPH_JMAT_RANGE(Acos)
+SPH_JMAT_RANGE(AcosFast)
+SPH_JMAT_RANGE(Gate)
+SPH_JMAT_RANGE(Count)
+#undef SPH_JMAT_RANGE
+
+/** Valida os parâmetros, monta o job e executa os blocos; -1 se inválidos. */
+static int JMatrixRun(SphPool *pool,
+                      const float *rx, const float *ry, const float *rz, size_t nAxes,
+                      const float *tx, const float *ty, const float *tz, size_t nTargets,
+                      float thr, void *out, SphRangeFn fn, size_t *count) {
+    if ((nAxes && (!rx || !ry || !rz)) || (nTargets && (!tx || !ty || !tz))) return -1;
+    if (count) *count = 0;
+    if (nAxes == 0 || nTargets == 0) return 0;
+    JMatrixJob job = { rx, ry, rz, tx, ty, tz, nAxes, nTargets,
+                       (nTargets + SPH_JMAT_TILE_COLS - 1) / SPH_JMAT_TILE_COLS, thr, out, 0 };
+    const size_t tiles = job.tilesPerRow * ((nAxes + SPH_JMAT_TILE_ROWS - 1) / SPH_JMAT_TILE_ROWS);
+    SphPoolParallelFor(pool, tiles, 1, fn, &job);
+    if (count) *count = atomic_load_explicit(&job.count, memory_order_relaxed);
+    return 0;
+}
+
+int SphJMatrixCos(SphPool *pool,
+                  const float *rx, const float *ry, const float *rz, size_t nAxes,
+                  const float *tx, const float *ty, const float *tz, size_t nTargets,
+                  float *outCosJ) {
+    if (!outCosJ) return -1;
+    return JMatrixRun(pool, rx, ry, rz, nAxes, tx, ty, tz, nTargets, 0.0f, outCosJ, JMatrixRangeCos, NULL);
+}
+
+int SphJMatrix(SphPool *pool,
+               const float *rx, const float *ry, const float *rz, size_t nAxes,
+               const float *tx, const float *ty, const float *tz, size_t nTargets,
+               SphAccuracy acc, float *outJ) {
+    if (!outJ) return -1;
+    return JMatrixRun(pool, rx, ry, rz, nAxes, tx, ty, tz, nTargets, 0.0f, outJ,
+                      acc == SPH_ACCURACY_FAST ? JMatrixRangeAcosFast : JMatrixRangeAcos, NULL);
+}
+
+int SphJMatrixGate(SphPool *pool,
+                   const float *rx, const float *ry, const float *rz, size_t nAxes,
+                   const float *tx, const float *ty, const float *tz, size_t nTargets,
+                   float cosThreshold, unsigned char *inside, size_t *count) {
+    return JMatrixRun(pool, rx, ry, rz, nAxes, tx, ty, tz, nTargets, cosThreshold, inside,
+                      inside ? JMatrixRangeGate : JMatrixRangeCount, count);
+}
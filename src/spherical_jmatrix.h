@@ -0,0 +1,126 @@
+/**
+ * \file spherical_jmatrix.h
+ * \brief Matriz J: muitos eixos de rolagem × muitos alvos, em blocos como uma SGEMM pequena.
+ *
+ * Uma aeronave com vários sensores tem vários eixos de rolagem; queremos J
+ * para cada par (eixo \f$R_i\f$, alvo \f$T_j\f$). Com as direções já
+ * convertidas em vetores unitários (\c SphAzElToVecSimd, uma conversão por
+ * eixo e por alvo, não por par), \f$\cos J_{ij} = R_i \cdot T_j\f$: a matriz
+ * de cossenos é o produto \f$R\,T^\top\f$ de uma matriz \f$n_R \times 3\f$ por
+ * uma \f$3 \times n_T\f$, seguido de um epílogo por elemento (limite a
+ * [-1, 1], depois \c acos ou a comparação com um limiar).
+ *
+ * Chamar \ref SphAngleBetweenUnit em dois laços aninhados lê os três
+ * componentes de cada alvo uma vez por eixo e grava o resultado em uma
+ * passada separada. Aqui, como em uma SGEMM:
+ * - \b registradores: o micronúcleo calcula \ref SPH_JMAT_MR eixos de uma
+ *   vez. Os \f$3 \cdot\f$ \ref SPH_JMAT_MR componentes dos eixos ficam em
+ *   registradores e cada alvo lido serve a \ref SPH_JMAT_MR produtos
+ *   escalares; o laço sobre os alvos vetoriza (um alvo por pista);
+ * - \b cache: a matriz é percorrida em blocos de \ref SPH_JMAT_TILE_ROWS
+ *   eixos × \ref SPH_JMAT_TILE_COLS alvos, e os alvos do bloco ficam na L1
+ *   enquanto todos os eixos do bloco passam por eles;
+ * - \b epílogo fundido: o limite, o \c acos (\ref SphAcosApprox) ou o
+ *   limiar são aplicados ao produto ainda no registrador, antes da única
+ *   escrita de cada elemento.
+ *
+ * Os blocos rodam em paralelo no \ref SphPool; cada bloco escreve só os seus
+ * elementos, com o mesmo código: o resultado é idêntico qualquer que seja o
+ * número de threads.
+ *
+ * Como em \ref SphAngleBetweenUnit, J vem de \f$\arccos\f$ do produto escalar
+ * em float: perto de 0° e de 180° o erro chega a \f$\sim 5\cdot10^{-4}\f$
+ * rad. Para essas regiões, use \ref SphAngleBetweenUnitAtan2 nos pares que
+ * importam (ou \ref SphAllPairsDistance, que usa a forma atan2 em todos).
+ */
+#ifndef SPHERICAL_JMATRIX_H
+#define SPHERICAL_JMATRIX_H
+
+#include "spherical.h"
+#include "spherical_parallel.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Eixos por micronúcleo (bloco de registradores).
+ *
+ * 12 componentes de eixo, 3 de alvo e 4 acumuladores cabem nos 16
+ * registradores vetoriais de SSE/AVX2 sem derramar para a pilha.
+ */
+#define SPH_JMAT_MR 4
+
+/** Eixos por bloco da matriz (múltiplo de \ref SPH_JMAT_MR). */
+#define SPH_JMAT_TILE_ROWS 64
+
+/**
+ * \brief Alvos por bloco da matriz.
+ *
+ * Os 1024 alvos do bloco (12 KiB) ficam na L1 enquanto os eixos do bloco os
+ * percorrem; a saída do bloco (256 KiB em float) vai direto para a L2.
+ */
+#define SPH_JMAT_TILE_COLS 1024
+
+/**
+ * \name Matriz eixos × alvos
+ * Eixos e alvos como vetores unitários em SoA. As saídas são matrizes
+ * \c nAxes × \c nTargets por linhas: o par (eixo i, alvo j) fica em
+ * \c out[i*nTargets + j].
+ * @{
+ */
+
+/**
+ * \brief \f$\cos J\f$ de cada par (eixo, alvo), limitado a [-1, 1].
+ *
+ * \param pool Pool de threads (NULL executa tudo na thread atual).
+ * \param rx,ry,rz \c nAxes eixos de rolagem unitários.
+ * \param tx,ty,tz \c nTargets direções de alvo unitárias.
+ * \param outCosJ Matriz de saída.
+ * \return 0, ou -1 se os parâmetros forem inválidos.
+ */
+int SphJMatrixCos(SphPool *pool,
+                  const float *rx, const float *ry, const float *rz, size_t nAxes,
+                  const float *tx, const float *ty, const float *tz, size_t nTargets,
+                  float *outCosJ);
+
+/**
+ * \brief J de cada par (eixo, alvo), em rad.
+ *
+ * \param acc Polinômio do \c acos (\ref SphAcosApprox): \ref SPH_ACCURACY_PRECISE
+ *            soma até \f$4.3\cdot10^{-7}\f$ rad ao erro do produto escalar;
+ *            \ref SPH_ACCURACY_FAST, até \f$6.8\cdot10^{-5}\f$ rad.
+ * \param outJ Matriz de saída.
+ * \return 0, ou -1 se os parâmetros forem inválidos.
+ */
+int SphJMatrix(SphPool *pool,
+               const float *rx, const float *ry, const float *rz, size_t nAxes,
+               const float *tx, const float *ty, const float *tz, size_t nTargets,
+               SphAccuracy acc, float *outJ);
+
+/**
+ * \brief Marca os pares com \f$J \le \alpha\f$, sem nenhum \c acos.
+ *
+ * O epílogo é a comparação \f$R_i \cdot T_j \ge \cos\alpha\f$, como em
+ * \ref SphBatchGateJ.
+ *
+ * \param cosThreshold Limiar obtido com \ref SphCosThreshold.
+ * \param inside Matriz de saída: 1 se o alvo j está no cone do eixo i, 0 caso
+ *               contrário (pode ser NULL, só para contar).
+ * \param count Saída (pode ser NULL): pares dentro do cone.
+ * \return 0, ou -1 se os parâmetros forem inválidos.
+ */
+int SphJMatrixGate(SphPool *pool,
+                   const float *rx, const float *ry, const float *rz, size_t nAxes,
+                   const float *tx, const float *ty, const float *tz, size_t nTargets,
+                   float cosThreshold, unsigned char *inside, size_t *count);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPHERICAL_JMATRIX_H */
@@ -0,0 +1,113 @@
+/**
+ * \file spherical_jmatrix_kernel.h
+ * \brief Modelo (template) do bloco da matriz J, especializado por epílogo.
+ *
+ * Como \ref spherical_angle_kernel.h, este arquivo \b não tem proteção contra
+ * inclusão múltipla: \c spherical_jmatrix.c define as macros abaixo e o
+ * inclui uma vez por epílogo, gerando \c JMatrixTile<sufixo>.
+ *
+ * Macros exigidas:
+ * - \c SPH_JMAT_SUFFIX       sufixo do nome gerado (\c Cos, \c Acos, ...)
+ * - \c SPH_JMAT_OUT          tipo dos elementos da matriz de saída
+ * - \c SPH_JMAT_STORE        1: grava a matriz; 0: só conta
+ * - \c SPH_JMAT_EMIT(d)      valor de saída a partir do produto escalar \c d
+ *                            (pode usar \c thr, o limiar do job)
+ * - \c SPH_JMAT_COUNTS       1: soma os valores emitidos (epílogo de limiar)
+ */
+
+#define SPH_JCAT_(a, b) a##b
+#define SPH_JCAT(a, b) SPH_JCAT_(a, b)
+#define SPH_JFN(name) SPH_JCAT(name, SPH_JMAT_SUFFIX)
+
+#if SPH_JMAT_STORE
+#define SPH_JMAT_PUT(o, j, v) ((o)[j] = (v))
+#else
+#define SPH_JMAT_PUT(o, j, v) ((void)(o))
+#endif
+
+/**
+ * Micronúcleo: \ref SPH_JMAT_MR eixos em registradores contra \c nc alvos;
+ * cada alvo é lido uma vez para os quatro produtos. Os ponteiros \c restrict
+ * nos parâmetros (e não em variáveis locais) deixam o laço vetorizar sem
+ * testes de sobreposição em tempo de execução.
+ */
+static inline size_t SPH_JFN(JMatrixMicro)(const float *restrict tx, const float *restrict ty,
+                                           const float *restrict tz, size_t nc,
+                                           const float *r, float thr,
+                                           SPH_JMAT_OUT *restrict o0, SPH_JMAT_OUT *restrict o1,
+                                           SPH_JMAT_OUT *restrict o2, SPH_JMAT_OUT *restrict o3) {
+    const float x0 = r[0], y0 = r[1], z0 = r[2],  x1 = r[3],  y1 = r[4],  z1 = r[5];
+    const float x2 = r[6], y2 = r[7], z2 = r[8],  x3 = r[9],  y3 = r[10], z3 = r[11];
+    size_t count = 0;
+    (void)thr;
+    for (size_t j = 0; j < nc; ++j) {
+        const float x = tx[j], y = ty[j], z = tz[j];
+        const SPH_JMAT_OUT v0 = SPH_JMAT_EMIT(x0*x + y0*y + z0*z);
+        const SPH_JMAT_OUT v1 = SPH_JMAT_EMIT(x1*x + y1*y + z1*z);
+        const SPH_JMAT_OUT v2 = SPH_JMAT_EMIT(x2*x + y2*y + z2*z);
+        const SPH_JMAT_OUT v3 = SPH_JMAT_EMIT(x3*x + y3*y + z3*z);
+        SPH_JMAT_PUT(o0, j, v0);
+        SPH_JMAT_PUT(o1, j, v1);
+        SPH_JMAT_PUT(o2, j, v2);
+        SPH_JMAT_PUT(o3, j, v3);
+#if SPH_JMAT_COUNTS
+        count += (size_t)v0 + (size_t)v1 + (size_t)v2 + (size_t)v3;
+#endif
+    }
+    return count;
+}
+
+/** Um eixo contra \c nc alvos (os eixos que sobram do último grupo). */
+static inline size_t SPH_JFN(JMatrixRow)(const float *restrict tx, const float *restrict ty,
+                                         const float *restrict tz, size_t nc,
+                                         const float *r, float thr, SPH_JMAT_OUT *restrict o0) {
+    const float x0 = r[0], y0 = r[1], z0 = r[2];
+    size_t count = 0;
+    (void)thr;
+    for (size_t j = 0; j < nc; ++j) {
+        const SPH_JMAT_OUT v0 = SPH_JMAT_EMIT(x0*tx[j] + y0*ty[j] + z0*tz[j]);
+        SPH_JMAT_PUT(o0, j, v0);
+#if SPH_JMAT_COUNTS
+        count += (size_t)v0;
+#endif
+    }
+    return count;
+}
+
+/** Bloco \c tile da matriz; devolve a soma dos valores emitidos (ou 0). */
+static size_t SPH_JFN(JMatrixTile)(const JMatrixJob *job, size_t tile) {
+    const size_t r0 = tile / job->tilesPerRow * SPH_JMAT_TILE_ROWS;
+    const size_t c0 = tile % job->tilesPerRow * SPH_JMAT_TILE_COLS;
+    const size_t r1 = job->nAxes - r0 < SPH_JMAT_TILE_ROWS ? job->nAxes : r0 + SPH_JMAT_TILE_ROWS;
+    const size_t nc = job->nTargets - c0 < SPH_JMAT_TILE_COLS ? job->nTargets - c0 : SPH_JMAT_TILE_COLS;
+    const size_t m = job->nTargets;
+    const float *tx = job->tx + c0, *ty = job->ty + c0, *tz = job->tz + c0;
+    SPH_JMAT_OUT *o = SPH_JMAT_STORE ? (SPH_JMAT_OUT *)job->out + r0*m + c0 : NULL;
+    float r[3 * SPH_JMAT_MR];
+    size_t count = 0;
+    size_t i = r0;
+    for (; i + SPH_JMAT_MR <= r1; i += SPH_JMAT_MR) {
+        for (int k = 0; k < SPH_JMAT_MR; ++k) {
+            r[3*k] = job->rx[i + k];
+            r[3*k + 1] = job->ry[i + k];
+            r[3*k + 2] = job->rz[i + k];
+        }
+        count += SPH_JFN(JMatrixMicro)(tx, ty, tz, nc, r, job->thr,
+                                       o, SPH_JMAT_STORE ? o + m : NULL,
+                                       SPH_JMAT_STORE ? o + 2*m : NULL, SPH_JMAT_STORE ? o + 3*m : NULL);
+        if (SPH_JMAT_STORE) o += SPH_JMAT_MR * m;
+    }
+    for (; i < r1; ++i) {
+        r[0] = job->rx[i];
+        r[1] = job->ry[i];
+        r[2] = job->rz[i];
+        count += SPH_JFN(JMatrixRow)(tx, ty, tz, nc, r, job->thr, o);
+        if (SPH_JMAT_STORE) o += m;
+    }
+    return count;
+}
+
+#undef SPH_JMAT_PUT
+#undef SPH_JFN
+#undef SPH_JCAT
+#undef SPH_JCAT_
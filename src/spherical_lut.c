@@ -0,0 +1,85 @@
+/**
+ * \file spherical_lut.c
+ * \brief Implementação do seno/cosseno por tabela para ângulos de 16 bits.
+ *
+ * O código de 16 bits é dividido em quadrante (2 bits altos) e posição dentro
+ * do quadrante (14 bits). Dessa posição, os \ref SPH_LUT_BITS bits altos são o
+ * índice na tabela e os restantes, a fração usada na interpolação. O cosseno
+ * do quadrante vem da mesma tabela lida de trás para frente
+ * (\f$\cos\varphi = \sin(\pi/2 - \varphi)\f$).
+ */
+#include "spherical_lut.h"
+
+#include "spherical_simd.h"
+
+// Gerado no build por tools/gen_sincos_lut.c (diretório de build, "generated/")
+#include "spherical_lut_table.h"
+
+#if SPH_LUT_TABLE_BITS != SPH_LUT_BITS
+#error "spherical_lut_table.h foi gerado com outro SPH_LUT_BITS"
+#endif
+
+#define LUT_N (1 << SPH_LUT_BITS)
+#define LUT_FRAC_BITS (14 - SPH_LUT_BITS)
+#define LUT_FRAC_MASK ((1 << LUT_FRAC_BITS) - 1)
+
+/** Ângulos convertidos para float por vez no lote (2 KiB na pilha). */
+#define Q16_CHUNK 256
+
+static inline void SinCosQuarter(unsigned r, SphAccuracy acc, float *s, float *c) {
+    if (acc == SPH_ACCURACY_FAST) {
+        unsigned i = (r + (1u << (LUT_FRAC_BITS - 1))) >> LUT_FRAC_BITS; // 0..LUT_N
+        *s = kSinQuarter[i];
+        *c = kSinQuarter[LUT_N - i];
+        return;
+    }
+    unsigned i = r >> LUT_FRAC_BITS; // 0..LUT_N-1
+    float f = (float)(r & LUT_FRAC_MASK) * (1.0f / (1 << LUT_FRAC_BITS));
+    float s0 = kSinQuarter[i], s1 = kSinQuarter[i + 1];
+    float c0 = kSinQuarter[LUT_N - i], c1 = kSinQuarter[LUT_N - i - 1];
+    *s = s0 + f * (s1 - s0);
+    *c = c0 + f * (c1 - c0);
+}
+
+/**
+ * Rotação por múltiplos de 90° sem desvios, como a correção de quadrante de
+ * spherical_simd_kernel.h: \f$\sin = [s, c, -s, -c]_q\f$ e
+ * \f$\cos = [c, -s, -c, s]_q\f$.
+ */
+static inline void RotateQuadrant(unsigned q, float sq, float cq, float *s, float *c) {
+    const float odd = (float)(q & 1u), even = 1.0f - odd;
+    const float signS = 1.0f - 2.0f*(float)(q >> 1);
+    const float signC = 1.0f - 2.0f*(float)(((q + 1u) >> 1) & 1u);
+    *s = signS * (even*sq + odd*cq);
+    *c = signC * (even*cq + odd*sq);
+}
+
+void SphSinCosQ16(uint16_t code, SphAccuracy acc, float *s, float *c) {
+    float sq, cq;
+    SinCosQuarter(code & 0x3FFFu, acc, &sq, &cq);
+    RotateQuadrant(code >> 14, sq, cq, s, c);
+}
+
+SphVec3 SphAzElQ16ToVec(uint16_t az, int16_t el, SphAccuracy acc) {
+    float sa, ca, se, ce;
+    SphSinCosQ16(az, acc, &sa, &ca);
+    SphSinCosQ16((uint16_t)el, acc, &se, &ce);
+    SphVec3 v = { ce * ca, ce * sa, se };
+    return v;
+}
+
+void SphBatchAzElQ16ToVec(const uint16_t *az, const int16_t *el, size_t n,
+                          float *x, float *y, float *z, SphAccuracy acc) {
+    // As contagens são inteiros exatos em float e o quarto de volta (16384)
+    // também: SphAzElToVecUnitSimd reduz sem erro e avalia o polinômio na ISA
+    // ativa, mais rápido que as leituras da tabela, que não vetorizam
+    float azF[Q16_CHUNK], elF[Q16_CHUNK];
+    for (size_t i0 = 0; i0 < n; i0 += Q16_CHUNK) {
+        const size_t m = n - i0 < Q16_CHUNK ? n - i0 : Q16_CHUNK;
+        for (size_t i = 0; i < m; ++i) {
+            azF[i] = (float)az[i0 + i];
+            elF[i] = (float)el[i0 + i];
+        }
+        SphAzElToVecUnitSimd(azF, elF, m, x + i0, y + i0, z + i0, 65536.0f, 0, acc);
+    }
+}
@@ -0,0 +1,85 @@
+/**
+ * \file spherical_lut.h
+ * \brief Seno/cosseno por tabela para ângulos quantizados de encoders (16 bits).
+ *
+ * Os encoders do gimbal entregam Az/El como inteiros de 16 bits, com 65536
+ * contagens por volta. Em vez de converter para radianos e chamar
+ * \c sinf / \c cosf, estas funções usam uma tabela de um quarto de onda do
+ * seno (\ref SPH_LUT_BITS bits, 16 KiB), que cabe na L1 e dá o cosseno por
+ * reflexão. A tabela é gerada no build por \c tools/gen_sincos_lut.c e fica
+ * em memória somente leitura: não há custo de inicialização.
+ *
+ * Duas precisões, escolhidas por \ref SphAccuracy:
+ * - \ref SPH_ACCURACY_FAST: entrada mais próxima da tabela, erro máximo
+ *   ~1.9e-4 por componente (\f$\pi/2^{14}\f$).
+ * - \ref SPH_ACCURACY_PRECISE: interpolação linear entre entradas vizinhas,
+ *   erro máximo ~1e-7 (abaixo da resolução do encoder, ~9.6e-5 rad).
+ *
+ * O lote \ref SphBatchAzElQ16ToVec não usa a tabela: as leituras não
+ * vetorizam, e o polinômio de \ref SphAzElToVecUnitSimd com 65536 unidades
+ * por volta é mais rápido.
+ *
+ * Convenção de eixos: a mesma de \ref SphAzElToVec (X = Norte, Y = Leste, Z = Cima).
+ */
+#ifndef SPHERICAL_LUT_H
+#define SPHERICAL_LUT_H
+
+#include "spherical.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Bits do índice na tabela de um quarto de onda (\f$2^{12}\f$ intervalos). */
+#define SPH_LUT_BITS 12
+
+/** Radianos por contagem do encoder (\f$2\pi/65536\f$). */
+#define SPH_Q16_TO_RAD 9.587379924285257e-5f
+
+/**
+ * \brief Seno e cosseno de um ângulo quantizado.
+ *
+ * \param code Ângulo em contagens (\f$\theta = code\cdot 2\pi/65536\f$). Uma
+ *             elevação com sinal (\c int16_t) convertida para \c uint16_t
+ *             representa o mesmo ângulo.
+ * \param acc Precisão (sem ou com interpolação).
+ * \param s,c Saídas: \f$\sin\theta\f$ e \f$\cos\theta\f$.
+ */
+void SphSinCosQ16(uint16_t code, SphAccuracy acc, float *s, float *c);
+
+/**
+ * \brief Converte azimute/elevação em contagens de encoder em um vetor unitário.
+ *
+ * Equivale a \ref SphAzElToVec com \c az e \c el convertidos por
+ * \ref SPH_Q16_TO_RAD.
+ *
+ * \param az Azimute em contagens (0..65535 = 0..360°).
+ * \param el Elevação em contagens com sinal (-16384..16384 = -90..90°).
+ * \param acc Precisão.
+ */
+SphVec3 SphAzElQ16ToVec(uint16_t az, int16_t el, SphAccuracy acc);
+
+/**
+ * \brief Versão em lote (SoA) de \ref SphAzElQ16ToVec.
+ *
+ * Converte as contagens para float e chama \ref SphAzElToVecUnitSimd com
+ * 65536 unidades por volta; a redução é exata. A precisão é a do caminho
+ * SIMD (~1e-7 em \ref SPH_ACCURACY_PRECISE, ~3.3e-4 em
+ * \ref SPH_ACCURACY_FAST), não a da tabela.
+ *
+ * \param az,el Arranjos com N azimutes e N elevações (contagens).
+ * \param n Quantidade de elementos.
+ * \param x,y,z Arranjos de saída com N componentes cada.
+ * \param acc Precisão.
+ */
+void SphBatchAzElQ16ToVec(const uint16_t *az, const int16_t *el, size_t n,
+                          float *x, float *y, float *z, SphAccuracy acc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPHERICAL_LUT_H */
@@ -0,0 +1,246 @@
+/**
+ * \file spherical_parallel.c
+ * \brief Implementação do pool com roubo de faixas de blocos.
+ *
+ * Cada thread guarda a sua faixa de blocos [lo, hi) em uma única palavra
+ * atômica de 64 bits (lo nos 32 bits baixos, hi nos altos). A dona consome a
+ * partir de \c lo; quem rouba reduz \c hi, levando a metade de cima. Como
+ * ambos usam compare-and-swap sobre a mesma palavra, nenhum bloco é
+ * executado duas vezes nem perdido. Cada faixa ocupa a sua própria linha de
+ * cache para evitar falso compartilhamento.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "spherical_parallel.h"
+#include "spherical.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef struct WorkerRange {
+    _Atomic uint64_t range;
+    char pad[64 - sizeof(uint64_t)];
+} WorkerRange;
+
+struct SphPool {
+    int threads;
+    pthread_t *tids;
+    WorkerRange *ranges;
+
+    pthread_mutex_t mu;
+    pthread_cond_t cvStart;
+    pthread_cond_t cvDone;
+    unsigned generation;
+    int shutdown;
+    int busy;
+
+    // Trabalho atual
+    SphRangeFn fn;
+    void *user;
+    size_t n, tile;
+};
+
+typedef struct WorkerArg {
+    SphPool *pool;
+    int id;
+} WorkerArg;
+
+static uint64_t PackRange(uint32_t lo, uint32_t hi) { return (uint64_t)lo | ((uint64_t)hi << 32); }
+static uint32_t RangeLo(uint64_t r) { return (uint32_t)r; }
+static uint32_t RangeHi(uint64_t r) { return (uint32_t)(r >> 32); }
+
+static int PopOwn(SphPool *p, int self, uint32_t *tile) {
+    _Atomic uint64_t *slot = &p->ranges[self].range;
+    uint64_t r = atomic_load(slot);
+    while (RangeLo(r) < RangeHi(r)) {
+        if (atomic_compare_exchange_weak(slot, &r, PackRange(RangeLo(r) + 1, RangeHi(r)))) {
+            *tile = RangeLo(r);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/** Rouba a metade de cima da maior faixa restante. \return 0 se não há mais nada. */
+static int Steal(SphPool *p, int self) {
+    for (;;) {
+        int victim = -1;
+        uint32_t best = 0;
+        uint64_t seen = 0;
+        for (int k = 1; k < p->threads; ++k) {
+            int v = (self + k) % p->threads;
+            uint64_t r = atomic_load(&p->ranges[v].range);
+            uint32_t left = RangeHi(r) - RangeLo(r);
+            if (RangeLo(r) < RangeHi(r) && left > best) { best = left; victim = v; seen = r; }
+        }
+        if (victim < 0) return 0;
+        uint32_t lo = RangeLo(seen), hi = RangeHi(seen);
+        uint32_t take = (hi - lo + 1) / 2;
+        if (atomic_compare_exchange_strong(&p->ranges[victim].range, &seen, PackRange(lo, hi - take))) {
+            atomic_store(&p->ranges[self].range, PackRange(hi - take, hi));
+            return 1;
+        }
+        // Outra thread mexeu na faixa: tenta de novo
+    }
+}
+
+static void RunTile(SphPool *p, uint32_t t) {
+    size_t begin = (size_t)t * p->tile;
+    size_t end = begin + p->tile < p->n ? begin + p->tile : p->n;
+    p->fn(begin, end, p->user);
+}
+
+static void RunWorker(SphPool *p, int self) {
+    for (;;) {
+        uint32_t t;
+        if (PopOwn(p, self, &t)) RunTile(p, t);
+        else if (!Steal(p, self)) break;
+    }
+}
+
+static void *WorkerMain(void *arg) {
+    WorkerArg wa = *(WorkerArg *)arg;
+    free(arg);
+    SphPool *p = wa.pool;
+    unsigned seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&p->mu);
+        while (p->generation == seen && !p->shutdown) pthread_cond_wait(&p->cvStart, &p->mu);
+        if (p->shutdown) {
+            pthread_mutex_unlock(&p->mu);
+            break;
+        }
+        seen = p->generation;
+        pthread_mutex_unlock(&p->mu);
+
+        RunWorker(p, wa.id);
+
+        pthread_mutex_lock(&p->mu);
+        if (--p->busy == 0) pthread_cond_signal(&p->cvDone);
+        pthread_mutex_unlock(&p->mu);
+    }
+    return NULL;
+}
+
+SphPool *SphPoolCreate(int threads) {
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    SphPool *p = calloc(1, sizeof *p);
+    if (!p) return NULL;
+    p->threads = threads;
+    p->tids = calloc((size_t)threads, sizeof *p->tids);
+    if (posix_memalign((void **)&p->ranges, 64, (size_t)threads * sizeof *p->ranges) != 0) p->ranges = NULL;
+    if (!p->tids || !p->ranges) {
+        free(p->tids);
+        free(p->ranges);
+        free(p);
+        return NULL;
+    }
+    for (int i = 0; i < threads; ++i) atomic_init(&p->ranges[i].range, 0);
+    pthread_mutex_init(&p->mu, NULL);
+    pthread_cond_init(&p->cvStart, NULL);
+    pthread_cond_init(&p->cvDone, NULL);
+
+    // A thread 0 é sempre a que chama SphPoolParallelFor
+    for (int i = 1; i < threads; ++i) {
+        WorkerArg *wa = malloc(sizeof *wa);
+        if (!wa) { p->threads = i; break; }
+        wa->pool = p;
+        wa->id = i;
+        if (pthread_create(&p->tids[i], NULL, WorkerMain, wa) != 0) {
+            free(wa);
+            p->threads = i;
+            break;
+        }
+    }
+    return p;
+}
+
+void SphPoolDestroy(SphPool *p) {
+    if (!p) return;
+    pthread_mutex_lock(&p->mu);
+    p->shutdown = 1;
+    pthread_cond_broadcast(&p->cvStart);
+    pthread_mutex_unlock(&p->mu);
+    for (int i = 1; i < p->threads; ++i) pthread_join(p->tids[i], NULL);
+    pthread_cond_destroy(&p->cvDone);
+    pthread_cond_destroy(&p->cvStart);
+    pthread_mutex_destroy(&p->mu);
+    free(p->ranges);
+    free(p->tids);
+    free(p);
+}
+
+int SphPoolThreads(const SphPool *p) {
+    return p ? p->threads : 1;
+}
+
+void SphPoolParallelFor(SphPool *p, size_t n, size_t tile, SphRangeFn fn, void *user) {
+    if (n == 0) return;
+    if (tile == 0) tile = SPH_PARALLEL_TILE;
+    // Os índices de bloco precisam caber em 32 bits
+    while (n / tile >= UINT32_MAX) tile *= 2;
+    size_t tiles = (n + tile - 1) / tile;
+    if (!p || p->threads == 1 || tiles == 1) {
+        for (size_t b = 0; b < n; b += tile) fn(b, b + tile < n ? b + tile : n, user);
+        return;
+    }
+
+    p->fn = fn;
+    p->user = user;
+    p->n = n;
+    p->tile = tile;
+    // Distribuição inicial: faixas contíguas e equilibradas
+    for (int i = 0; i < p->threads; ++i) {
+        uint32_t lo = (uint32_t)(tiles * (size_t)i / (size_t)p->threads);
+        uint32_t hi = (uint32_t)(tiles * (size_t)(i + 1) / (size_t)p->threads);
+        atomic_store(&p->ranges[i].range, PackRange(lo, hi));
+    }
+
+    pthread_mutex_lock(&p->mu);
+    p->busy = p->threads - 1;
+    p->generation++;
+    pthread_cond_broadcast(&p->cvStart);
+    pthread_mutex_unlock(&p->mu);
+
+    RunWorker(p, 0);
+
+    pthread_mutex_lock(&p->mu);
+    while (p->busy > 0) pthread_cond_wait(&p->cvDone, &p->mu);
+    pthread_mutex_unlock(&p->mu);
+}
+
+typedef struct AngleJJob {
+    const float *azT, *elT, *azR, *elR;
+    float azR0, elR0;
+    float *out;
+} AngleJJob;
+
+static void AngleJRange(size_t begin, size_t end, void *user) {
+    const AngleJJob *j = user;
+    SphBatchAngleJ(j->azT + begin, j->elT + begin, end - begin, j->azR0, j->elR0, j->out + begin);
+}
+
+static void AngleJPairedRange(size_t begin, size_t end, void *user) {
+    const AngleJJob *j = user;
+    SphBatchAngleJPaired(j->azT + begin, j->elT + begin, j->azR + begin, j->elR + begin,
+                         end - begin, j->out + begin);
+}
+
+void SphParallelAngleJ(SphPool *pool, const float *azT, const float *elT, size_t n,
+                       float azR, float elR, float *outJ) {
+    AngleJJob j = { azT, elT, NULL, NULL, azR, elR, outJ };
+    SphPoolParallelFor(pool, n, SPH_PARALLEL_TILE, AngleJRange, &j);
+}
+
+void SphParallelAngleJPaired(SphPool *pool, const float *azT, const float *elT,
+                             const float *azR, const float *elR,
+                             size_t n, float *outJ) {
+    AngleJJob j = { azT, elT, azR, elR, 0.0f, 0.0f, outJ };
+    SphPoolParallelFor(pool, n, SPH_PARALLEL_TILE, AngleJPairedRange, &j);
+}
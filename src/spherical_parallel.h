@@ -0,0 +1,81 @@
+/**
+ * \file spherical_parallel.h
+ * \brief Pool de threads com roubo de trabalho (work stealing) para os kernels em lote.
+ *
+ * O arranjo de alvos é dividido em \b blocos (tiles) de tamanho fixo, pensados
+ * para caber na cache L2 (\ref SPH_PARALLEL_TILE). Cada thread recebe
+ * inicialmente uma faixa contígua de blocos; quando termina a sua, rouba
+ * metade da faixa restante da thread mais atrasada. Assim núcleos mais lentos
+ * ou ocupados não seguram o lote inteiro.
+ *
+ * Saída determinística: cada bloco escreve apenas a sua própria fatia de
+ * \c outJ, e cada elemento é calculado pelo mesmo código do kernel serial
+ * (\ref SphBatchAngleJ / \ref SphBatchAngleJPaired). O resultado é idêntico,
+ * bit a bit, ao da versão serial, qualquer que seja o número de threads ou a
+ * ordem em que os blocos foram executados.
+ */
+#ifndef SPHERICAL_PARALLEL_H
+#define SPHERICAL_PARALLEL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Elementos por bloco nos laços paralelos.
+ *
+ * Com quatro arranjos de entrada e um de saída (20 bytes por elemento), um
+ * bloco de 8192 elementos ocupa 160 KiB, dentro da L2 de um núcleo típico.
+ */
+#define SPH_PARALLEL_TILE 8192
+
+/** Pool de threads opaco. */
+typedef struct SphPool SphPool;
+
+/** Função executada para a faixa de elementos [begin, end). */
+typedef void (*SphRangeFn)(size_t begin, size_t end, void *user);
+
+/**
+ * \brief Cria um pool com \c threads threads (incluindo a que chama).
+ * \param threads Quantidade de threads; 0 usa a quantidade de núcleos online.
+ * \return Pool, ou NULL se não foi possível criá-lo.
+ */
+SphPool *SphPoolCreate(int threads);
+
+/** \brief Encerra as threads e libera o pool. */
+void SphPoolDestroy(SphPool *pool);
+
+/** \brief Quantidade de threads do pool (incluindo a que chama). */
+int SphPoolThreads(const SphPool *pool);
+
+/**
+ * \brief Executa \c fn sobre [0, n) em blocos de \c tile elementos, em paralelo.
+ *
+ * A thread que chama participa do trabalho e a função só retorna quando
+ * todos os blocos terminaram. Não é reentrante: um mesmo pool atende uma
+ * chamada por vez.
+ *
+ * \param pool Pool (NULL executa tudo na thread atual).
+ * \param n Quantidade de elementos.
+ * \param tile Elementos por bloco (0 usa \ref SPH_PARALLEL_TILE).
+ * \param fn Função chamada para cada bloco.
+ * \param user Ponteiro repassado a \c fn.
+ */
+void SphPoolParallelFor(SphPool *pool, size_t n, size_t tile, SphRangeFn fn, void *user);
+
+/** \brief Versão paralela de \ref SphBatchAngleJ (mesmo resultado, bit a bit). */
+void SphParallelAngleJ(SphPool *pool, const float *azT, const float *elT, size_t n,
+                       float azR, float elR, float *outJ);
+
+/** \brief Versão paralela de \ref SphBatchAngleJPaired (mesmo resultado, bit a bit). */
+void SphParallelAngleJPaired(SphPool *pool, const float *azT, const float *elT,
+                             const float *azR, const float *elR,
+                             size_t n, float *outJ);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPHERICAL_PARALLEL_H */
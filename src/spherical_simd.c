@@ -0,0 +1,175 @@
+/**
+ * \file spherical_simd.c
+ * \brief Despacho em tempo de execução e versão escalar dos kernels SIMD.
+ *
+ * A detecção de CPU usa \c __builtin_cpu_supports (GCC/Clang) em x86. No
+ * AArch64 o NEON é obrigatório, então está sempre disponível quando compilado.
+ */
+#include "spherical_simd.h"
+#include "spherical_simd_internal.h"
+
+#include <math.h>
+#include <stdatomic.h>
+
+#define SPH_V float
+#define SPH_W 1
+#define SPH_SUFFIX Scalar
+#define SPH_LOAD(p) (*(p))
+#define SPH_STORE(p, v) (*(p) = (v))
+#define SPH_SET1(x) (x)
+#define SPH_ADD(a, b) ((a) + (b))
+#define SPH_SUB(a, b) ((a) - (b))
+#define SPH_MUL(a, b) ((a) * (b))
+#define SPH_FMA(a, b, c) ((a) * (b) + (c))
+#define SPH_ROUND(v) rintf(v)
+
+#include "spherical_simd_kernel.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SPH_X86_CPU_DETECT 1
+#endif
+
+static const SphAzElToVecFn kKernels[SPH_ISA_COUNT] = {
+    SphAzElToVecScalar,
+#ifdef SPH_HAVE_SSE41
+    SphAzElToVecSse41,
+#else
+    0,
+#endif
+#ifdef SPH_HAVE_AVX2
+    SphAzElToVecAvx2,
+#else
+    0,
+#endif
+#ifdef SPH_HAVE_AVX512
+    SphAzElToVecAvx512,
+#else
+    0,
+#endif
+#ifdef SPH_HAVE_NEON
+    SphAzElToVecNeon,
+#else
+    0,
+#endif
+};
+
+static const SphAzElToVecUnitFn kUnitKernels[SPH_ISA_COUNT] = {
+    SphAzElToVecUnitScalar,
+#ifdef SPH_HAVE_SSE41
+    SphAzElToVecUnitSse41,
+#else
+    0,
+#endif
+#ifdef SPH_HAVE_AVX2
+    SphAzElToVecUnitAvx2,
+#else
+    0,
+#endif
+#ifdef SPH_HAVE_AVX512
+    SphAzElToVecUnitAvx512,
+#else
+    0,
+#endif
+#ifdef SPH_HAVE_NEON
+    SphAzElToVecUnitNeon,
+#else
+    0,
+#endif
+};
+
+static const SphSlerpEvalFn kSlerpKernels[SPH_ISA_COUNT] = {
+    SphSlerpEvalScalar,
+#ifdef SPH_HAVE_SSE41
+    SphSlerpEvalSse41,
+#else
+    0,
+#endif
+#ifdef SPH_HAVE_AVX2
+    SphSlerpEvalAvx2,
+#else
+    0,
+#endif
+#ifdef SPH_HAVE_AVX512
+    SphSlerpEvalAvx512,
+#else
+    0,
+#endif
+#ifdef SPH_HAVE_NEON
+    SphSlerpEvalNeon,
+#else
+    0,
+#endif
+};
+
+static const char *const kIsaNames[SPH_ISA_COUNT] = {
+    "scalar", "sse4.1", "avx2", "avx512", "neon"
+};
+
+// -1: ainda não detectado. Atômico porque os kernels são chamados de várias
+// threads (pool, ABI C, Python sem GIL): na primeira chamada, todas podem
+// detectar e gravar o mesmo valor; relaxed basta, nenhum outro dado depende dele.
+static _Atomic int gActiveIsa = -1;
+
+int SphIsaSupported(SphIsa isa) {
+    if (isa < 0 || isa >= SPH_ISA_COUNT || !kKernels[isa]) return 0;
+    switch (isa) {
+    case SPH_ISA_SCALAR: return 1;
+#ifdef SPH_X86_CPU_DETECT
+    case SPH_ISA_SSE41:  return __builtin_cpu_supports("sse4.1");
+    case SPH_ISA_AVX2:   return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case SPH_ISA_AVX512: return __builtin_cpu_supports("avx512f");
+#endif
+#ifdef __aarch64__
+    case SPH_ISA_NEON:   return 1;
+#endif
+    default: return 0;
+    }
+}
+
+SphIsa SphIsaDetect(void) {
+    for (int isa = SPH_ISA_COUNT - 1; isa > SPH_ISA_SCALAR; --isa) {
+        if (SphIsaSupported((SphIsa)isa)) return (SphIsa)isa;
+    }
+    return SPH_ISA_SCALAR;
+}
+
+SphIsa SphIsaActive(void) {
+    int isa = atomic_load_explicit(&gActiveIsa, memory_order_relaxed);
+    if (isa < 0) {
+        isa = (int)SphIsaDetect();
+        atomic_store_explicit(&gActiveIsa, isa, memory_order_relaxed);
+    }
+    return (SphIsa)isa;
+}
+
+int SphIsaSelect(SphIsa isa) {
+    if (!SphIsaSupported(isa)) return -1;
+    atomic_store_explicit(&gActiveIsa, (int)isa, memory_order_relaxed);
+    return 0;
+}
+
+const char *SphIsaName(SphIsa isa) {
+    if (isa < 0 || isa >= SPH_ISA_COUNT) return "unknown";
+    return kIsaNames[isa];
+}
+
+void SphAzElToVecSimd(const float *az, const float *el, size_t n,
+                      float *x, float *y, float *z, SphAccuracy acc) {
+    kKernels[SphIsaActive()](az, el, n, x, y, z, acc == SPH_ACCURACY_FAST);
+}
+
+void SphAzElToVecUnitSimd(const float *az, const float *el, size_t n,
+                          float *x, float *y, float *z,
+                          float unitsPerTurn, int flipZ, SphAccuracy acc) {
+    kUnitKernels[SphIsaActive()](az, el, n, x, y, z, 0.25f * unitsPerTurn, flipZ, acc == SPH_ACCURACY_FAST);
+}
+
+void SphSlerpEvalSimd(const SphSlerpBatch *b, size_t n, float t,
+                      float *x, float *y, float *z, SphAccuracy acc) {
+    kSlerpKernels[SphIsaActive()](b->ux, b->uy, b->uz, b->wx, b->wy, b->wz, b->theta, n, t,
+                                  x, y, z, acc == SPH_ACCURACY_FAST);
+}
+
+void SphSinCosPoly(float v, float *s, float *c, SphAccuracy acc) {
+    SphSinCosVScalar(v, acc == SPH_ACCURACY_FAST, s, c);
+}
@@ -0,0 +1,115 @@
+/**
+ * \file spherical_simd.h
+ * \brief Conversão Az/El -> vetor unitário com SIMD explícito e despacho em tempo de execução.
+ *
+ * Em vez de \c cosf / \c sinf da libm (uma chamada por ângulo, sem
+ * vetorização), usamos polinômios de seno/cosseno avaliados em registradores
+ * SIMD de 4, 8 ou 16 floats. A ISA é escolhida na primeira chamada conforme a
+ * CPU: o mesmo binário roda em estações x86 (SSE4.1, AVX2, AVX-512) e em
+ * equipamentos ARM (NEON do AArch64). Sem nenhuma dessas, usa-se a versão
+ * escalar do mesmo polinômio.
+ *
+ * Como \f$(\cos El\cos Az, \cos El\sin Az, \sin El)\f$ já tem norma 1 por
+ * construção, não há \c sqrtf nem divisões de renormalização.
+ */
+#ifndef SPHERICAL_SIMD_H
+#define SPHERICAL_SIMD_H
+
+#include "spherical.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Conjuntos de instruções (ISA) suportados pelo despacho.
+ */
+typedef enum SphIsa {
+    SPH_ISA_SCALAR = 0,
+    SPH_ISA_SSE41,
+    SPH_ISA_AVX2,
+    SPH_ISA_AVX512,
+    SPH_ISA_NEON,
+    SPH_ISA_COUNT
+} SphIsa;
+
+/**
+ * \brief Retorna a melhor ISA disponível nesta CPU (e compilada no binário).
+ */
+SphIsa SphIsaDetect(void);
+
+/**
+ * \brief Indica se a ISA pode ser usada nesta CPU.
+ */
+int SphIsaSupported(SphIsa isa);
+
+/**
+ * \brief ISA atualmente usada por \ref SphAzElToVecSimd.
+ */
+SphIsa SphIsaActive(void);
+
+/**
+ * \brief Força uma ISA específica (útil em testes e benchmarks).
+ *
+ * \param isa ISA desejada.
+ * \return 0 em caso de sucesso; -1 se a ISA não estiver disponível (a atual é mantida).
+ */
+int SphIsaSelect(SphIsa isa);
+
+/**
+ * \brief Nome legível da ISA ("scalar", "sse4.1", "avx2", "avx512", "neon").
+ */
+const char *SphIsaName(SphIsa isa);
+
+/**
+ * \brief Converte N pares (az, el) em N vetores unitários (SoA) usando a ISA ativa.
+ *
+ * \param az,el Arranjos com N ângulos em radianos.
+ * \param n Quantidade de elementos.
+ * \param x,y,z Arranjos de saída.
+ * \param acc Orçamento de precisão dos polinômios.
+ */
+void SphAzElToVecSimd(const float *az, const float *el, size_t n,
+                      float *x, float *y, float *z, SphAccuracy acc);
+
+/**
+ * \brief Como \ref SphAzElToVecSimd, com os ângulos em outra unidade e Z opcionalmente invertido.
+ *
+ * Uma unidade cujo quarto de volta é exato em float (graus: 90; milésimos:
+ * 1600) é reduzida na própria unidade: \f$r = x - k\cdot\frac{1}{4}\text{volta}\f$
+ * não tem erro, e uma multiplicação leva \f$r\f$ para radianos. Não há
+ * passada de conversão pela memória, e a precisão é a de \ref SphAzElToVecSimd.
+ * Com \c unitsPerTurn = \f$2\pi\f$ (float), a redução é a dos radianos.
+ * \ref spherical_frames.h a usa com constantes.
+ *
+ * \param unitsPerTurn Unidades por volta (por exemplo 360.0f).
+ * \param flipZ 1 para \f$z = -\sin El\f$ (eixo vertical para baixo).
+ */
+void SphAzElToVecUnitSimd(const float *az, const float *el, size_t n,
+                          float *x, float *y, float *z,
+                          float unitsPerTurn, int flipZ, SphAccuracy acc);
+
+/**
+ * \brief Versão SIMD de \ref SphBatchSlerpEval (polinômios de seno/cosseno na ISA ativa).
+ *
+ * \param bases Bases preparadas com \ref SphBatchSlerpPrepare.
+ * \param n Quantidade de arcos.
+ * \param t Parâmetro comum aos N arcos.
+ * \param x,y,z Saída com N pontos.
+ * \param acc Orçamento de precisão dos polinômios.
+ */
+void SphSlerpEvalSimd(const SphSlerpBatch *bases, size_t n, float t,
+                      float *x, float *y, float *z, SphAccuracy acc);
+
+/**
+ * \brief Seno e cosseno escalares com o mesmo polinômio dos kernels SIMD.
+ */
+void SphSinCosPoly(float v, float *s, float *c, SphAccuracy acc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPHERICAL_SIMD_H */
@@ -0,0 +1,21 @@
+/**
+ * \file spherical_simd_avx2.c
+ * \brief Kernel Az/El -> vetor com AVX2 + FMA (8 floats por vetor).
+ */
+#include "spherical_simd_internal.h"
+
+#include <immintrin.h>
+
+#define SPH_V __m256
+#define SPH_W 8
+#define SPH_SUFFIX Avx2
+#define SPH_LOAD(p) _mm256_loadu_ps(p)
+#define SPH_STORE(p, v) _mm256_storeu_ps((p), (v))
+#define SPH_SET1(x) _mm256_set1_ps(x)
+#define SPH_ADD(a, b) _mm256_add_ps((a), (b))
+#define SPH_SUB(a, b) _mm256_sub_ps((a), (b))
+#define SPH_MUL(a, b) _mm256_mul_ps((a), (b))
+#define SPH_FMA(a, b, c) _mm256_fmadd_ps((a), (b), (c))
+#define SPH_ROUND(v) _mm256_round_ps((v), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+
+#include "spherical_simd_kernel.h"
@@ -0,0 +1,21 @@
+/**
+ * \file spherical_simd_avx512.c
+ * \brief Kernel Az/El -> vetor com AVX-512F (16 floats por vetor).
+ */
+#include "spherical_simd_internal.h"
+
+#include <immintrin.h>
+
+#define SPH_V __m512
+#define SPH_W 16
+#define SPH_SUFFIX Avx512
+#define SPH_LOAD(p) _mm512_loadu_ps(p)
+#define SPH_STORE(p, v) _mm512_storeu_ps((p), (v))
+#define SPH_SET1(x) _mm512_set1_ps(x)
+#define SPH_ADD(a, b) _mm512_add_ps((a), (b))
+#define SPH_SUB(a, b) _mm512_sub_ps((a), (b))
+#define SPH_MUL(a, b) _mm512_mul_ps((a), (b))
+#define SPH_FMA(a, b, c) _mm512_fmadd_ps((a), (b), (c))
+#define SPH_ROUND(v) _mm512_roundscale_ps((v), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+
+#include "spherical_simd_kernel.h"
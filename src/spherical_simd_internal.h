@@ -0,0 +1,80 @@
+/**
+ * \file spherical_simd_internal.h
+ * \brief Declarações internas dos kernels por ISA (uso exclusivo do despachante).
+ *
+ * Cada função é compilada em sua própria unidade de tradução, com as flags de
+ * compilação da ISA correspondente (veja \c CMakeLists.txt). Só podem ser
+ * chamadas depois que \ref SphIsaDetect confirmar o suporte da CPU.
+ */
+#ifndef SPHERICAL_SIMD_INTERNAL_H
+#define SPHERICAL_SIMD_INTERNAL_H
+
+#include <stddef.h>
+
+typedef void (*SphAzElToVecFn)(const float *az, const float *el, size_t n,
+                               float *x, float *y, float *z, int fast);
+
+typedef void (*SphAzElToVecUnitFn)(const float *az, const float *el, size_t n,
+                                   float *x, float *y, float *z,
+                                   float quarter, int flipZ, int fast);
+
+typedef void (*SphSlerpEvalFn)(const float *ux, const float *uy, const float *uz,
+                               const float *wx, const float *wy, const float *wz,
+                               const float *theta, size_t n, float t,
+                               float *x, float *y, float *z, int fast);
+
+void SphAzElToVecScalar(const float *az, const float *el, size_t n,
+                        float *x, float *y, float *z, int fast);
+void SphAzElToVecUnitScalar(const float *az, const float *el, size_t n,
+                            float *x, float *y, float *z,
+                            float quarter, int flipZ, int fast);
+void SphSlerpEvalScalar(const float *ux, const float *uy, const float *uz,
+                        const float *wx, const float *wy, const float *wz,
+                        const float *theta, size_t n, float t,
+                        float *x, float *y, float *z, int fast);
+#ifdef SPH_HAVE_SSE41
+void SphAzElToVecSse41(const float *az, const float *el, size_t n,
+                       float *x, float *y, float *z, int fast);
+void SphAzElToVecUnitSse41(const float *az, const float *el, size_t n,
+                           float *x, float *y, float *z,
+                           float quarter, int flipZ, int fast);
+void SphSlerpEvalSse41(const float *ux, const float *uy, const float *uz,
+                       const float *wx, const float *wy, const float *wz,
+                       const float *theta, size_t n, float t,
+                       float *x, float *y, float *z, int fast);
+#endif
+#ifdef SPH_HAVE_AVX2
+void SphAzElToVecAvx2(const float *az, const float *el, size_t n,
+                      float *x, float *y, float *z, int fast);
+void SphAzElToVecUnitAvx2(const float *az, const float *el, size_t n,
+                          float *x, float *y, float *z,
+                          float quarter, int flipZ, int fast);
+void SphSlerpEvalAvx2(const float *ux, const float *uy, const float *uz,
+                      const float *wx, const float *wy, const float *wz,
+                      const float *theta, size_t n, float t,
+                      float *x, float *y, float *z, int fast);
+#endif
+#ifdef SPH_HAVE_AVX512
+void SphAzElToVecAvx512(const float *az, const float *el, size_t n,
+                        float *x, float *y, float *z, int fast);
+void SphAzElToVecUnitAvx512(const float *az, const float *el, size_t n,
+                            float *x, float *y, float *z,
+                            float quarter, int flipZ, int fast);
+void SphSlerpEvalAvx512(const float *ux, const float *uy, const float *uz,
+                        const float *wx, const float *wy, const float *wz,
+                        const float *theta, size_t n, float t,
+                        float *x, float *y, float *z, int fast);
+#endif
+#ifdef SPH_HAVE_NEON
+void SphAzElToVecNeon(const float *az, const float *el, size_t n,
+                      float *x, float *y, float *z, int fast);
+void SphAzElToVecUnitNeon(const float *az, const float *el, size_t n,
+                          float *x, float *y, float *z,
+                          float quarter, int flipZ, int fast);
+void SphSlerpEvalNeon(const float *ux, const float *uy, const float *uz,
+                      const float *wx, const float *wy, const float *wz,
+                      const float *theta, size_t n, float t,
+                      float *x, float *y, float *z, int fast);
+#endif
+
+#endif /* SPHERICAL_SIMD_INTERNAL_H */
@@ -0,0 +1,199 @@
+/**
+ * \file spherical_simd_kernel.h
+ * \brief Modelo (template) dos kernels SIMD (Az/El -> vetor, slerp em lote), incluído por cada ISA.
+ *
+ * Este arquivo \b não tem proteção contra inclusão múltipla de propósito: cada
+ * unidade de tradução (\c spherical_simd_sse41.c, \c spherical_simd_avx2.c, ...)
+ * define as macros abaixo para a sua largura de vetor e inclui este arquivo,
+ * gerando as funções \c SphAzElToVec<Sufixo>, \c SphAzElToVecUnit<Sufixo> e
+ * \c SphSlerpEval<Sufixo>. Assim a matemática é escrita uma
+ * única vez e todas as ISAs produzem o mesmo resultado (até o arredondamento).
+ *
+ * Macros exigidas:
+ * - \c SPH_V          tipo do vetor (por exemplo \c __m256)
+ * - \c SPH_W          quantidade de floats por vetor
+ * - \c SPH_SUFFIX     sufixo do nome da função gerada
+ * - \c SPH_LOAD(p) \c SPH_STORE(p, v) \c SPH_SET1(x)
+ * - \c SPH_ADD(a, b) \c SPH_SUB(a, b) \c SPH_MUL(a, b)
+ * - \c SPH_FMA(a, b, c)  calcula a*b + c
+ * - \c SPH_ROUND(v)      arredonda para o inteiro mais próximo
+ *
+ * Redução de argumento: \f$x = k\,\pi/2 + r\f$, com \f$|r| \le \pi/4\f$ e
+ * \f$\pi/2\f$ dividido em três parcelas (Cody-Waite). O quadrante \c q = k mod 4
+ * é aplicado sem desvios, apenas com somas e multiplicações:
+ * \f$\sin x = [s, c, -s, -c]_q\f$ e \f$\cos x = [c, -s, -c, s]_q\f$.
+ * A redução é precisa para \f$|x| \lesssim 10^4\f$ rad, muito além de qualquer
+ * ângulo de sensor.
+ */
+
+#define SPH_CAT_(a, b) a##b
+#define SPH_CAT(a, b) SPH_CAT_(a, b)
+#define SPH_FN(name) SPH_CAT(name, SPH_SUFFIX)
+
+/**
+ * Seno e cosseno de \f$k\,\pi/2 + r\f$, com \f$|r| \le \pi/4\f$ já reduzido,
+ * pelo polinômio escolhido por \c fast.
+ */
+static inline void SPH_FN(SphSinCosReduced)(SPH_V k, SPH_V r, int fast, SPH_V *sOut, SPH_V *cOut) {
+    const SPH_V r2 = SPH_MUL(r, r);
+
+    SPH_V s, c;
+    if (fast) {
+        // Taylor de grau 5/4: erro máximo ~3.3e-4 (dominado pelo cosseno)
+        s = SPH_FMA(r2, SPH_SET1(8.3333333e-3f), SPH_SET1(-1.6666667e-1f));
+        s = SPH_FMA(SPH_MUL(s, r2), r, r);
+        c = SPH_FMA(r2, SPH_SET1(4.1666667e-2f), SPH_SET1(-0.5f));
+        c = SPH_FMA(c, r2, SPH_SET1(1.0f));
+    } else {
+        // Minimax de grau 7/8 (coeficientes da Cephes): erro ~1e-7
+        s = SPH_FMA(r2, SPH_SET1(-1.9515295891e-4f), SPH_SET1(8.3321608736e-3f));
+        s = SPH_FMA(s, r2, SPH_SET1(-1.6666654611e-1f));
+        s = SPH_FMA(SPH_MUL(s, r2), r, r);
+        c = SPH_FMA(r2, SPH_SET1(2.443315711809948e-5f), SPH_SET1(-1.388731625493765e-3f));
+        c = SPH_FMA(c, r2, SPH_SET1(4.166664568298827e-2f));
+        c = SPH_FMA(c, r2, SPH_SET1(-0.5f));
+        c = SPH_FMA(c, r2, SPH_SET1(1.0f));
+    }
+
+    // q = k mod 4; odd = q mod 2; half = floor(q/2) (valores inteiros em float)
+    const SPH_V one = SPH_SET1(1.0f);
+    const SPH_V q = SPH_FMA(SPH_ROUND(SPH_FMA(k, SPH_SET1(0.25f), SPH_SET1(-0.375f))), SPH_SET1(-4.0f), k);
+    const SPH_V half = SPH_ROUND(SPH_FMA(q, SPH_SET1(0.5f), SPH_SET1(-0.25f)));
+    const SPH_V odd = SPH_FMA(half, SPH_SET1(-2.0f), q);
+    // Cosseno negativo quando q está em {1, 2}, isto é, floor(((q+1) mod 4)/2) = 1
+    const SPH_V q1 = SPH_ADD(q, one);
+    const SPH_V q1m = SPH_FMA(SPH_ROUND(SPH_FMA(q1, SPH_SET1(0.25f), SPH_SET1(-0.375f))), SPH_SET1(-4.0f), q1);
+    const SPH_V halfC = SPH_ROUND(SPH_FMA(q1m, SPH_SET1(0.5f), SPH_SET1(-0.25f)));
+
+    const SPH_V signS = SPH_FMA(half, SPH_SET1(-2.0f), one);
+    const SPH_V signC = SPH_FMA(halfC, SPH_SET1(-2.0f), one);
+    const SPH_V even = SPH_SUB(one, odd);
+    *sOut = SPH_MUL(signS, SPH_FMA(even, s, SPH_MUL(odd, c)));
+    *cOut = SPH_MUL(signC, SPH_FMA(even, c, SPH_MUL(odd, s)));
+}
+
+/** Calcula seno e cosseno de \c x (rad) com o polinômio escolhido por \c fast. */
+static inline void SPH_FN(SphSinCosV)(SPH_V x, int fast, SPH_V *sOut, SPH_V *cOut) {
+    const SPH_V k = SPH_ROUND(SPH_MUL(x, SPH_SET1(0.63661977236758134f))); // 2/pi
+    SPH_V r = SPH_FMA(k, SPH_SET1(-1.5703125f), x);
+    r = SPH_FMA(k, SPH_SET1(-4.837512969970703125e-4f), r);
+    r = SPH_FMA(k, SPH_SET1(-7.54978995489188216e-8f), r);
+    SPH_FN(SphSinCosReduced)(k, r, fast, sOut, cOut);
+}
+
+/**
+ * Seno e cosseno de \c x em uma unidade com quarto de volta \c q exato em
+ * float (90°, 1600 mil): \f$x - kq\f$ é exato, e uma multiplicação leva o
+ * resto para radianos, no lugar das três parcelas de Cody-Waite.
+ */
+static inline void SPH_FN(SphSinCosUnitV)(SPH_V x, SPH_V q, SPH_V invQ, SPH_V radPerUnit, int fast,
+                                          SPH_V *sOut, SPH_V *cOut) {
+    const SPH_V k = SPH_ROUND(SPH_MUL(x, invQ));
+    const SPH_V r = SPH_MUL(SPH_SUB(x, SPH_MUL(k, q)), radPerUnit);
+    SPH_FN(SphSinCosReduced)(k, r, fast, sOut, cOut);
+}
+
+/**
+ * Corpo comum de Az/El -> vetor. \c unit (constante após o inline) escolhe a
+ * redução: 0 em radianos, 1 na unidade de quarto de volta \c quarter. Com
+ * \c flip, Z sai multiplicado por -1 (eixo vertical para baixo).
+ */
+static inline void SPH_FN(SphAzElToVecBody)(const float *az, const float *el, size_t n,
+                                           float *x, float *y, float *z,
+                                           int unit, float quarter, int flip, int fast) {
+    const SPH_V q = SPH_SET1(quarter), invQ = SPH_SET1(1.0f / quarter);
+    const SPH_V radPerUnit = SPH_SET1(1.57079632679489661923f / quarter);
+    const SPH_V minusOne = SPH_SET1(-1.0f);
+    size_t i = 0;
+    for (; i + SPH_W <= n; i += SPH_W) {
+        SPH_V sa, ca, se, ce;
+        if (unit) {
+            SPH_FN(SphSinCosUnitV)(SPH_LOAD(az + i), q, invQ, radPerUnit, fast, &sa, &ca);
+            SPH_FN(SphSinCosUnitV)(SPH_LOAD(el + i), q, invQ, radPerUnit, fast, &se, &ce);
+        } else {
+            SPH_FN(SphSinCosV)(SPH_LOAD(az + i), fast, &sa, &ca);
+            SPH_FN(SphSinCosV)(SPH_LOAD(el + i), fast, &se, &ce);
+        }
+        SPH_STORE(x + i, SPH_MUL(ce, ca));
+        SPH_STORE(y + i, SPH_MUL(ce, sa));
+        SPH_STORE(z + i, flip ? SPH_MUL(se, minusOne) : se);
+    }
+    if (i < n) {
+        // Cauda: completa um vetor com zeros em buffers locais
+        float ta[SPH_W], te[SPH_W], tx[SPH_W], ty[SPH_W], tz[SPH_W];
+        size_t m = n - i;
+        for (size_t k = 0; k < SPH_W; ++k) {
+            ta[k] = k < m ? az[i + k] : 0.0f;
+            te[k] = k < m ? el[i + k] : 0.0f;
+        }
+        SPH_V sa, ca, se, ce;
+        if (unit) {
+            SPH_FN(SphSinCosUnitV)(SPH_LOAD(ta), q, invQ, radPerUnit, fast, &sa, &ca);
+            SPH_FN(SphSinCosUnitV)(SPH_LOAD(te), q, invQ, radPerUnit, fast, &se, &ce);
+        } else {
+            SPH_FN(SphSinCosV)(SPH_LOAD(ta), fast, &sa, &ca);
+            SPH_FN(SphSinCosV)(SPH_LOAD(te), fast, &se, &ce);
+        }
+        SPH_STORE(tx, SPH_MUL(ce, ca));
+        SPH_STORE(ty, SPH_MUL(ce, sa));
+        SPH_STORE(tz, flip ? SPH_MUL(se, minusOne) : se);
+        for (size_t k = 0; k < m; ++k) {
+            x[i + k] = tx[k]; y[i + k] = ty[k]; z[i + k] = tz[k];
+        }
+    }
+}
+
+void SPH_FN(SphAzElToVec)(const float *az, const float *el, size_t n,
+                          float *x, float *y, float *z, int fast) {
+    SPH_FN(SphAzElToVecBody)(az, el, n, x, y, z, 0, 1.0f, 0, fast);
+}
+
+void SPH_FN(SphAzElToVecUnit)(const float *az, const float *el, size_t n,
+                              float *x, float *y, float *z,
+                              float quarter, int flipZ, int fast) {
+    // Os quatro casos saem do laço: cada um é um laço especializado
+    const int unit = quarter != 1.57079632679489661923f;
+    if (unit && flipZ) SPH_FN(SphAzElToVecBody)(az, el, n, x, y, z, 1, quarter, 1, fast);
+    else if (unit)     SPH_FN(SphAzElToVecBody)(az, el, n, x, y, z, 1, quarter, 0, fast);
+    else if (flipZ)    SPH_FN(SphAzElToVecBody)(az, el, n, x, y, z, 0, 1.0f, 1, fast);
+    else               SPH_FN(SphAzElToVecBody)(az, el, n, x, y, z, 0, 1.0f, 0, fast);
+}
+
+void SPH_FN(SphSlerpEval)(const float *ux, const float *uy, const float *uz,
+                          const float *wx, const float *wy, const float *wz,
+                          const float *theta, size_t n, float t,
+                          float *x, float *y, float *z, int fast) {
+    const SPH_V vt = SPH_SET1(t);
+    size_t i = 0;
+    for (; i + SPH_W <= n; i += SPH_W) {
+        SPH_V s, c;
+        SPH_FN(SphSinCosV)(SPH_MUL(vt, SPH_LOAD(theta + i)), fast, &s, &c);
+        SPH_STORE(x + i, SPH_FMA(c, SPH_LOAD(ux + i), SPH_MUL(s, SPH_LOAD(wx + i))));
+        SPH_STORE(y + i, SPH_FMA(c, SPH_LOAD(uy + i), SPH_MUL(s, SPH_LOAD(wy + i))));
+        SPH_STORE(z + i, SPH_FMA(c, SPH_LOAD(uz + i), SPH_MUL(s, SPH_LOAD(wz + i))));
+    }
+    if (i < n) {
+        // Cauda: completa um vetor com zeros em buffers locais
+        float tth[SPH_W], tu[3][SPH_W], tw[3][SPH_W], to[3][SPH_W];
+        const float *const us[3] = { ux, uy, uz }, *const ws[3] = { wx, wy, wz };
+        float *const os[3] = { x, y, z };
+        size_t m = n - i;
+        for (size_t k = 0; k < SPH_W; ++k) {
+            tth[k] = k < m ? theta[i + k] : 0.0f;
+            for (int d = 0; d < 3; ++d) {
+                tu[d][k] = k < m ? us[d][i + k] : 0.0f;
+                tw[d][k] = k < m ? ws[d][i + k] : 0.0f;
+            }
+        }
+        SPH_V s, c;
+        SPH_FN(SphSinCosV)(SPH_MUL(vt, SPH_LOAD(tth)), fast, &s, &c);
+        for (int d = 0; d < 3; ++d) {
+            SPH_STORE(to[d], SPH_FMA(c, SPH_LOAD(tu[d]), SPH_MUL(s, SPH_LOAD(tw[d]))));
+            for (size_t k = 0; k < m; ++k) os[d][i + k] = to[d][k];
+        }
+    }
+}
+
+#undef SPH_FN
+#undef SPH_CAT
+#undef SPH_CAT_
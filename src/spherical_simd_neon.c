@@ -0,0 +1,21 @@
+/**
+ * \file spherical_simd_neon.c
+ * \brief Kernel Az/El -> vetor com NEON do AArch64 (4 floats por vetor, com FMA).
+ */
+#include "spherical_simd_internal.h"
+
+#include <arm_neon.h>
+
+#define SPH_V float32x4_t
+#define SPH_W 4
+#define SPH_SUFFIX Neon
+#define SPH_LOAD(p) vld1q_f32(p)
+#define SPH_STORE(p, v) vst1q_f32((p), (v))
+#define SPH_SET1(x) vdupq_n_f32(x)
+#define SPH_ADD(a, b) vaddq_f32((a), (b))
+#define SPH_SUB(a, b) vsubq_f32((a), (b))
+#define SPH_MUL(a, b) vmulq_f32((a), (b))
+#define SPH_FMA(a, b, c) vfmaq_f32((c), (a), (b))
+#define SPH_ROUND(v) vrndnq_f32(v)
+
+#include "spherical_simd_kernel.h"
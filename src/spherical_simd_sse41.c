@@ -0,0 +1,21 @@
+/**
+ * \file spherical_simd_sse41.c
+ * \brief Kernel Az/El -> vetor com SSE4.1 (4 floats por vetor, sem FMA).
+ */
+#include "spherical_simd_internal.h"
+
+#include <smmintrin.h>
+
+#define SPH_V __m128
+#define SPH_W 4
+#define SPH_SUFFIX Sse41
+#define SPH_LOAD(p) _mm_loadu_ps(p)
+#define SPH_STORE(p, v) _mm_storeu_ps((p), (v))
+#define SPH_SET1(x) _mm_set1_ps(x)
+#define SPH_ADD(a, b) _mm_add_ps((a), (b))
+#define SPH_SUB(a, b) _mm_sub_ps((a), (b))
+#define SPH_MUL(a, b) _mm_mul_ps((a), (b))
+#define SPH_FMA(a, b, c) _mm_add_ps(_mm_mul_ps((a), (b)), (c))
+#define SPH_ROUND(v) _mm_round_ps((v), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+
+#include "spherical_simd_kernel.h"
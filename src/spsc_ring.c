@@ -0,0 +1,99 @@
+/**
+ * \file spsc_ring.c
+ * \brief Implementação da fila SPSC com índices monotônicos e máscara.
+ *
+ * \c head (escrito pelo produtor) e \c tail (escrito pelo consumidor) só
+ * crescem; a posição no arranjo é o índice módulo a capacidade (potência de
+ * 2, via máscara). O produtor publica um elemento com uma escrita \e release
+ * em \c head depois de copiá-lo; o consumidor lê \c head com \e acquire antes
+ * de copiar, e devolve as posições com uma escrita \e release em \c tail.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "spsc_ring.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RING_LINE 64
+
+struct SpscRing {
+    // Lado do produtor
+    _Alignas(RING_LINE) _Atomic size_t head;
+    size_t cachedTail;
+    _Atomic uint64_t overruns;
+    // Lado do consumidor
+    _Alignas(RING_LINE) _Atomic size_t tail;
+    size_t cachedHead;
+    // Somente leitura depois de criada
+    _Alignas(RING_LINE) size_t mask;
+    size_t elemSize;
+    unsigned char *data;
+};
+
+SpscRing *SpscRingCreate(size_t elemSize, size_t capacity) {
+    size_t cap = 2;
+    while (cap < capacity) cap *= 2;
+    SpscRing *r;
+    if (posix_memalign((void **)&r, RING_LINE, sizeof *r) != 0) return NULL;
+    memset(r, 0, sizeof *r);
+    r->data = malloc(cap * elemSize);
+    if (!r->data) {
+        free(r);
+        return NULL;
+    }
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    atomic_init(&r->overruns, 0);
+    r->mask = cap - 1;
+    r->elemSize = elemSize;
+    return r;
+}
+
+void SpscRingDestroy(SpscRing *r) {
+    if (!r) return;
+    free(r->data);
+    free(r);
+}
+
+int SpscRingPush(SpscRing *r, const void *elem) {
+    size_t h = atomic_load_explicit(&r->head, memory_order_relaxed);
+    if (h - r->cachedTail > r->mask) {
+        r->cachedTail = atomic_load_explicit(&r->tail, memory_order_acquire);
+        if (h - r->cachedTail > r->mask) {
+            atomic_fetch_add_explicit(&r->overruns, 1, memory_order_relaxed);
+            return -1;
+        }
+    }
+    memcpy(r->data + (h & r->mask) * r->elemSize, elem, r->elemSize);
+    atomic_store_explicit(&r->head, h + 1, memory_order_release);
+    return 0;
+}
+
+size_t SpscRingPop(SpscRing *r, void *out, size_t max) {
+    size_t t = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    size_t n = r->cachedHead - t;
+    if (n < max) {
+        // Só relê a linha do produtor quando a cópia local não basta
+        r->cachedHead = atomic_load_explicit(&r->head, memory_order_acquire);
+        n = r->cachedHead - t;
+    }
+    if (n == 0) return 0;
+    if (n > max) n = max;
+    // Até duas cópias contíguas (antes e depois da volta do arranjo)
+    size_t pos = t & r->mask;
+    size_t first = n < r->mask + 1 - pos ? n : r->mask + 1 - pos;
+    memcpy(out, r->data + pos * r->elemSize, first * r->elemSize);
+    memcpy((unsigned char *)out + first * r->elemSize, r->data, (n - first) * r->elemSize);
+    atomic_store_explicit(&r->tail, t + n, memory_order_release);
+    return n;
+}
+
+uint64_t SpscRingOverruns(const SpscRing *r) {
+    return atomic_load_explicit(&((SpscRing *)r)->overruns, memory_order_relaxed);
+}
+
+size_t SpscRingCapacity(const SpscRing *r) {
+    return r->mask + 1;
+}
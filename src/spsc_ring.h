@@ -0,0 +1,52 @@
+/**
+ * \file spsc_ring.h
+ * \brief Fila circular sem locks para um produtor e um consumidor (SPSC).
+ *
+ * Uma thread empilha (\ref SpscRingPush) e outra desempilha
+ * (\ref SpscRingPop); nenhuma delas bloqueia ou chama o sistema operacional.
+ * Os índices de escrita e de leitura ficam em linhas de cache separadas, e
+ * cada lado guarda uma cópia do índice do outro, relida só quando a fila
+ * parece cheia (ou vazia). Com isso, no caso comum uma operação não toca na
+ * linha de cache da outra thread.
+ *
+ * Quando a fila está cheia, o elemento novo é descartado e contado como
+ * \b overrun (\ref SpscRingOverruns): o produtor nunca espera pelo consumidor.
+ */
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Fila opaca. */
+typedef struct SpscRing SpscRing;
+
+/**
+ * \brief Cria uma fila para \c capacity elementos de \c elemSize bytes.
+ * \param capacity Capacidade, arredondada para cima até uma potência de 2.
+ * \return Fila, ou NULL sem memória.
+ */
+SpscRing *SpscRingCreate(size_t elemSize, size_t capacity);
+
+/** \brief Libera a fila (nenhuma das threads pode estar usando-a). */
+void SpscRingDestroy(SpscRing *ring);
+
+/**
+ * \brief Empilha uma cópia de \c elem (só a thread produtora).
+ * \return 0, ou -1 se a fila estava cheia (o elemento é descartado e contado como overrun).
+ */
+int SpscRingPush(SpscRing *ring, const void *elem);
+
+/**
+ * \brief Desempilha até \c max elementos, em ordem, para \c out (só a thread consumidora).
+ * \return Quantidade de elementos copiados (0 se a fila estava vazia).
+ */
+size_t SpscRingPop(SpscRing *ring, void *out, size_t max);
+
+/** \brief Elementos descartados por fila cheia (pode ser lido de qualquer thread). */
+uint64_t SpscRingOverruns(const SpscRing *ring);
+
+/** \brief Capacidade da fila (potência de 2). */
+size_t SpscRingCapacity(const SpscRing *ring);
+
+#endif /* SPSC_RING_H */
@@ -0,0 +1,178 @@
+/**
+ * \file state_client.c
+ * \brief Thread de recepção do assinante: quadros TCP -> \ref StateDecodeFrame -> fila SPSC.
+ *
+ * Os bytes chegam em blocos de qualquer tamanho; quadros incompletos ficam
+ * no buffer até a próxima leitura, como os registros parciais em
+ * \c telemetry.c.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "state_client.h"
+
+#include "spsc_ring.h"
+
+#include <errno.h>
+#include <netdb.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define STATE_CLIENT_RAW_BYTES (2 * STATE_PROTO_MAX_FRAME)
+#define STATE_CLIENT_POLL_MS 100
+
+struct StateClient {
+    int fd;
+    SpscRing *ring;
+    pthread_t thread;
+    StateDecoder dec;
+    _Atomic uint64_t received;
+    _Atomic uint64_t keys;
+    _Atomic int ended;
+    _Atomic int stop;
+    unsigned char *raw;
+};
+
+static int Connect(const char *spec) {
+    char host[256];
+    const char *colon = strrchr(spec, ':');
+    if (!colon) {
+        fprintf(stderr, "assinante: porta ausente em '%s'\n", spec);
+        return -1;
+    }
+    size_t hl = (size_t)(colon - spec);
+    if (hl >= sizeof host) return -1;
+    memcpy(host, spec, hl);
+    host[hl] = '\0';
+
+    struct addrinfo hints, *res = NULL;
+    memset(&hints, 0, sizeof hints);
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    int rc = getaddrinfo(hl ? host : NULL, colon + 1, &hints, &res);
+    if (rc != 0) {
+        fprintf(stderr, "assinante: endereço inválido '%s': %s\n", spec, gai_strerror(rc));
+        return -1;
+    }
+    int fd = -1;
+    for (struct addrinfo *a = res; a && fd < 0; a = a->ai_next) {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    if (fd < 0) fprintf(stderr, "assinante: não foi possível conectar a '%s'\n", spec);
+    return fd;
+}
+
+static uint32_t LoadLe32(const unsigned char *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void PushSample(const StateSample *s, void *user) {
+    StateClient *c = user;
+    SpscRingPush(c->ring, s); // fila cheia: descartado e contado como overrun
+    atomic_fetch_add_explicit(&c->received, 1, memory_order_relaxed);
+}
+
+static void *ReceiveThread(void *arg) {
+    StateClient *c = arg;
+    struct pollfd pfd = { c->fd, POLLIN, 0 };
+    size_t beg = 0, end = 0;
+    while (!atomic_load_explicit(&c->stop, memory_order_relaxed)) {
+        int rc = poll(&pfd, 1, STATE_CLIENT_POLL_MS);
+        if (rc == 0 || (rc < 0 && errno == EINTR)) continue;
+        if (rc < 0) break;
+        if (beg > 0) {
+            memmove(c->raw, c->raw + beg, end - beg);
+            end -= beg;
+            beg = 0;
+        }
+        ssize_t n = recv(c->fd, c->raw + end, STATE_CLIENT_RAW_BYTES - end, 0);
+        if (n < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+        if (n <= 0) break;
+        end += (size_t)n;
+        // Decodifica todos os quadros completos
+        int bad = 0;
+        while (end - beg >= 4) {
+            size_t len = LoadLe32(c->raw + beg);
+            if (len > STATE_PROTO_MAX_FRAME - 4) { bad = 1; break; }
+            if (end - beg - 4 < len) break;
+            if (StateDecodeFrame(&c->dec, c->raw + beg + 4, len, PushSample, c) != 0) { bad = 1; break; }
+            beg += 4 + len;
+        }
+        atomic_store_explicit(&c->keys, c->dec.keys, memory_order_relaxed);
+        if (bad) {
+            fprintf(stderr, "assinante: quadro inválido, conexão encerrada\n");
+            break;
+        }
+    }
+    atomic_store(&c->ended, 1);
+    return NULL;
+}
+
+StateClient *StateClientStart(const char *addr) {
+    StateClient *c = calloc(1, sizeof *c);
+    if (!c) return NULL;
+    atomic_init(&c->received, 0);
+    atomic_init(&c->keys, 0);
+    atomic_init(&c->ended, 0);
+    atomic_init(&c->stop, 0);
+    c->raw = malloc(STATE_CLIENT_RAW_BYTES);
+    c->ring = c->raw ? SpscRingCreate(sizeof(StateSample), STATE_CLIENT_RING) : NULL;
+    c->fd = c->ring ? Connect(addr) : -1;
+    if (c->fd < 0) {
+        SpscRingDestroy(c->ring);
+        free(c->raw);
+        free(c);
+        return NULL;
+    }
+    if (pthread_create(&c->thread, NULL, ReceiveThread, c) != 0) {
+        fprintf(stderr, "assinante: não foi possível criar a thread de recepção\n");
+        close(c->fd);
+        SpscRingDestroy(c->ring);
+        free(c->raw);
+        free(c);
+        return NULL;
+    }
+    return c;
+}
+
+size_t StateClientDrain(StateClient *c, StateSample *out, size_t max) {
+    return SpscRingPop(c->ring, out, max);
+}
+
+uint64_t StateClientReceived(const StateClient *c) {
+    return atomic_load_explicit(&((StateClient *)c)->received, memory_order_relaxed);
+}
+
+uint64_t StateClientOverruns(const StateClient *c) {
+    return SpscRingOverruns(c->ring);
+}
+
+uint64_t StateClientResyncs(const StateClient *c) {
+    uint64_t keys = atomic_load_explicit(&((StateClient *)c)->keys, memory_order_relaxed);
+    return keys > 1 ? keys - 1 : 0;
+}
+
+int StateClientEnded(const StateClient *c) {
+    return atomic_load(&((StateClient *)c)->ended);
+}
+
+void StateClientStop(StateClient *c) {
+    if (!c) return;
+    // A thread confere a parada a cada STATE_CLIENT_POLL_MS
+    atomic_store(&c->stop, 1);
+    pthread_join(c->thread, NULL);
+    close(c->fd);
+    SpscRingDestroy(c->ring);
+    free(c->raw);
+    free(c);
+}
@@ -0,0 +1,51 @@
+/**
+ * \file state_client.h
+ * \brief Visualizador assinante: recebe o estado de um publicador (\ref state_server.h).
+ *
+ * Como em \ref live_feed.h, uma thread lê o socket e empilha cada estado
+ * decodificado em uma \ref SpscRing; o laço de renderização desempilha tudo
+ * uma vez por quadro, sem locks. J já vem calculado pelo publicador.
+ */
+#ifndef STATE_CLIENT_H
+#define STATE_CLIENT_H
+
+#include "state_proto.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Capacidade da fila entre a thread de rede e o laço (estados). */
+#define STATE_CLIENT_RING 65536
+
+/** Assinatura opaca. */
+typedef struct StateClient StateClient;
+
+/**
+ * \brief Conecta ao publicador e inicia a thread de recepção.
+ * \param addr \c "endereço:porta".
+ * \return Assinatura, ou NULL em caso de erro (mensagem em stderr).
+ */
+StateClient *StateClientStart(const char *addr);
+
+/**
+ * \brief Desempilha até \c max estados, em ordem (só a thread do laço).
+ * \return Quantidade copiada para \c out.
+ */
+size_t StateClientDrain(StateClient *c, StateSample *out, size_t max);
+
+/** \brief Estados recebidos desde a conexão. */
+uint64_t StateClientReceived(const StateClient *c);
+
+/** \brief Estados descartados: fila local cheia. */
+uint64_t StateClientOverruns(const StateClient *c);
+
+/** \brief Quadros-chave recebidos além do primeiro (o publicador nos ressincronizou). */
+uint64_t StateClientResyncs(const StateClient *c);
+
+/** \brief 1 depois que a conexão terminou (fim, erro ou quadro inválido). */
+int StateClientEnded(const StateClient *c);
+
+/** \brief Encerra a thread e fecha a conexão. */
+void StateClientStop(StateClient *c);
+
+#endif /* STATE_CLIENT_H */
@@ -0,0 +1,165 @@
+/**
+ * \file state_proto.c
+ * \brief Codificação e decodificação dos quadros do publicador de estado.
+ */
+#include "state_proto.h"
+
+#include <math.h>
+#include <string.h>
+
+static void StoreLe16(unsigned char *p, uint32_t u) {
+    p[0] = (unsigned char)u; p[1] = (unsigned char)(u >> 8);
+}
+
+static void StoreLe32(unsigned char *p, uint32_t u) {
+    p[0] = (unsigned char)u; p[1] = (unsigned char)(u >> 8);
+    p[2] = (unsigned char)(u >> 16); p[3] = (unsigned char)(u >> 24);
+}
+
+static void StoreLe64(unsigned char *p, uint64_t u) {
+    StoreLe32(p, (uint32_t)u);
+    StoreLe32(p + 4, (uint32_t)(u >> 32));
+}
+
+static uint32_t LoadLe16(const unsigned char *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8;
+}
+
+static uint32_t LoadLe32(const unsigned char *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint64_t LoadLe64(const unsigned char *p) {
+    return (uint64_t)LoadLe32(p) | (uint64_t)LoadLe32(p + 4) << 32;
+}
+
+/** Varint LEB128 do zigue-zague de \c v (pequenos em módulo -> poucos bytes). */
+static size_t PutVarint(unsigned char *p, int64_t v) {
+    uint64_t u = ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+    size_t n = 0;
+    while (u >= 0x80) {
+        p[n++] = (unsigned char)(u | 0x80);
+        u >>= 7;
+    }
+    p[n++] = (unsigned char)u;
+    return n;
+}
+
+/** \return Bytes consumidos, ou 0 se o varint passa do fim ou de 64 bits. */
+static size_t GetVarint(const unsigned char *p, const unsigned char *end, int64_t *v) {
+    uint64_t u = 0;
+    for (size_t n = 0; n < 10 && p + n < end; ++n) {
+        u |= (uint64_t)(p[n] & 0x7f) << (7 * n);
+        if (!(p[n] & 0x80)) {
+            *v = (int64_t)(u >> 1) ^ -(int64_t)(u & 1);
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+/** Arredonda para o passo mais próximo; NaN vira 0 e o resto satura em 32 bits. */
+static int32_t QuantizeAngle(float deg) {
+    double q = nearbyint((double)deg / STATE_PROTO_ANGLE_QUANTUM);
+    if (!(q == q)) return 0;
+    if (q > INT32_MAX) return INT32_MAX;
+    if (q < -INT32_MAX) return -INT32_MAX;
+    return (int32_t)q;
+}
+
+void StateQuantize(const StateSample *s, StateQ *q) {
+    double t = nearbyint(s->t / STATE_PROTO_TIME_QUANTUM);
+    q->t = t == t && fabs(t) < 9e18 ? (int64_t)t : 0;
+    q->v[0] = QuantizeAngle(s->azT);
+    q->v[1] = QuantizeAngle(s->elT);
+    q->v[2] = QuantizeAngle(s->azR);
+    q->v[3] = QuantizeAngle(s->elR);
+    q->v[4] = QuantizeAngle(s->J);
+}
+
+void StateDequantize(const StateQ *q, StateSample *s) {
+    s->t = (double)q->t * STATE_PROTO_TIME_QUANTUM;
+    s->azT = (float)(q->v[0] * STATE_PROTO_ANGLE_QUANTUM);
+    s->elT = (float)(q->v[1] * STATE_PROTO_ANGLE_QUANTUM);
+    s->azR = (float)(q->v[2] * STATE_PROTO_ANGLE_QUANTUM);
+    s->elR = (float)(q->v[3] * STATE_PROTO_ANGLE_QUANTUM);
+    s->J = (float)(q->v[4] * STATE_PROTO_ANGLE_QUANTUM);
+}
+
+size_t StateEncodeKey(const StateQ *q, uint32_t seq, unsigned char *out) {
+    unsigned char *p = out + 4;
+    *p++ = STATE_FRAME_KEY;
+    *p++ = STATE_PROTO_VERSION;
+    StoreLe32(p, seq); p += 4;
+    StoreLe64(p, (uint64_t)q->t); p += 8;
+    for (int f = 0; f < STATE_PROTO_FIELDS; ++f, p += 4) StoreLe32(p, (uint32_t)q->v[f]);
+    size_t bytes = (size_t)(p - out);
+    StoreLe32(out, (uint32_t)(bytes - 4));
+    return bytes;
+}
+
+size_t StateBeginDelta(uint32_t seq, unsigned char *out) {
+    out[4] = STATE_FRAME_DELTA;
+    StoreLe32(out + 5, seq);
+    return 4 + 1 + 4 + 2; // tamanho e quantidade preenchidos em StateEndDelta
+}
+
+size_t StateEncodeDelta(const StateQ *prev, const StateQ *cur, unsigned char *out) {
+    unsigned mask = 0;
+    for (int f = 0; f < STATE_PROTO_FIELDS; ++f) mask |= (unsigned)(cur->v[f] != prev->v[f]) << f;
+    size_t n = 0;
+    out[n++] = (unsigned char)mask;
+    n += PutVarint(out + n, (int64_t)((uint64_t)cur->t - (uint64_t)prev->t));
+    for (int f = 0; f < STATE_PROTO_FIELDS; ++f) {
+        if (mask & (1u << f)) n += PutVarint(out + n, (int64_t)cur->v[f] - prev->v[f]);
+    }
+    return n;
+}
+
+void StateEndDelta(unsigned char *frame, size_t frameBytes, unsigned count) {
+    StoreLe32(frame, (uint32_t)(frameBytes - 4));
+    StoreLe16(frame + 9, count);
+}
+
+int StateDecodeFrame(StateDecoder *d, const unsigned char *payload, size_t len, StateSink sink, void *user) {
+    const unsigned char *p = payload, *end = payload + len;
+    if (len < 1) return -1;
+    StateSample s;
+    if (*p == STATE_FRAME_KEY) {
+        if (len != 1 + 1 + 4 + 8 + 4 * STATE_PROTO_FIELDS || p[1] != STATE_PROTO_VERSION) return -1;
+        p += 2;
+        d->seq = LoadLe32(p) + 1; p += 4;
+        d->state.t = (int64_t)LoadLe64(p); p += 8;
+        for (int f = 0; f < STATE_PROTO_FIELDS; ++f, p += 4) d->state.v[f] = (int32_t)LoadLe32(p);
+        d->synced = 1;
+        d->keys++;
+        StateDequantize(&d->state, &s);
+        sink(&s, user);
+        return 0;
+    }
+    if (*p != STATE_FRAME_DELTA || len < 1 + 4 + 2) return -1;
+    if (!d->synced) return 0;
+    uint32_t seq = LoadLe32(p + 1);
+    unsigned count = LoadLe16(p + 5);
+    if (seq != d->seq) return -1;
+    p += 7;
+    for (unsigned i = 0; i < count; ++i) {
+        if (p >= end) return -1;
+        unsigned mask = *p++;
+        int64_t dv;
+        size_t n = GetVarint(p, end, &dv);
+        if (!n || mask >> STATE_PROTO_FIELDS) return -1;
+        p += n;
+        d->state.t = (int64_t)((uint64_t)d->state.t + (uint64_t)dv);
+        for (int f = 0; f < STATE_PROTO_FIELDS; ++f) {
+            if (!(mask & (1u << f))) continue;
+            if (!(n = GetVarint(p, end, &dv))) return -1;
+            p += n;
+            d->state.v[f] = (int32_t)((int64_t)d->state.v[f] + dv);
+        }
+        StateDequantize(&d->state, &s);
+        sink(&s, user);
+    }
+    d->seq += count;
+    return p == end ? 0 : -1;
+}
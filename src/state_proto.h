@@ -0,0 +1,125 @@
+/**
+ * \file state_proto.h
+ * \brief Protocolo binário do publicador de estado: quadros-chave e lotes de deltas.
+ *
+ * O publicador (\ref state_server.h) calcula J uma vez por registro e manda o
+ * estado (t, AzT, ElT, AzR, ElR, J) a todos os visualizadores
+ * (\ref state_client.h). Para caber dezenas de clientes em um enlace comum,
+ * o estado viaja quantizado e em deltas:
+ * - ângulos em passos de \ref STATE_PROTO_ANGLE_QUANTUM graus e o tempo em
+ *   passos de \ref STATE_PROTO_TIME_QUANTUM, como inteiros. Os dois lados
+ *   somam os mesmos inteiros, então o cliente reconstrói exatamente o estado
+ *   quantizado do publicador, sem deriva acumulada;
+ * - cada registro de um lote leva só os campos que mudaram (máscara de 5
+ *   bits) e as diferenças em varint com zigue-zague: um alvo se movendo
+ *   devagar custa 8 a 12 bytes por registro, contra 28 do registro cru;
+ * - vários registros vão no mesmo quadro (um por período de lote do
+ *   publicador), ou seja, um \c send por cliente por lote.
+ *
+ * Todo quadro começa com o tamanho da carga (\c u32 little-endian, sem contar
+ * esses 4 bytes) e o tipo (1 byte):
+ * - \ref STATE_FRAME_KEY: \c u8 versão, \c u32 seq, \c i64 t, 5 × \c i32
+ *   (azT, elT, azR, elR, J): o estado absoluto. É o primeiro quadro de todo
+ *   cliente e é reenviado depois que um cliente lento perde deltas.
+ * - \ref STATE_FRAME_DELTA: \c u32 seq do primeiro registro, \c u16
+ *   quantidade e os registros: \c u8 máscara, varint Δt e um varint por
+ *   campo marcado. O seq de cada registro é o do anterior + 1.
+ */
+#ifndef STATE_PROTO_H
+#define STATE_PROTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Versão do protocolo (vai em cada quadro-chave). */
+#define STATE_PROTO_VERSION 1
+
+/** Graus por unidade inteira dos ângulos (0,36"). */
+#define STATE_PROTO_ANGLE_QUANTUM 1e-4
+/** Unidades de tempo (as do produtor, em geral segundos) por unidade inteira. */
+#define STATE_PROTO_TIME_QUANTUM 1e-6
+
+/** Campos angulares do estado. */
+#define STATE_PROTO_FIELDS 5
+
+/** Registros por quadro de deltas. */
+#define STATE_PROTO_MAX_BATCH 1024
+
+/** Maior registro de delta: máscara + Δt (10 bytes) + 5 campos (5 bytes cada). */
+#define STATE_PROTO_MAX_RECORD (1 + 10 + STATE_PROTO_FIELDS * 5)
+/** Maior quadro, com o prefixo de tamanho. */
+#define STATE_PROTO_MAX_FRAME (4 + 1 + 4 + 2 + STATE_PROTO_MAX_BATCH * STATE_PROTO_MAX_RECORD)
+
+/** Tipos de quadro. */
+enum {
+    STATE_FRAME_KEY = 'K',
+    STATE_FRAME_DELTA = 'D'
+};
+
+/** Estado publicado (ângulos e J em graus). */
+typedef struct StateSample {
+    double t;
+    float azT, elT;
+    float azR, elR;
+    float J;
+} StateSample;
+
+/** Estado quantizado: o que os dois lados realmente compartilham. */
+typedef struct StateQ {
+    int64_t t;
+    int32_t v[STATE_PROTO_FIELDS]; ///< azT, elT, azR, elR, J.
+} StateQ;
+
+/** \brief Quantiza um estado (arredondando ao passo mais próximo). */
+void StateQuantize(const StateSample *s, StateQ *q);
+
+/** \brief Estado em ponto flutuante correspondente a \c q. */
+void StateDequantize(const StateQ *q, StateSample *s);
+
+/**
+ * \brief Escreve um quadro-chave completo (com o prefixo de tamanho).
+ * \return Bytes escritos em \c out (no máximo \ref STATE_PROTO_MAX_FRAME).
+ */
+size_t StateEncodeKey(const StateQ *q, uint32_t seq, unsigned char *out);
+
+/**
+ * \brief Começa um quadro de deltas em \c out; os registros são acrescentados
+ *        com \ref StateEncodeDelta e o quadro é fechado com \ref StateEndDelta.
+ * \return Bytes do cabeçalho.
+ */
+size_t StateBeginDelta(uint32_t seq, unsigned char *out);
+
+/**
+ * \brief Acrescenta o registro \c cur (diferença para \c prev) em \c out.
+ * \return Bytes escritos (no máximo \ref STATE_PROTO_MAX_RECORD).
+ */
+size_t StateEncodeDelta(const StateQ *prev, const StateQ *cur, unsigned char *out);
+
+/** \brief Fecha o quadro que começa em \c frame: grava o tamanho e a quantidade. */
+void StateEndDelta(unsigned char *frame, size_t frameBytes, unsigned count);
+
+/** Recebe cada registro decodificado. */
+typedef void (*StateSink)(const StateSample *s, void *user);
+
+/**
+ * \brief Decodificador do lado do cliente: estado atual e próximo seq esperado.
+ */
+typedef struct StateDecoder {
+    StateQ state;
+    uint32_t seq;   ///< Seq do próximo registro.
+    int synced;     ///< Já recebeu um quadro-chave.
+    uint64_t keys;  ///< Quadros-chave recebidos (o primeiro + ressincronizações).
+} StateDecoder;
+
+/**
+ * \brief Decodifica uma carga (o que vem depois do prefixo de tamanho).
+ *
+ * Deltas antes do primeiro quadro-chave são ignorados. Cada registro (e o
+ * estado de um quadro-chave) vai para \c sink.
+ *
+ * \return 0, ou -1 se a carga estiver malformada ou fora de sequência
+ *         (o cliente deve fechar a conexão).
+ */
+int StateDecodeFrame(StateDecoder *d, const unsigned char *payload, size_t len, StateSink sink, void *user);
+
+#endif /* STATE_PROTO_H */
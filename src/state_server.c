@@ -0,0 +1,370 @@
+/**
+ * \file state_server.c
+ * \brief Implementação do publicador de estado com \c epoll e um buffer de saída por cliente.
+ *
+ * Só a thread do servidor toca nos sockets, nos clientes e no estado
+ * quantizado; a única ponte com quem publica é a fila SPSC (e um \c eventfd
+ * para pedir a parada). O laço acorda por eventos de socket ou no prazo do
+ * próximo lote: não há espera ativa nem um timer por cliente.
+ */
+#define _GNU_SOURCE // accept4
+
+#include "state_server.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __linux__
+
+#include "spsc_ring.h"
+
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define STATE_SERVER_DEFAULT_HZ 50
+#define STATE_SERVER_EVENTS 64
+
+// Identificadores dos descritores no epoll (clientes: índice + STATE_EV_CLIENT)
+#define STATE_EV_LISTEN 0u
+#define STATE_EV_WAKE 1u
+#define STATE_EV_CLIENT 2u
+
+typedef struct Client {
+    int fd;            // -1 = posição livre
+    int stale;         // perdeu deltas: recebe um quadro-chave quando o buffer esvaziar
+    int wantOut;       // EPOLLOUT registrado
+    size_t head, len;  // bytes [head, len) de buf ainda por enviar
+    unsigned char *buf;
+} Client;
+
+struct StateServer {
+    int listenFd, epfd, wakeFd;
+    long long tickNs;
+    SpscRing *ring;
+    pthread_t thread;
+    _Atomic int stop;
+    _Atomic int clientCount;
+    _Atomic uint64_t resyncs;
+
+    // Estado que os clientes sincronizados têm (só a thread do servidor)
+    StateQ state;
+    uint32_t seq;
+    int haveState;
+
+    Client clients[STATE_SERVER_MAX_CLIENTS];
+    StateSample batch[STATE_PROTO_MAX_BATCH];
+    unsigned char frame[STATE_PROTO_MAX_FRAME];
+};
+
+static long long NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int OpenListen(const char *spec) {
+    char host[256];
+    const char *colon = strrchr(spec, ':');
+    const char *port = colon ? colon + 1 : spec;
+    size_t hl = colon ? (size_t)(colon - spec) : 0;
+    if (hl >= sizeof host) return -1;
+    memcpy(host, spec, hl);
+    host[hl] = '\0';
+
+    struct addrinfo hints, *res = NULL;
+    memset(&hints, 0, sizeof hints);
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    int rc = getaddrinfo(hl ? host : NULL, port, &hints, &res);
+    if (rc != 0) {
+        fprintf(stderr, "publicador: endereço inválido '%s': %s\n", spec, gai_strerror(rc));
+        return -1;
+    }
+    int fd = socket(res->ai_family, res->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, res->ai_protocol);
+    if (fd >= 0) {
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+        if (bind(fd, res->ai_addr, res->ai_addrlen) != 0 || listen(fd, 64) != 0) {
+            perror("publicador: bind");
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+static void WatchOut(StateServer *s, Client *c, int on) {
+    if (c->wantOut == on) return;
+    struct epoll_event ev = { EPOLLIN | EPOLLRDHUP | (on ? EPOLLOUT : 0),
+                              { .u32 = (uint32_t)(c - s->clients) + STATE_EV_CLIENT } };
+    epoll_ctl(s->epfd, EPOLL_CTL_MOD, c->fd, &ev);
+    c->wantOut = on;
+}
+
+static void ClientClose(StateServer *s, Client *c) {
+    epoll_ctl(s->epfd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    free(c->buf);
+    memset(c, 0, sizeof *c);
+    c->fd = -1;
+    atomic_fetch_sub_explicit(&s->clientCount, 1, memory_order_relaxed);
+}
+
+/** Copia um quadro para a saída do cliente; sem espaço, o cliente passa a esperar um quadro-chave. */
+static void ClientQueue(StateServer *s, Client *c, const unsigned char *bytes, size_t n) {
+    if (c->stale) return;
+    if (c->len + n > STATE_SERVER_CLIENT_BYTES && c->head > 0) {
+        memmove(c->buf, c->buf + c->head, c->len - c->head);
+        c->len -= c->head;
+        c->head = 0;
+    }
+    if (c->len + n > STATE_SERVER_CLIENT_BYTES) {
+        c->stale = 1;
+        atomic_fetch_add_explicit(&s->resyncs, 1, memory_order_relaxed);
+        return;
+    }
+    memcpy(c->buf + c->len, bytes, n);
+    c->len += n;
+}
+
+/** Envia o que o socket aceitar agora. \return 0, ou -1 se o cliente foi fechado. */
+static int ClientFlush(StateServer *s, Client *c) {
+    for (;;) {
+        while (c->head < c->len) {
+            ssize_t n = send(c->fd, c->buf + c->head, c->len - c->head, MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (n > 0) { c->head += (size_t)n; continue; }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                WatchOut(s, c, 1);
+                return 0;
+            }
+            ClientClose(s, c);
+            return -1;
+        }
+        c->head = c->len = 0;
+        if (!c->stale || !s->haveState) break;
+        // Alcançou o fim do que estava na fila: retoma a partir do estado atual
+        c->stale = 0;
+        c->len = StateEncodeKey(&s->state, s->seq, c->buf);
+    }
+    WatchOut(s, c, 0);
+    return 0;
+}
+
+static void Broadcast(StateServer *s, const unsigned char *bytes, size_t n) {
+    for (int i = 0; i < STATE_SERVER_MAX_CLIENTS; ++i) {
+        Client *c = &s->clients[i];
+        if (c->fd < 0) continue;
+        ClientQueue(s, c, bytes, n);
+        // Com EPOLLOUT pendente o socket está cheio: o laço envia quando ele liberar
+        if (!c->wantOut) ClientFlush(s, c);
+    }
+}
+
+static void AcceptClients(StateServer *s) {
+    for (;;) {
+        int fd = accept4(s->listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            return; // EAGAIN: nenhuma conexão pendente
+        }
+        Client *c = NULL;
+        for (int i = 0; i < STATE_SERVER_MAX_CLIENTS && !c; ++i) {
+            if (s->clients[i].fd < 0) c = &s->clients[i];
+        }
+        unsigned char *buf = c ? malloc(STATE_SERVER_CLIENT_BYTES) : NULL;
+        if (!buf) {
+            close(fd);
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one); // um quadro por lote: sem Nagle
+        struct epoll_event ev = { EPOLLIN | EPOLLRDHUP, { .u32 = (uint32_t)(c - s->clients) + STATE_EV_CLIENT } };
+        if (epoll_ctl(s->epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            free(buf);
+            continue;
+        }
+        memset(c, 0, sizeof *c);
+        c->fd = fd;
+        c->buf = buf;
+        atomic_fetch_add_explicit(&s->clientCount, 1, memory_order_relaxed);
+        if (s->haveState) {
+            c->len = StateEncodeKey(&s->state, s->seq, c->buf);
+            ClientFlush(s, c);
+        }
+    }
+}
+
+/** Os clientes não mandam nada: dados são descartados, fim ou erro fecha a conexão. */
+static void ClientEvent(StateServer *s, Client *c, uint32_t events) {
+    if (events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) {
+        ClientClose(s, c);
+        return;
+    }
+    if (events & EPOLLIN) {
+        unsigned char sink[512];
+        ssize_t n;
+        while ((n = recv(c->fd, sink, sizeof sink, MSG_DONTWAIT)) > 0) {}
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            ClientClose(s, c);
+            return;
+        }
+    }
+    if (events & EPOLLOUT) ClientFlush(s, c);
+}
+
+/** Um lote: tudo o que foi publicado desde o anterior, codificado uma vez para todos. */
+static void Tick(StateServer *s) {
+    size_t n;
+    while ((n = SpscRingPop(s->ring, s->batch, STATE_PROTO_MAX_BATCH)) > 0) {
+        size_t i = 0;
+        if (!s->haveState) {
+            // Primeiro estado: quadro-chave para quem já estava conectado
+            StateQuantize(&s->batch[0], &s->state);
+            s->seq = 0;
+            s->haveState = 1;
+            Broadcast(s, s->frame, StateEncodeKey(&s->state, s->seq, s->frame));
+            i = 1;
+        }
+        if (i == n) continue;
+        size_t bytes = StateBeginDelta(s->seq + 1, s->frame);
+        unsigned count = (unsigned)(n - i);
+        for (; i < n; ++i) {
+            StateQ q;
+            StateQuantize(&s->batch[i], &q);
+            bytes += StateEncodeDelta(&s->state, &q, s->frame + bytes);
+            s->state = q;
+        }
+        s->seq += count;
+        StateEndDelta(s->frame, bytes, count);
+        Broadcast(s, s->frame, bytes);
+    }
+}
+
+static void *ServerThread(void *arg) {
+    StateServer *s = arg;
+    struct epoll_event events[STATE_SERVER_EVENTS];
+    long long next = NowNs() + s->tickNs;
+    while (!atomic_load_explicit(&s->stop, memory_order_acquire)) {
+        long long wait = next - NowNs();
+        int timeoutMs = wait > 0 ? (int)((wait + 999999) / 1000000) : 0;
+        int n = epoll_wait(s->epfd, events, STATE_SERVER_EVENTS, timeoutMs);
+        for (int e = 0; e < n; ++e) {
+            uint32_t id = events[e].data.u32;
+            if (id == STATE_EV_LISTEN) AcceptClients(s);
+            else if (id == STATE_EV_WAKE) continue; // parada: conferida no topo do laço
+            else if (s->clients[id - STATE_EV_CLIENT].fd >= 0) ClientEvent(s, &s->clients[id - STATE_EV_CLIENT], events[e].events);
+        }
+        long long now = NowNs();
+        if (now >= next) {
+            Tick(s);
+            next += s->tickNs;
+            if (next < now) next = now + s->tickNs; // atrasou (máquina ocupada): não acumula lotes
+        }
+    }
+    // Último lote e uma última tentativa de envio antes de fechar
+    Tick(s);
+    return NULL;
+}
+
+StateServer *StateServerStart(const char *bind, int batchHz) {
+    StateServer *s = calloc(1, sizeof *s);
+    if (!s) return NULL;
+    s->listenFd = s->epfd = s->wakeFd = -1;
+    for (int i = 0; i < STATE_SERVER_MAX_CLIENTS; ++i) s->clients[i].fd = -1;
+    s->tickNs = 1000000000LL / (batchHz > 0 ? batchHz : STATE_SERVER_DEFAULT_HZ);
+    if (s->tickNs < 1) s->tickNs = 1; // acima de 1 GHz o passo seria 0 e o laço giraria sem esperar
+    atomic_init(&s->stop, 0);
+    atomic_init(&s->clientCount, 0);
+    atomic_init(&s->resyncs, 0);
+
+    s->ring = SpscRingCreate(sizeof(StateSample), STATE_SERVER_RING);
+    s->listenFd = s->ring ? OpenListen(bind) : -1;
+    s->epfd = s->listenFd >= 0 ? epoll_create1(EPOLL_CLOEXEC) : -1;
+    s->wakeFd = s->epfd >= 0 ? eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC) : -1;
+    int ok = s->wakeFd >= 0;
+    if (ok) {
+        struct epoll_event lev = { EPOLLIN, { .u32 = STATE_EV_LISTEN } };
+        struct epoll_event wev = { EPOLLIN, { .u32 = STATE_EV_WAKE } };
+        ok = epoll_ctl(s->epfd, EPOLL_CTL_ADD, s->listenFd, &lev) == 0 &&
+             epoll_ctl(s->epfd, EPOLL_CTL_ADD, s->wakeFd, &wev) == 0;
+    }
+    if (ok && pthread_create(&s->thread, NULL, ServerThread, s) != 0) {
+        fprintf(stderr, "publicador: não foi possível criar a thread do servidor\n");
+        ok = 0;
+    }
+    if (!ok) {
+        if (s->wakeFd >= 0) close(s->wakeFd);
+        if (s->epfd >= 0) close(s->epfd);
+        if (s->listenFd >= 0) close(s->listenFd);
+        SpscRingDestroy(s->ring);
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+int StateServerPublish(StateServer *s, const StateSample *state) {
+    return SpscRingPush(s->ring, state);
+}
+
+int StateServerClients(const StateServer *s) {
+    return atomic_load_explicit(&((StateServer *)s)->clientCount, memory_order_relaxed);
+}
+
+uint64_t StateServerResyncs(const StateServer *s) {
+    return atomic_load_explicit(&((StateServer *)s)->resyncs, memory_order_relaxed);
+}
+
+uint64_t StateServerOverruns(const StateServer *s) {
+    return SpscRingOverruns(s->ring);
+}
+
+void StateServerStop(StateServer *s) {
+    if (!s) return;
+    atomic_store_explicit(&s->stop, 1, memory_order_release);
+    uint64_t one = 1;
+    if (write(s->wakeFd, &one, sizeof one) < 0) {} // acorda o epoll_wait
+    pthread_join(s->thread, NULL);
+    for (int i = 0; i < STATE_SERVER_MAX_CLIENTS; ++i) {
+        if (s->clients[i].fd >= 0) ClientClose(s, &s->clients[i]);
+    }
+    close(s->wakeFd);
+    close(s->epfd);
+    close(s->listenFd);
+    SpscRingDestroy(s->ring);
+    free(s);
+}
+
+#else /* !__linux__ */
+
+struct StateServer {
+    int unused;
+};
+
+StateServer *StateServerStart(const char *bind, int batchHz) {
+    (void)bind; (void)batchHz;
+    fprintf(stderr, "publicador: disponível só no Linux (epoll)\n");
+    return NULL;
+}
+
+int StateServerPublish(StateServer *s, const StateSample *state) { (void)s; (void)state; return -1; }
+int StateServerClients(const StateServer *s) { (void)s; return 0; }
+uint64_t StateServerResyncs(const StateServer *s) { (void)s; return 0; }
+uint64_t StateServerOverruns(const StateServer *s) { (void)s; return 0; }
+void StateServerStop(StateServer *s) { (void)s; }
+
+#endif /* __linux__ */
@@ -0,0 +1,70 @@
+/**
+ * \file state_server.h
+ * \brief Publicador de estado para vários visualizadores: laço de eventos não bloqueante (epoll).
+ *
+ * Um nó de ingestão (\c --headless \c --publish) calcula J uma vez por
+ * registro e publica o estado; dezenas de consoles (\c --subscribe) só
+ * desenham. O publicador roda em uma thread própria:
+ * - a thread que calcula J empilha cada estado em uma \ref SpscRing
+ *   (\ref StateServerPublish), sem locks e sem chamadas ao sistema;
+ * - a thread do servidor espera em \c epoll por conexões, dados de saída
+ *   pendentes e o próximo lote. A cada período de lote, desempilha tudo o
+ *   que chegou e codifica \b um quadro de deltas (\ref state_proto.h), que é
+ *   copiado para o buffer de saída de cada cliente: o custo por cliente é
+ *   um \c memcpy e um \c send, não uma conta;
+ * - todo socket é não bloqueante. Um cliente que não acompanha (buffer de
+ *   saída cheio) deixa de receber deltas até esvaziar o buffer e então
+ *   recebe um quadro-chave com o estado atual: ele perde registros, mas
+ *   nunca atrasa o publicador nem os outros clientes.
+ *
+ * Disponível só no Linux (\c epoll); nos outros sistemas
+ * \ref StateServerStart falha com uma mensagem.
+ */
+#ifndef STATE_SERVER_H
+#define STATE_SERVER_H
+
+#include "state_proto.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Capacidade da fila entre quem publica e o laço de eventos (estados). */
+#define STATE_SERVER_RING 65536
+/** Clientes simultâneos. */
+#define STATE_SERVER_MAX_CLIENTS 256
+/** Buffer de saída por cliente (bytes); cheio, o cliente é ressincronizado. */
+#define STATE_SERVER_CLIENT_BYTES (256u * 1024u)
+
+/** Publicador opaco. */
+typedef struct StateServer StateServer;
+
+/**
+ * \brief Abre a porta TCP e inicia a thread do laço de eventos.
+ * \param bind \c "porta" ou \c "endereço:porta" (como em \c udp:// de \ref TelemetryOpen).
+ * \param batchHz Quadros de deltas por segundo (0 usa 50). Cada quadro leva
+ *                todos os estados publicados no período.
+ * \return Publicador, ou NULL em caso de erro (mensagem em stderr).
+ */
+StateServer *StateServerStart(const char *bind, int batchHz);
+
+/**
+ * \brief Publica um estado (ângulos e J em graus). Só uma thread pode publicar.
+ * \return 0, ou -1 se a fila estava cheia (o estado é descartado e contado).
+ */
+int StateServerPublish(StateServer *s, const StateSample *state);
+
+/** \brief Clientes conectados agora. */
+int StateServerClients(const StateServer *s);
+
+/** \brief Quadros-chave de ressincronização enviados a clientes lentos. */
+uint64_t StateServerResyncs(const StateServer *s);
+
+/** \brief Estados descartados por fila cheia. */
+uint64_t StateServerOverruns(const StateServer *s);
+
+/**
+ * \brief Envia o último lote, encerra a thread e fecha todas as conexões.
+ */
+void StateServerStop(StateServer *s);
+
+#endif /* STATE_SERVER_H */
@@ -0,0 +1,386 @@
+/**
+ * \file telemetry.c
+ * \brief Implementação do leitor de telemetria com thread de leitura e buffer duplo.
+ *
+ * Os bytes brutos são lidos em blocos grandes (um \c read / \c recv por vez)
+ * para um buffer intermediário e convertidos em registros SoA. Registros
+ * incompletos no fim do bloco (linha CSV sem \c '\\n' ou registro binário
+ * parcial) ficam no buffer até a próxima leitura.
+ */
+#define _POSIX_C_SOURCE 200809L // getaddrinfo, poll etc. mesmo com -std=c99 estrito
+
+#include "telemetry.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define TELEMETRY_DEFAULT_BATCH 65536
+#define TELEMETRY_RAW_BYTES (1u << 20)
+#define TELEMETRY_POLL_MS 100
+
+struct TelemetryReader {
+    int fd;
+    int isSocket;
+    int ownsFd;
+    TelemetryFormat format;
+
+    TelemetryBatch batches[2];
+    int filled[2];  // 1 = lote pronto (ou em uso) pelo consumidor
+    int front;      // lote entregue ao consumidor, ou -1
+    int next;       // próximo lote que o consumidor deve receber
+    int eof;
+    int stop;
+    int running;    // a thread de leitura foi criada (e precisa de join)
+    _Atomic size_t errors;  // escrito pela thread de leitura, lido sem o mutex
+
+    pthread_t thread;
+    pthread_mutex_t mu;
+    pthread_cond_t cv;
+
+    char *raw;
+    size_t rawBeg, rawEnd;
+
+    SphBufferPool *pool;  // de onde vêm os lotes e o buffer bruto
+};
+
+/** Um registro descartado; só a thread de leitura escreve, então basta um contador relaxado. */
+static void CountError(TelemetryReader *r) {
+    atomic_fetch_add_explicit(&r->errors, 1, memory_order_relaxed);
+}
+
+/** Os cinco arranjos do lote ficam em um único buffer do pool (os \c double primeiro). */
+static int BatchAlloc(TelemetryBatch *b, size_t capacity, SphBufferPool *pool) {
+    b->count = 0;
+    b->capacity = capacity;
+    b->t = NULL;
+    if (capacity > SIZE_MAX / (sizeof *b->t + 4 * sizeof *b->azT)) return 0;
+    b->t = SphBufferPoolAcquire(pool, capacity * (sizeof *b->t + 4 * sizeof *b->azT));
+    if (!b->t) return 0;
+    b->azT = (float *)(b->t + capacity);
+    b->elT = b->azT + capacity;
+    b->azR = b->elT + capacity;
+    b->elR = b->azR + capacity;
+    return 1;
+}
+
+static void BatchFree(TelemetryBatch *b, SphBufferPool *pool) {
+    SphBufferPoolRelease(pool, b->t);
+    memset(b, 0, sizeof *b);
+}
+
+static void BatchPush(TelemetryBatch *b, double t, float azT, float elT, float azR, float elR) {
+    size_t i = b->count++;
+    b->t[i] = t;
+    b->azT[i] = azT; b->elT[i] = elT;
+    b->azR[i] = azR; b->elR[i] = elR;
+}
+
+static uint32_t LoadLe32(const unsigned char *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static float LoadLeFloat(const unsigned char *p) {
+    uint32_t u = LoadLe32(p);
+    float f;
+    memcpy(&f, &u, sizeof f);
+    return f;
+}
+
+static double LoadLeDouble(const unsigned char *p) {
+    uint64_t u = (uint64_t)LoadLe32(p) | ((uint64_t)LoadLe32(p + 4) << 32);
+    double d;
+    memcpy(&d, &u, sizeof d);
+    return d;
+}
+
+/**
+ * \brief Interpreta uma linha CSV "t,azT,elT,azR,elR" (sem o '\\n').
+ *
+ * \c *end tem de ser '\\0': o \c strtod pula espaços, inclusive '\\n', e
+ * sem o terminador leria a linha seguinte ou além dos dados do buffer.
+ * \return 1 se a linha gerou um registro, 0 se foi ignorada, -1 se inválida.
+ */
+static int ParseCsvLine(const char *s, const char *end, TelemetryBatch *b) {
+    while (s < end && (*s == ' ' || *s == '\t')) ++s;
+    if (s == end || *s == '#' || *s == '\r') return 0;
+    double v[5];
+    for (int k = 0; k < 5; ++k) {
+        char *stop;
+        v[k] = strtod(s, &stop);
+        if (stop == s || stop > end) return -1;
+        s = stop;
+        while (s < end && (*s == ' ' || *s == '\t')) ++s;
+        if (k < 4) {
+            if (s == end || *s != ',') return -1;
+            ++s;
+        }
+    }
+    BatchPush(b, v[0], (float)v[1], (float)v[2], (float)v[3], (float)v[4]);
+    return 1;
+}
+
+/** Converte registros completos do buffer bruto até encher o lote. */
+static void ParsePending(TelemetryReader *r, TelemetryBatch *b) {
+    if (r->format == TELEMETRY_BINARY) {
+        while (b->count < b->capacity && r->rawEnd - r->rawBeg >= TELEMETRY_RECORD_SIZE) {
+            const unsigned char *p = (const unsigned char *)r->raw + r->rawBeg;
+            BatchPush(b, LoadLeDouble(p), LoadLeFloat(p + 8), LoadLeFloat(p + 12),
+                      LoadLeFloat(p + 16), LoadLeFloat(p + 20));
+            r->rawBeg += TELEMETRY_RECORD_SIZE;
+        }
+        return;
+    }
+    while (b->count < b->capacity && r->rawBeg < r->rawEnd) {
+        char *line = r->raw + r->rawBeg;
+        char *nl = memchr(line, '\n', r->rawEnd - r->rawBeg);
+        if (!nl) break;
+        *nl = '\0'; // limita o strtod à linha (que já foi consumida)
+        if (ParseCsvLine(line, nl, b) < 0) CountError(r);
+        r->rawBeg = (size_t)(nl - r->raw) + 1;
+    }
+}
+
+/** Espera dados no descritor. \return 1 se há dados, 0 se expirou, -1 se pediram parada. */
+static int WaitReadable(TelemetryReader *r, int timeoutMs) {
+    struct pollfd pfd = { r->fd, POLLIN, 0 };
+    for (;;) {
+        pthread_mutex_lock(&r->mu);
+        int stop = r->stop;
+        pthread_mutex_unlock(&r->mu);
+        if (stop) return -1;
+        int rc = poll(&pfd, 1, timeoutMs);
+        if (rc < 0 && errno == EINTR) continue;
+        return rc != 0;
+    }
+}
+
+/**
+ * \brief Preenche um lote. Publica assim que não houver mais dados imediatos
+ *        (latência mínima) ou quando o lote enche (vazão máxima).
+ * \return 1 se a fonte continua aberta, 0 no fim dos dados.
+ */
+static int FillBatch(TelemetryReader *r, TelemetryBatch *b) {
+    for (;;) {
+        ParsePending(r, b);
+        if (b->count == b->capacity) return 1;
+
+        if (b->count > 0) {
+            int ready = WaitReadable(r, 0);
+            if (ready < 0) return 0;
+            if (!ready) return 1;
+        }
+
+        // Compacta o buffer bruto, mantendo o registro parcial no início
+        if (r->rawBeg > 0) {
+            memmove(r->raw, r->raw + r->rawBeg, r->rawEnd - r->rawBeg);
+            r->rawEnd -= r->rawBeg;
+            r->rawBeg = 0;
+        }
+        if (r->rawEnd == TELEMETRY_RAW_BYTES) {
+            // Linha maior que o buffer inteiro: descarta
+            CountError(r);
+            r->rawEnd = 0;
+        }
+
+        int ready;
+        while ((ready = WaitReadable(r, TELEMETRY_POLL_MS)) == 0) {}
+        if (ready < 0) return 0;
+
+        ssize_t n = r->isSocket
+            ? recv(r->fd, r->raw + r->rawEnd, TELEMETRY_RAW_BYTES - r->rawEnd, 0)
+            : read(r->fd, r->raw + r->rawEnd, TELEMETRY_RAW_BYTES - r->rawEnd);
+        if (n < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+        if (n <= 0 && !r->isSocket) {
+            // Fim do arquivo: aproveita uma última linha CSV sem '\n'
+            if (r->format == TELEMETRY_CSV && r->rawEnd > r->rawBeg && b->count < b->capacity) {
+                r->raw[r->rawEnd] = '\0'; // limita o strtod (byte extra do buffer)
+                if (ParseCsvLine(r->raw + r->rawBeg, r->raw + r->rawEnd, b) < 0) CountError(r);
+            } else if (r->rawEnd > r->rawBeg) {
+                CountError(r);
+            }
+            r->rawBeg = r->rawEnd = 0;
+            return 0;
+        }
+        if (n < 0) return 0;
+        if (n == 0) continue; // datagrama vazio
+        r->rawEnd += (size_t)n;
+
+        if (r->isSocket) {
+            // Cada datagrama contém registros completos
+            if (r->format == TELEMETRY_CSV) {
+                if (r->raw[r->rawEnd - 1] != '\n' && r->rawEnd < TELEMETRY_RAW_BYTES) r->raw[r->rawEnd++] = '\n';
+            } else if ((r->rawEnd - r->rawBeg) % TELEMETRY_RECORD_SIZE) {
+                CountError(r);
+                r->rawEnd -= (r->rawEnd - r->rawBeg) % TELEMETRY_RECORD_SIZE;
+            }
+        }
+    }
+}
+
+static void *ReaderThread(void *arg) {
+    TelemetryReader *r = arg;
+    int idx = 0;
+    for (;;) {
+        pthread_mutex_lock(&r->mu);
+        while (r->filled[idx] && !r->stop) pthread_cond_wait(&r->cv, &r->mu);
+        int stop = r->stop;
+        pthread_mutex_unlock(&r->mu);
+        if (stop) break;
+
+        TelemetryBatch *b = &r->batches[idx];
+        b->count = 0;
+        int more = FillBatch(r, b);
+
+        pthread_mutex_lock(&r->mu);
+        if (b->count > 0) r->filled[idx] = 1;
+        if (!more) r->eof = 1;
+        pthread_cond_broadcast(&r->cv);
+        pthread_mutex_unlock(&r->mu);
+        if (!more) break;
+        if (b->count > 0) idx ^= 1;
+    }
+    return NULL;
+}
+
+static int OpenUdp(const char *spec) {
+    char host[256];
+    const char *colon = strrchr(spec, ':');
+    if (!colon) {
+        fprintf(stderr, "telemetria: porta ausente em 'udp://%s'\n", spec);
+        return -1;
+    }
+    size_t hl = (size_t)(colon - spec);
+    if (hl >= sizeof host) return -1;
+    memcpy(host, spec, hl);
+    host[hl] = '\0';
+
+    struct addrinfo hints, *res = NULL;
+    memset(&hints, 0, sizeof hints);
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = AI_PASSIVE;
+    int rc = getaddrinfo(hl ? host : NULL, colon + 1, &hints, &res);
+    if (rc != 0) {
+        fprintf(stderr, "telemetria: endereço inválido '%s': %s\n", spec, gai_strerror(rc));
+        return -1;
+    }
+    int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (fd >= 0) {
+        int rcvbuf = 8 << 20; // absorve rajadas enquanto o consumidor processa
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof rcvbuf);
+        if (bind(fd, res->ai_addr, res->ai_addrlen) != 0) {
+            perror("telemetria: bind");
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+TelemetryReader *TelemetryOpen(const char *uri, TelemetryFormat format, size_t batchCapacity,
+                               SphBufferPool *pool) {
+    if (batchCapacity > TELEMETRY_MAX_BATCH) {
+        fprintf(stderr, "telemetria: lote de %zu registros excede o máximo de %zu\n",
+                batchCapacity, TELEMETRY_MAX_BATCH);
+        return NULL;
+    }
+    TelemetryReader *r = calloc(1, sizeof *r);
+    if (!r) return NULL;
+    r->format = format;
+    r->pool = pool;
+    r->front = -1;
+
+    if (strcmp(uri, "-") == 0) {
+        r->fd = STDIN_FILENO;
+    } else if (strncmp(uri, "udp://", 6) == 0) {
+        r->fd = OpenUdp(uri + 6);
+        r->isSocket = 1;
+        r->ownsFd = 1;
+    } else {
+        r->fd = open(uri, O_RDONLY);
+        r->ownsFd = 1;
+        if (r->fd < 0) perror(uri);
+    }
+    if (r->fd < 0) {
+        free(r);
+        return NULL;
+    }
+
+    if (batchCapacity == 0) batchCapacity = TELEMETRY_DEFAULT_BATCH;
+    // Um byte além dos dados para o terminador da última linha CSV
+    r->raw = SphBufferPoolAcquire(pool, TELEMETRY_RAW_BYTES + 1);
+    if (!r->raw || !BatchAlloc(&r->batches[0], batchCapacity, pool)
+        || !BatchAlloc(&r->batches[1], batchCapacity, pool)) {
+        fprintf(stderr, "telemetria: memória insuficiente\n");
+        BatchFree(&r->batches[0], pool); BatchFree(&r->batches[1], pool);
+        SphBufferPoolRelease(pool, r->raw);
+        if (r->ownsFd) close(r->fd);
+        free(r);
+        return NULL;
+    }
+
+    pthread_mutex_init(&r->mu, NULL);
+    pthread_cond_init(&r->cv, NULL);
+    if (pthread_create(&r->thread, NULL, ReaderThread, r) != 0) {
+        fprintf(stderr, "telemetria: não foi possível criar a thread de leitura\n");
+        r->eof = 1;
+        r->stop = 1;
+    } else {
+        r->running = 1;
+    }
+    return r;
+}
+
+const TelemetryBatch *TelemetryNext(TelemetryReader *r) {
+    pthread_mutex_lock(&r->mu);
+    if (r->front >= 0) {
+        r->filled[r->front] = 0;
+        r->front = -1;
+        pthread_cond_broadcast(&r->cv);
+    }
+    while (!r->filled[r->next] && !r->eof && !r->stop) pthread_cond_wait(&r->cv, &r->mu);
+    const TelemetryBatch *b = NULL;
+    if (r->filled[r->next]) {
+        r->front = r->next;
+        r->next ^= 1;
+        b = &r->batches[r->front];
+    }
+    pthread_mutex_unlock(&r->mu);
+    return b;
+}
+
+size_t TelemetryErrors(const TelemetryReader *r) {
+    return atomic_load_explicit(&r->errors, memory_order_relaxed);
+}
+
+void TelemetryInterrupt(TelemetryReader *r) {
+    pthread_mutex_lock(&r->mu);
+    r->stop = 1;
+    pthread_cond_broadcast(&r->cv);
+    pthread_mutex_unlock(&r->mu);
+}
+
+void TelemetryClose(TelemetryReader *r) {
+    if (!r) return;
+    TelemetryInterrupt(r);
+    if (r->running) pthread_join(r->thread, NULL);
+
+    pthread_cond_destroy(&r->cv);
+    pthread_mutex_destroy(&r->mu);
+    if (r->ownsFd) close(r->fd);
+    BatchFree(&r->batches[0], r->pool);
+    BatchFree(&r->batches[1], r->pool);
+    SphBufferPoolRelease(r->pool, r->raw);
+    free(r);
+}
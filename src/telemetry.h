@@ -0,0 +1,99 @@
+/**
+ * \file telemetry.h
+ * \brief Leitura em lote de telemetria Az/El (stdin, arquivo ou UDP) com buffer duplo.
+ *
+ * Cada registro traz (timestamp, AzT, ElT, AzR, ElR), com ângulos em \b graus
+ * (a mesma unidade do HUD). Dois formatos são aceitos:
+ * - CSV: uma linha por registro, \c "t,azT,elT,azR,elR". Linhas vazias ou
+ *   começando com \c # são ignoradas.
+ * - Binário: registros de 24 bytes, little-endian e sem preenchimento:
+ *   \c double t seguido de quatro \c float (azT, elT, azR, elR).
+ *
+ * A leitura acontece em uma thread dedicada que preenche um lote enquanto o
+ * consumidor processa o outro (buffer duplo). Assim a chamada de sistema
+ * (\c read / \c recv) e o parsing se sobrepõem ao cálculo de J.
+ */
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "spherical_arena.h"
+
+#include <stddef.h>
+
+/** Formato dos registros de entrada. */
+typedef enum TelemetryFormat {
+    TELEMETRY_CSV = 0,
+    TELEMETRY_BINARY
+} TelemetryFormat;
+
+/** Tamanho, em bytes, de um registro no formato binário. */
+#define TELEMETRY_RECORD_SIZE 24
+
+/**
+ * \brief Maior lote aceito por \ref TelemetryOpen (registros).
+ *
+ * 2^24 registros dão dois lotes de 448 MiB; acima disso o tamanho vem de um
+ * erro de digitação, não de um rastreio real.
+ */
+#define TELEMETRY_MAX_BATCH ((size_t)1 << 24)
+
+/**
+ * \brief Lote de registros em formato SoA (um arranjo por campo).
+ */
+typedef struct TelemetryBatch {
+    size_t count;     ///< Quantidade de registros válidos.
+    size_t capacity;  ///< Capacidade de cada arranjo.
+    double *t;        ///< Timestamps (unidade definida pelo produtor).
+    float *azT, *elT; ///< Alvo T, em graus.
+    float *azR, *elR; ///< Eixo de rolagem R, em graus.
+} TelemetryBatch;
+
+/** Leitor opaco (thread de leitura + dois lotes). */
+typedef struct TelemetryReader TelemetryReader;
+
+/**
+ * \brief Abre uma fonte de telemetria e inicia a thread de leitura.
+ *
+ * \param uri \c "-" para stdin, \c "udp://[endereço]:porta" para receber
+ *            datagramas UDP nessa porta, ou o caminho de um arquivo.
+ * \param format Formato dos registros.
+ * \param batchCapacity Registros por lote (0 usa o padrão de 65536; no máximo
+ *                      \ref TELEMETRY_MAX_BATCH).
+ * \param pool Pool de onde vêm os dois lotes e o buffer bruto, devolvidos a
+ *             ele em \ref TelemetryClose (NULL usa \c malloc). A thread de
+ *             leitura não toca no pool: só \c TelemetryOpen e
+ *             \c TelemetryClose, na thread que os chama.
+ * \return Leitor, ou NULL em caso de erro (mensagem em stderr).
+ */
+TelemetryReader *TelemetryOpen(const char *uri, TelemetryFormat format, size_t batchCapacity,
+                               SphBufferPool *pool);
+
+/**
+ * \brief Obtém o próximo lote, bloqueando até haver dados.
+ *
+ * O lote devolvido permanece válido até a próxima chamada, que o devolve à
+ * thread de leitura para ser preenchido novamente.
+ *
+ * \return Lote com \c count > 0, ou NULL no fim da fonte.
+ */
+const TelemetryBatch *TelemetryNext(TelemetryReader *reader);
+
+/**
+ * \brief Quantidade de linhas/registros descartados por erro de formato.
+ */
+size_t TelemetryErrors(const TelemetryReader *reader);
+
+/**
+ * \brief Pede o fim da leitura: \ref TelemetryNext deixa de esperar e devolve NULL.
+ *
+ * Pode ser chamada de outra thread, por exemplo para acordar uma thread de
+ * ingestão parada em \ref TelemetryNext antes de \ref TelemetryClose.
+ */
+void TelemetryInterrupt(TelemetryReader *reader);
+
+/**
+ * \brief Encerra a thread de leitura e libera os recursos.
+ */
+void TelemetryClose(TelemetryReader *reader);
+
+#endif /* TELEMETRY_H */
@@ -0,0 +1,93 @@
+/**
+ * \file text_cache.c
+ * \brief Layout dos glifos (as mesmas contas de \c DrawTextEx) e envio em lote.
+ */
+#include "text_cache.h"
+
+#include "rlgl.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/** Refaz os quads de \c label->text com a fonte padrão, como \c DrawText(text, 0, 0, fontSize, ...). */
+static void Layout(TextLabel *label) {
+    Font font = GetFontDefault();
+    // DrawText: tamanho mínimo 10 e espaçamento inteiro de fontSize/10
+    const int size = label->fontSize < 10 ? 10 : label->fontSize;
+    const float scale = (float)size / (float)font.baseSize;
+    const float spacing = (float)(size / 10);
+    const float pad = (float)font.glyphPadding;
+    const float tw = (float)font.texture.width, th = (float)font.texture.height;
+    float pen = 0.0f;
+    label->texture = font.texture.id;
+    label->count = 0;
+    for (const char *p = label->text; *p;) {
+        int bytes = 0;
+        int cp = GetCodepointNext(p, &bytes);
+        p += bytes > 0 ? bytes : 1;
+        int g = GetGlyphIndex(font, cp);
+        Rectangle r = font.recs[g];
+        if (cp != ' ' && cp != '\t') {
+            TextQuad *q = &label->quads[label->count++];
+            q->x0 = pen + ((float)font.glyphs[g].offsetX - pad) * scale;
+            q->y0 = ((float)font.glyphs[g].offsetY - pad) * scale;
+            q->x1 = q->x0 + (r.width + 2.0f*pad) * scale;
+            q->y1 = q->y0 + (r.height + 2.0f*pad) * scale;
+            q->u0 = (r.x - pad) / tw;
+            q->v0 = (r.y - pad) / th;
+            q->u1 = (r.x + r.width + pad) / tw;
+            q->v1 = (r.y + r.height + pad) / th;
+        }
+        float adv = font.glyphs[g].advanceX ? (float)font.glyphs[g].advanceX : r.width;
+        pen += adv * scale + spacing;
+    }
+    label->width = pen > 0.0f ? pen - spacing : 0.0f;
+}
+
+bool TextLabelSet(TextLabel *label, const char *text, int fontSize, Color color) {
+    label->color = color;
+    if (label->fontSize == fontSize && strncmp(label->text, text, sizeof label->text) == 0) return false;
+    snprintf(label->text, sizeof label->text, "%s", text);
+    label->fontSize = fontSize;
+    Layout(label);
+    return true;
+}
+
+void TextLabelDraw(const TextLabel *label, float x, float y) {
+    if (label->count == 0) return;
+    // Garante espaço no lote atual; quads seguidos com a mesma textura viram uma só chamada de desenho
+    rlCheckRenderBatchLimit(4 * label->count);
+    rlSetTexture(label->texture);
+    rlBegin(RL_QUADS);
+    rlColor4ub(label->color.r, label->color.g, label->color.b, label->color.a);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    for (int i = 0; i < label->count; ++i) {
+        const TextQuad *q = &label->quads[i];
+        rlTexCoord2f(q->u0, q->v0); rlVertex2f(x + q->x0, y + q->y0);
+        rlTexCoord2f(q->u0, q->v1); rlVertex2f(x + q->x0, y + q->y1);
+        rlTexCoord2f(q->u1, q->v1); rlVertex2f(x + q->x1, y + q->y1);
+        rlTexCoord2f(q->u1, q->v0); rlVertex2f(x + q->x1, y + q->y0);
+    }
+    rlEnd();
+    rlSetTexture(0);
+}
+
+bool TextFieldUpdate(TextField *field, int fontSize, Color color, double resolution,
+                     const char *fmt, int n, const double *values) {
+    if (n > TEXT_FIELD_MAX_VALUES) n = TEXT_FIELD_MAX_VALUES;
+    long long key[TEXT_FIELD_MAX_VALUES] = { 0 };
+    for (int i = 0; i < n; ++i) key[i] = llround(values[i] / resolution);
+    field->label.color = color;
+    if (field->label.fontSize == fontSize && field->fmt == fmt && field->keyCount == n &&
+        memcmp(key, field->key, sizeof key) == 0) return false;
+    field->fmt = fmt;
+    memcpy(field->key, key, sizeof key);
+    field->keyCount = n;
+    double v[TEXT_FIELD_MAX_VALUES] = { 0 };
+    for (int i = 0; i < n; ++i) v[i] = values[i];
+    // Argumentos a mais são avaliados e ignorados pelo printf
+    char text[TEXT_LABEL_MAX];
+    snprintf(text, sizeof text, fmt, v[0], v[1], v[2], v[3]);
+    return TextLabelSet(&field->label, text, fontSize, color);
+}
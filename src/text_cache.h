@@ -0,0 +1,87 @@
+/**
+ * \file text_cache.h
+ * \brief Textos com o layout dos glifos em cache, desenhados em lote (fonte padrão da Raylib).
+ *
+ * \c DrawText decodifica o UTF-8, procura cada glifo na fonte
+ * (\c GetGlyphIndex, uma busca linear) e calcula o retângulo de cada letra
+ * a cada chamada, mesmo quando o texto é o mesmo do quadro anterior. Aqui o
+ * layout é feito uma vez: uma \ref TextLabel guarda os quads prontos
+ * (posição relativa e coordenadas de textura) e o desenho só os envia.
+ * Todos os textos usam a textura da fonte padrão, então a rlgl junta os
+ * quads de todos eles na mesma chamada de desenho enquanto nenhuma outra
+ * textura entrar no meio.
+ *
+ * Campos numéricos (\ref TextField) só são formatados e refeitos quando o
+ * valor \e mostrado muda, isto é, quando muda na resolução do formato.
+ */
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include "raylib.h"
+
+#include <stdbool.h>
+
+/** Tamanho máximo de um texto (bytes, incluindo o terminador). */
+#define TEXT_LABEL_MAX 192
+
+/** Maior quantidade de valores de um \ref TextField. */
+#define TEXT_FIELD_MAX_VALUES 4
+
+/** Quad de um glifo: retângulo relativo à origem do texto e coordenadas de textura. */
+typedef struct TextQuad {
+    float x0, y0, x1, y1;
+    float u0, v0, u1, v1;
+} TextQuad;
+
+/**
+ * \brief Texto com layout em cache. Zerada, está vazia e será refeita no primeiro \ref TextLabelSet.
+ */
+typedef struct TextLabel {
+    char text[TEXT_LABEL_MAX];
+    int fontSize;          ///< 0: ainda sem layout.
+    Color color;
+    unsigned int texture;  ///< Textura da fonte usada no layout.
+    float width;           ///< Largura do texto (pixels), como \c MeasureText.
+    int count;             ///< Quads em uso.
+    TextQuad quads[TEXT_LABEL_MAX];
+} TextLabel;
+
+/**
+ * \brief Define o texto; o layout só é refeito se o texto ou o tamanho mudarem.
+ *
+ * Com a janela já aberta (a fonte padrão é carregada em \c InitWindow).
+ *
+ * \return true se o layout foi refeito.
+ */
+bool TextLabelSet(TextLabel *label, const char *text, int fontSize, Color color);
+
+/** \brief Envia os quads do texto com a origem em (x, y), como \c DrawText. */
+void TextLabelDraw(const TextLabel *label, float x, float y);
+
+/**
+ * \brief Texto formatado a partir de até \ref TEXT_FIELD_MAX_VALUES valores.
+ *
+ * Os valores são comparados já arredondados para a resolução do formato:
+ * enquanto nenhum muda o que o formato mostraria, nem \c snprintf nem o
+ * layout rodam.
+ */
+typedef struct TextField {
+    TextLabel label;
+    const char *fmt;       ///< Formato da última formatação (comparado pelo endereço).
+    long long key[TEXT_FIELD_MAX_VALUES];
+    int keyCount;
+} TextField;
+
+/**
+ * \brief Atualiza o campo com \c n valores.
+ *
+ * \param resolution Menor diferença visível no formato (0.1 para \c "%.1f",
+ *                   0.001 para \c "%.3f", 1 para \c "%.0f").
+ * \param fmt Formato \c printf que consome os \c n valores como \c double (\c %f, \c %g...);
+ *            trocar de formato (outro literal) também refaz o texto.
+ * \return true se o texto foi refeito.
+ */
+bool TextFieldUpdate(TextField *field, int fontSize, Color color, double resolution,
+                     const char *fmt, int n, const double *values);
+
+#endif /* TEXT_CACHE_H */
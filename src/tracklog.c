@@ -0,0 +1,228 @@
+/**
+ * \file tracklog.c
+ * \brief Escrita em blocos colunares e replay via \c mmap dos logs de trilhas.
+ */
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE // madvise
+
+#include "tracklog.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TRACKLOG_MAGIC "SPHTRK01"
+#define TRACKLOG_VERSION 1u
+#define TRACKLOG_HEADER_BYTES 64u
+
+struct TrackLogWriter {
+    FILE *f;
+    uint32_t block;
+    size_t fill;
+    uint64_t total;
+    unsigned char *buf; // um bloco: t | azT | elT | azR | elR
+};
+
+struct TrackLog {
+    int fd;
+    const unsigned char *map;
+    size_t mapBytes;
+    uint32_t block;
+    uint64_t total;
+};
+
+static int HostIsLittleEndian(void) {
+    const uint16_t one = 1;
+    return *(const unsigned char *)&one == 1;
+}
+
+static size_t BlockBytes(uint32_t block) {
+    return (size_t)block * (sizeof(double) + 4 * sizeof(float));
+}
+
+static void StoreLe32(unsigned char *p, uint32_t u) {
+    p[0] = (unsigned char)u; p[1] = (unsigned char)(u >> 8);
+    p[2] = (unsigned char)(u >> 16); p[3] = (unsigned char)(u >> 24);
+}
+
+static uint32_t LoadLe32(const unsigned char *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void WriteHeader(unsigned char *h, uint32_t block, uint64_t total) {
+    memset(h, 0, TRACKLOG_HEADER_BYTES);
+    memcpy(h, TRACKLOG_MAGIC, 8);
+    StoreLe32(h + 8, TRACKLOG_VERSION);
+    StoreLe32(h + 12, block);
+    StoreLe32(h + 16, (uint32_t)total);
+    StoreLe32(h + 20, (uint32_t)(total >> 32));
+}
+
+TrackLogWriter *TrackLogCreate(const char *path, uint32_t blockRecords) {
+    if (!HostIsLittleEndian()) {
+        fprintf(stderr, "tracklog: apenas hosts little-endian são suportados\n");
+        return NULL;
+    }
+    if (blockRecords == 0) blockRecords = TRACKLOG_DEFAULT_BLOCK;
+    if (blockRecords > TRACKLOG_MAX_BLOCK) {
+        fprintf(stderr, "tracklog: %u registros por bloco (máximo %u)\n",
+                (unsigned)blockRecords, (unsigned)TRACKLOG_MAX_BLOCK);
+        return NULL;
+    }
+    blockRecords = (blockRecords + 15u) & ~15u;
+
+    TrackLogWriter *w = calloc(1, sizeof *w);
+    if (!w) return NULL;
+    w->block = blockRecords;
+    w->buf = calloc(1, BlockBytes(blockRecords));
+    w->f = fopen(path, "wb");
+    if (!w->buf || !w->f) {
+        if (!w->f) perror(path);
+        if (w->f) fclose(w->f);
+        free(w->buf);
+        free(w);
+        return NULL;
+    }
+    unsigned char h[TRACKLOG_HEADER_BYTES];
+    WriteHeader(h, w->block, 0);
+    fwrite(h, 1, sizeof h, w->f);
+    return w;
+}
+
+static int FlushBlock(TrackLogWriter *w) {
+    if (w->fill == 0) return 0;
+    size_t bytes = BlockBytes(w->block);
+    if (w->fill < w->block) {
+        // Bloco final incompleto: zera o resto de cada coluna
+        size_t nb = w->block;
+        memset(w->buf + w->fill * sizeof(double), 0, (nb - w->fill) * sizeof(double));
+        for (int c = 0; c < 4; ++c) {
+            unsigned char *col = w->buf + nb * sizeof(double) + (size_t)c * nb * sizeof(float);
+            memset(col + w->fill * sizeof(float), 0, (nb - w->fill) * sizeof(float));
+        }
+    }
+    int ok = fwrite(w->buf, 1, bytes, w->f) == bytes;
+    w->fill = 0;
+    return ok ? 0 : -1;
+}
+
+int TrackLogAppend(TrackLogWriter *w, double t, float azT, float elT, float azR, float elR) {
+    size_t nb = w->block, i = w->fill;
+    double *ct = (double *)w->buf;
+    float *cf = (float *)(w->buf + nb * sizeof(double));
+    ct[i] = t;
+    cf[i] = azT;
+    cf[nb + i] = elT;
+    cf[2 * nb + i] = azR;
+    cf[3 * nb + i] = elR;
+    w->total++;
+    if (++w->fill == w->block) return FlushBlock(w);
+    return 0;
+}
+
+int TrackLogFinish(TrackLogWriter *w) {
+    int rc = FlushBlock(w);
+    unsigned char h[TRACKLOG_HEADER_BYTES];
+    WriteHeader(h, w->block, w->total);
+    if (rc == 0 && (fseek(w->f, 0, SEEK_SET) != 0 || fwrite(h, 1, sizeof h, w->f) != sizeof h)) rc = -1;
+    if (fclose(w->f) != 0) rc = -1;
+    free(w->buf);
+    free(w);
+    return rc;
+}
+
+TrackLog *TrackLogOpen(const char *path) {
+    if (!HostIsLittleEndian()) {
+        fprintf(stderr, "tracklog: apenas hosts little-endian são suportados\n");
+        return NULL;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < TRACKLOG_HEADER_BYTES) {
+        fprintf(stderr, "tracklog: '%s' não é um log válido\n", path);
+        close(fd);
+        return NULL;
+    }
+    size_t bytes = (size_t)st.st_size;
+    void *map = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        perror("tracklog: mmap");
+        close(fd);
+        return NULL;
+    }
+    const unsigned char *h = map;
+    uint32_t block = LoadLe32(h + 12);
+    uint64_t total = (uint64_t)LoadLe32(h + 16) | ((uint64_t)LoadLe32(h + 20) << 32);
+    int ok = memcmp(h, TRACKLOG_MAGIC, 8) == 0 && LoadLe32(h + 8) == TRACKLOG_VERSION &&
+             block != 0 && block % 16 == 0 && block <= TRACKLOG_MAX_BLOCK;
+    // total vem do arquivo: o limite é calculado por divisão, para que um valor
+    // forjado não dê a volta em (total + block - 1) nem em blocos × bytes
+    if (ok) {
+        uint64_t maxBlocks = (uint64_t)((bytes - TRACKLOG_HEADER_BYTES) / BlockBytes(block));
+        ok = total <= maxBlocks * block;
+    }
+    if (!ok) {
+        fprintf(stderr, "tracklog: cabeçalho inválido ou arquivo truncado em '%s'\n", path);
+        munmap(map, bytes);
+        close(fd);
+        return NULL;
+    }
+    madvise(map, bytes, MADV_SEQUENTIAL);
+
+    TrackLog *log = calloc(1, sizeof *log);
+    if (!log) {
+        munmap(map, bytes);
+        close(fd);
+        return NULL;
+    }
+    log->fd = fd;
+    log->map = map;
+    log->mapBytes = bytes;
+    log->block = block;
+    log->total = total;
+    return log;
+}
+
+size_t TrackLogCount(const TrackLog *log) {
+    return (size_t)log->total;
+}
+
+int TrackLogReplay(TrackLog *log, TrackLogChunkFn fn, void *user) {
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    const size_t nb = log->block, bytes = BlockBytes(log->block);
+    for (uint64_t first = 0; first < log->total; first += nb) {
+        const unsigned char *base = log->map + TRACKLOG_HEADER_BYTES + (size_t)(first / nb) * bytes;
+        const float *cf = (const float *)(base + nb * sizeof(double));
+        TrackLogChunk c;
+        c.first = (size_t)first;
+        c.count = log->total - first < nb ? (size_t)(log->total - first) : nb;
+        c.t = (const double *)base;
+        c.azT = cf;
+        c.elT = cf + nb;
+        c.azR = cf + 2 * nb;
+        c.elR = cf + 3 * nb;
+        int rc = fn(&c, user);
+        if (rc) return rc;
+
+        // Devolve as páginas já processadas: o RSS não cresce com o arquivo
+        uintptr_t lo = (uintptr_t)base & ~(uintptr_t)(page - 1);
+        uintptr_t hi = ((uintptr_t)base + bytes) & ~(uintptr_t)(page - 1);
+        if (hi > lo) madvise((void *)lo, hi - lo, MADV_DONTNEED);
+    }
+    return 0;
+}
+
+void TrackLogClose(TrackLog *log) {
+    if (!log) return;
+    munmap((void *)log->map, log->mapBytes);
+    close(log->fd);
+    free(log);
+}
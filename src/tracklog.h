@@ -0,0 +1,86 @@
+/**
+ * \file tracklog.h
+ * \brief Formato binário colunar para logs de trilhas Az/El e replay por mapeamento em memória.
+ *
+ * Layout do arquivo (little-endian):
+ * - Cabeçalho de 64 bytes: \c "SPHTRK01", versão (u32), registros por bloco
+ *   \c B (u32), total de registros (u64), restante reservado (zeros).
+ * - Blocos de \c B registros, um após o outro. Dentro de cada bloco os campos
+ *   ficam em colunas contíguas: \c t (B doubles), depois \c azT, \c elT,
+ *   \c azR e \c elR (B floats cada). O último bloco pode estar incompleto.
+ *
+ * Ângulos são gravados em \b radianos, exatamente como
+ * \ref SphBatchAngleJPaired os consome: no replay, as colunas do arquivo
+ * mapeado são passadas diretamente aos kernels, sem cópia nem conversão.
+ * Cada bloco tem 24·B bytes e, com B múltiplo de 16, todas as colunas ficam
+ * alinhadas a 64 bytes.
+ */
+#ifndef TRACKLOG_H
+#define TRACKLOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Registros por bloco usados quando \ref TrackLogCreate recebe 0. */
+#define TRACKLOG_DEFAULT_BLOCK 65536u
+
+/**
+ * Maior quantidade de registros por bloco (\f$2^{24}\f$, blocos de 384 MiB):
+ * mantém o arredondamento para múltiplo de 16 e os 24·B bytes do bloco longe
+ * de estourar, mesmo com \c size_t de 32 bits.
+ */
+#define TRACKLOG_MAX_BLOCK (1u << 24)
+
+/**
+ * \brief Visão de um bloco do arquivo (ponteiros para a memória mapeada).
+ */
+typedef struct TrackLogChunk {
+    size_t first;           ///< Índice global do primeiro registro do bloco.
+    size_t count;           ///< Registros válidos neste bloco.
+    const double *t;        ///< Timestamps.
+    const float *azT, *elT; ///< Alvo T (rad).
+    const float *azR, *elR; ///< Eixo R (rad).
+} TrackLogChunk;
+
+/** Callback chamado para cada bloco durante o replay. Retorne 0 para continuar. */
+typedef int (*TrackLogChunkFn)(const TrackLogChunk *chunk, void *user);
+
+typedef struct TrackLogWriter TrackLogWriter;
+typedef struct TrackLog TrackLog;
+
+/**
+ * \brief Cria um arquivo de log para escrita sequencial.
+ * \param path Caminho do arquivo (sobrescrito se existir).
+ * \param blockRecords Registros por bloco (arredondado para múltiplo de 16; 0 = padrão).
+ *                     Acima de \ref TRACKLOG_MAX_BLOCK é rejeitado.
+ * \return NULL em caso de erro (mensagem em stderr).
+ */
+TrackLogWriter *TrackLogCreate(const char *path, uint32_t blockRecords);
+
+/** \brief Acrescenta um registro (ângulos em radianos). \return 0 em caso de sucesso. */
+int TrackLogAppend(TrackLogWriter *w, double t, float azT, float elT, float azR, float elR);
+
+/** \brief Grava o último bloco, atualiza o cabeçalho e fecha. \return 0 em caso de sucesso. */
+int TrackLogFinish(TrackLogWriter *w);
+
+/** \brief Abre e mapeia um log para leitura. \return NULL em caso de erro (mensagem em stderr). */
+TrackLog *TrackLogOpen(const char *path);
+
+/** \brief Total de registros do log. */
+size_t TrackLogCount(const TrackLog *log);
+
+/**
+ * \brief Percorre o log bloco a bloco, sem cópias.
+ *
+ * Depois que o callback retorna, as páginas do bloco são devolvidas ao
+ * sistema (\c MADV_DONTNEED), de modo que o uso de memória residente fica
+ * limitado a aproximadamente um bloco, qualquer que seja o tamanho do arquivo.
+ *
+ * \return 0 ao fim do arquivo, ou o valor não nulo devolvido pelo callback.
+ */
+int TrackLogReplay(TrackLog *log, TrackLogChunkFn fn, void *user);
+
+/** \brief Desfaz o mapeamento e fecha o arquivo. */
+void TrackLogClose(TrackLog *log);
+
+#endif /* TRACKLOG_H */
@@ -0,0 +1,1453 @@
+/**
+ * \file spherical_accuracy.c
+ * \brief Testes de regressão de precisão e de desempenho dos kernels da \c spherical_core.
+ *
+ * Cada kernel rápido (lote, SIMD em todas as ISAs desta CPU, tabela Q16,
+ * aproximação de \c acos) é comparado com uma referência em \c double
+ * calculada a partir das \b mesmas entradas em float: o erro medido é o do
+ * kernel, não o da quantização das entradas. Dois conjuntos de entradas:
+ * - aleatórias: direções uniformes, azimutes em \f$[-4\pi, 4\pi]\f$
+ *   (várias voltas) e elevações dentro do limite de ±89° da simulação;
+ * - de borda: polos (±89° e ±90°), azimute em 0, ±π e múltiplos de 2π
+ *   (inclusive o float vizinho), vetores idênticos, quase idênticos,
+ *   antípodas e quase antípodas.
+ *
+ * Para cada kernel são mostrados o erro absoluto máximo (componentes do
+ * vetor, ou ângulo em rad) e o erro máximo em ULPs do float mais próximo da
+ * referência. Valores de referência menores que \f$2^{-6}\f$ contam ULPs de
+ * \f$2^{-6}\f$: uma componente que deveria ser 0 e sai 1e-8 não vira milhões
+ * de ULPs. O teste falha se algum erro passar do orçamento do kernel.
+ *
+ * Com \c --perf, mede o desempenho (melhor de várias rodadas) e confere
+ * orçamentos de vazão: razões mínimas entre o kernel rápido e o escalar
+ * (independentes da máquina) e um teto em ns/elemento, escalável com
+ * \c --budget-scale para máquinas lentas. Só faz sentido em build otimizado:
+ * sem \c NDEBUG, as medições são mostradas mas não reprovam.
+ *
+ * Uso:
+ * \code
+ * spherical_accuracy [--n count] [--seed s]
+ * spherical_accuracy --perf [--budget-scale f]
+ * \endcode
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "spherical.h"
+#include "spherical_attitude.h"
+#include "spherical_coverage.h"
+#include "spherical_frames.h"
+#include "spherical_geodesy.h"
+#include "spherical_jmatrix.h"
+#include "spherical_lut.h"
+#include "spherical_parallel.h"
+#include "spherical_simd.h"
+
+#include "test_util.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PI_D 3.14159265358979323846
+
+/* --- Referências em double --- */
+
+typedef struct DVec3 {
+    double x, y, z;
+} DVec3;
+
+static DVec3 ToD(SphVec3 v) { return (DVec3){ v.x, v.y, v.z }; }
+
+static double DotD(DVec3 a, DVec3 b) { return a.x*b.x + a.y*b.y + a.z*b.z; }
+
+static double NormD(DVec3 a) { return sqrt(DotD(a, a)); }
+
+static DVec3 RefAzElToVec(double az, double el) {
+    return (DVec3){ cos(el) * cos(az), cos(el) * sin(az), sin(el) };
+}
+
+/** Ângulo exato entre as entradas (em float, não necessariamente de norma 1). */
+static double RefAngle(DVec3 a, DVec3 b) {
+    DVec3 c = { a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x };
+    return atan2(NormD(c), DotD(a, b));
+}
+
+/** Slerp exato; \return 0 se o arco não é único (antípodas). */
+static int RefSlerp(DVec3 a, DVec3 b, double t, DVec3 *out) {
+    double na = NormD(a), nb = NormD(b);
+    a = (DVec3){ a.x / na, a.y / na, a.z / na };
+    b = (DVec3){ b.x / nb, b.y / nb, b.z / nb };
+    double d = DotD(a, b);
+    DVec3 w = { b.x - d*a.x, b.y - d*a.y, b.z - d*a.z };
+    double s = NormD(w);
+    if (s < 1e-300) {
+        if (d < 0.0) return 0;
+        *out = a;
+        return 1;
+    }
+    double theta = atan2(s, d), c = cos(t * theta), sn = sin(t * theta);
+    *out = (DVec3){ c*a.x + sn*w.x/s, c*a.y + sn*w.y/s, c*a.z + sn*w.z/s };
+    return 1;
+}
+
+static double RefCosJ(double azT, double elT, double azR, double elR) {
+    return sin(elT)*sin(elR) + cos(elT)*cos(elR)*cos(azT - azR);
+}
+
+/* --- Medição do erro --- */
+
+typedef struct ErrStat {
+    size_t count;
+    double maxAbs;
+    double maxUlp;
+    int nonFinite;
+} ErrStat;
+
+/** ULP do float mais próximo de \c ref, com piso em \f$2^{-6}\f$. */
+static double UlpOf(double ref) {
+    double a = fabs(ref);
+    if (a < 0.015625) a = 0.015625;
+    int e;
+    frexp(a, &e);
+    return ldexp(1.0, e - 24);
+}
+
+static void ErrAdd(ErrStat *s, double got, double ref) {
+    s->count++;
+    if (!isfinite(got)) {
+        s->nonFinite++;
+        return;
+    }
+    double d = fabs(got - ref);
+    if (d > s->maxAbs) s->maxAbs = d;
+    double u = d / UlpOf(ref);
+    if (u > s->maxUlp) s->maxUlp = u;
+}
+
+static void ErrAddVec(ErrStat *s, float x, float y, float z, DVec3 ref) {
+    ErrAdd(s, x, ref.x);
+    ErrAdd(s, y, ref.y);
+    ErrAdd(s, z, ref.z);
+}
+
+static void PrintHeader(const char *title) {
+    printf("\n%s\n", title);
+    printf("%-34s %-8s %9s %11s %9s %11s  %s\n", "Kernel", "ISA", "Valores", "Erro máx", "ULP máx", "Orçamento", "");
+    printf("-------------------------------------------------------------------------------------------------\n");
+}
+
+/** Mostra a linha e conta a falha se o erro passou de \c budget (ou apareceu NaN/inf). */
+static void Report(const char *kernel, const char *isa, const ErrStat *s, double budget) {
+    int ok = s->nonFinite == 0 && s->maxAbs <= budget && s->count > 0;
+    printf("%-34s %-8s %9zu %11.3e %9.1f %11.3e  %s", kernel, isa, s->count, s->maxAbs, s->maxUlp, budget,
+           ok ? "ok" : "FALHOU");
+    if (s->nonFinite) printf(" (%d não finitos)", s->nonFinite);
+    printf("\n");
+    if (!ok) gFailures++;
+}
+
+/* --- Entradas --- */
+
+/** Elevação uniforme na esfera, limitada a ±89° (como a simulação). */
+static double RandomEl(void) {
+    double lim = sin(89.0 * PI_D / 180.0);
+    return asin(Uniform(-lim, lim));
+}
+
+typedef struct AngleSet {
+    size_t n;
+    float *az, *el;
+} AngleSet;
+
+typedef struct PairSet {
+    size_t n;
+    float *ax, *ay, *az;
+    float *bx, *by, *bz;
+} PairSet;
+
+static void *Alloc(size_t bytes) {
+    void *p = malloc(bytes ? bytes : 1);
+    if (!p) {
+        fprintf(stderr, "sem memória\n");
+        exit(2);
+    }
+    return p;
+}
+
+static AngleSet AngleSetAlloc(size_t n) {
+    AngleSet s = { n, Alloc(n * sizeof(float)), Alloc(n * sizeof(float)) };
+    return s;
+}
+
+static void AngleSetFree(AngleSet *s) {
+    free(s->az);
+    free(s->el);
+}
+
+static AngleSet RandomAngles(size_t n) {
+    AngleSet s = AngleSetAlloc(n);
+    for (size_t i = 0; i < n; ++i) {
+        s.az[i] = (float)Uniform(-4.0 * PI_D, 4.0 * PI_D);
+        s.el[i] = (float)RandomEl();
+    }
+    return s;
+}
+
+/** Produto cartesiano de azimutes e elevações de borda. */
+static AngleSet EdgeAngles(void) {
+    const float twoPi = (float)(2.0 * PI_D);
+    const float az[] = {
+        0.0f, -0.0f, (float)(0.5 * PI_D), (float)PI_D, -(float)PI_D, (float)(1.5 * PI_D),
+        twoPi, -twoPi, nextafterf(twoPi, 0.0f), nextafterf(twoPi, 10.0f), nextafterf(-twoPi, 0.0f),
+        2.0f * twoPi, -2.0f * twoPi, 1e-7f, -1e-7f, 0.7853982f
+    };
+    const float deg = (float)(PI_D / 180.0);
+    const float el[] = {
+        0.0f, 89.0f * deg, -89.0f * deg, 89.9999f * deg, -89.9999f * deg,
+        (float)(0.5 * PI_D), -(float)(0.5 * PI_D), 45.0f * deg, 1e-7f, -1e-7f
+    };
+    size_t na = sizeof az / sizeof *az, ne = sizeof el / sizeof *el;
+    AngleSet s = AngleSetAlloc(na * ne);
+    for (size_t i = 0; i < na; ++i) {
+        for (size_t j = 0; j < ne; ++j) {
+            s.az[i * ne + j] = az[i];
+            s.el[i * ne + j] = el[j];
+        }
+    }
+    return s;
+}
+
+static PairSet PairSetAlloc(size_t n) {
+    PairSet p;
+    p.n = n;
+    p.ax = Alloc(n * sizeof(float)); p.ay = Alloc(n * sizeof(float)); p.az = Alloc(n * sizeof(float));
+    p.bx = Alloc(n * sizeof(float)); p.by = Alloc(n * sizeof(float)); p.bz = Alloc(n * sizeof(float));
+    return p;
+}
+
+static void PairSetFree(PairSet *p) {
+    free(p->ax); free(p->ay); free(p->az);
+    free(p->bx); free(p->by); free(p->bz);
+}
+
+static void PairSet1(PairSet *p, size_t i, DVec3 a, DVec3 b) {
+    p->ax[i] = (float)a.x; p->ay[i] = (float)a.y; p->az[i] = (float)a.z;
+    p->bx[i] = (float)b.x; p->by[i] = (float)b.y; p->bz[i] = (float)b.z;
+}
+
+static SphVec3 PairA(const PairSet *p, size_t i) { return (SphVec3){ p->ax[i], p->ay[i], p->az[i] }; }
+static SphVec3 PairB(const PairSet *p, size_t i) { return (SphVec3){ p->bx[i], p->by[i], p->bz[i] }; }
+
+static PairSet RandomPairs(size_t n) {
+    PairSet p = PairSetAlloc(n);
+    for (size_t i = 0; i < n; ++i) {
+        PairSet1(&p, i, RefAzElToVec(Uniform(-PI_D, PI_D), RandomEl()),
+                 RefAzElToVec(Uniform(-PI_D, PI_D), RandomEl()));
+    }
+    return p;
+}
+
+/** Gira \c a de \c delta rad em direção a uma perpendicular qualquer. */
+static DVec3 Tilt(DVec3 a, double delta) {
+    DVec3 h = fabs(a.z) < 0.9 ? (DVec3){ 0, 0, 1 } : (DVec3){ 1, 0, 0 };
+    double d = DotD(h, a);
+    DVec3 w = { h.x - d*a.x, h.y - d*a.y, h.z - d*a.z };
+    double n = NormD(w);
+    return (DVec3){ cos(delta)*a.x + sin(delta)*w.x/n, cos(delta)*a.y + sin(delta)*w.y/n,
+                    cos(delta)*a.z + sin(delta)*w.z/n };
+}
+
+/**
+ * Pares de borda: idênticos, quase idênticos, ortogonais, quase antípodas e
+ * antípodas exatos (b = -a, sem arredondamento), inclusive nos polos.
+ * \param antipodal 0 omite os antípodas exatos (slerp sem arco único).
+ */
+static PairSet EdgePairs(int antipodal, double minDelta) {
+    static const double kDeltas[] = { 0.0, 1e-7, 1e-6, 1e-5, 1e-4, 1e-3, 1e-2 };
+    const size_t nd = sizeof kDeltas / sizeof *kDeltas, bases = 64;
+    PairSet p = PairSetAlloc(bases * (2 * nd + 2));
+    size_t k = 0;
+    for (size_t i = 0; i < bases; ++i) {
+        double el = i < 4 ? (i & 1 ? -0.5 : 0.5) * PI_D * (i < 2 ? 1.0 : 89.0 / 90.0) : RandomEl();
+        DVec3 a = RefAzElToVec(Uniform(-PI_D, PI_D), el);
+        // Arredonda para float antes de girar: "idêntico" é bit a bit
+        a = (DVec3){ (float)a.x, (float)a.y, (float)a.z };
+        for (size_t d = 0; d < nd; ++d) {
+            PairSet1(&p, k++, a, Tilt(a, kDeltas[d]));
+            if (kDeltas[d] >= minDelta) {
+                DVec3 t = Tilt(a, kDeltas[d]);
+                PairSet1(&p, k++, a, (DVec3){ -t.x, -t.y, -t.z });
+            }
+        }
+        PairSet1(&p, k++, a, Tilt(a, 0.5 * PI_D));
+        if (antipodal) {
+            PairSet1(&p, k, a, a);
+            p.bx[k] = -p.ax[k]; p.by[k] = -p.ay[k]; p.bz[k] = -p.az[k];
+            ++k;
+        }
+    }
+    p.n = k;
+    return p;
+}
+
+/* --- AzElToVec --- */
+
+typedef void (*BatchAzElFn)(const float *az, const float *el, size_t n, float *x, float *y, float *z,
+                            SphAccuracy acc);
+
+/** Variantes de spherical_frames.h: unidade e troca de eixos da referência. */
+typedef struct FrameCase {
+    const char *name;
+    BatchAzElFn fn;
+    double unitsPerTurn;
+    int enu;     // X = Leste, Y = Norte
+    int down;    // Z = Baixo
+} FrameCase;
+
+static const FrameCase kFrames[] = {
+    { "BatchAzElToVecNeuRad", SphBatchAzElToVecNeuRad, 2.0 * PI_D, 0, 0 },
+    { "BatchAzElToVecNeuDeg", SphBatchAzElToVecNeuDeg, 360.0, 0, 0 },
+    { "BatchAzElToVecNeuMil", SphBatchAzElToVecNeuMil, 6400.0, 0, 0 },
+    { "BatchAzElToVecNedRad", SphBatchAzElToVecNedRad, 2.0 * PI_D, 0, 1 },
+    { "BatchAzElToVecNedDeg", SphBatchAzElToVecNedDeg, 360.0, 0, 1 },
+    { "BatchAzElToVecNedMil", SphBatchAzElToVecNedMil, 6400.0, 0, 1 },
+    { "BatchAzElToVecEnuRad", SphBatchAzElToVecEnuRad, 2.0 * PI_D, 1, 0 },
+    { "BatchAzElToVecEnuDeg", SphBatchAzElToVecEnuDeg, 360.0, 1, 0 },
+    { "BatchAzElToVecEnuMil", SphBatchAzElToVecEnuMil, 6400.0, 1, 0 },
+};
+
+static DVec3 RefFrame(const FrameCase *f, float az, float el) {
+    double k = 2.0 * PI_D / f->unitsPerTurn;
+    DVec3 v = RefAzElToVec(az * k, el * k);
+    if (f->enu) v = (DVec3){ v.y, v.x, v.z };
+    if (f->down) v.z = -v.z;
+    return v;
+}
+
+/** Erro de todos os kernels Az/El -> vetor em um conjunto de entradas. */
+static void TestAzElSet(const char *label, const AngleSet *in) {
+    size_t n = in->n;
+    float *x = Alloc(n * sizeof(float)), *y = Alloc(n * sizeof(float)), *z = Alloc(n * sizeof(float));
+    char name[64];
+    ErrStat s;
+
+    memset(&s, 0, sizeof s);
+    for (size_t i = 0; i < n; ++i) {
+        SphVec3 v = SphAzElToVec(in->az[i], in->el[i]);
+        ErrAddVec(&s, v.x, v.y, v.z, RefAzElToVec(in->az[i], in->el[i]));
+    }
+    snprintf(name, sizeof name, "AzElToVec (%s)", label);
+    Report(name, "libm", &s, 3e-7);
+
+    memset(&s, 0, sizeof s);
+    SphBatchAzElToVec(in->az, in->el, n, x, y, z);
+    for (size_t i = 0; i < n; ++i) ErrAddVec(&s, x[i], y[i], z[i], RefAzElToVec(in->az[i], in->el[i]));
+    snprintf(name, sizeof name, "BatchAzElToVec (%s)", label);
+    Report(name, "libm", &s, 3e-7);
+
+    SphIsa saved = SphIsaActive();
+    for (int isa = 0; isa < SPH_ISA_COUNT; ++isa) {
+        if (!SphIsaSupported((SphIsa)isa) || SphIsaSelect((SphIsa)isa) != 0) continue;
+        const char *isaName = SphIsaName((SphIsa)isa);
+        for (int acc = 0; acc < 2; ++acc) {
+            SphAccuracy a = acc ? SPH_ACCURACY_FAST : SPH_ACCURACY_PRECISE;
+            memset(&s, 0, sizeof s);
+            SphAzElToVecSimd(in->az, in->el, n, x, y, z, a);
+            for (size_t i = 0; i < n; ++i) ErrAddVec(&s, x[i], y[i], z[i], RefAzElToVec(in->az[i], in->el[i]));
+            snprintf(name, sizeof name, "AzElToVecSimd %s (%s)", acc ? "fast" : "precise", label);
+            Report(name, isaName, &s, acc ? 5e-4 : 5e-7);
+        }
+        // Convenções e unidades: as mesmas entradas lidas como graus/milésimos, em escala
+        for (size_t f = 0; f < sizeof kFrames / sizeof *kFrames; ++f) {
+            const FrameCase *fc = &kFrames[f];
+            float k = (float)(fc->unitsPerTurn / (2.0 * PI_D));
+            float *az = Alloc(n * sizeof(float)), *el = Alloc(n * sizeof(float));
+            for (size_t i = 0; i < n; ++i) { az[i] = in->az[i] * k; el[i] = in->el[i] * k; }
+            memset(&s, 0, sizeof s);
+            fc->fn(az, el, n, x, y, z, SPH_ACCURACY_PRECISE);
+            for (size_t i = 0; i < n; ++i) ErrAddVec(&s, x[i], y[i], z[i], RefFrame(fc, az[i], el[i]));
+            snprintf(name, sizeof name, "%s (%s)", fc->name, label);
+            Report(name, isaName, &s, 5e-7);
+            free(az);
+            free(el);
+        }
+    }
+    SphIsaSelect(saved);
+    free(x); free(y); free(z);
+}
+
+/** Tabela Q16: todos os 65536 códigos de seno/cosseno e pares Az/El aleatórios. */
+static void TestQ16(size_t n) {
+    for (int acc = 0; acc < 2; ++acc) {
+        SphAccuracy a = acc ? SPH_ACCURACY_FAST : SPH_ACCURACY_PRECISE;
+        ErrStat s;
+        memset(&s, 0, sizeof s);
+        for (uint32_t code = 0; code < 65536u; ++code) {
+            float sn, cs;
+            SphSinCosQ16((uint16_t)code, a, &sn, &cs);
+            double th = code * (2.0 * PI_D / 65536.0);
+            ErrAdd(&s, sn, sin(th));
+            ErrAdd(&s, cs, cos(th));
+        }
+        Report(acc ? "SinCosQ16 fast (65536 códigos)" : "SinCosQ16 precise (65536 códigos)", "lut", &s,
+               acc ? 1e-3 : 3e-7);
+
+        uint16_t *az = Alloc(n * sizeof *az);
+        int16_t *el = Alloc(n * sizeof *el);
+        float *x = Alloc(n * sizeof(float)), *y = Alloc(n * sizeof(float)), *z = Alloc(n * sizeof(float));
+        for (size_t i = 0; i < n; ++i) {
+            az[i] = (uint16_t)Uniform(0.0, 65536.0);
+            el[i] = (int16_t)Uniform(-16384.0, 16385.0);
+        }
+        SphBatchAzElQ16ToVec(az, el, n, x, y, z, a);
+        memset(&s, 0, sizeof s);
+        for (size_t i = 0; i < n; ++i) {
+            DVec3 ref = RefAzElToVec(az[i] * (2.0 * PI_D / 65536.0), el[i] * (2.0 * PI_D / 65536.0));
+            ErrAddVec(&s, x[i], y[i], z[i], ref);
+            SphVec3 v = SphAzElQ16ToVec(az[i], el[i], a);
+            ErrAddVec(&s, v.x, v.y, v.z, ref);
+        }
+        Report(acc ? "AzElQ16ToVec fast (aleatórios)" : "AzElQ16ToVec precise (aleatórios)", "lut", &s,
+               acc ? 1e-3 : 5e-7);
+        free(az); free(el); free(x); free(y); free(z);
+    }
+}
+
+/* --- Ângulo entre vetores --- */
+
+typedef float (*AngleFn)(SphVec3 a, SphVec3 b);
+typedef void (*BatchAngleFn)(const float *ax, const float *ay, const float *az,
+                             const float *bx, const float *by, const float *bz, size_t n, float *out);
+
+typedef struct AngleCase {
+    const char *name;
+    AngleFn scalar;
+    BatchAngleFn batch;
+    double budgetRandom, budgetEdge;
+} AngleCase;
+
+/*
+ * Com acos do produto escalar em float, J perto de 0 ou de π herda o erro
+ * de arredondamento de a·b amplificado: até \f$\sqrt{2\varepsilon}\f$
+ * (~5e-4 rad). É o comportamento documentado, não uma regressão; ACOSD e
+ * ATAN2 existem para isso e têm orçamentos apertados também na borda.
+ */
+static const AngleCase kAngles[] = {
+    { "AngleBetweenUnit", SphAngleBetweenUnit, SphBatchAngleBetweenUnit, 2e-4, 1e-3 },
+    { "AngleBetweenUnitAcosd", SphAngleBetweenUnitAcosd, SphBatchAngleBetweenUnitAcosd, 2e-4, 1e-3 },
+    { "AngleBetweenUnitAtan2", SphAngleBetweenUnitAtan2, SphBatchAngleBetweenUnitAtan2, 1e-6, 1e-6 },
+};
+
+static void TestAngleSet(const char *label, const PairSet *p, int edge) {
+    size_t n = p->n;
+    float *out = Alloc(n * sizeof(float));
+    double *ref = Alloc(n * sizeof(double));
+    char name[64];
+    for (size_t i = 0; i < n; ++i) ref[i] = RefAngle(ToD(PairA(p, i)), ToD(PairB(p, i)));
+
+    for (size_t c = 0; c < sizeof kAngles / sizeof *kAngles; ++c) {
+        const AngleCase *ac = &kAngles[c];
+        double budget = edge ? ac->budgetEdge : ac->budgetRandom;
+        ErrStat s;
+        memset(&s, 0, sizeof s);
+        for (size_t i = 0; i < n; ++i) ErrAdd(&s, ac->scalar(PairA(p, i), PairB(p, i)), ref[i]);
+        snprintf(name, sizeof name, "%s (%s)", ac->name, label);
+        Report(name, "scalar", &s, budget);
+
+        memset(&s, 0, sizeof s);
+        ac->batch(p->ax, p->ay, p->az, p->bx, p->by, p->bz, n, out);
+        for (size_t i = 0; i < n; ++i) ErrAdd(&s, out[i], ref[i]);
+        snprintf(name, sizeof name, "Batch%s (%s)", ac->name, label);
+        Report(name, "batch", &s, budget);
+    }
+
+    // acos aproximado sobre o mesmo produto escalar do AngleBetweenUnit
+    for (int acc = 0; acc < 2; ++acc) {
+        SphAccuracy a = acc ? SPH_ACCURACY_FAST : SPH_ACCURACY_PRECISE;
+        ErrStat s;
+        memset(&s, 0, sizeof s);
+        for (size_t i = 0; i < n; ++i) {
+            float d = p->ax[i]*p->bx[i] + p->ay[i]*p->by[i] + p->az[i]*p->bz[i];
+            ErrAdd(&s, SphAcosApprox(d, a), ref[i]);
+        }
+        snprintf(name, sizeof name, "AcosApprox(a.b) %s (%s)", acc ? "fast" : "precise", label);
+        Report(name, "scalar", &s, acc ? (edge ? 1e-3 : 2e-4) : (edge ? 1e-3 : 2e-4));
+    }
+    free(out);
+    free(ref);
+}
+
+/** O polinômio sozinho contra \c acos em [-1, 1] (e valores fora, que são limitados). */
+static void TestAcosApprox(void) {
+    const size_t n = 1u << 20;
+    float *in = Alloc((n + 6) * sizeof(float)), *out = Alloc((n + 6) * sizeof(float));
+    for (size_t i = 0; i < n; ++i) in[i] = (float)(-1.0 + 2.0 * (double)i / (double)(n - 1));
+    const float edges[] = { 1.0f, -1.0f, nextafterf(1.0f, 0.0f), nextafterf(-1.0f, 0.0f), 1.5f, -1.5f };
+    memcpy(in + n, edges, sizeof edges);
+    for (int acc = 0; acc < 2; ++acc) {
+        SphAccuracy a = acc ? SPH_ACCURACY_FAST : SPH_ACCURACY_PRECISE;
+        ErrStat s;
+        memset(&s, 0, sizeof s);
+        SphBatchAcosApprox(in, n + 6, out, a);
+        for (size_t i = 0; i < n + 6; ++i) {
+            double x = in[i] > 1.0f ? 1.0 : in[i] < -1.0f ? -1.0 : in[i];
+            ErrAdd(&s, out[i], acos(x));
+            ErrAdd(&s, SphAcosApprox(in[i], a), acos(x));
+        }
+        Report(acc ? "AcosApprox fast [-1, 1]" : "AcosApprox precise [-1, 1]", "scalar", &s, acc ? 7e-5 : 5e-7);
+    }
+    free(in);
+    free(out);
+}
+
+/* --- J a partir de Az/El e cos J analítico --- */
+
+static void TestAngleJSet(const char *label, const AngleSet *t, const AngleSet *r, int edge) {
+    size_t n = t->n;
+    float *out = Alloc(n * sizeof(float));
+    double *refJ = Alloc(n * sizeof(double)), *refC = Alloc(n * sizeof(double));
+    char name[64];
+    ErrStat s;
+    for (size_t i = 0; i < n; ++i) {
+        DVec3 vt = RefAzElToVec(t->az[i], t->el[i]), vr = RefAzElToVec(r->az[i], r->el[i]);
+        refJ[i] = RefAngle(vt, vr);
+        refC[i] = RefCosJ(t->az[i], t->el[i], r->az[i], r->el[i]);
+    }
+
+    memset(&s, 0, sizeof s);
+    for (size_t i = 0; i < n; ++i) ErrAdd(&s, SphCosJ(t->az[i], t->el[i], r->az[i], r->el[i]), refC[i]);
+    snprintf(name, sizeof name, "CosJ analítico (%s)", label);
+    Report(name, "scalar", &s, 1e-6);
+
+    // Eixo único: o primeiro R para todos os alvos
+    memset(&s, 0, sizeof s);
+    SphBatchCosJ(t->az, t->el, n, r->az[0], r->el[0], out);
+    for (size_t i = 0; i < n; ++i) ErrAdd(&s, out[i], RefCosJ(t->az[i], t->el[i], r->az[0], r->el[0]));
+    snprintf(name, sizeof name, "BatchCosJ (%s)", label);
+    Report(name, "batch", &s, 1e-6);
+
+    memset(&s, 0, sizeof s);
+    SphBatchAngleJ(t->az, t->el, n, r->az[0], r->el[0], out);
+    for (size_t i = 0; i < n; ++i) {
+        ErrAdd(&s, out[i], RefAngle(RefAzElToVec(t->az[i], t->el[i]), RefAzElToVec(r->az[0], r->el[0])));
+    }
+    snprintf(name, sizeof name, "BatchAngleJ (%s)", label);
+    Report(name, "batch", &s, edge ? 1e-3 : 2e-4);
+
+    struct { const char *name; float (*scalar)(float, float, float, float);
+             void (*batch)(const float *, const float *, const float *, const float *, size_t, float *);
+             double budgetRandom, budgetEdge; } kJ[] = {
+        { "AngleJ", SphAngleJ, SphBatchAngleJPaired, 2e-4, 1e-3 },
+        { "AngleJAcosd", SphAngleJAcosd, SphBatchAngleJPairedAcosd, 2e-4, 1e-3 },
+        { "AngleJAtan2", SphAngleJAtan2, SphBatchAngleJPairedAtan2, 2e-6, 2e-6 },
+    };
+    for (size_t c = 0; c < sizeof kJ / sizeof *kJ; ++c) {
+        double budget = edge ? kJ[c].budgetEdge : kJ[c].budgetRandom;
+        memset(&s, 0, sizeof s);
+        for (size_t i = 0; i < n; ++i) ErrAdd(&s, kJ[c].scalar(t->az[i], t->el[i], r->az[i], r->el[i]), refJ[i]);
+        snprintf(name, sizeof name, "%s (%s)", kJ[c].name, label);
+        Report(name, "scalar", &s, budget);
+
+        memset(&s, 0, sizeof s);
+        kJ[c].batch(t->az, t->el, r->az, r->el, n, out);
+        for (size_t i = 0; i < n; ++i) ErrAdd(&s, out[i], refJ[i]);
+        snprintf(name, sizeof name, "Batch%sPaired (%s)", kJ[c].name, label);
+        Report(name, "batch", &s, budget);
+    }
+
+    // Cone: só pode discordar da referência a 1e-5 (em cos J) do limiar
+    const float half = 0.5f;
+    const double thr = cos((double)half);
+    unsigned char *inside = Alloc(n);
+    size_t count = SphBatchGateJ(t->az, t->el, n, r->az[0], r->el[0], SphCosThreshold(half), inside);
+    size_t wrong = 0, refCount = 0, marked = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double c = RefCosJ(t->az[i], t->el[i], r->az[0], r->el[0]);
+        int expect = c >= thr;
+        refCount += (size_t)expect;
+        marked += inside[i];
+        if (inside[i] != expect && fabs(c - thr) > 1e-5) wrong++;
+    }
+    printf("%-34s %-8s %9zu %11s %9s %11s  %s\n", "BatchGateJ", "batch", n, "", "",
+           "", wrong == 0 && count == marked ? "ok" : "FALHOU");
+    if (wrong != 0 || count != marked) {
+        printf("  %zu alvos fora da faixa de tolerância classificados errado (ref: %zu no cone, kernel: %zu)\n",
+               wrong, refCount, count);
+        gFailures++;
+    }
+    free(inside);
+    free(out);
+    free(refJ);
+    free(refC);
+}
+
+/* --- Slerp --- */
+
+static const float kSlerpT[] = { 0.0f, 0.25f, 0.5f, 0.75f, 1.0f, 0.1f, 0.9f };
+#define SLERP_T_COUNT (sizeof kSlerpT / sizeof *kSlerpT)
+
+/**
+ * \c budgetSin vale para a forma com pesos \f$\sin((1-t)\theta)/\sin\theta\f$
+ * (\ref SphSlerpUnit, \ref SphArcPoint), que perde dígitos em arcos curtos;
+ * \c budget para a forma com base ortonormal.
+ */
+static void TestSlerpSet(const char *label, const PairSet *p, double budgetSin, double budget, double budgetFast) {
+    size_t n = p->n;
+    float *x = Alloc(n * sizeof(float)), *y = Alloc(n * sizeof(float)), *z = Alloc(n * sizeof(float));
+    SphSlerpBatch b;
+    b.ux = Alloc(n * sizeof(float)); b.uy = Alloc(n * sizeof(float)); b.uz = Alloc(n * sizeof(float));
+    b.wx = Alloc(n * sizeof(float)); b.wy = Alloc(n * sizeof(float)); b.wz = Alloc(n * sizeof(float));
+    b.theta = Alloc(n * sizeof(float));
+    SphBatchSlerpPrepare(p->ax, p->ay, p->az, p->bx, p->by, p->bz, n, &b);
+    char name[64];
+    ErrStat sUnit, sPlan, sBasis, sBatch;
+    memset(&sUnit, 0, sizeof sUnit); memset(&sPlan, 0, sizeof sPlan);
+    memset(&sBasis, 0, sizeof sBasis); memset(&sBatch, 0, sizeof sBatch);
+
+    for (size_t k = 0; k < SLERP_T_COUNT; ++k) {
+        float t = kSlerpT[k];
+        SphBatchSlerpEval(&b, n, t, x, y, z);
+        for (size_t i = 0; i < n; ++i) {
+            SphVec3 a = PairA(p, i), e = PairB(p, i);
+            DVec3 ref;
+            if (!RefSlerp(ToD(a), ToD(e), t, &ref)) continue;
+            SphVec3 v = SphSlerpUnit(a, e, t);
+            ErrAddVec(&sUnit, v.x, v.y, v.z, ref);
+            SphArcPlan plan = SphArcPrepare(a, e);
+            v = SphArcPoint(&plan, t);
+            ErrAddVec(&sPlan, v.x, v.y, v.z, ref);
+            SphSlerpBasis basis = SphSlerpPrepare(a, e);
+            v = SphSlerpBasisPoint(&basis, t);
+            ErrAddVec(&sBasis, v.x, v.y, v.z, ref);
+            ErrAddVec(&sBatch, x[i], y[i], z[i], ref);
+        }
+    }
+    snprintf(name, sizeof name, "SlerpUnit (%s)", label);
+    Report(name, "scalar", &sUnit, budgetSin);
+    snprintf(name, sizeof name, "ArcPoint (%s)", label);
+    Report(name, "scalar", &sPlan, budgetSin);
+    snprintf(name, sizeof name, "SlerpBasisPoint (%s)", label);
+    Report(name, "scalar", &sBasis, budget);
+    snprintf(name, sizeof name, "BatchSlerpEval (%s)", label);
+    Report(name, "batch", &sBatch, budget);
+
+    SphIsa saved = SphIsaActive();
+    for (int isa = 0; isa < SPH_ISA_COUNT; ++isa) {
+        if (!SphIsaSupported((SphIsa)isa) || SphIsaSelect((SphIsa)isa) != 0) continue;
+        for (int acc = 0; acc < 2; ++acc) {
+            ErrStat s;
+            memset(&s, 0, sizeof s);
+            for (size_t k = 0; k < SLERP_T_COUNT; ++k) {
+                SphSlerpEvalSimd(&b, n, kSlerpT[k], x, y, z, acc ? SPH_ACCURACY_FAST : SPH_ACCURACY_PRECISE);
+                for (size_t i = 0; i < n; ++i) {
+                    DVec3 ref;
+                    if (RefSlerp(ToD(PairA(p, i)), ToD(PairB(p, i)), kSlerpT[k], &ref)) ErrAddVec(&s, x[i], y[i], z[i], ref);
+                }
+            }
+            snprintf(name, sizeof name, "SlerpEvalSimd %s (%s)", acc ? "fast" : "precise", label);
+            Report(name, SphIsaName((SphIsa)isa), &s, acc ? budgetFast : budget);
+        }
+    }
+    SphIsaSelect(saved);
+    free(x); free(y); free(z);
+    free(b.ux); free(b.uy); free(b.uz); free(b.wx); free(b.wy); free(b.wz); free(b.theta);
+}
+
+/**
+ * Antípodas exatos: o arco não é único, então só se exige que a base
+ * (\ref SphSlerpPrepare) dê pontos unitários a \f$t\pi\f$ de \c a. O
+ * \ref SphSlerpUnit clássico (divisão por \f$\sin\theta\f$) não define esse
+ * caso e fica de fora.
+ */
+static void TestSlerpAntipodal(void) {
+    ErrStat sNorm, sAngle;
+    memset(&sNorm, 0, sizeof sNorm);
+    memset(&sAngle, 0, sizeof sAngle);
+    PairSet p = EdgePairs(1, 1.0);
+    for (size_t i = 0; i < p.n; ++i) {
+        SphVec3 a = PairA(&p, i), b = PairB(&p, i);
+        if (a.x != -b.x || a.y != -b.y || a.z != -b.z) continue;
+        SphSlerpBasis basis = SphSlerpPrepare(a, b);
+        for (size_t k = 0; k < SLERP_T_COUNT; ++k) {
+            SphVec3 v = SphSlerpBasisPoint(&basis, kSlerpT[k]);
+            ErrAdd(&sNorm, NormD(ToD(v)), 1.0);
+            ErrAdd(&sAngle, RefAngle(ToD(a), ToD(v)), kSlerpT[k] * PI_D);
+        }
+    }
+    Report("SlerpBasisPoint antípodas: |p|", "scalar", &sNorm, 1e-6);
+    Report("SlerpBasisPoint antípodas: ângulo", "scalar", &sAngle, 1e-5);
+    PairSetFree(&p);
+}
+
+static void TestSlerpUniform(void) {
+    // Tesselação longa: o erro da recorrência cresce com n (~5e-6 em alguns milhares de passos)
+    ErrStat s;
+    memset(&s, 0, sizeof s);
+    PairSet p = RandomPairs(256);
+    const size_t steps = 4096;
+    SphVec3 *pts = Alloc((steps + 1) * sizeof *pts);
+    for (size_t i = 0; i < p.n; ++i) {
+        SphSlerpBasis basis = SphSlerpPrepare(PairA(&p, i), PairB(&p, i));
+        SphSlerpBasisUniform(&basis, 0.0f, 1.0f / (float)steps, steps + 1, pts);
+        for (size_t k = 0; k <= steps; ++k) {
+            DVec3 ref;
+            if (RefSlerp(ToD(PairA(&p, i)), ToD(PairB(&p, i)), (double)k / (double)steps, &ref)) {
+                ErrAddVec(&s, pts[k].x, pts[k].y, pts[k].z, ref);
+            }
+        }
+    }
+    Report("SlerpBasisUniform (4096 passos)", "scalar", &s, 1e-5);
+    free(pts);
+    PairSetFree(&p);
+}
+
+/* --- Matriz J (eixos × alvos) --- */
+
+/**
+ * Eixos = as \c nAxes primeiras entradas A de \c p, alvos = as \c nTargets
+ * primeiras B. \c nAxes fora de múltiplos de \ref SPH_JMAT_MR e
+ * \c nTargets acima de \ref SPH_JMAT_TILE_COLS cobrem os restos dos blocos.
+ * Com um pool, o resultado tem de ser idêntico bit a bit ao de uma thread.
+ */
+static void TestJMatrixSet(const char *label, const PairSet *p, size_t nAxes, size_t nTargets,
+                           SphPool *pool, int edge) {
+    const size_t nn = nAxes * nTargets;
+    float *out = Alloc(nn * sizeof(float)), *outMt = Alloc(nn * sizeof(float));
+    double *refC = Alloc(nn * sizeof(double)), *refJ = Alloc(nn * sizeof(double));
+    unsigned char *inside = Alloc(nn), *insideMt = Alloc(nn);
+    char name[64];
+    for (size_t i = 0; i < nAxes; ++i) {
+        DVec3 r = ToD(PairA(p, i));
+        for (size_t j = 0; j < nTargets; ++j) {
+            DVec3 t = ToD(PairB(p, j));
+            refC[i*nTargets + j] = DotD(r, t);
+            refJ[i*nTargets + j] = RefAngle(r, t);
+        }
+    }
+    int same = 1;
+    ErrStat s;
+
+    memset(&s, 0, sizeof s);
+    SphJMatrixCos(NULL, p->ax, p->ay, p->az, nAxes, p->bx, p->by, p->bz, nTargets, out);
+    SphJMatrixCos(pool, p->ax, p->ay, p->az, nAxes, p->bx, p->by, p->bz, nTargets, outMt);
+    for (size_t k = 0; k < nn; ++k) ErrAdd(&s, out[k], refC[k] > 1.0 ? 1.0 : (refC[k] < -1.0 ? -1.0 : refC[k]));
+    same &= memcmp(out, outMt, nn * sizeof(float)) == 0;
+    snprintf(name, sizeof name, "JMatrixCos (%s)", label);
+    Report(name, "scalar", &s, 1e-6);
+
+    for (int acc = 0; acc < 2; ++acc) {
+        SphAccuracy a = acc ? SPH_ACCURACY_FAST : SPH_ACCURACY_PRECISE;
+        memset(&s, 0, sizeof s);
+        SphJMatrix(NULL, p->ax, p->ay, p->az, nAxes, p->bx, p->by, p->bz, nTargets, a, out);
+        SphJMatrix(pool, p->ax, p->ay, p->az, nAxes, p->bx, p->by, p->bz, nTargets, a, outMt);
+        for (size_t k = 0; k < nn; ++k) ErrAdd(&s, out[k], refJ[k]);
+        same &= memcmp(out, outMt, nn * sizeof(float)) == 0;
+        // Mesmo limite de acos(a·b) em float que AngleBetweenUnit, mais o do polinômio
+        snprintf(name, sizeof name, "JMatrix %s (%s)", acc ? "fast" : "precise", label);
+        Report(name, "scalar", &s, edge ? 1e-3 : (acc ? 3e-4 : 2e-4));
+    }
+
+    // Cone: só pode discordar da referência a 1e-5 (em cos J) do limiar
+    const float half = 0.5f;
+    const double thr = cos((double)half);
+    size_t count = 0, countMt = 0, countOnly = 0, wrong = 0, marked = 0;
+    SphJMatrixGate(NULL, p->ax, p->ay, p->az, nAxes, p->bx, p->by, p->bz, nTargets,
+                   SphCosThreshold(half), inside, &count);
+    SphJMatrixGate(pool, p->ax, p->ay, p->az, nAxes, p->bx, p->by, p->bz, nTargets,
+                   SphCosThreshold(half), insideMt, &countMt);
+    SphJMatrixGate(pool, p->ax, p->ay, p->az, nAxes, p->bx, p->by, p->bz, nTargets,
+                   SphCosThreshold(half), NULL, &countOnly);
+    for (size_t k = 0; k < nn; ++k) {
+        int expect = refC[k] >= thr;
+        marked += inside[k];
+        if (inside[k] != expect && fabs(refC[k] - thr) > 1e-5) wrong++;
+    }
+    same &= memcmp(inside, insideMt, nn) == 0 && count == countMt && count == countOnly;
+    int ok = wrong == 0 && count == marked;
+    snprintf(name, sizeof name, "JMatrixGate (%s)", label);
+    printf("%-34s %-8s %9zu %11s %9s %11s  %s\n", name, "scalar", nn, "", "", "", ok ? "ok" : "FALHOU");
+    if (!ok) {
+        printf("  %zu pares fora da faixa de tolerância classificados errado (marcados: %zu, contagem: %zu)\n",
+               wrong, marked, count);
+        gFailures++;
+    }
+    snprintf(name, sizeof name, "JMatrix mt (%s)", label);
+    printf("%-34s %-8s %9zu %11s %9s %11s  %s\n", name, "mt", nn, "", "", "", same ? "ok" : "FALHOU");
+    if (!same) gFailures++;
+
+    free(out); free(outMt); free(refC); free(refJ); free(inside); free(insideMt);
+}
+
+/* --- Atitude: J com alvos no corpo --- */
+
+static DVec3 RefMat3Apply(const SphMat3 *m, DVec3 v) {
+    return (DVec3){ m->m[0][0]*v.x + m->m[0][1]*v.y + m->m[0][2]*v.z,
+                    m->m[1][0]*v.x + m->m[1][1]*v.y + m->m[1][2]*v.z,
+                    m->m[2][0]*v.x + m->m[2][1]*v.y + m->m[2][2]*v.z };
+}
+
+static DVec3 RefMat3ApplyTranspose(const SphMat3 *m, DVec3 v) {
+    return (DVec3){ m->m[0][0]*v.x + m->m[1][0]*v.y + m->m[2][0]*v.z,
+                    m->m[0][1]*v.x + m->m[1][1]*v.y + m->m[2][1]*v.z,
+                    m->m[0][2]*v.x + m->m[1][2]*v.y + m->m[2][2]*v.z };
+}
+
+/** Guinada, arfagem e rolamento: nula, qualquer, arfagem de ±90° (gimbal lock) e dorso. */
+static const float kAttitudes[][3] = {
+    { 0.0f, 0.0f, 0.0f },
+    { 0.3f, -0.2f, 1.1f },
+    { 3.14159265f, 1.57079633f, 0.0f },
+    { -2.5f, -1.57079633f, 0.4f },
+    { 1.0f, 0.7f, 3.14159265f },
+};
+
+/**
+ * Alvos no corpo contra o eixo R: aleatórios e, na borda, sobre R (J = 0),
+ * antípodas de R (J = π) e a poucos µrad de um e de outro, onde o \c acos
+ * converte o erro de \f$\cos J\f$ em \f$\sqrt{2\varepsilon}\f$.
+ */
+static void TestAngleJBody(size_t n) {
+    static const double kDeltas[] = { 0.0, 1e-7, 1e-6, 1e-5, 1e-4, 1e-3, 1e-2 };
+    const size_t nd = sizeof kDeltas / sizeof *kDeltas, na = sizeof kAttitudes / sizeof *kAttitudes;
+    const size_t nEdge = 2 * nd * 64;
+    AngleSet rnd = RandomAngles(n), edge = AngleSetAlloc(nEdge);
+    float *out = Alloc((n > nEdge ? n : nEdge) * sizeof(float));
+    char name[64];
+    ErrStat s[2][2];
+
+    SphIsa saved = SphIsaActive();
+    for (int isa = 0; isa < SPH_ISA_COUNT; ++isa) {
+        if (!SphIsaSupported((SphIsa)isa) || SphIsaSelect((SphIsa)isa) != 0) continue;
+        memset(s, 0, sizeof s);
+        for (size_t k = 0; k < na; ++k) {
+            SphMat3 m = SphAttitudeMat3(kAttitudes[k][0], kAttitudes[k][1], kAttitudes[k][2]);
+            float azR = (float)Uniform(-PI_D, PI_D), elR = (float)RandomEl();
+            DVec3 r = RefAzElToVec(azR, elR);
+            // Borda: R levado ao corpo e girado de delta, ou o antípoda disso
+            DVec3 rB = RefMat3ApplyTranspose(&m, r);
+            for (size_t i = 0; i < 64; ++i) {
+                for (size_t d = 0; d < nd; ++d) {
+                    DVec3 t = Tilt(rB, kDeltas[d] * (double)(i + 1) / 64.0);
+                    size_t e = 2 * (i * nd + d);
+                    edge.az[e] = (float)atan2(t.y, t.x);
+                    edge.el[e] = (float)asin(t.z > 1.0 ? 1.0 : (t.z < -1.0 ? -1.0 : t.z));
+                    edge.az[e + 1] = edge.az[e] + (float)PI_D;
+                    edge.el[e + 1] = -edge.el[e];
+                }
+            }
+            for (int set = 0; set < 2; ++set) {
+                const AngleSet *t = set ? &edge : &rnd;
+                for (int acc = 0; acc < 2; ++acc) {
+                    SphBatchAngleJBody(&m, t->az, t->el, t->n, azR, elR, out,
+                                       acc ? SPH_ACCURACY_FAST : SPH_ACCURACY_PRECISE);
+                    for (size_t i = 0; i < t->n; ++i) {
+                        ErrAdd(&s[set][acc], out[i], RefAngle(RefMat3Apply(&m, RefAzElToVec(t->az[i], t->el[i])), r));
+                    }
+                }
+            }
+        }
+        for (int set = 0; set < 2; ++set) {
+            for (int acc = 0; acc < 2; ++acc) {
+                // acos(cos J) leva o erro e de cos J a e/sen J, até sqrt(2e) em J = 0 e em J = π:
+                // 6e-4 com o seno/cosseno preciso, 3e-2 com o rápido (5e-4)
+                snprintf(name, sizeof name, "BatchAngleJBody %s (%s)", acc ? "fast" : "precise",
+                         set ? "borda" : "aleatórios");
+                Report(name, SphIsaName((SphIsa)isa), &s[set][acc], acc ? 4e-2 : 1e-3);
+            }
+        }
+    }
+    SphIsaSelect(saved);
+    AngleSetFree(&rnd);
+    AngleSetFree(&edge);
+    free(out);
+}
+
+/* --- Mapa de cobertura --- */
+
+/**
+ * Confere \c outJ (o menor J entre os eixos) e \c outCount com a referência
+ * em double nas mesmas coordenadas de célula, e exige o mesmo resultado com e
+ * sem o pool e com cada saída pedida sozinha.
+ */
+static void TestCoverageSet(const char *label, const SphCoverageGrid *g, const float *azR, const float *elR,
+                            size_t nAxes, float halfAngle, SphPool *pool, double budget) {
+    const size_t cells = g->rows * g->cols;
+    float *outJ = Alloc(cells * sizeof(float)), *outJMt = Alloc(cells * sizeof(float));
+    uint16_t *cnt = Alloc(cells * sizeof(uint16_t)), *cntMt = Alloc(cells * sizeof(uint16_t));
+    const double thr = cos((double)halfAngle);
+    char name[64];
+    ErrStat s;
+    memset(&s, 0, sizeof s);
+
+    int okRun = SphCoverageCompute(NULL, g, azR, elR, nAxes, halfAngle, outJ, cnt) == 0;
+    okRun &= SphCoverageCompute(pool, g, azR, elR, nAxes, halfAngle, outJMt, cntMt) == 0;
+    int same = okRun && memcmp(outJ, outJMt, cells * sizeof(float)) == 0
+                     && memcmp(cnt, cntMt, cells * sizeof(uint16_t)) == 0;
+    okRun &= SphCoverageCompute(pool, g, azR, elR, nAxes, halfAngle, outJMt, NULL) == 0;
+    okRun &= SphCoverageCompute(pool, g, azR, elR, nAxes, halfAngle, NULL, cntMt) == 0;
+    same &= okRun && memcmp(outJ, outJMt, cells * sizeof(float)) == 0
+                  && memcmp(cnt, cntMt, cells * sizeof(uint16_t)) == 0;
+
+    size_t wrong = 0;
+    for (size_t i = 0; i < g->rows && okRun; ++i) {
+        // As mesmas contas em float que o kernel usa para a célula
+        const float el = g->el0 + (float)i*g->dEl;
+        for (size_t j = 0; j < g->cols; ++j) {
+            const float az = g->az0 + (float)j*g->dAz;
+            DVec3 c = RefAzElToVec(az, el);
+            double best = 4.0;
+            unsigned expect = 0, border = 0;
+            for (size_t k = 0; k < nAxes; ++k) {
+                DVec3 r = RefAzElToVec(azR[k], elR[k]);
+                double jk = RefAngle(c, r), ck = DotD(c, r);
+                if (jk < best) best = jk;
+                expect += ck >= thr;
+                border += fabs(ck - thr) <= 1e-5;
+            }
+            ErrAdd(&s, outJ[i*g->cols + j], best);
+            // Só os eixos na faixa de tolerância do limiar podem mudar a contagem
+            unsigned got = cnt[i*g->cols + j];
+            if (got + border < expect || got > expect + border) wrong++;
+        }
+    }
+    snprintf(name, sizeof name, "CoverageCompute J (%s)", label);
+    Report(name, "scalar", &s, budget);
+    snprintf(name, sizeof name, "CoverageCompute FOV (%s)", label);
+    printf("%-34s %-8s %9zu %11s %9s %11s  %s\n", name, "scalar", cells, "", "", "",
+           okRun && wrong == 0 ? "ok" : "FALHOU");
+    if (!okRun || wrong != 0) {
+        printf("  %zu células com contagem fora da faixa de tolerância\n", wrong);
+        gFailures++;
+    }
+    snprintf(name, sizeof name, "CoverageCompute mt (%s)", label);
+    printf("%-34s %-8s %9zu %11s %9s %11s  %s\n", name, "mt", cells, "", "", "", same ? "ok" : "FALHOU");
+    if (!same) gFailures++;
+    free(outJ); free(outJMt); free(cnt); free(cntMt);
+}
+
+static void TestCoverage(SphPool *pool) {
+    // Esfera inteira contra eixos aleatórios
+    float azR[8], elR[8];
+    for (size_t k = 0; k < 8; ++k) {
+        azR[k] = (float)Uniform(-PI_D, PI_D);
+        elR[k] = (float)RandomEl();
+    }
+    SphCoverageGrid full = SphCoverageGridFull(0.02f);
+    TestCoverageSet("esfera, 8 eixos", &full, azR, elR, 8, 0.5f, pool, 2e-4);
+
+    // Borda: células sobre o eixo (J = 0) e na antípoda (J = π), eixos no polo e
+    // em ±π, passos negativos e restos de bloco nas linhas e nas colunas
+    const float pi = (float)PI_D, halfPi = (float)(0.5 * PI_D);
+    const float azE[] = { 0.3f, pi, -pi, 0.0f, 0.3f + pi };
+    const float elE[] = { 0.2f, 0.0f, halfPi, -halfPi, -0.2f };
+    SphCoverageGrid g = { 0.3f, 0.2f, 2.5e-4f, -2.5e-4f, 2 * SPH_COVERAGE_TILE_COLS + 5, SPH_COVERAGE_TILE_ROWS + 3 };
+    TestCoverageSet("borda: J = 0", &g, azE, elE, 1, 1e-3f, pool, 1e-3);
+    TestCoverageSet("borda: J = π", &g, azE + 4, elE + 4, 1, (float)PI_D - 1e-3f, pool, 1e-3);
+    g = (SphCoverageGrid){ pi - 0.05f, halfPi - 0.05f, 1e-4f, 1e-4f, 1001, 1001 };
+    TestCoverageSet("borda: polo e ±π", &g, azE + 1, elE + 1, 3, 0.04f, pool, 1e-3);
+}
+
+/* --- Geodésia --- */
+
+typedef struct GeoSet {
+    size_t n;
+    float *lat1, *lon1, *lat2, *lon2, *latP, *lonP;
+} GeoSet;
+
+static GeoSet GeoSetAlloc(size_t n) {
+    GeoSet g = { n, Alloc(n * sizeof(float)), Alloc(n * sizeof(float)), Alloc(n * sizeof(float)),
+                 Alloc(n * sizeof(float)), Alloc(n * sizeof(float)), Alloc(n * sizeof(float)) };
+    return g;
+}
+
+static void GeoSetFree(GeoSet *g) {
+    free(g->lat1); free(g->lon1); free(g->lat2); free(g->lon2); free(g->latP); free(g->lonP);
+}
+
+static double WrapPi(double a) { return remainder(a, 2.0 * PI_D); }
+
+/** Posição a \c delta rad de (lat, lon) no rumo \c bearing, por extenso em double. */
+static void RefDestination(double lat, double lon, double bearing, double delta, float *latOut, float *lonOut) {
+    double la = asin(sin(lat)*cos(delta) + cos(lat)*sin(delta)*cos(bearing));
+    double lo = lon + atan2(sin(bearing)*sin(delta)*cos(lat), cos(delta) - sin(lat)*sin(la));
+    *latOut = (float)la;
+    *lonOut = (float)WrapPi(lo);
+}
+
+static double RefGeoDistance(float lat1, float lon1, float lat2, float lon2) {
+    return RefAngle(RefAzElToVec(lon1, lat1), RefAzElToVec(lon2, lat2));
+}
+
+static double RefGeoBearing(float lat1, float lon1, float lat2, float lon2) {
+    double dLon = (double)lon2 - lon1;
+    return atan2(sin(dLon)*cos(lat2), cos(lat1)*sin(lat2) - sin(lat1)*cos(lat2)*cos(dLon));
+}
+
+static double RefGeoCrossTrack(const GeoSet *g, size_t i) {
+    if (g->lat1[i] == g->lat2[i] && g->lon1[i] == g->lon2[i]) return 0.0;
+    double d = RefGeoDistance(g->lat1[i], g->lon1[i], g->latP[i], g->lonP[i]);
+    double b = RefGeoBearing(g->lat1[i], g->lon1[i], g->latP[i], g->lonP[i])
+             - RefGeoBearing(g->lat1[i], g->lon1[i], g->lat2[i], g->lon2[i]);
+    double x = sin(d)*sin(b);
+    return asin(x > 1.0 ? 1.0 : (x < -1.0 ? -1.0 : x));
+}
+
+/** Rotas e pontos P uniformes na esfera (limitados a ±89°). */
+static GeoSet RandomGeo(size_t n) {
+    GeoSet g = GeoSetAlloc(n);
+    for (size_t i = 0; i < n; ++i) {
+        g.lat1[i] = (float)RandomEl(); g.lon1[i] = (float)Uniform(-PI_D, PI_D);
+        g.lat2[i] = (float)RandomEl(); g.lon2[i] = (float)Uniform(-PI_D, PI_D);
+        g.latP[i] = (float)RandomEl(); g.lonP[i] = (float)Uniform(-PI_D, PI_D);
+    }
+    return g;
+}
+
+/** Rotas curtas, de 6 m a 6000 km (\f$10^{-6}\f$ a 1 rad), com P perto da rota. */
+static GeoSet ShortGeo(size_t n) {
+    GeoSet g = GeoSetAlloc(n);
+    for (size_t i = 0; i < n; ++i) {
+        double lat = RandomEl(), lon = Uniform(-PI_D, PI_D), b = Uniform(-PI_D, PI_D);
+        double d = pow(10.0, Uniform(-6.0, 0.0));
+        g.lat1[i] = (float)lat; g.lon1[i] = (float)lon;
+        RefDestination(g.lat1[i], g.lon1[i], b, d, &g.lat2[i], &g.lon2[i]);
+        RefDestination(g.lat1[i], g.lon1[i], b + Uniform(-0.5, 0.5) * PI_D, d * Uniform(0.1, 2.0),
+                       &g.latP[i], &g.lonP[i]);
+    }
+    return g;
+}
+
+/**
+ * Casos de borda, 14 por posição de partida (polos inclusive): ponto repetido,
+ * rumo Sul exato e a um float de ±π, antimeridiano, antípodas e quase
+ * antípodas (haversine com \f$h \to 1\f$) e P a quase 90° da rota, com o
+ * argumento do \c asin do desvio lateral perto de ±1.
+ */
+static GeoSet EdgeGeo(void) {
+    const size_t bases = 64, perBase = 14;
+    GeoSet g = GeoSetAlloc(bases * perBase);
+    const float pi = (float)PI_D;
+    size_t k = 0;
+    for (size_t i = 0; i < bases; ++i) {
+        float lat = i < 2 ? (i ? -1.0f : 1.0f) * (float)(0.5 * PI_D) : (float)RandomEl();
+        float lon = i == 2 ? pi : (i == 3 ? -pi : (float)Uniform(-PI_D, PI_D));
+        float south = lat - 0.3f < -(float)(0.5 * PI_D) ? lat + 0.3f : lat - 0.3f;
+        float cases[][4] = {
+            { lat, lon, lat, lon },                                           // ponto repetido
+            { lat, lon, south, lon },                                         // rumo ±π ou 0
+            { lat, lon, south, nextafterf(lon, 10.0f) },
+            { lat, lon, south, nextafterf(lon, -10.0f) },
+            { lat, pi - 1e-3f, lat, -pi + 1e-3f },                            // antimeridiano
+            { lat, -pi + 1e-3f, lat, pi - 1e-3f },
+            { lat, lon, -lat, (float)WrapPi((double)lon + PI_D) },            // antípodas
+            { lat, lon, -lat + 1e-3f, (float)WrapPi((double)lon + PI_D) },
+            { lat, lon, -lat, (float)WrapPi((double)lon + PI_D - 1e-2) },
+        };
+        for (size_t c = 0; c < sizeof cases / sizeof *cases; ++c, ++k) {
+            g.lat1[k] = cases[c][0]; g.lon1[k] = cases[c][1];
+            g.lat2[k] = cases[c][2]; g.lon2[k] = cases[c][3];
+            g.latP[k] = g.lat2[k]; g.lonP[k] = g.lon2[k];
+        }
+        // P a 90° - e da partida, a 90° do rumo da rota: desvio lateral perto de ±π/2
+        float lat2, lon2;
+        double b = Uniform(-PI_D, PI_D);
+        RefDestination(lat, lon, b, 0.5, &lat2, &lon2);
+        static const double kOff[] = { 0.0, 1e-6, 1e-4, 1e-2, 0.3 };
+        for (size_t c = 0; c < sizeof kOff / sizeof *kOff; ++c, ++k) {
+            g.lat1[k] = lat; g.lon1[k] = lon;
+            g.lat2[k] = lat2; g.lon2[k] = lon2;
+            double b12 = RefGeoBearing(lat, lon, lat2, lon2);
+            RefDestination(lat, lon, b12 + (c & 1 ? -0.5 : 0.5) * PI_D, 0.5 * PI_D - kOff[c],
+                           &g.latP[k], &g.lonP[k]);
+        }
+    }
+    g.n = k;
+    return g;
+}
+
+/**
+ * Lotes de distância, rumo e desvio lateral em cada ISA e precisão. O rumo é
+ * comparado módulo 2π (±π são o mesmo rumo) e fica de fora a menos de
+ * \c minBearingDistance rad do ponto de partida ou da sua antípoda, onde deixa
+ * de ser definido: o cancelamento no \c atan2 em float vale ~1e-7/sen δ rad.
+ */
+static void TestGeoSet(const char *label, const GeoSet *g, const double budget[2][3], double minBearingDistance) {
+    const size_t n = g->n;
+    float *out = Alloc(n * sizeof(float));
+    double *refD = Alloc(n * sizeof(double)), *refB = Alloc(n * sizeof(double)), *refX = Alloc(n * sizeof(double));
+    for (size_t i = 0; i < n; ++i) {
+        refD[i] = RefGeoDistance(g->lat1[i], g->lon1[i], g->lat2[i], g->lon2[i]);
+        refB[i] = RefGeoBearing(g->lat1[i], g->lon1[i], g->lat2[i], g->lon2[i]);
+        refX[i] = RefGeoCrossTrack(g, i);
+    }
+    char name[64];
+    ErrStat s;
+
+    SphIsa saved = SphIsaActive();
+    for (int isa = 0; isa < SPH_ISA_COUNT; ++isa) {
+        if (!SphIsaSupported((SphIsa)isa) || SphIsaSelect((SphIsa)isa) != 0) continue;
+        const char *isaName = SphIsaName((SphIsa)isa);
+        for (int acc = 0; acc < 2; ++acc) {
+            SphAccuracy a = acc ? SPH_ACCURACY_FAST : SPH_ACCURACY_PRECISE;
+            memset(&s, 0, sizeof s);
+            SphBatchHaversine(g->lat1, g->lon1, g->lat2, g->lon2, n, out, a);
+            for (size_t i = 0; i < n; ++i) ErrAdd(&s, out[i], refD[i]);
+            snprintf(name, sizeof name, "BatchHaversine %s (%s)", acc ? "fast" : "precise", label);
+            Report(name, isaName, &s, budget[acc][0]);
+
+            memset(&s, 0, sizeof s);
+            SphBatchInitialBearing(g->lat1, g->lon1, g->lat2, g->lon2, n, out, a);
+            for (size_t i = 0; i < n; ++i) {
+                if (refD[i] >= minBearingDistance && refD[i] <= PI_D - minBearingDistance) ErrAdd(&s, refB[i] + WrapPi(out[i] - refB[i]), refB[i]);
+            }
+            snprintf(name, sizeof name, "BatchInitialBearing %s (%s)", acc ? "fast" : "precise", label);
+            Report(name, isaName, &s, budget[acc][1]);
+
+            memset(&s, 0, sizeof s);
+            SphBatchCrossTrack(g->lat1, g->lon1, g->lat2, g->lon2, g->latP, g->lonP, n, out, a);
+            for (size_t i = 0; i < n; ++i) ErrAdd(&s, out[i], refX[i]);
+            snprintf(name, sizeof name, "BatchCrossTrack %s (%s)", acc ? "fast" : "precise", label);
+            Report(name, isaName, &s, budget[acc][2]);
+        }
+    }
+    SphIsaSelect(saved);
+    free(out); free(refD); free(refB); free(refX);
+}
+
+/**
+ * Matriz N × M com \c atan2(|a × b|, a · b) e a janela por corda: os pares
+ * aceitos têm a distância da matriz, e um par só pode ficar do lado errado da
+ * janela se estiver a 1e-5 rad dela.
+ */
+static void TestAllPairsSet(const char *label, const PairSet *p, size_t n, size_t m, float window,
+                            SphPool *pool, double budget) {
+    const size_t nn = n * m;
+    float *out = Alloc(nn * sizeof(float)), *outMt = Alloc(nn * sizeof(float));
+    double *ref = Alloc(nn * sizeof(double));
+    unsigned char *seen = Alloc(nn);
+    char name[64];
+    ErrStat s;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < m; ++j) ref[i*m + j] = RefAngle(ToD(PairA(p, i)), ToD(PairB(p, j)));
+    }
+
+    memset(&s, 0, sizeof s);
+    int okRun = SphAllPairsDistance(NULL, p->ax, p->ay, p->az, n, p->bx, p->by, p->bz, m, out) == 0;
+    okRun &= SphAllPairsDistance(pool, p->ax, p->ay, p->az, n, p->bx, p->by, p->bz, m, outMt) == 0;
+    for (size_t k = 0; k < nn; ++k) ErrAdd(&s, out[k], ref[k]);
+    if (!okRun) s.count = 0;
+    snprintf(name, sizeof name, "AllPairsDistance (%s)", label);
+    Report(name, "scalar", &s, budget);
+    int same = okRun && memcmp(out, outMt, nn * sizeof(float)) == 0;
+    snprintf(name, sizeof name, "AllPairsDistance mt (%s)", label);
+    printf("%-34s %-8s %9zu %11s %9s %11s  %s\n", name, "mt", nn, "", "", "", same ? "ok" : "FALHOU");
+    if (!same) gFailures++;
+
+    size_t count = SphAllPairsGate(p->ax, p->ay, p->az, n, p->bx, p->by, p->bz, m, window, NULL, 0);
+    SphGeoPair *pairs = Alloc((count + 1) * sizeof(SphGeoPair));
+    size_t found = SphAllPairsGate(p->ax, p->ay, p->az, n, p->bx, p->by, p->bz, m, window, pairs, count);
+    size_t half = SphAllPairsGate(p->ax, p->ay, p->az, n, p->bx, p->by, p->bz, m, window, pairs, count / 2);
+    size_t wrong = 0;
+    memset(seen, 0, nn);
+    memset(&s, 0, sizeof s);
+    for (size_t k = 0; k < found && k < count; ++k) {
+        size_t ij = (size_t)pairs[k].i * m + pairs[k].j;
+        if (pairs[k].i >= n || pairs[k].j >= m || seen[ij]) { wrong++; continue; }
+        seen[ij] = 1;
+        ErrAdd(&s, pairs[k].distance, ref[ij]);
+    }
+    for (size_t k = 0; k < nn; ++k) {
+        if (seen[k] != (ref[k] <= window) && fabs(ref[k] - window) > 1e-5) wrong++;
+    }
+    snprintf(name, sizeof name, "AllPairsGate (%s)", label);
+    Report(name, "scalar", &s, budget);
+    int ok = wrong == 0 && found == count && half == count;
+    snprintf(name, sizeof name, "AllPairsGate janela (%s)", label);
+    printf("%-34s %-8s %9zu %11s %9s %11s  %s\n", name, "scalar", nn, "", "", "", ok ? "ok" : "FALHOU");
+    if (!ok) {
+        printf("  %zu pares classificados errado (contagem: %zu, com saída: %zu, truncada: %zu)\n",
+               wrong, count, found, half);
+        gFailures++;
+    }
+    free(out); free(outMt); free(ref); free(seen); free(pairs);
+}
+
+/* --- Desempenho --- */
+
+static double NowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+typedef struct PerfData {
+    size_t n;
+    AngleSet t;
+    PairSet p;
+    float *x, *y, *z, *out;
+    SphVec3 *vo;
+    SphSlerpBatch basis;
+    uint16_t *azQ;
+    int16_t *elQ;
+} PerfData;
+
+typedef void (*PerfFn)(PerfData *d);
+
+static volatile float gSink;
+
+static void PAzElScalar(PerfData *d) {
+    for (size_t i = 0; i < d->n; ++i) d->vo[i] = SphAzElToVec(d->t.az[i], d->t.el[i]);
+    gSink = d->vo[d->n - 1].x;
+}
+static void PAzElSimd(PerfData *d) {
+    SphAzElToVecSimd(d->t.az, d->t.el, d->n, d->x, d->y, d->z, SPH_ACCURACY_PRECISE);
+    gSink = d->x[d->n - 1];
+}
+static void PAzElNedDeg(PerfData *d) {
+    SphBatchAzElToVecNedDeg(d->t.az, d->t.el, d->n, d->x, d->y, d->z, SPH_ACCURACY_PRECISE);
+    gSink = d->x[d->n - 1];
+}
+static void PAzElQ16Scalar(PerfData *d) {
+    for (size_t i = 0; i < d->n; ++i) d->vo[i] = SphAzElQ16ToVec(d->azQ[i], d->elQ[i], SPH_ACCURACY_PRECISE);
+    gSink = d->vo[d->n - 1].x;
+}
+static void PAzElQ16Batch(PerfData *d) {
+    SphBatchAzElQ16ToVec(d->azQ, d->elQ, d->n, d->x, d->y, d->z, SPH_ACCURACY_PRECISE);
+    gSink = d->x[d->n - 1];
+}
+static void PAngleScalar(PerfData *d) {
+    for (size_t i = 0; i < d->n; ++i) d->out[i] = SphAngleBetweenUnit(PairA(&d->p, i), PairB(&d->p, i));
+    gSink = d->out[d->n - 1];
+}
+static void PAngleBatch(PerfData *d) {
+    SphBatchAngleBetweenUnit(d->p.ax, d->p.ay, d->p.az, d->p.bx, d->p.by, d->p.bz, d->n, d->out);
+    gSink = d->out[d->n - 1];
+}
+static void PSlerpScalar(PerfData *d) {
+    for (size_t i = 0; i < d->n; ++i) d->vo[i] = SphSlerpUnit(PairA(&d->p, i), PairB(&d->p, i), 0.3f);
+    gSink = d->vo[d->n - 1].x;
+}
+static void PSlerpSimd(PerfData *d) {
+    SphSlerpEvalSimd(&d->basis, d->n, 0.3f, d->x, d->y, d->z, SPH_ACCURACY_PRECISE);
+    gSink = d->x[d->n - 1];
+}
+static void PCosJScalar(PerfData *d) {
+    for (size_t i = 0; i < d->n; ++i) d->out[i] = SphCosJ(d->t.az[i], d->t.el[i], 0.3f, 0.1f);
+    gSink = d->out[d->n - 1];
+}
+static void PCosJBatch(PerfData *d) {
+    SphBatchCosJ(d->t.az, d->t.el, d->n, 0.3f, 0.1f, d->out);
+    gSink = d->out[d->n - 1];
+}
+// Matriz J: 16 eixos (A) × n/16 alvos (B), n pares
+static void PJMatrixNested(PerfData *d) {
+    const size_t m = d->n / 16;
+    for (size_t i = 0; i < 16; ++i)
+        for (size_t j = 0; j < m; ++j) d->out[i*m + j] = SphAngleBetweenUnit(PairA(&d->p, i), PairB(&d->p, j));
+    gSink = d->out[d->n - 1];
+}
+static void PJMatrix(PerfData *d) {
+    SphJMatrix(NULL, d->p.ax, d->p.ay, d->p.az, 16, d->p.bx, d->p.by, d->p.bz, d->n / 16,
+               SPH_ACCURACY_PRECISE, d->out);
+    gSink = d->out[d->n - 1];
+}
+
+/** Melhor tempo por elemento (ns) em \c reps rodadas de pelo menos \c minTime s. */
+static double TimeNs(PerfFn fn, PerfData *d, double minTime, int reps) {
+    double best = INFINITY;
+    for (int r = 0; r < reps; ++r) {
+        long iters = 0;
+        double t0 = NowSeconds(), t1;
+        do {
+            fn(d);
+            ++iters;
+            t1 = NowSeconds();
+        } while (t1 - t0 < minTime);
+        double ns = (t1 - t0) * 1e9 / ((double)iters * (double)d->n);
+        if (ns < best) best = ns;
+    }
+    return best;
+}
+
+/**
+ * Orçamentos de vazão. \c minSpeedup compara com a versão escalar do mesmo
+ * cálculo (vale em qualquer máquina); 0 dispensa. \c simdOnly liga a razão
+ * só quando a ISA ativa não é a escalar. \c maxNs é o teto absoluto por
+ * elemento (multiplicado por \c --budget-scale).
+ */
+typedef struct PerfCase {
+    const char *name;
+    PerfFn fn, baseline;
+    double minSpeedup;
+    int simdOnly;
+    double maxNs;
+} PerfCase;
+
+static const PerfCase kPerf[] = {
+    { "AzElToVecSimd precise", PAzElSimd, PAzElScalar, 3.0, 1, 8.0 },
+    { "BatchAzElToVecNedDeg", PAzElNedDeg, PAzElScalar, 3.0, 1, 8.0 },
+    // Contra a tabela elemento a elemento: o lote perdia para o SIMD em radianos
+    { "BatchAzElQ16ToVec precise", PAzElQ16Batch, PAzElQ16Scalar, 3.0, 1, 8.0 },
+    { "BatchAngleBetweenUnit", PAngleBatch, PAngleScalar, 0.8, 0, 40.0 },
+    { "SlerpEvalSimd precise", PSlerpSimd, PSlerpScalar, 3.0, 1, 8.0 },
+    { "BatchCosJ", PCosJBatch, PCosJScalar, 0.8, 0, 60.0 },
+    { "JMatrix precise", PJMatrix, PJMatrixNested, 3.0, 0, 10.0 },
+};
+
+static int RunPerf(double budgetScale) {
+    PerfData d;
+    d.n = 4096; // entradas e saídas cabem na L2: mede o kernel, não a DRAM
+    d.t = RandomAngles(d.n);
+    d.p = RandomPairs(d.n);
+    d.x = Alloc(d.n * sizeof(float)); d.y = Alloc(d.n * sizeof(float)); d.z = Alloc(d.n * sizeof(float));
+    d.out = Alloc(d.n * sizeof(float));
+    d.vo = Alloc(d.n * sizeof(SphVec3));
+    d.basis.ux = Alloc(d.n * sizeof(float)); d.basis.uy = Alloc(d.n * sizeof(float));
+    d.basis.uz = Alloc(d.n * sizeof(float)); d.basis.wx = Alloc(d.n * sizeof(float));
+    d.basis.wy = Alloc(d.n * sizeof(float)); d.basis.wz = Alloc(d.n * sizeof(float));
+    d.basis.theta = Alloc(d.n * sizeof(float));
+    SphBatchSlerpPrepare(d.p.ax, d.p.ay, d.p.az, d.p.bx, d.p.by, d.p.bz, d.n, &d.basis);
+    d.azQ = Alloc(d.n * sizeof *d.azQ);
+    d.elQ = Alloc(d.n * sizeof *d.elQ);
+    for (size_t i = 0; i < d.n; ++i) {
+        d.azQ[i] = (uint16_t)Uniform(0.0, 65536.0);
+        d.elQ[i] = (int16_t)Uniform(-16384.0, 16385.0);
+    }
+
+#ifdef NDEBUG
+    const int enforce = 1;
+#else
+    const int enforce = 0;
+#endif
+    int simd = SphIsaActive() != SPH_ISA_SCALAR;
+    printf("ISA: %s%s\n", SphIsaName(SphIsaActive()),
+           enforce ? "" : " | build sem NDEBUG: orçamentos só informativos");
+    printf("%-26s %10s %10s %9s %9s %11s  %s\n", "Kernel", "ns/elem", "escalar", "ganho", "mínimo", "teto ns", "");
+    printf("-----------------------------------------------------------------------------------------\n");
+    int failures = 0;
+    for (size_t c = 0; c < sizeof kPerf / sizeof *kPerf; ++c) {
+        const PerfCase *pc = &kPerf[c];
+        double ns = TimeNs(pc->fn, &d, 0.05, 5);
+        double base = TimeNs(pc->baseline, &d, 0.05, 5);
+        double speedup = base / ns;
+        double minSpeedup = pc->simdOnly && !simd ? 0.0 : pc->minSpeedup;
+        double maxNs = pc->maxNs * budgetScale;
+        int ok = speedup >= minSpeedup && ns <= maxNs;
+        printf("%-26s %10.3f %10.3f %8.2fx %8.2fx %11.1f  %s\n", pc->name, ns, base, speedup, minSpeedup, maxNs,
+               ok ? "ok" : enforce ? "FALHOU" : "(acima do orçamento)");
+        if (!ok && enforce) failures++;
+    }
+
+    AngleSetFree(&d.t);
+    PairSetFree(&d.p);
+    free(d.x); free(d.y); free(d.z); free(d.out); free(d.vo);
+    free(d.basis.ux); free(d.basis.uy); free(d.basis.uz);
+    free(d.basis.wx); free(d.basis.wy); free(d.basis.wz); free(d.basis.theta);
+    free(d.azQ); free(d.elQ);
+    return failures;
+}
+
+/* --- Principal --- */
+
+static void Usage(void) {
+    fprintf(stderr, "uso: spherical_accuracy [--n count] [--seed s]\n"
+                    "     spherical_accuracy --perf [--budget-scale f]\n");
+}
+
+int main(int argc, char **argv) {
+    size_t n = 200000;
+    int perf = 0;
+    double budgetScale = 1.0;
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(a, "--perf") == 0) perf = 1;
+        else if (strcmp(a, "--n") == 0 && v) { n = (size_t)strtoul(v, NULL, 10); ++i; }
+        else if (strcmp(a, "--seed") == 0 && v) { SeedRng(strtoull(v, NULL, 10)); ++i; }
+        else if (strcmp(a, "--budget-scale") == 0 && v) { budgetScale = strtod(v, NULL); ++i; }
+        else { Usage(); return 2; }
+    }
+    if (n < 16) n = 16;
+
+    if (perf) {
+        int failures = RunPerf(budgetScale);
+        printf("\n%s\n", failures ? "desempenho: FALHOU" : "desempenho: ok");
+        return failures ? 1 : 0;
+    }
+
+    AngleSet rnd = RandomAngles(n), edge = EdgeAngles();
+    PrintHeader("Az/El -> vetor");
+    TestAzElSet("aleatórios", &rnd);
+    TestAzElSet("borda", &edge);
+    TestQ16(n);
+
+    PairSet pr = RandomPairs(n), pe = EdgePairs(1, 0.0);
+    PrintHeader("Ângulo entre vetores unitários");
+    TestAngleSet("aleatórios", &pr, 0);
+    TestAngleSet("borda", &pe, 1);
+    TestAcosApprox();
+
+    // Pares Az/El: aleatórios e T = R, T antípoda de R e polos, a partir das entradas de borda
+    AngleSet rr = RandomAngles(n);
+    AngleSet et = AngleSetAlloc(3 * edge.n), er = AngleSetAlloc(3 * edge.n);
+    for (size_t i = 0; i < edge.n; ++i) {
+        et.az[3*i] = edge.az[i];     et.el[3*i] = edge.el[i];
+        er.az[3*i] = edge.az[i];     er.el[3*i] = edge.el[i];        // T = R
+        et.az[3*i+1] = edge.az[i];   et.el[3*i+1] = edge.el[i];
+        er.az[3*i+1] = edge.az[i] + (float)PI_D; er.el[3*i+1] = -edge.el[i]; // antípoda
+        et.az[3*i+2] = edge.az[i];   et.el[3*i+2] = edge.el[i];
+        er.az[3*i+2] = edge.az[(i * 7) % edge.n]; er.el[3*i+2] = edge.el[(i * 7) % edge.n];
+    }
+    PrintHeader("J a partir de Az/El e cos J analítico");
+    TestAngleJSet("aleatórios", &rnd, &rr, 0);
+    TestAngleJSet("borda", &et, &er, 1);
+
+    // Quase antípodas abaixo de 1e-3 rad não têm arco bem condicionado em float
+    PairSet ps = EdgePairs(0, 1e-3);
+    PrintHeader("Slerp");
+    TestSlerpSet("aleatórios", &pr, 5e-5, 3e-6, 4e-4);
+    TestSlerpSet("borda", &ps, 2e-4, 5e-5, 4e-4);
+    TestSlerpAntipodal();
+    TestSlerpUniform();
+
+    // 70 eixos: um bloco inteiro de linhas e um resto que não fecha um micronúcleo
+    SphPool *pool = SphPoolCreate(4);
+    PrintHeader("Matriz J (eixos × alvos)");
+    TestJMatrixSet("aleatórios", &pr, n < 70 ? n : 70, n < 2500 ? n : 2500, pool, 0);
+    TestJMatrixSet("borda", &pe, pe.n, pe.n, pool, 1);
+
+    PrintHeader("Alvos no corpo da aeronave");
+    TestAngleJBody(n);
+
+    PrintHeader("Mapa de cobertura");
+    TestCoverage(pool);
+
+    // Orçamentos {haversine, rumo, desvio lateral}, preciso e rápido. Perto das
+    // antípodas (h -> 1) e do argumento ±1 do asin, o erro e das somas vira
+    // ~sqrt(2e) rad: até 5e-4 com o seno/cosseno preciso e 3e-2 com o rápido (5e-4)
+    static const double kGeoRandom[2][3] = { { 1e-4, 2e-5, 5e-5 }, { 5e-2, 1e-2, 5e-2 } };
+    static const double kGeoShort[2][3] = { { 5e-7, 5e-5, 3e-6 }, { 1e-3, 5e-2, 2e-3 } };
+    static const double kGeoEdge[2][3] = { { 1e-3, 5e-5, 1e-3 }, { 2e-2, 1e-2, 2e-3 } };
+    GeoSet gr = RandomGeo(n), gs = ShortGeo(n), ge = EdgeGeo();
+    PrintHeader("Geodésia");
+    TestGeoSet("aleatórios", &gr, kGeoRandom, 1e-2);
+    TestGeoSet("curtas", &gs, kGeoShort, 1e-2);
+    TestGeoSet("borda", &ge, kGeoEdge, 1e-2);
+    // 200 × 3000: restos de bloco nas linhas e nas colunas
+    TestAllPairsSet("aleatórios", &pr, n < 200 ? n : 200, n < 3000 ? n : 3000, 0.2f, pool, 5e-7);
+    TestAllPairsSet("borda", &pe, pe.n, pe.n, 1e-3f, pool, 5e-7);
+    TestAllPairsSet("borda, janela π", &pe, 64, pe.n, (float)PI_D, pool, 5e-7);
+    GeoSetFree(&gr); GeoSetFree(&gs); GeoSetFree(&ge);
+    SphPoolDestroy(pool);
+
+    AngleSetFree(&rnd); AngleSetFree(&edge); AngleSetFree(&rr);
+    AngleSetFree(&et); AngleSetFree(&er);
+    PairSetFree(&pr); PairSetFree(&pe); PairSetFree(&ps);
+
+    printf("\n%s (%d falhas)\n", gFailures ? "precisão: FALHOU" : "precisão: ok", gFailures);
+    return gFailures ? 1 : 0;
+}
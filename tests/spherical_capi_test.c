@@ -0,0 +1,207 @@
+/**
+ * \file spherical_capi_test.c
+ * \brief Teste da ABI C da \c libspherical, ligado só à biblioteca compartilhada.
+ *
+ * Como o binding Python, este programa só enxerga \ref spherical_capi.h: cada
+ * função \c SphLib* é chamada com entradas válidas (e comparada com uma
+ * referência em \c double), com parâmetros inválidos (tem de voltar -1, sem
+ * abortar) e com \c n = 0. Por fim, várias threads chamam a biblioteca ao
+ * mesmo tempo e têm de obter os mesmos números que uma thread sozinha.
+ *
+ * Uso:
+ * \code
+ * spherical_capi_test
+ * \endcode
+ */
+#include "spherical_capi.h"
+
+#include "test_util.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#define CAPI_TEST_THREADS 4
+#endif
+
+#define PI_D 3.14159265358979323846
+#define N 4096
+
+static void CheckErr(const char *what, double err, double budget) {
+    printf("%-52s %11.3e <= %9.1e  %s\n", what, err, budget, err <= budget ? "ok" : "FALHOU");
+    if (!(err <= budget)) gFailures++;
+}
+
+static float azT[N], elT[N], azR[N], elR[N];
+static float ax[N], ay[N], az[N], bx[N], by[N], bz[N];
+static float out[N];
+static unsigned char inside[N];
+
+static double RefAngleF(double x1, double y1, double z1, double x2, double y2, double z2) {
+    double cx = y1*z2 - z1*y2, cy = z1*x2 - x1*z2, cz = x1*y2 - y1*x2;
+    return atan2(sqrt(cx*cx + cy*cy + cz*cz), x1*x2 + y1*y2 + z1*z2);
+}
+
+static double RefAngleJ(double aT, double eT, double aR, double eR) {
+    return RefAngleF(cos(eT)*cos(aT), cos(eT)*sin(aT), sin(eT), cos(eR)*cos(aR), cos(eR)*sin(aR), sin(eR));
+}
+
+static double RefHaversine(double lat1, double lon1, double lat2, double lon2) {
+    double s1 = sin(0.5*(lat2 - lat1)), s2 = sin(0.5*(lon2 - lon1));
+    double h = s1*s1 + cos(lat1)*cos(lat2)*s2*s2;
+    return 2.0 * asin(sqrt(h < 1.0 ? h : 1.0));
+}
+
+static void TestVersion(void) {
+    Check(SphLibAbiVersion() == SPH_LIB_ABI_VERSION, "SphLibAbiVersion == SPH_LIB_ABI_VERSION");
+    const char *isa = SphLibIsaName();
+    Check(isa && isa[0] && strcmp(isa, "unknown") != 0, "SphLibIsaName");
+    if (isa) printf("  ISA: %s\n", isa);
+}
+
+static void TestAzElToVec(void) {
+    static const int kAcc[] = { SPH_LIB_PRECISE, SPH_LIB_FAST };
+    static const double kBudget[] = { 5e-7, 5e-4 };
+    for (int k = 0; k < 2; ++k) {
+        int rc = SphLibAzElToVec(azT, elT, N, ax, ay, az, kAcc[k]);
+        double err = rc == 0 ? 0.0 : INFINITY;
+        for (size_t i = 0; i < N && rc == 0; ++i) {
+            double ce = cos((double)elT[i]);
+            double e = fmax(fabs(ax[i] - ce*cos((double)azT[i])), fabs(ay[i] - ce*sin((double)azT[i])));
+            err = fmax(err, fmax(e, fabs(az[i] - sin((double)elT[i]))));
+        }
+        CheckErr(k ? "SphLibAzElToVec fast" : "SphLibAzElToVec precise", err, kBudget[k]);
+    }
+    Check(SphLibAzElToVec(azT, elT, N, ax, ay, az, 7) == -1, "SphLibAzElToVec: precisão inválida -> -1");
+    Check(SphLibAzElToVec(NULL, elT, N, ax, ay, az, SPH_LIB_PRECISE) == -1, "SphLibAzElToVec: NULL -> -1");
+    Check(SphLibAzElToVec(NULL, NULL, 0, NULL, NULL, NULL, SPH_LIB_PRECISE) == 0, "SphLibAzElToVec: n = 0 -> 0");
+}
+
+static void TestAngleBetween(void) {
+    static const int kModes[] = { SPH_LIB_ANGLE_ACOSF, SPH_LIB_ANGLE_ACOSD, SPH_LIB_ANGLE_ATAN2 };
+    static const char *const kNames[] = { "SphLibAngleBetween acosf", "SphLibAngleBetween acosd",
+                                          "SphLibAngleBetween atan2" };
+    static const double kBudget[] = { 2e-4, 2e-4, 1e-6 };
+    SphLibAzElToVec(azT, elT, N, ax, ay, az, SPH_LIB_PRECISE);
+    SphLibAzElToVec(azR, elR, N, bx, by, bz, SPH_LIB_PRECISE);
+    for (int k = 0; k < 3; ++k) {
+        int rc = SphLibAngleBetween(ax, ay, az, bx, by, bz, N, out, kModes[k]);
+        double err = rc == 0 ? 0.0 : INFINITY;
+        for (size_t i = 0; i < N && rc == 0; ++i)
+            err = fmax(err, fabs(out[i] - RefAngleF(ax[i], ay[i], az[i], bx[i], by[i], bz[i])));
+        CheckErr(kNames[k], err, kBudget[k]);
+    }
+    Check(SphLibAngleBetween(ax, ay, az, bx, by, bz, N, out, 3) == -1, "SphLibAngleBetween: modo inválido -> -1");
+    Check(SphLibAngleBetween(ax, ay, az, bx, by, bz, N, NULL, 0) == -1, "SphLibAngleBetween: NULL -> -1");
+    Check(SphLibAngleBetween(NULL, NULL, NULL, NULL, NULL, NULL, 0, NULL, 0) == 0, "SphLibAngleBetween: n = 0 -> 0");
+}
+
+static void TestAngleJ(void) {
+    int rc = SphLibAngleJ(azT, elT, N, azR[0], elR[0], out);
+    double err = rc == 0 ? 0.0 : INFINITY;
+    for (size_t i = 0; i < N && rc == 0; ++i) err = fmax(err, fabs(out[i] - RefAngleJ(azT[i], elT[i], azR[0], elR[0])));
+    CheckErr("SphLibAngleJ", err, 2e-4);
+    Check(SphLibAngleJ(azT, NULL, N, 0.0f, 0.0f, out) == -1, "SphLibAngleJ: NULL -> -1");
+
+    static const int kModes[] = { SPH_LIB_ANGLE_ACOSF, SPH_LIB_ANGLE_ACOSD, SPH_LIB_ANGLE_ATAN2 };
+    static const char *const kNames[] = { "SphLibAngleJPaired acosf", "SphLibAngleJPaired acosd",
+                                          "SphLibAngleJPaired atan2" };
+    static const double kBudget[] = { 2e-4, 2e-4, 2e-6 };
+    for (int k = 0; k < 3; ++k) {
+        rc = SphLibAngleJPaired(azT, elT, azR, elR, N, out, kModes[k]);
+        err = rc == 0 ? 0.0 : INFINITY;
+        for (size_t i = 0; i < N && rc == 0; ++i) err = fmax(err, fabs(out[i] - RefAngleJ(azT[i], elT[i], azR[i], elR[i])));
+        CheckErr(kNames[k], err, kBudget[k]);
+    }
+    Check(SphLibAngleJPaired(azT, elT, azR, elR, N, out, -1) == -1, "SphLibAngleJPaired: modo inválido -> -1");
+}
+
+static void TestGateJ(void) {
+    const float half = 0.5f;
+    long long count = SphLibGateJ(azT, elT, N, azR[0], elR[0], half, inside);
+    long long marked = 0, wrong = 0;
+    for (size_t i = 0; i < N; ++i) {
+        double j = RefAngleJ(azT[i], elT[i], azR[0], elR[0]);
+        marked += inside[i];
+        // Só pode discordar da referência perto do limite do cone
+        if (inside[i] != (j <= half) && fabs(j - half) > 1e-4) wrong++;
+    }
+    Check(count >= 0 && count == marked && wrong == 0, "SphLibGateJ: contagem e máscara");
+    Check(SphLibGateJ(azT, elT, N, azR[0], elR[0], half, NULL) == count, "SphLibGateJ: só contagem");
+    Check(SphLibGateJ(azT, elT, N, azR[0], elR[0], NAN, inside) == -1, "SphLibGateJ: semiângulo NaN -> -1");
+    Check(SphLibGateJ(NULL, elT, N, azR[0], elR[0], half, inside) == -1, "SphLibGateJ: NULL -> -1");
+}
+
+static void TestHaversine(void) {
+    // Pares a menos de ~1 rad: a haversine perde precisão perto das antípodas
+    static float lat2[N], lon2[N];
+    for (size_t i = 0; i < N; ++i) {
+        lat2[i] = (float)(0.5 * elT[i] + Uniform(-0.5, 0.5));
+        lon2[i] = (float)(azT[i] + Uniform(-0.5, 0.5));
+    }
+    static const int kAcc[] = { SPH_LIB_PRECISE, SPH_LIB_FAST };
+    static const double kBudget[] = { 1e-6, 1e-3 };
+    for (int k = 0; k < 2; ++k) {
+        int rc = SphLibHaversine(elT, azT, lat2, lon2, N, out, kAcc[k]);
+        double err = rc == 0 ? 0.0 : INFINITY;
+        for (size_t i = 0; i < N && rc == 0; ++i) err = fmax(err, fabs(out[i] - RefHaversine(elT[i], azT[i], lat2[i], lon2[i])));
+        CheckErr(k ? "SphLibHaversine fast" : "SphLibHaversine precise", err, kBudget[k]);
+    }
+    Check(SphLibHaversine(elT, azT, lat2, lon2, N, out, 2) == -1, "SphLibHaversine: precisão inválida -> -1");
+    Check(SphLibHaversine(elT, azT, lat2, NULL, N, out, SPH_LIB_PRECISE) == -1, "SphLibHaversine: NULL -> -1");
+}
+
+#ifdef CAPI_TEST_THREADS
+typedef struct ThreadOut {
+    float x[N], y[N], z[N], j[N];
+    int rc;
+} ThreadOut;
+
+static void *ThreadMain(void *arg) {
+    ThreadOut *t = arg;
+    t->rc = 0;
+    for (int r = 0; r < 50; ++r) {
+        t->rc |= SphLibAzElToVec(azT, elT, N, t->x, t->y, t->z, SPH_LIB_PRECISE);
+        t->rc |= SphLibAngleJPaired(azT, elT, azR, elR, N, t->j, SPH_LIB_ANGLE_ATAN2);
+    }
+    return NULL;
+}
+
+static void TestThreads(void) {
+    static ThreadOut ref, outs[CAPI_TEST_THREADS];
+    ThreadMain(&ref);
+    pthread_t th[CAPI_TEST_THREADS];
+    int ok = ref.rc == 0;
+    for (int i = 0; i < CAPI_TEST_THREADS; ++i) ok &= pthread_create(&th[i], NULL, ThreadMain, &outs[i]) == 0;
+    for (int i = 0; i < CAPI_TEST_THREADS; ++i) {
+        pthread_join(th[i], NULL);
+        ok &= outs[i].rc == 0 && memcmp(&outs[i], &ref, offsetof(ThreadOut, rc)) == 0;
+    }
+    Check(ok, "várias threads == uma thread");
+}
+#endif
+
+int main(void) {
+    for (size_t i = 0; i < N; ++i) {
+        azT[i] = (float)Uniform(-2.0 * PI_D, 2.0 * PI_D);
+        elT[i] = (float)Uniform(-0.49 * PI_D, 0.49 * PI_D);
+        azR[i] = (float)Uniform(-2.0 * PI_D, 2.0 * PI_D);
+        elR[i] = (float)Uniform(-0.49 * PI_D, 0.49 * PI_D);
+    }
+    TestVersion();
+    TestAzElToVec();
+    TestAngleBetween();
+    TestAngleJ();
+    TestGateJ();
+    TestHaversine();
+#ifdef CAPI_TEST_THREADS
+    TestThreads();
+#endif
+    printf("\n%s (%d falhas)\n", gFailures ? "ABI C: FALHOU" : "ABI C: ok", gFailures);
+    return gFailures ? 1 : 0;
+}
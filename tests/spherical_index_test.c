@@ -0,0 +1,197 @@
+/**
+ * \file spherical_index_test.c
+ * \brief Teste do índice espacial (\ref spherical_index.h) contra a força bruta.
+ *
+ * Cada consulta de cone e de vizinhos mais próximos é comparada com uma
+ * varredura de todos os itens, depois da construção e depois de
+ * atualizações que movem itens entre células e enchem uma célula até forçar
+ * a redistribuição do arranjo. Os itens incluem pontos nas arestas e nos
+ * cantos do cubo e nos polos, onde a célula é decidida por empates.
+ *
+ * Um item só pode ficar do lado errado do cone se estiver a 1e-5 do limiar
+ * em \f$\cos J\f$; os vizinhos devolvidos têm de ser os k melhores, a menos da
+ * tolerância de \ref AngleTolerance.
+ *
+ * Uso:
+ * \code
+ * spherical_index_test
+ * \endcode
+ */
+#include "spherical_index.h"
+
+#include "test_util.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PI_D 3.14159265358979323846
+#define N 20000
+
+static SphVec3 RandomUnit(void) {
+    double z = Uniform(-1.0, 1.0), a = Uniform(-PI_D, PI_D), r = sqrt(1.0 - z*z);
+    SphVec3 v = { (float)(r*cos(a)), (float)(r*sin(a)), (float)z };
+    return v;
+}
+
+/** Ponto a \c delta rad de \c c, em direção aleatória. */
+static SphVec3 Near(SphVec3 c, double delta) {
+    SphVec3 t = RandomUnit();
+    double d = (double)t.x*c.x + (double)t.y*c.y + (double)t.z*c.z;
+    double px = t.x - d*c.x, py = t.y - d*c.y, pz = t.z - d*c.z;
+    double n = sqrt(px*px + py*py + pz*pz);
+    double x = cos(delta)*c.x + sin(delta)*px/n, y = cos(delta)*c.y + sin(delta)*py/n;
+    double z = cos(delta)*c.z + sin(delta)*pz/n;
+    double m = sqrt(x*x + y*y + z*z);
+    SphVec3 v = { (float)(x/m), (float)(y/m), (float)(z/m) };
+    return v;
+}
+
+static float x[N], y[N], z[N];
+static uint32_t ids[N + 16];
+static float angles[N + 16];
+static unsigned char seen[N];
+
+/** Itens aleatórios, mais arestas e cantos do cubo, polos e um aglomerado. */
+static void MakeItems(void) {
+    static const float kSpecial[][3] = {
+        { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 },
+        { 0.70710678f, 0.70710678f, 0 }, { -0.70710678f, 0, 0.70710678f }, { 0, 0.70710678f, -0.70710678f },
+        { 0.57735027f, 0.57735027f, 0.57735027f }, { -0.57735027f, -0.57735027f, -0.57735027f },
+        { 0.57735027f, -0.57735027f, 0.57735027f },
+    };
+    const size_t ns = sizeof kSpecial / sizeof *kSpecial;
+    const SphVec3 cluster = { 0.6f, 0.0f, 0.8f };
+    for (size_t i = 0; i < N; ++i) {
+        SphVec3 v = i < ns ? (SphVec3){ kSpecial[i][0], kSpecial[i][1], kSpecial[i][2] }
+                  : i % 10 == 0 ? Near(cluster, Uniform(0.0, 1e-3))
+                  : RandomUnit();
+        x[i] = v.x; y[i] = v.y; z[i] = v.z;
+    }
+}
+
+static double TrueAngle(SphVec3 q, size_t i) {
+    double d = (double)q.x*x[i] + (double)q.y*y[i] + (double)q.z*z[i];
+    double cx = (double)q.y*z[i] - (double)q.z*y[i], cy = (double)q.z*x[i] - (double)q.x*z[i];
+    double cz = (double)q.x*y[i] - (double)q.y*x[i];
+    return atan2(sqrt(cx*cx + cy*cy + cz*cz), d);
+}
+
+/** Cone contra a varredura, e a mesma contagem com a saída truncada. */
+static int ConeMatches(const SphIndex *ix, SphVec3 axis, float half) {
+    size_t total = SphIndexCone(ix, axis, half, ids, N);
+    size_t truncated = SphIndexCone(ix, axis, half, ids + N, 3);
+    size_t none = SphIndexCone(ix, axis, half, NULL, 0);
+    if (total > N || truncated != total || none != total) return 0;
+    const float h = half < 0.0f ? 0.0f : (half > (float)PI_D ? (float)PI_D : half);
+    const double ch = SphCosThreshold(h);
+    memset(seen, 0, sizeof seen);
+    for (size_t k = 0; k < total; ++k) {
+        if (ids[k] >= N || seen[ids[k]]) return 0;
+        seen[ids[k]] = 1;
+    }
+    for (size_t i = 0; i < N; ++i) {
+        double d = (double)axis.x*x[i] + (double)axis.y*y[i] + (double)axis.z*z[i];
+        if (seen[i] != (d >= ch) && fabs(d - ch) > 1e-5) return 0;
+    }
+    return 1;
+}
+
+/**
+ * Erro do ângulo devolvido pelo kNN: \f$2\arcsin(c/2)\f$ da corda em float
+ * amplifica o erro de \f$c/2\f$ (~6e-8) por \f$2/\cos(J/2)\f$ perto de π,
+ * até \f$2\sqrt{2 \cdot 6\cdot10^{-8}} \approx 7\cdot10^{-4}\f$ na antípoda.
+ */
+static double AngleTolerance(double a) {
+    double c = cos(0.5 * a);
+    return 1e-6 + (c > 4e-4 ? 4e-7 / c : 1e-3);
+}
+
+/** Vizinhos contra a varredura: ordem, ângulos e nenhum item melhor deixado de fora. */
+static int NearestMatches(const SphIndex *ix, SphVec3 q, size_t k, void *scratch) {
+    size_t n = SphIndexNearest(ix, q, k, ids, angles, scratch);
+    if (n != (k < N ? k : N)) return 0;
+    memset(seen, 0, sizeof seen);
+    for (size_t i = 0; i < n; ++i) {
+        if (ids[i] >= N || seen[ids[i]]) return 0;
+        seen[ids[i]] = 1;
+        if (fabs(angles[i] - TrueAngle(q, ids[i])) > AngleTolerance(angles[i])) return 0;
+        if (i > 0 && angles[i] < angles[i - 1]) return 0;
+    }
+    if (n == 0) return 1;
+    const double worst = angles[n - 1] - AngleTolerance(angles[n - 1]);
+    for (size_t i = 0; i < N; ++i) {
+        if (!seen[i] && TrueAngle(q, i) < worst) return 0;
+    }
+    return 1;
+}
+
+/** Consultas em eixos aleatórios, nos itens especiais e no aglomerado. */
+static void CheckQueries(const SphIndex *ix, const char *label) {
+    static const float kHalf[] = { -0.1f, 0.0f, 1e-4f, 1e-3f, 0.05f, 0.3f, 1.0f, 1.5707964f, 2.5f, 3.1415926f, 4.0f };
+    static const size_t kK[] = { 0, 1, 8, 100, 1000, N + 5 };
+    void *scratch = malloc(SphIndexNearestScratchSize(ix, N + 5));
+    if (!scratch) {
+        Check(0, "sem memória");
+        return;
+    }
+    int cone = 1, knn = 1;
+    for (int a = 0; a < 60; ++a) {
+        SphVec3 axis = a < 12 ? (SphVec3){ x[a], y[a], z[a] }
+                     : a < 20 ? Near((SphVec3){ 0.6f, 0.0f, 0.8f }, Uniform(0.0, 2e-3))
+                     : RandomUnit();
+        for (size_t h = 0; h < sizeof kHalf / sizeof *kHalf; ++h) cone &= ConeMatches(ix, axis, kHalf[h]);
+        // O kNN de N itens é caro na força bruta: só alguns eixos com k grande
+        for (size_t k = 0; k < sizeof kK / sizeof *kK; ++k) {
+            if (kK[k] > 100 && a % 10 != 0) continue;
+            knn &= NearestMatches(ix, axis, kK[k], scratch);
+        }
+    }
+    free(scratch);
+    char what[64];
+    snprintf(what, sizeof what, "SphIndexCone (%s)", label);
+    Check(cone, what);
+    snprintf(what, sizeof what, "SphIndexNearest (%s)", label);
+    Check(knn, what);
+}
+
+int main(void) {
+    MakeItems();
+    SphIndex *ix = SphIndexCreate(16, N);
+    if (!ix) {
+        fprintf(stderr, "sem memória\n");
+        return 1;
+    }
+    Check(SphIndexCreate(12, N) == NULL && SphIndexCreate(4, N) == NULL, "grade fora dos múltiplos de 8: NULL");
+    Check(SphIndexBuild(ix, x, y, z, N + 1) == -1, "SphIndexBuild acima da capacidade: -1");
+    Check(SphIndexBuild(ix, x, y, z, N) == 0 && SphIndexCount(ix) == N, "SphIndexBuild");
+    CheckQueries(ix, "construção");
+
+    // Um a um: metade dos itens para outro lugar, e 1000 no mesmo ponto, o que
+    // enche a célula dele várias vezes (redistribuição do arranjo)
+    const SphVec3 spot = { -0.48f, 0.6f, 0.64f };
+    for (size_t i = 0; i < N; i += 2) {
+        SphVec3 v = i % 20 == 0 ? Near(spot, Uniform(0.0, 1e-4)) : RandomUnit();
+        x[i] = v.x; y[i] = v.y; z[i] = v.z;
+        SphIndexUpdate(ix, i, v);
+    }
+    SphIndexUpdate(ix, N, spot);        // fora do índice: ignorado
+    SphIndexUpdate(ix, SIZE_MAX, spot);
+    Check(SphIndexCount(ix) == N, "SphIndexUpdate com id inválido: ignorado");
+    CheckQueries(ix, "SphIndexUpdate");
+
+    // Em lote: pequenos deslocamentos para todos e um segundo aglomerado
+    for (size_t i = 0; i < N; ++i) {
+        SphVec3 v = i % 7 == 0 ? Near((SphVec3){ 0.0f, 0.0f, -1.0f }, Uniform(0.0, 1e-3))
+                               : Near((SphVec3){ x[i], y[i], z[i] }, Uniform(0.0, 0.05));
+        x[i] = v.x; y[i] = v.y; z[i] = v.z;
+    }
+    SphIndexUpdateBatch(ix, x, y, z, N);
+    CheckQueries(ix, "SphIndexUpdateBatch");
+
+    SphIndexDestroy(ix);
+    printf("\níndice: %s (%d falhas)\n", gFailures ? "FALHOU" : "ok", gFailures);
+    return gFailures ? 1 : 0;
+}
@@ -0,0 +1,150 @@
+/**
+ * \file spsc_ring_test.c
+ * \brief Teste da fila SPSC (\ref spsc_ring.h) com um produtor e um consumidor reais.
+ *
+ * Primeiro, em uma thread só, a capacidade, a fila cheia (overrun) e a
+ * cópia em dois pedaços quando a leitura passa pela volta do arranjo. Depois
+ * duas threads, com uma fila pequena para que os índices deem milhares de
+ * voltas:
+ * - sem perdas: o produtor repete cada push recusado, e o consumidor tem de
+ *   receber todos os elementos, em ordem e intactos;
+ * - com perdas: o produtor nunca repete, e o consumidor tem de receber uma
+ *   subsequência crescente, com recebidos + \ref SpscRingOverruns igual ao
+ *   total empilhado.
+ *
+ * Uso:
+ * \code
+ * spsc_ring_test
+ * \endcode
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "spsc_ring.h"
+
+#include "test_util.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ITEMS 200000
+#define RING_CAPACITY 64
+
+/** Elemento de 24 bytes (não múltiplo da linha de cache): seq e duas cópias embaralhadas. */
+typedef struct Item {
+    uint64_t seq, a, b;
+} Item;
+
+static Item MakeItem(uint64_t seq) {
+    Item it = { seq, seq * 0x9E3779B97F4A7C15ull, ~seq };
+    return it;
+}
+
+static int ItemIntact(const Item *it) {
+    return it->a == it->seq * 0x9E3779B97F4A7C15ull && it->b == ~it->seq;
+}
+
+static void TestSingleThread(void) {
+    SpscRing *r = SpscRingCreate(sizeof(Item), 5);
+    if (!r) {
+        Check(0, "SpscRingCreate");
+        return;
+    }
+    Check(SpscRingCapacity(r) == 8, "capacidade 5 arredondada para 8");
+
+    Item out[16];
+    int ok = SpscRingPop(r, out, 16) == 0;
+    for (uint64_t i = 0; i < 8; ++i) ok &= SpscRingPush(r, &(Item){ i, 0, 0 }) == 0;
+    ok &= SpscRingPush(r, &(Item){ 8, 0, 0 }) == -1 && SpscRingOverruns(r) == 1;
+    Check(ok, "fila cheia: push recusado e overrun contado");
+
+    // Lê 5, escreve 5 (passando pela volta) e lê tudo: 3 antes da volta e 5 depois
+    ok = SpscRingPop(r, out, 5) == 5;
+    for (uint64_t i = 0; i < 5; ++i) ok &= out[i].seq == i;
+    for (uint64_t i = 8; i < 13; ++i) ok &= SpscRingPush(r, &(Item){ i, 0, 0 }) == 0;
+    ok &= SpscRingPop(r, out, 16) == 8;
+    for (uint64_t i = 0; i < 8; ++i) ok &= out[i].seq == 5 + i;
+    ok &= SpscRingPop(r, out, 16) == 0 && SpscRingOverruns(r) == 1;
+    Check(ok, "volta do arranjo: ordem preservada");
+    SpscRingDestroy(r);
+}
+
+typedef struct Shared {
+    SpscRing *ring;
+    int lossless;
+    _Atomic int done;
+    uint64_t refused;  ///< Pushes recusados, contados pelo produtor
+} Shared;
+
+static void *Producer(void *arg) {
+    Shared *s = arg;
+    for (uint64_t i = 0; i < ITEMS; ++i) {
+        Item it = MakeItem(i);
+        while (SpscRingPush(s->ring, &it) != 0) {
+            s->refused++;
+            if (!s->lossless) break;
+            sched_yield();
+        }
+    }
+    atomic_store_explicit(&s->done, 1, memory_order_release);
+    return NULL;
+}
+
+static void TestTwoThreads(int lossless) {
+    Shared s = { SpscRingCreate(sizeof(Item), RING_CAPACITY), lossless, 0, 0 };
+    if (!s.ring) {
+        Check(0, "SpscRingCreate");
+        return;
+    }
+    pthread_t t;
+    if (pthread_create(&t, NULL, Producer, &s) != 0) {
+        Check(0, "pthread_create");
+        SpscRingDestroy(s.ring);
+        return;
+    }
+
+    // Lotes de tamanhos variados, maiores e menores que a capacidade
+    Item out[RING_CAPACITY + 7];
+    uint64_t received = 0, next = 0, batches = 0;
+    int ordered = 1, intact = 1;
+    for (;;) {
+        int done = atomic_load_explicit(&s.done, memory_order_acquire);
+        size_t max = 1 + (size_t)(batches++ * 7919 % (sizeof out / sizeof *out));
+        size_t n = SpscRingPop(s.ring, out, max);
+        for (size_t k = 0; k < n; ++k) {
+            ordered &= lossless ? out[k].seq == next : out[k].seq >= next;
+            intact &= ItemIntact(&out[k]);
+            next = out[k].seq + 1;
+        }
+        received += n;
+        // Só termina com a fila vazia depois de ver o fim do produtor
+        if (n == 0 && done) break;
+        if (n == 0) sched_yield(); // com um núcleo só, o produtor precisa rodar
+    }
+    pthread_join(t, NULL);
+
+    const char *mode = lossless ? "sem perdas" : "com perdas";
+    char what[64];
+    snprintf(what, sizeof what, "%s: ordem", mode);
+    Check(ordered, what);
+    snprintf(what, sizeof what, "%s: elementos intactos", mode);
+    Check(intact, what);
+    uint64_t overruns = SpscRingOverruns(s.ring);
+    snprintf(what, sizeof what, "%s: overruns == pushes recusados", mode);
+    Check(overruns == s.refused, what);
+    snprintf(what, sizeof what, "%s: recebidos + perdidos == empilhados", mode);
+    Check(lossless ? received == ITEMS && next == ITEMS : received + overruns == ITEMS, what);
+    printf("  %llu recebidos, %llu overruns\n", (unsigned long long)received, (unsigned long long)overruns);
+    SpscRingDestroy(s.ring);
+}
+
+int main(void) {
+    TestSingleThread();
+    TestTwoThreads(1);
+    TestTwoThreads(0);
+    printf("\nfila SPSC: %s (%d falhas)\n", gFailures ? "FALHOU" : "ok", gFailures);
+    return gFailures ? 1 : 0;
+}
@@ -0,0 +1,235 @@
+/**
+ * \file state_proto_test.c
+ * \brief Teste do protocolo do publicador de estado (\ref state_proto.h).
+ *
+ * O decodificador lê bytes vindos da rede, então além da ida e volta
+ * (quadro-chave e deltas reconstroem exatamente o \ref StateQ do publicador)
+ * cada carga malformada tem de voltar -1: seq fora de ordem, varint cortado,
+ * máscara com bits além de \ref STATE_PROTO_FIELDS, bytes sobrando e
+ * qualquer prefixo de um quadro válido.
+ *
+ * Uso:
+ * \code
+ * state_proto_test
+ * \endcode
+ */
+#include "state_proto.h"
+
+#include "test_util.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RECORDS 5000
+
+/** Registros recebidos pelo sink. */
+typedef struct Received {
+    StateSample s[RECORDS + 1];
+    size_t n;
+} Received;
+
+static void Collect(const StateSample *s, void *user) {
+    Received *r = user;
+    if (r->n < RECORDS + 1) r->s[r->n] = *s;
+    r->n++;
+}
+
+static void Ignore(const StateSample *s, void *user) {
+    (void)s; (void)user;
+}
+
+static int SameQ(const StateQ *a, const StateQ *b) {
+    return a->t == b->t && memcmp(a->v, b->v, sizeof a->v) == 0;
+}
+
+/** Mesmo registro, campo a campo (os floats comparados pelos bits). */
+static int SameSample(const StateSample *a, const StateSample *b) {
+    return memcmp(&a->t, &b->t, sizeof a->t) == 0 && memcmp(&a->azT, &b->azT, sizeof a->azT) == 0 &&
+           memcmp(&a->elT, &b->elT, sizeof a->elT) == 0 && memcmp(&a->azR, &b->azR, sizeof a->azR) == 0 &&
+           memcmp(&a->elR, &b->elR, sizeof a->elR) == 0 && memcmp(&a->J, &b->J, sizeof a->J) == 0;
+}
+
+/**
+ * Caminho de estados: na maior parte passos pequenos (o caso comum), campos
+ * parados, saltos até os extremos de 32 bits e tempo voltando.
+ */
+static void MakeStates(StateQ *q, size_t n) {
+    memset(q, 0, sizeof *q);
+    q[0].t = 1234567;
+    for (size_t i = 1; i < n; ++i) {
+        q[i] = q[i - 1];
+        uint64_t r = Next();
+        q[i].t += (int64_t)(r % 20000) - (r % 97 == 0 ? 50000 : 0);
+        for (int f = 0; f < STATE_PROTO_FIELDS; ++f) {
+            uint64_t u = Next();
+            switch (u % 8) {
+            case 0: case 1: break;                                            // parado
+            case 2: q[i].v[f] = (int32_t)(uint32_t)(u >> 32); break;           // salto qualquer
+            case 3: q[i].v[f] = (u >> 8) & 1 ? INT32_MAX : -INT32_MAX; break;  // extremos
+            default: {                                                         // passo pequeno
+                int64_t v = (int64_t)q[i].v[f] + (int64_t)((u >> 16) % 201) - 100;
+                q[i].v[f] = (int32_t)(v > INT32_MAX ? INT32_MAX : (v < -INT32_MAX ? -INT32_MAX : v));
+                break;
+            }
+            }
+        }
+    }
+}
+
+/** Quadro de deltas com os registros \c q[first + 1 .. first + count] sobre \c q[first]. */
+static size_t EncodeBatch(const StateQ *q, size_t first, unsigned count, unsigned char *frame) {
+    size_t bytes = StateBeginDelta((uint32_t)(first + 1), frame);
+    for (unsigned k = 0; k < count; ++k) bytes += StateEncodeDelta(&q[first + k], &q[first + k + 1], frame + bytes);
+    StateEndDelta(frame, bytes, count);
+    return bytes;
+}
+
+static void TestRoundTrip(unsigned char *frame) {
+    static StateQ q[RECORDS];
+    static Received got;
+    MakeStates(q, RECORDS);
+    StateDecoder d;
+    memset(&d, 0, sizeof d);
+    got.n = 0;
+
+    size_t bytes = StateEncodeKey(&q[0], 0, frame);
+    int ok = bytes <= STATE_PROTO_MAX_FRAME && StateDecodeFrame(&d, frame + 4, bytes - 4, Collect, &got) == 0;
+    ok = ok && d.synced && d.keys == 1 && d.seq == 1 && SameQ(&d.state, &q[0]);
+    Check(ok, "quadro-chave: estado exato");
+
+    // Lotes de tamanhos variados, incluindo o máximo e lotes vazios
+    size_t i = 0;
+    int same = ok, bounded = 1;
+    while (same && i + 1 < RECORDS) {
+        unsigned count = (unsigned)(Next() % (STATE_PROTO_MAX_BATCH + 1));
+        if (Next() % 16 == 0) count = STATE_PROTO_MAX_BATCH;
+        if (count > RECORDS - 1 - i) count = (unsigned)(RECORDS - 1 - i);
+        bytes = EncodeBatch(q, i, count, frame);
+        bounded &= bytes <= STATE_PROTO_MAX_FRAME;
+        same = StateDecodeFrame(&d, frame + 4, bytes - 4, Collect, &got) == 0;
+        i += count;
+        same = same && d.seq == i + 1 && SameQ(&d.state, &q[i]);
+    }
+    Check(bounded, "deltas: quadros <= STATE_PROTO_MAX_FRAME");
+    Check(same && i + 1 == RECORDS, "deltas: StateQ exato ao fim de cada quadro");
+
+    int samples = got.n == RECORDS;
+    for (size_t k = 0; samples && k < RECORDS; ++k) {
+        StateSample ref;
+        StateDequantize(&q[k], &ref);
+        samples = SameSample(&got.s[k], &ref);
+    }
+    Check(samples, "sink: um registro por estado, na ordem");
+}
+
+/** Decodificador sincronizado em q[0], com seq 1. */
+static StateDecoder Synced(const StateQ *q0, unsigned char *frame) {
+    StateDecoder d;
+    memset(&d, 0, sizeof d);
+    size_t bytes = StateEncodeKey(q0, 0, frame);
+    StateDecodeFrame(&d, frame + 4, bytes - 4, Ignore, NULL);
+    return d;
+}
+
+static void TestMalformed(unsigned char *frame) {
+    StateQ q[8];
+    MakeStates(q, 8);
+    StateDecoder d;
+
+    // Deltas antes do quadro-chave são ignorados
+    memset(&d, 0, sizeof d);
+    size_t bytes = EncodeBatch(q, 0, 4, frame);
+    Check(StateDecodeFrame(&d, frame + 4, bytes - 4, Ignore, NULL) == 0 && !d.synced,
+          "delta antes do quadro-chave: ignorado");
+
+    Check(StateDecodeFrame(&d, frame + 4, 0, Ignore, NULL) == -1, "carga vazia: -1");
+    frame[4] = 'X';
+    Check(StateDecodeFrame(&d, frame + 4, bytes - 4, Ignore, NULL) == -1, "tipo desconhecido: -1");
+
+    // Seq adiante (registros perdidos) e repetido
+    d = Synced(&q[0], frame);
+    bytes = StateBeginDelta(2, frame);
+    bytes += StateEncodeDelta(&q[0], &q[1], frame + bytes);
+    StateEndDelta(frame, bytes, 1);
+    Check(StateDecodeFrame(&d, frame + 4, bytes - 4, Ignore, NULL) == -1, "seq com buraco: -1");
+    d = Synced(&q[0], frame);
+    bytes = EncodeBatch(q, 0, 3, frame);
+    int ok = StateDecodeFrame(&d, frame + 4, bytes - 4, Ignore, NULL) == 0;
+    Check(ok && StateDecodeFrame(&d, frame + 4, bytes - 4, Ignore, NULL) == -1, "seq repetido: -1");
+
+    // Último varint com o bit de continuação e sem o byte seguinte
+    d = Synced(&q[0], frame);
+    bytes = StateBeginDelta(1, frame);
+    frame[bytes++] = 1;    // máscara: só azT
+    frame[bytes++] = 2;    // Δt = 1
+    frame[bytes++] = 0x81; // varint cortado
+    StateEndDelta(frame, bytes, 1);
+    Check(StateDecodeFrame(&d, frame + 4, bytes - 4, Ignore, NULL) == -1, "varint cortado: -1");
+
+    // Varint de 11 bytes (mais de 64 bits)
+    d = Synced(&q[0], frame);
+    bytes = StateBeginDelta(1, frame);
+    frame[bytes++] = 0;
+    for (int k = 0; k < 10; ++k) frame[bytes++] = 0xff;
+    frame[bytes++] = 0x01;
+    StateEndDelta(frame, bytes, 1);
+    Check(StateDecodeFrame(&d, frame + 4, bytes - 4, Ignore, NULL) == -1, "varint de mais de 64 bits: -1");
+
+    // Máscara com bits acima dos campos
+    int allMasks = 1;
+    for (unsigned bit = STATE_PROTO_FIELDS; bit < 8; ++bit) {
+        d = Synced(&q[0], frame);
+        bytes = StateBeginDelta(1, frame);
+        frame[bytes++] = (unsigned char)(1u << bit);
+        frame[bytes++] = 0;
+        for (int k = 0; k < 8; ++k) frame[bytes++] = 0;
+        StateEndDelta(frame, bytes, 1);
+        allMasks &= StateDecodeFrame(&d, frame + 4, bytes - 4, Ignore, NULL) == -1;
+    }
+    Check(allMasks, "máscara com bits >= STATE_PROTO_FIELDS: -1");
+
+    // Bytes sobrando depois dos registros e do quadro-chave
+    d = Synced(&q[0], frame);
+    bytes = EncodeBatch(q, 0, 4, frame);
+    frame[bytes++] = 0;
+    StateEndDelta(frame, bytes, 4);
+    Check(StateDecodeFrame(&d, frame + 4, bytes - 4, Ignore, NULL) == -1, "delta com bytes sobrando: -1");
+    memset(&d, 0, sizeof d);
+    bytes = StateEncodeKey(&q[0], 0, frame);
+    frame[bytes++] = 0;
+    Check(StateDecodeFrame(&d, frame + 4, bytes - 4, Ignore, NULL) == -1 && !d.synced,
+          "quadro-chave com bytes sobrando: -1");
+    bytes = StateEncodeKey(&q[0], 0, frame);
+    frame[5] = STATE_PROTO_VERSION + 1;
+    Check(StateDecodeFrame(&d, frame + 4, bytes - 4, Ignore, NULL) == -1, "versão desconhecida: -1");
+
+    // Todo prefixo próprio de quadros válidos
+    int prefixes = 1;
+    bytes = StateEncodeKey(&q[0], 0, frame);
+    for (size_t len = 0; len < bytes - 4; ++len) {
+        memset(&d, 0, sizeof d);
+        prefixes &= StateDecodeFrame(&d, frame + 4, len, Ignore, NULL) == -1;
+    }
+    bytes = EncodeBatch(q, 0, 7, frame);
+    for (size_t len = 0; len < bytes - 4; ++len) {
+        d = Synced(&q[0], frame + STATE_PROTO_MAX_FRAME);
+        prefixes &= StateDecodeFrame(&d, frame + 4, len, Ignore, NULL) == -1;
+    }
+    Check(prefixes, "prefixos de quadros válidos: -1");
+}
+
+int main(void) {
+    // Dois quadros: o segundo guarda o quadro-chave usado por Synced nos prefixos
+    unsigned char *frame = malloc(2 * STATE_PROTO_MAX_FRAME);
+    if (!frame) {
+        fprintf(stderr, "sem memória\n");
+        return 1;
+    }
+    TestRoundTrip(frame);
+    TestMalformed(frame);
+    free(frame);
+    printf("\nprotocolo: %s (%d falhas)\n", gFailures ? "FALHOU" : "ok", gFailures);
+    return gFailures ? 1 : 0;
+}
@@ -0,0 +1,44 @@
+/**
+ * \file test_util.h
+ * \brief Contagem de falhas, \ref Check e o gerador pseudoaleatório comuns aos testes.
+ *
+ * Cada teste é um executável próprio que inclui este cabeçalho uma vez: o
+ * estado (\c gFailures, \c gRng) é \c static, um por programa. O gerador é
+ * um xorshift64*: suficiente para amostrar entradas e reproduzível pela
+ * semente.
+ */
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/** Falhas contadas até agora; o \c main devolve 1 se não for zero. */
+static int gFailures;
+
+/** Estado do gerador (nunca zero). */
+static uint64_t gRng = 0x9E3779B97F4A7C15ull;
+
+/** Mostra \c what com "ok" ou "FALHOU" e conta a falha. */
+static inline void Check(int ok, const char *what) {
+    printf("%-52s %s\n", what, ok ? "ok" : "FALHOU");
+    if (!ok) gFailures++;
+}
+
+/** Reinicia o gerador (o bit baixo evita o estado zero, do qual ele não sai). */
+static inline void SeedRng(uint64_t seed) {
+    gRng = seed | 1u;
+}
+
+/** Próximos 64 bits do gerador. */
+static inline uint64_t Next(void) {
+    gRng ^= gRng >> 12; gRng ^= gRng << 25; gRng ^= gRng >> 27;
+    return gRng * 0x2545F4914F6CDD1Dull;
+}
+
+/** Uniforme em \f$[lo, hi)\f$, com os 53 bits altos de \ref Next. */
+static inline double Uniform(double lo, double hi) {
+    return lo + (hi - lo) * (double)(Next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+#endif /* TEST_UTIL_H */
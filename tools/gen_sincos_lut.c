@@ -0,0 +1,44 @@
+/**
+ * \file gen_sincos_lut.c
+ * \brief Gera a tabela de um quarto de onda do seno usada por \ref spherical_lut.h.
+ *
+ * Executado pelo CMake durante o build; escreve um cabeçalho com
+ * \f$2^{SPH\_LUT\_BITS} + 1\f$ valores de \f$\sin(i\cdot\frac{\pi/2}{2^{SPH\_LUT\_BITS}})\f$,
+ * calculados em \c double e arredondados para float.
+ *
+ * Uso:
+ * \code
+ * gen_sincos_lut saida.h
+ * \endcode
+ */
+#include "spherical_lut.h"
+
+#include <math.h>
+#include <stdio.h>
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "uso: %s saida.h\n", argv[0]);
+        return 2;
+    }
+    FILE *f = fopen(argv[1], "w");
+    if (!f) {
+        perror(argv[1]);
+        return 1;
+    }
+    const int n = 1 << SPH_LUT_BITS;
+    const double step = acos(-1.0) / 2.0 / n;
+    fprintf(f, "/* Gerado por tools/gen_sincos_lut.c: não editar. */\n");
+    fprintf(f, "#define SPH_LUT_TABLE_BITS %d\n\n", SPH_LUT_BITS);
+    fprintf(f, "static const float kSinQuarter[%d] = {\n", n + 1);
+    for (int i = 0; i <= n; ++i) {
+        fprintf(f, "%s%.9ef,%s", i % 6 == 0 ? "    " : " ", (double)(float)sin(i * step),
+                i % 6 == 5 || i == n ? "\n" : "");
+    }
+    fprintf(f, "};\n");
+    if (fclose(f) != 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    return 0;
+}